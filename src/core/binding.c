@@ -43,6 +43,7 @@ QuicBindingInitialize(
     QUIC_STATUS Status;
     QUIC_BINDING* Binding;
     BOOLEAN HashTableInitialized = FALSE;
+    BOOLEAN ListenerIndexInitialized = FALSE;
 
     Binding = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_BINDING), QUIC_POOL_BINDING);
     if (Binding == NULL) {
@@ -76,6 +77,11 @@ QuicBindingInitialize(
         goto Error;
     }
     HashTableInitialized = TRUE;
+    if (!QuicListenerIndexInitialize(&Binding->ListenerIndex)) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    ListenerIndexInitialized = TRUE;
     CxPlatListInitializeHead(&Binding->StatelessOperList);
 
     //
@@ -182,6 +188,9 @@ Error:
             if (HashTableInitialized) {
                 CxPlatHashtableUninitialize(&Binding->StatelessOperTable);
             }
+            if (ListenerIndexInitialized) {
+                QuicListenerIndexUninitialize(&Binding->ListenerIndex);
+            }
 #if DEBUG
             QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
 #endif
@@ -237,6 +246,7 @@ QuicBindingUninitialize(
     QuicLookupUninitialize(&Binding->Lookup);
     CxPlatDispatchLockUninitialize(&Binding->StatelessOperLock);
     CxPlatHashtableUninitialize(&Binding->StatelessOperTable);
+    QuicListenerIndexUninitialize(&Binding->ListenerIndex);
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
 #endif
@@ -398,6 +408,10 @@ QuicBindingRegisterListener(
         }
     }
 
+    if (Status == QUIC_STATUS_SUCCESS) {
+        Status = QuicListenerIndexInsert(&Binding->ListenerIndex, NewListener);
+    }
+
     if (Status == QUIC_STATUS_SUCCESS) {
         MaximizeLookup = CxPlatListIsEmpty(&Binding->Listeners);
 
@@ -440,45 +454,32 @@ QuicBindingGetListener(
     QUIC_LISTENER* Listener = NULL;
 
     const QUIC_ADDR* Addr = Info->LocalAddress;
-    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Addr);
-
-    BOOLEAN FailedAlpnMatch = FALSE;
-    BOOLEAN FailedAddrMatch = TRUE;
+    BOOLEAN AddressMatched;
 
     CxPlatDispatchRwLockAcquireShared(&Binding->RwLock, PrevIrql);
 
-    for (CXPLAT_LIST_ENTRY* Link = Binding->Listeners.Flink;
-        Link != &Binding->Listeners;
-        Link = Link->Flink) {
-
-        QUIC_LISTENER* ExistingListener =
-            CXPLAT_CONTAINING_RECORD(Link, QUIC_LISTENER, Link);
-        const QUIC_ADDR* ExistingAddr = &ExistingListener->LocalAddress;
-        const BOOLEAN ExistingWildCard = ExistingListener->WildCard;
-        const QUIC_ADDRESS_FAMILY ExistingFamily = QuicAddrGetFamily(ExistingAddr);
-        FailedAlpnMatch = FALSE;
-
-        if (ExistingFamily != QUIC_ADDRESS_FAMILY_UNSPEC) {
-            if (Family != ExistingFamily ||
-                (!ExistingWildCard && !QuicAddrCompareIp(Addr, ExistingAddr))) {
-                FailedAddrMatch = TRUE;
-                continue; // No IP match.
-            }
-        }
-        FailedAddrMatch = FALSE;
-
-        if (QuicListenerMatchesAlpn(ExistingListener, Info)) {
-            if (CxPlatRefIncrementNonZero(&ExistingListener->StartRefCount, 1)) {
-                Listener = ExistingListener;
-            }
-            goto Done;
-        } else {
-            FailedAlpnMatch = TRUE;
-        }
+    //
+    // The index returns the same listener as walking the sorted list of
+    // listeners would, i.e. the first one matching both the address and one
+    // of the client's ALPNs, without looking at the other listeners.
+    //
+    QUIC_LISTENER* ExistingListener =
+        QuicListenerIndexFind(
+            &Binding->ListenerIndex,
+            Addr,
+            Info->ClientAlpnListLength,
+            Info->ClientAlpnList,
+            &AddressMatched);
+
+    const BOOLEAN FailedAddrMatch = !AddressMatched;
+    const BOOLEAN FailedAlpnMatch = AddressMatched && ExistingListener == NULL;
+
+    if (ExistingListener != NULL &&
+        QuicListenerMatchesAlpn(ExistingListener, Info) &&
+        CxPlatRefIncrementNonZero(&ExistingListener->StartRefCount, 1)) {
+        Listener = ExistingListener;
     }
 
-Done:
-
     CxPlatDispatchRwLockReleaseShared(&Binding->RwLock, PrevIrql);
 
     if (FailedAddrMatch) {
@@ -507,6 +508,7 @@ QuicBindingUnregisterListener(
     )
 {
     CxPlatDispatchRwLockAcquireExclusive(&Binding->RwLock, PrevIrql);
+    QuicListenerIndexRemove(&Binding->ListenerIndex, Listener);
     CxPlatListEntryRemove(&Listener->Link);
     CxPlatDispatchRwLockReleaseExclusive(&Binding->RwLock, PrevIrql);
 }
@@ -546,7 +548,7 @@ QuicBindingAcceptConnection(
     if (NegotiatedAlpnLength <= TLS_SMALL_ALPN_BUFFER_SIZE) {
         NegotiatedAlpn = Connection->Crypto.TlsState.SmallAlpnBuffer;
     } else {
-        NegotiatedAlpn = CXPLAT_ALLOC_NONPAGED(NegotiatedAlpnLength, QUIC_POOL_ALPN);
+        NegotiatedAlpn = QuicConnArenaAlloc(&Connection->Arena, NegotiatedAlpnLength, QUIC_POOL_ALPN);
         if (NegotiatedAlpn == NULL) {
             QuicTraceEvent(
                 AllocFailure,
@@ -822,7 +824,7 @@ QuicBindingProcessStatelessOperation(
         Binding,
         OperationType);
 
-    CXPLAT_SEND_CONFIG SendConfig = { RecvPacket->Route, 0, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0 };
+    CXPLAT_SEND_CONFIG SendConfig = { RecvPacket->Route, 0, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0, 0 };
     CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Binding->Socket, &SendConfig);
     if (SendData == NULL) {
         QuicTraceEvent(
@@ -1375,7 +1377,7 @@ Exit:
 
     } else {
         NewConnection->SourceCids.Next = NULL;
-        CXPLAT_FREE(SourceCid, QUIC_POOL_CIDHASH);
+        QuicConnArenaFree(&NewConnection->Arena, SourceCid, QUIC_POOL_CIDHASH);
         QuicConnRelease(NewConnection, QUIC_CONN_REF_LOOKUP_RESULT);
 #pragma prefast(suppress:6001, "SAL doesn't understand ref counts")
         QuicConnRelease(NewConnection, QUIC_CONN_REF_HANDLE_OWNER);
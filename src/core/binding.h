@@ -255,6 +255,11 @@ typedef struct QUIC_BINDING {
     //
     CXPLAT_LIST_ENTRY Listeners;
 
+    //
+    // Index of the listeners, by address and ALPN, for accepting connections.
+    //
+    QUIC_LISTENER_INDEX ListenerIndex;
+
     //
     // Lookup tables for connection IDs.
     //
@@ -119,6 +119,16 @@ typedef struct QUIC_CID {
     // Used for source CIDs. The CID is in the binding's lookup table.
     //
     uint8_t IsInLookupTable : 1;
+    //
+    // Used for source CIDs. The CID payload is purely random, so the lookup
+    // may replace it with an encoded lookup slot.
+    //
+    uint8_t IsEncodable : 1;
+    //
+    // Used for source CIDs. The CID payload encodes a slot in the lookup's
+    // slot table, instead of the CID being in the lookup's hash tables.
+    //
+    uint8_t IsInSlotTable : 1;
 
     uint8_t Length;
     QUIC_VAR_INT SequenceNumber;
@@ -165,13 +175,17 @@ typedef struct QUIC_CID_LIST_ENTRY {
 
 typedef struct QUIC_CID_HASH_ENTRY {
 
-    CXPLAT_HASHTABLE_ENTRY Entry;
     CXPLAT_SLIST_ENTRY Link;
     QUIC_CONNECTION* Connection;
     QUIC_CID CID;
 
 } QUIC_CID_HASH_ENTRY;
 
+//
+// N.B. The CIDs below are allocated from their connection's arena, and must be
+// freed with QuicConnArenaFree.
+//
+
 //
 // Creates a new null/empty source connection ID, that will be used on the
 // receive path.
@@ -180,11 +194,13 @@ QUIC_INLINE
 _Success_(return != NULL)
 QUIC_CID_HASH_ENTRY*
 QuicCidNewNullSource(
-    _In_ QUIC_CONNECTION* Connection
+    _In_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_CONN_ARENA* Arena
     )
 {
     QUIC_CID_HASH_ENTRY* Entry =
-        (QUIC_CID_HASH_ENTRY*)CXPLAT_ALLOC_NONPAGED(
+        (QUIC_CID_HASH_ENTRY*)QuicConnArenaAlloc(
+            Arena,
             sizeof(QUIC_CID_HASH_ENTRY),
             QUIC_POOL_CIDHASH);
 
@@ -204,6 +220,7 @@ _Success_(return != NULL)
 QUIC_CID_HASH_ENTRY*
 QuicCidNewSource(
     _In_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_CONN_ARENA* Arena,
     _In_ uint8_t Length,
     _In_reads_(Length)
         const uint8_t* const Data
@@ -211,7 +228,8 @@ QuicCidNewSource(
 {
     QUIC_CID_HASH_ENTRY* Entry =
         (QUIC_CID_HASH_ENTRY*)
-        CXPLAT_ALLOC_NONPAGED(
+        QuicConnArenaAlloc(
+            Arena,
             sizeof(QUIC_CID_HASH_ENTRY) +
             Length,
             QUIC_POOL_CIDHASH);
@@ -236,11 +254,13 @@ QUIC_INLINE
 _Success_(return != NULL)
 QUIC_CID_LIST_ENTRY*
 QuicCidNewRandomDestination(
+    _Inout_ QUIC_CONN_ARENA* Arena
     )
 {
     QUIC_CID_LIST_ENTRY* Entry =
         (QUIC_CID_LIST_ENTRY*)
-        CXPLAT_ALLOC_NONPAGED(
+        QuicConnArenaAlloc(
+            Arena,
             sizeof(QUIC_CID_LIST_ENTRY) +
             QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH,
             QUIC_POOL_CIDLIST);
@@ -262,6 +282,7 @@ QUIC_INLINE
 _Success_(return != NULL)
 QUIC_CID_LIST_ENTRY*
 QuicCidNewDestination(
+    _Inout_ QUIC_CONN_ARENA* Arena,
     _In_ uint8_t Length,
     _In_reads_(Length)
         const uint8_t* const Data
@@ -269,7 +290,8 @@ QuicCidNewDestination(
 {
     QUIC_CID_LIST_ENTRY* Entry =
         (QUIC_CID_LIST_ENTRY*)
-        CXPLAT_ALLOC_NONPAGED(
+        QuicConnArenaAlloc(
+            Arena,
             sizeof(QUIC_CID_LIST_ENTRY) +
             Length,
             QUIC_POOL_CIDLIST);
@@ -0,0 +1,857 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the open addressing table of local
+    connection IDs used by the lookup, along with the epoch scheme protecting
+    its lock-free readers.
+
+    All the control bytes of a group are compared to the hash tag at once,
+    using plain 64-bit arithmetic: XOR'ing the control word with the tag
+    repeated in every byte gives a zero byte for each match, and zero bytes are
+    then found with the usual "has zero byte" bit trick. That trick may report
+    a false positive in the bytes above a real match, so the control byte is
+    always checked again before the slot is looked at.
+
+--*/
+
+#include "precomp.h"
+
+#define QUIC_CID_TABLE_CTRL_EMPTY       0x00
+#define QUIC_CID_TABLE_CTRL_DELETED     0x01
+#define QUIC_CID_TABLE_CTRL_FULL        0x80
+
+#define QUIC_CID_TABLE_LSB              0x0101010101010101ull
+#define QUIC_CID_TABLE_MSB              0x8080808080808080ull
+
+//
+// Maximum load, in eighths, before the table is rehashed.
+//
+#define QUIC_CID_TABLE_MAX_LOAD         7
+
+//
+// Mixes the bits of the hash, so that both the low (group index) and the high
+// (tag) bits depend on the whole CID.
+//
+QUIC_INLINE
+uint32_t
+QuicCidTableMixHash(
+    _In_ uint32_t Hash
+    )
+{
+    Hash ^= Hash >> 16;
+    Hash *= 0x85ebca6b;
+    Hash ^= Hash >> 13;
+    Hash *= 0xc2b2ae35;
+    Hash ^= Hash >> 16;
+    return Hash;
+}
+
+QUIC_INLINE
+uint8_t
+QuicCidTableTag(
+    _In_ uint32_t MixedHash
+    )
+{
+    return (uint8_t)(QUIC_CID_TABLE_CTRL_FULL | (MixedHash >> 25));
+}
+
+QUIC_INLINE
+uint8_t
+QuicCidTableControlByte(
+    _In_ uint64_t Control,
+    _In_ uint32_t Index
+    )
+{
+    return (uint8_t)(Control >> (Index * 8));
+}
+
+//
+// Returns a mask with the high bit set in every byte of the control word that
+// (might) equal 'Value'.
+//
+QUIC_INLINE
+uint64_t
+QuicCidTableMatch(
+    _In_ uint64_t Control,
+    _In_ uint8_t Value
+    )
+{
+    const uint64_t X = Control ^ (QUIC_CID_TABLE_LSB * Value);
+    return (X - QUIC_CID_TABLE_LSB) & ~X & QUIC_CID_TABLE_MSB;
+}
+
+//
+// Returns the index of the lowest byte set in a (non-zero) match mask.
+//
+QUIC_INLINE
+uint32_t
+QuicCidTableLowestMatch(
+    _In_ uint64_t Match
+    )
+{
+    CXPLAT_DBG_ASSERT(Match != 0);
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long Index;
+    _BitScanForward64(&Index, Match);
+    return Index / 8;
+#elif defined(_MSC_VER)
+    unsigned long Index;
+    if ((uint32_t)Match != 0) {
+        _BitScanForward(&Index, (uint32_t)Match);
+        return Index / 8;
+    }
+    _BitScanForward(&Index, (uint32_t)(Match >> 32));
+    return 4 + Index / 8;
+#else
+    return (uint32_t)__builtin_ctzll(Match) / 8;
+#endif
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CID_TABLE_STORE*
+QuicCidTableAllocStore(
+    _In_ uint32_t GroupCount
+    )
+{
+    CXPLAT_DBG_ASSERT((GroupCount & (GroupCount - 1)) == 0);
+
+    const size_t ControlSize = sizeof(int64_t) * GroupCount;
+    const size_t SlotsSize =
+        sizeof(QUIC_CID_TABLE_SLOT) * QUIC_CID_TABLE_GROUP_SIZE * GroupCount;
+
+    QUIC_CID_TABLE_STORE* Store =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CID_TABLE_STORE) + ControlSize + SlotsSize,
+            QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Store == NULL) {
+        return NULL;
+    }
+
+    Store->GroupMask = GroupCount - 1;
+    Store->Control = (int64_t*)(Store + 1);
+    Store->Slots = (QUIC_CID_TABLE_SLOT*)((uint8_t*)Store->Control + ControlSize);
+
+    //
+    // Only the control words need to be cleared. Slots are always written
+    // before they are marked as full.
+    //
+    CxPlatZeroMemory(Store->Control, ControlSize);
+
+    return Store;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableFreeStore(
+    _In_ QUIC_CID_TABLE_STORE* Store
+    )
+{
+    CXPLAT_FREE(Store, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+//
+// Returns the number of groups needed to hold 'Count' CIDs at most half full.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicCidTableGroupCount(
+    _In_ uint32_t Count
+    )
+{
+    uint32_t GroupCount = QUIC_CID_TABLE_MIN_GROUP_COUNT;
+    while ((uint64_t)GroupCount * QUIC_CID_TABLE_GROUP_SIZE < 2 * (uint64_t)Count) {
+        GroupCount <<= 1;
+    }
+    return GroupCount;
+}
+
+//
+// Writes the CID into the first empty slot of its probe sequence. The store
+// must have at least one empty slot.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableStoreInsert(
+    _Inout_ QUIC_CID_TABLE_STORE* Store,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t MixedHash,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const uint8_t Tag = QuicCidTableTag(MixedHash);
+    uint32_t Group = MixedHash & Store->GroupMask;
+
+    for (uint32_t Probe = 1; ; ++Probe) {
+        const uint64_t Control = (uint64_t)Store->Control[Group];
+        const uint64_t Empty = QuicCidTableMatch(Control, QUIC_CID_TABLE_CTRL_EMPTY);
+        if (Empty != 0) {
+            //
+            // The "has zero byte" trick never reports a false positive below
+            // the lowest real match, so the lowest match is always empty.
+            //
+            const uint32_t Index = QuicCidTableLowestMatch(Empty);
+            CXPLAT_DBG_ASSERT(QuicCidTableControlByte(Control, Index) == QUIC_CID_TABLE_CTRL_EMPTY);
+
+            QUIC_CID_TABLE_SLOT* Slot =
+                &Store->Slots[Group * QUIC_CID_TABLE_GROUP_SIZE + Index];
+            Slot->Connection = Connection;
+            Slot->Length = Length;
+            CxPlatCopyMemory(Slot->Data, Cid, Length);
+
+            //
+            // Publish the slot to any concurrent readers.
+            //
+            QuicWriteRelease64(
+                &Store->Control[Group],
+                (int64_t)(Control | ((uint64_t)Tag << (Index * 8))));
+            return;
+        }
+
+        CXPLAT_DBG_ASSERT(Probe <= Store->GroupMask);
+        Group = (Group + Probe) & Store->GroupMask;
+    }
+}
+
+//
+// Returns the slot index of the CID in the store, or UINT32_MAX.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicCidTableStoreFind(
+    _In_ const QUIC_CID_TABLE_STORE* Store,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t MixedHash
+    )
+{
+    const uint8_t Tag = QuicCidTableTag(MixedHash);
+    uint32_t Group = MixedHash & Store->GroupMask;
+
+    for (uint32_t Probe = 1; Probe <= Store->GroupMask + 1; ++Probe) {
+        const uint64_t Control =
+            (uint64_t)QuicReadAcquire64(&Store->Control[Group]);
+
+        uint64_t Match = QuicCidTableMatch(Control, Tag);
+        while (Match != 0) {
+            const uint32_t Index = QuicCidTableLowestMatch(Match);
+            Match &= Match - 1;
+            if (QuicCidTableControlByte(Control, Index) != Tag) {
+                continue;
+            }
+            const uint32_t SlotIndex = Group * QUIC_CID_TABLE_GROUP_SIZE + Index;
+            const QUIC_CID_TABLE_SLOT* Slot = &Store->Slots[SlotIndex];
+            if (Slot->Length == Length &&
+                memcmp(Slot->Data, Cid, Length) == 0) {
+                return SlotIndex;
+            }
+        }
+
+        if (QuicCidTableMatch(Control, QUIC_CID_TABLE_CTRL_EMPTY) != 0) {
+            break;
+        }
+
+        Group = (Group + Probe) & Store->GroupMask;
+    }
+
+    return UINT32_MAX;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInitialize(
+    _Out_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t InitialCount
+    )
+{
+    Table->Count = 0;
+    Table->UsedCount = 0;
+    Table->Store = QuicCidTableAllocStore(QuicCidTableGroupCount(InitialCount));
+    return Table->Store != NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableUninitialize(
+    _In_ QUIC_CID_TABLE* Table
+    )
+{
+    QuicCidTableFreeStore(Table->Store);
+    Table->Store = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicCidTableLookup(
+    _In_ const QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    const QUIC_CID_TABLE_STORE* Store = QuicReadPtrAcquire(&Table->Store);
+    const uint32_t SlotIndex =
+        QuicCidTableStoreFind(Store, Cid, Length, QuicCidTableMixHash(Hash));
+    return SlotIndex == UINT32_MAX ? NULL : Store->Slots[SlotIndex].Connection;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInsert(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CONNECTION* Connection,
+    _Outptr_result_maybenull_ QUIC_CID_TABLE_STORE** RetiredStore
+    )
+{
+    CXPLAT_DBG_ASSERT(Length <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
+    const uint32_t MixedHash = QuicCidTableMixHash(Hash);
+    QUIC_CID_TABLE_STORE* Store = Table->Store;
+    const uint64_t SlotCount =
+        ((uint64_t)Store->GroupMask + 1) * QUIC_CID_TABLE_GROUP_SIZE;
+
+    *RetiredStore = NULL;
+
+    if (((uint64_t)Table->UsedCount + 1) * 8 > SlotCount * QUIC_CID_TABLE_MAX_LOAD) {
+        //
+        // Too many slots are used, either by CIDs or by deleted entries.
+        // Rehash everything into a new store, which readers will switch to
+        // once it is fully built.
+        //
+        QUIC_CID_TABLE_STORE* NewStore =
+            QuicCidTableAllocStore(QuicCidTableGroupCount(Table->Count + 1));
+        if (NewStore != NULL) {
+            for (uint32_t i = 0; i < SlotCount; ++i) {
+                const uint8_t Control =
+                    QuicCidTableControlByte(
+                        (uint64_t)Store->Control[i / QUIC_CID_TABLE_GROUP_SIZE],
+                        i % QUIC_CID_TABLE_GROUP_SIZE);
+                if (Control & QUIC_CID_TABLE_CTRL_FULL) {
+                    const QUIC_CID_TABLE_SLOT* Slot = &Store->Slots[i];
+                    QuicCidTableStoreInsert(
+                        NewStore,
+                        Slot->Data,
+                        Slot->Length,
+                        QuicCidTableMixHash(CxPlatHashSimple(Slot->Length, Slot->Data)),
+                        Slot->Connection);
+                }
+            }
+
+            QuicWritePtrRelease(&Table->Store, NewStore);
+            Table->UsedCount = Table->Count;
+            *RetiredStore = Store;
+            Store = NewStore;
+
+        } else if (Table->UsedCount == SlotCount) {
+            return FALSE;
+        }
+        //
+        // Otherwise, just keep using the current store above its preferred
+        // load. The next insert will try again.
+        //
+    }
+
+    QuicCidTableStoreInsert(Store, Cid, Length, MixedHash, Connection);
+    Table->Count++;
+    Table->UsedCount++;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableRemove(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    QUIC_CID_TABLE_STORE* Store = Table->Store;
+    const uint32_t SlotIndex =
+        QuicCidTableStoreFind(Store, Cid, Length, QuicCidTableMixHash(Hash));
+    if (SlotIndex == UINT32_MAX) {
+        return FALSE;
+    }
+
+    //
+    // The slot is only marked as deleted, and never reused by this store, so
+    // that a concurrent reader that already matched it still reads consistent
+    // data.
+    //
+    const uint32_t Group = SlotIndex / QUIC_CID_TABLE_GROUP_SIZE;
+    const uint32_t Shift = (SlotIndex % QUIC_CID_TABLE_GROUP_SIZE) * 8;
+    uint64_t Control = (uint64_t)Store->Control[Group];
+    Control &= ~(0xFFull << Shift);
+    Control |= (uint64_t)QUIC_CID_TABLE_CTRL_DELETED << Shift;
+    QuicWriteRelease64(&Store->Control[Group], (int64_t)Control);
+
+    CXPLAT_DBG_ASSERT(Table->Count != 0);
+    Table->Count--;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+const QUIC_CID_TABLE_SLOT*
+QuicCidTableEnumerateNext(
+    _In_ const QUIC_CID_TABLE* Table,
+    _Inout_ uint32_t* Index
+    )
+{
+    const QUIC_CID_TABLE_STORE* Store = Table->Store;
+    const uint64_t SlotCount =
+        ((uint64_t)Store->GroupMask + 1) * QUIC_CID_TABLE_GROUP_SIZE;
+
+    while (*Index < SlotCount) {
+        const uint32_t i = (*Index)++;
+        const uint8_t Control =
+            QuicCidTableControlByte(
+                (uint64_t)Store->Control[i / QUIC_CID_TABLE_GROUP_SIZE],
+                i % QUIC_CID_TABLE_GROUP_SIZE);
+        if (Control & QUIC_CID_TABLE_CTRL_FULL) {
+            return &Store->Slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+#define QUIC_CID_SLOT_HALF_BITS     28
+#define QUIC_CID_SLOT_HALF_MASK     ((1u << QUIC_CID_SLOT_HALF_BITS) - 1)
+#define QUIC_CID_SLOT_GEN_MASK      0xFF
+
+CXPLAT_STATIC_ASSERT(
+    QUIC_CID_PAYLOAD_LENGTH * 8 == 2 * QUIC_CID_SLOT_HALF_BITS,
+    "The Feistel network covers the whole payload");
+
+//
+// Enciphers (or deciphers) the 56-bit payload value with a balanced Feistel
+// network over its two 28-bit halves.
+//
+QUIC_INLINE
+uint64_t
+QuicCidSlotEncipher(
+    _In_ const uint32_t* Keys,
+    _In_ uint64_t Value
+    )
+{
+    uint32_t Left = (uint32_t)(Value >> QUIC_CID_SLOT_HALF_BITS);
+    uint32_t Right = (uint32_t)Value & QUIC_CID_SLOT_HALF_MASK;
+    for (uint32_t i = 0; i < QUIC_CID_SLOT_ROUNDS; ++i) {
+        const uint32_t Temp = Right;
+        Right = Left ^ (QuicCidTableMixHash(Right ^ Keys[i]) & QUIC_CID_SLOT_HALF_MASK);
+        Left = Temp;
+    }
+    return ((uint64_t)Left << QUIC_CID_SLOT_HALF_BITS) | Right;
+}
+
+QUIC_INLINE
+uint64_t
+QuicCidSlotDecipher(
+    _In_ const uint32_t* Keys,
+    _In_ uint64_t Value
+    )
+{
+    uint32_t Left = (uint32_t)(Value >> QUIC_CID_SLOT_HALF_BITS);
+    uint32_t Right = (uint32_t)Value & QUIC_CID_SLOT_HALF_MASK;
+    for (uint32_t i = QUIC_CID_SLOT_ROUNDS; i > 0; --i) {
+        const uint32_t Temp = Left;
+        Left = Right ^ (QuicCidTableMixHash(Left ^ Keys[i - 1]) & QUIC_CID_SLOT_HALF_MASK);
+        Right = Temp;
+    }
+    return ((uint64_t)Left << QUIC_CID_SLOT_HALF_BITS) | Right;
+}
+
+//
+// Returns the slot index encoded in the payload, or 0 if the payload wasn't
+// issued by this table.
+//
+QUIC_INLINE
+uint32_t
+QuicCidSlotDecode(
+    _In_ const QUIC_CID_SLOT_TABLE* Table,
+    _In_reads_(QUIC_CID_PAYLOAD_LENGTH)
+        const uint8_t* const Payload,
+    _Out_ uint8_t* Generation
+    )
+{
+    uint64_t Value = 0;
+    for (uint32_t i = 0; i < QUIC_CID_PAYLOAD_LENGTH; ++i) {
+        Value = (Value << 8) | Payload[i];
+    }
+    Value = QuicCidSlotDecipher(Table->Keys, Value);
+    if ((Value & 0xFFFFFF) != 0) {
+        *Generation = 0;
+        return 0;
+    }
+    *Generation = (uint8_t)(Value >> 24);
+    return (uint32_t)(Value >> 32);
+}
+
+QUIC_INLINE
+void
+QuicCidSlotEncode(
+    _In_ const QUIC_CID_SLOT_TABLE* Table,
+    _In_ uint32_t Slot,
+    _In_ uint8_t Generation,
+    _Out_writes_(QUIC_CID_PAYLOAD_LENGTH)
+        uint8_t* Payload
+    )
+{
+    uint64_t Value =
+        QuicCidSlotEncipher(
+            Table->Keys,
+            ((uint64_t)Slot << 32) | ((uint64_t)Generation << 24));
+    for (uint32_t i = QUIC_CID_PAYLOAD_LENGTH; i > 0; --i) {
+        Payload[i - 1] = (uint8_t)Value;
+        Value >>= 8;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableInitialize(
+    _Out_ QUIC_CID_SLOT_TABLE* Table
+    )
+{
+    CxPlatZeroMemory(Table, sizeof(*Table));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableUninitialize(
+    _In_ QUIC_CID_SLOT_TABLE* Table
+    )
+{
+    if (Table->Array != NULL) {
+        QuicCidSlotTableFreeArray(Table->Array);
+        Table->Array = NULL;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableFreeArray(
+    _In_ QUIC_CID_SLOT_ARRAY* Array
+    )
+{
+    CXPLAT_FREE(Array, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+//
+// Replaces the slot array with one twice as large, and adds the new slots to
+// the free list.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidSlotTableGrow(
+    _Inout_ QUIC_CID_SLOT_TABLE* Table,
+    _Outptr_result_maybenull_ QUIC_CID_SLOT_ARRAY** RetiredArray
+    )
+{
+    QUIC_CID_SLOT_ARRAY* OldArray = Table->Array;
+    const uint32_t OldCount = OldArray == NULL ? 0 : OldArray->Count;
+    const uint32_t NewCount =
+        OldCount == 0 ? QUIC_CID_SLOT_MIN_COUNT : OldCount * 2;
+    if (NewCount > QUIC_CID_SLOT_MAX_COUNT) {
+        return FALSE;
+    }
+
+    if (OldArray == NULL &&
+        QUIC_FAILED(CxPlatRandom(sizeof(Table->Keys), Table->Keys))) {
+        return FALSE;
+    }
+
+    QUIC_CID_SLOT_ARRAY* NewArray =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CID_SLOT_ARRAY) + sizeof(QUIC_CID_SLOT) * NewCount,
+            QUIC_POOL_LOOKUP_HASHTABLE);
+    if (NewArray == NULL) {
+        return FALSE;
+    }
+
+    NewArray->Count = NewCount;
+    if (OldCount != 0) {
+        CxPlatCopyMemory(
+            NewArray->Slots, OldArray->Slots, sizeof(QUIC_CID_SLOT) * OldCount);
+    }
+    CxPlatZeroMemory(
+        NewArray->Slots + OldCount,
+        sizeof(QUIC_CID_SLOT) * (NewCount - OldCount));
+
+    //
+    // Slot 0 is reserved, so that a zero index always means no slot.
+    //
+    for (uint32_t i = OldCount == 0 ? 1 : OldCount; i < NewCount; ++i) {
+        if (Table->FreeTail == 0) {
+            Table->FreeHead = i;
+        } else {
+            NewArray->Slots[Table->FreeTail].NextFree = i;
+        }
+        Table->FreeTail = i;
+    }
+
+    QuicWritePtrRelease(&Table->Array, NewArray);
+    *RetiredArray = OldArray;
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicCidSlotTableLookup(
+    _In_ const QUIC_CID_SLOT_TABLE* Table,
+    _In_reads_(QUIC_CID_PAYLOAD_LENGTH)
+        const uint8_t* const Payload
+    )
+{
+    const QUIC_CID_SLOT_ARRAY* Array = QuicReadPtrAcquire(&Table->Array);
+    if (Array == NULL) {
+        return NULL;
+    }
+
+    uint8_t Generation;
+    const uint32_t Index = QuicCidSlotDecode(Table, Payload, &Generation);
+    if (Index == 0 || Index >= Array->Count) {
+        return NULL;
+    }
+
+    //
+    // Releasing a slot clears the connection before bumping the generation,
+    // so the connection belongs to the generation read on both sides of it.
+    //
+    QUIC_CID_SLOT* Slot = (QUIC_CID_SLOT*)&Array->Slots[Index];
+    const long Before = QuicReadAcquire(&Slot->Generation);
+    QUIC_CONNECTION* Connection = QuicReadPtrAcquire(&Slot->Connection);
+    const long After = QuicReadAcquire(&Slot->Generation);
+
+    if (Connection == NULL ||
+        Before != After ||
+        (uint8_t)(Before & QUIC_CID_SLOT_GEN_MASK) != Generation) {
+        return NULL;
+    }
+
+    return Connection;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidSlotTableInsert(
+    _Inout_ QUIC_CID_SLOT_TABLE* Table,
+    _In_ QUIC_CONNECTION* Connection,
+    _Out_writes_(QUIC_CID_PAYLOAD_LENGTH)
+        uint8_t* Payload,
+    _Outptr_result_maybenull_ QUIC_CID_SLOT_ARRAY** RetiredArray
+    )
+{
+    *RetiredArray = NULL;
+
+    if (Table->FreeHead == 0 &&
+        !QuicCidSlotTableGrow(Table, RetiredArray)) {
+        return FALSE;
+    }
+
+    const uint32_t Index = Table->FreeHead;
+    QUIC_CID_SLOT* Slot = &Table->Array->Slots[Index];
+    Table->FreeHead = Slot->NextFree;
+    if (Table->FreeHead == 0) {
+        Table->FreeTail = 0;
+    }
+    Slot->NextFree = 0;
+
+    CXPLAT_DBG_ASSERT(Slot->Connection == NULL);
+    QuicWritePtrRelease(&Slot->Connection, Connection);
+
+    QuicCidSlotEncode(
+        Table,
+        Index,
+        (uint8_t)(Slot->Generation & QUIC_CID_SLOT_GEN_MASK),
+        Payload);
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableRemove(
+    _Inout_ QUIC_CID_SLOT_TABLE* Table,
+    _In_reads_(QUIC_CID_PAYLOAD_LENGTH)
+        const uint8_t* const Payload
+    )
+{
+    uint8_t Generation;
+    const uint32_t Index = QuicCidSlotDecode(Table, Payload, &Generation);
+    CXPLAT_DBG_ASSERT(Index != 0 && Index < Table->Array->Count);
+
+    QUIC_CID_SLOT* Slot = &Table->Array->Slots[Index];
+    CXPLAT_DBG_ASSERT(Slot->Connection != NULL);
+    CXPLAT_DBG_ASSERT((uint8_t)(Slot->Generation & QUIC_CID_SLOT_GEN_MASK) == Generation);
+
+    QuicWritePtrRelease(&Slot->Connection, NULL);
+    QuicWriteRelease(&Slot->Generation, Slot->Generation + 1);
+
+    if (Table->FreeTail == 0) {
+        Table->FreeHead = Index;
+    } else {
+        Table->Array->Slots[Table->FreeTail].NextFree = Index;
+    }
+    Table->FreeTail = Index;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidEpochInitialize(
+    _Out_ QUIC_CID_EPOCH* Epoch
+    )
+{
+    Epoch->Epoch = 0;
+    Epoch->ReaderCount = CxPlatProcCount();
+    Epoch->Readers =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CID_EPOCH_READER) * Epoch->ReaderCount,
+            QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Epoch->Readers == NULL) {
+        return FALSE;
+    }
+    CxPlatZeroMemory(
+        Epoch->Readers,
+        sizeof(QUIC_CID_EPOCH_READER) * Epoch->ReaderCount);
+    CxPlatDispatchLockInitialize(&Epoch->Lock);
+    return TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochUninitialize(
+    _In_ QUIC_CID_EPOCH* Epoch
+    )
+{
+#if DEBUG
+    for (uint32_t i = 0; i < Epoch->ReaderCount; ++i) {
+        CXPLAT_DBG_ASSERT(Epoch->Readers[i].Count[0] == 0);
+        CXPLAT_DBG_ASSERT(Epoch->Readers[i].Count[1] == 0);
+    }
+#endif
+    CxPlatDispatchLockUninitialize(&Epoch->Lock);
+    CXPLAT_FREE(Epoch->Readers, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+long*
+QuicCidEpochEnter(
+    _In_ QUIC_CID_EPOCH* Epoch
+    )
+{
+    QUIC_CID_EPOCH_READER* Reader =
+        &Epoch->Readers[CxPlatProcCurrentNumber() % Epoch->ReaderCount];
+
+    while (TRUE) {
+        const long Current = QuicReadAcquire(&Epoch->Epoch);
+        long* Count = &Reader->Count[Current & 1];
+        InterlockedIncrement(Count);
+
+        //
+        // If a writer advanced the epoch in the meantime, it might not be
+        // waiting on the count just incremented, so try again.
+        //
+        if (QuicReadAcquire(&Epoch->Epoch) == Current) {
+            return Count;
+        }
+        InterlockedDecrement(Count);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochExit(
+    _In_ long* ReaderCount
+    )
+{
+    InterlockedDecrement(ReaderCount);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+long
+QuicCidEpochCurrent(
+    _In_ QUIC_CID_EPOCH* Epoch
+    )
+{
+    //
+    // The full barrier orders the writer's earlier changes before the read, so
+    // that any reader that might have seen the state before them has entered
+    // an epoch no later than the one returned.
+    //
+    return InterlockedCompareExchange(&Epoch->Epoch, 0, 0);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidEpochTryAdvance(
+    _In_ QUIC_CID_EPOCH* Epoch
+    )
+{
+    BOOLEAN Advanced = TRUE;
+
+    CxPlatDispatchLockAcquire(&Epoch->Lock);
+
+    //
+    // The next epoch reuses the count of the one before the current, so the
+    // epoch may only advance once all its readers have left.
+    //
+    const long Current = Epoch->Epoch;
+    for (uint32_t i = 0; i < Epoch->ReaderCount; ++i) {
+        if (QuicReadAcquire(&Epoch->Readers[i].Count[(Current + 1) & 1]) != 0) {
+            Advanced = FALSE;
+            break;
+        }
+    }
+    if (Advanced) {
+        InterlockedIncrement(&Epoch->Epoch);
+    }
+
+    CxPlatDispatchLockRelease(&Epoch->Lock);
+
+    return Advanced;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochSynchronize(
+    _In_ QUIC_CID_EPOCH* Epoch
+    )
+{
+    CxPlatDispatchLockAcquire(&Epoch->Lock);
+
+    //
+    // Readers of the epoch before the current one may still be around if it
+    // was last advanced by QuicCidEpochTryAdvance. They have to leave before
+    // their count is reused by the next epoch.
+    //
+    const long Current = Epoch->Epoch;
+    for (uint32_t i = 0; i < Epoch->ReaderCount; ++i) {
+        while (QuicReadAcquire(&Epoch->Readers[i].Count[(Current + 1) & 1]) != 0) {
+            CxPlatSchedulerYield();
+        }
+    }
+
+    InterlockedIncrement(&Epoch->Epoch);
+    for (uint32_t i = 0; i < Epoch->ReaderCount; ++i) {
+        while (QuicReadAcquire(&Epoch->Readers[i].Count[Current & 1]) != 0) {
+            CxPlatSchedulerYield();
+        }
+    }
+
+    CxPlatDispatchLockRelease(&Epoch->Lock);
+}
@@ -0,0 +1,393 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Open addressing table of local connection IDs that supports lookups without
+    taking any locks.
+
+    The table is organized in groups of 8 slots. Each group has a single 64-bit
+    control word, with one control byte per slot: either empty, deleted or the
+    top 7 bits of the hash of the CID in the slot. A lookup compares a whole
+    control word against the hash tag at once, and only looks at the slots
+    that match. Groups are probed (triangular numbers) until one with an empty
+    slot is found.
+
+    Only a single writer may modify the table at a time. Readers don't take any
+    lock, and instead must be in a QUIC_CID_EPOCH read section. Writers never
+    modify a slot once it has been published; removed slots are only marked as
+    deleted and reclaimed when the table is rehashed into a new store. The old
+    store must then be kept alive until all readers have left, i.e. until the
+    epoch has advanced twice (QuicCidEpochTryAdvance), or via
+    QuicCidEpochSynchronize.
+
+    The 'Hash' passed to the functions below must always be
+    CxPlatHashSimple() of the CID, as the table computes it again on rehash.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#define QUIC_CID_TABLE_GROUP_SIZE       8
+#define QUIC_CID_TABLE_MIN_GROUP_COUNT  2
+
+typedef struct QUIC_CID_TABLE_SLOT {
+
+    QUIC_CONNECTION* Connection;
+    uint8_t Length;
+    uint8_t Data[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+
+} QUIC_CID_TABLE_SLOT;
+
+typedef struct QUIC_CID_TABLE_STORE {
+
+    //
+    // The number of groups, minus one. The number of groups is always a power
+    // of 2.
+    //
+    uint32_t GroupMask;
+
+    //
+    // One control word per group.
+    //
+    int64_t* Control;
+
+    //
+    // QUIC_CID_TABLE_GROUP_SIZE slots per group.
+    //
+    QUIC_CID_TABLE_SLOT* Slots;
+
+} QUIC_CID_TABLE_STORE;
+
+typedef struct QUIC_CID_TABLE {
+
+    //
+    // The current store. Read without locks by readers.
+    //
+    QUIC_CID_TABLE_STORE* Store;
+
+    //
+    // Number of CIDs in the table.
+    //
+    uint32_t Count;
+
+    //
+    // Number of slots that aren't empty, i.e. including the deleted ones.
+    //
+    uint32_t UsedCount;
+
+} QUIC_CID_TABLE;
+
+//
+// Initializes the table, with space for at least 'InitialCount' CIDs.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInitialize(
+    _Out_ QUIC_CID_TABLE* Table,
+    _In_ uint32_t InitialCount
+    );
+
+//
+// Frees the table. No readers may still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableUninitialize(
+    _In_ QUIC_CID_TABLE* Table
+    );
+
+//
+// Frees a store previously retired by QuicCidTableInsert.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidTableFreeStore(
+    _In_ QUIC_CID_TABLE_STORE* Store
+    );
+
+//
+// Returns the connection for the CID, or NULL. Must either be called within
+// a QUIC_CID_EPOCH read section or by the writer. The connection is only
+// guaranteed to stay valid for the duration of the read section.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicCidTableLookup(
+    _In_ const QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    );
+
+//
+// Inserts a CID that isn't already in the table. If the table had to be
+// rehashed, the previous store is returned in 'RetiredStore', and must be
+// freed with QuicCidTableFreeStore once no readers can still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableInsert(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CONNECTION* Connection,
+    _Outptr_result_maybenull_ QUIC_CID_TABLE_STORE** RetiredStore
+    );
+
+//
+// Removes a CID from the table. Returns FALSE if it wasn't found.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidTableRemove(
+    _Inout_ QUIC_CID_TABLE* Table,
+    _In_reads_(Length)
+        const uint8_t* const Cid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    );
+
+//
+// Returns the next CID in the table, starting from '*Index', or NULL when
+// there are no more. Start with '*Index' set to 0. Only for the writer.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+const QUIC_CID_TABLE_SLOT*
+QuicCidTableEnumerateNext(
+    _In_ const QUIC_CID_TABLE* Table,
+    _Inout_ uint32_t* Index
+    );
+
+//
+// Table of connection slots, used to route CIDs that encode their slot
+// directly to the connection, without any hashing.
+//
+// The 7 byte payload of such a CID (following the server ID and partition ID)
+// is a 24-bit slot index, the 8-bit generation of the slot and 24 bits that
+// must be zero, all enciphered by a small Feistel network keyed with random
+// per-table keys. The zero bits act as a short MAC: a CID not issued by the
+// table decodes to non-zero bits with high probability, and the payload
+// doesn't reveal which CIDs belong to the same connection. Each CID gets its
+// own slot, which is released when the CID is removed; bumping the
+// generation then keeps the CID from routing to the next owner of the slot.
+//
+// Like QUIC_CID_TABLE, only a single writer may modify the table at a time,
+// and readers must be in a QUIC_CID_EPOCH read section.
+//
+
+#define QUIC_CID_SLOT_MIN_COUNT     64
+#define QUIC_CID_SLOT_MAX_COUNT     (1u << 24)
+#define QUIC_CID_SLOT_ROUNDS        4
+
+typedef struct QUIC_CID_SLOT {
+
+    //
+    // The connection using the slot, or NULL if it's free.
+    //
+    QUIC_CONNECTION* Connection;
+
+    //
+    // Incremented every time the slot is released. The low 8 bits are encoded
+    // in the CID.
+    //
+    long Generation;
+
+    //
+    // The next slot in the free list, or 0.
+    //
+    uint32_t NextFree;
+
+} QUIC_CID_SLOT;
+
+typedef struct QUIC_CID_SLOT_ARRAY {
+
+    uint32_t Count;
+    QUIC_CID_SLOT Slots[0];
+
+} QUIC_CID_SLOT_ARRAY;
+
+typedef struct QUIC_CID_SLOT_TABLE {
+
+    //
+    // The current slot array, or NULL if no slot was ever used. Read without
+    // locks by readers.
+    //
+    QUIC_CID_SLOT_ARRAY* Array;
+
+    //
+    // Free slots are reused in FIFO order, so that a slot's generation wraps
+    // around as late as possible. Slot 0 is never used.
+    //
+    uint32_t FreeHead;
+    uint32_t FreeTail;
+
+    uint32_t Keys[QUIC_CID_SLOT_ROUNDS];
+
+} QUIC_CID_SLOT_TABLE;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableInitialize(
+    _Out_ QUIC_CID_SLOT_TABLE* Table
+    );
+
+//
+// Frees the table. No readers may still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableUninitialize(
+    _In_ QUIC_CID_SLOT_TABLE* Table
+    );
+
+//
+// Frees a slot array previously retired by QuicCidSlotTableInsert.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableFreeArray(
+    _In_ QUIC_CID_SLOT_ARRAY* Array
+    );
+
+//
+// Returns the connection for the encoded CID payload, or NULL. Must either be
+// called within a QUIC_CID_EPOCH read section or by the writer.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicCidSlotTableLookup(
+    _In_ const QUIC_CID_SLOT_TABLE* Table,
+    _In_reads_(QUIC_CID_PAYLOAD_LENGTH)
+        const uint8_t* const Payload
+    );
+
+//
+// Assigns a new slot to the connection and writes the encoded CID payload
+// for it. If the slot array had to grow, the previous array is returned in
+// 'RetiredArray', and must be freed with QuicCidSlotTableFreeArray once no
+// readers can still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidSlotTableInsert(
+    _Inout_ QUIC_CID_SLOT_TABLE* Table,
+    _In_ QUIC_CONNECTION* Connection,
+    _Out_writes_(QUIC_CID_PAYLOAD_LENGTH)
+        uint8_t* Payload,
+    _Outptr_result_maybenull_ QUIC_CID_SLOT_ARRAY** RetiredArray
+    );
+
+//
+// Releases the slot of a payload returned by QuicCidSlotTableInsert.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidSlotTableRemove(
+    _Inout_ QUIC_CID_SLOT_TABLE* Table,
+    _In_reads_(QUIC_CID_PAYLOAD_LENGTH)
+        const uint8_t* const Payload
+    );
+
+//
+// Epoch based protection for lock-free readers. Readers increment a
+// per-processor count for the current epoch for the duration of their read
+// section. Writers advance the epoch and wait for the count of readers in the
+// previous epoch to drain before freeing anything readers might still be
+// accessing.
+//
+
+#define QUIC_CID_EPOCH_READER_SIZE 64 // Cache line
+
+typedef struct QUIC_CACHEALIGN QUIC_CID_EPOCH_READER {
+
+    long Count[2];
+    uint8_t Reserved[QUIC_CID_EPOCH_READER_SIZE - 2 * sizeof(long)];
+
+} QUIC_CID_EPOCH_READER;
+
+typedef struct QUIC_CID_EPOCH {
+
+    long Epoch;
+
+    uint32_t ReaderCount;
+
+    _Field_size_(ReaderCount)
+    QUIC_CID_EPOCH_READER* Readers;
+
+    //
+    // Serializes writers waiting for the readers to drain.
+    //
+    CXPLAT_DISPATCH_LOCK Lock;
+
+} QUIC_CID_EPOCH;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidEpochInitialize(
+    _Out_ QUIC_CID_EPOCH* Epoch
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochUninitialize(
+    _In_ QUIC_CID_EPOCH* Epoch
+    );
+
+//
+// Enters a read section. The returned value must be passed to
+// QuicCidEpochExit.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+long*
+QuicCidEpochEnter(
+    _In_ QUIC_CID_EPOCH* Epoch
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochExit(
+    _In_ long* ReaderCount
+    );
+
+//
+// Returns the current epoch, after all the writer's previous changes. Anything
+// those changes retired may be freed once the epoch has advanced twice since.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+long
+QuicCidEpochCurrent(
+    _In_ QUIC_CID_EPOCH* Epoch
+    );
+
+//
+// Advances the epoch if that doesn't require waiting for any reader. Returns
+// FALSE if readers of the previous epoch are still in their read sections.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicCidEpochTryAdvance(
+    _In_ QUIC_CID_EPOCH* Epoch
+    );
+
+//
+// Waits for all the readers that might have seen any previous changes to leave
+// their read sections. Only meant for paths that can't defer freeing what they
+// retired, such as teardown.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicCidEpochSynchronize(
+    _In_ QUIC_CID_EPOCH* Epoch
+    );
+
+#if defined(__cplusplus)
+}
+#endif
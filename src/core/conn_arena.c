@@ -0,0 +1,150 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the per-connection arena allocator.
+
+--*/
+
+#include "precomp.h"
+
+//
+// Allocations from the block are aligned to 8 bytes.
+//
+#define QUIC_CONN_ARENA_ALIGN(Size) (((Size) + 7) & ~(uint32_t)7)
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaInitialize(
+    _Out_ QUIC_CONN_ARENA* Arena,
+    _In_ uint32_t Size
+    )
+{
+    Arena->Block = NULL;
+    Arena->Size = Size;
+    Arena->Used = 0;
+    Arena->LastOffset = 0;
+    Arena->Requested = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaUninitialize(
+    _In_ QUIC_CONN_ARENA* Arena
+    )
+{
+    if (Arena->Block != NULL) {
+        CXPLAT_FREE(Arena->Block, QUIC_POOL_CONN_ARENA);
+        Arena->Block = NULL;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+void*
+QuicConnArenaAlloc(
+    _Inout_ QUIC_CONN_ARENA* Arena,
+    _In_ size_t Size,
+    _In_ uint32_t Tag
+    )
+{
+    if (Arena->Size == 0 || Size > QUIC_CONN_ARENA_MAX_SIZE) {
+        return CXPLAT_ALLOC_NONPAGED(Size, Tag);
+    }
+
+    const uint32_t AlignedSize = QUIC_CONN_ARENA_ALIGN((uint32_t)Size);
+    Arena->Requested += AlignedSize;
+
+    if (Arena->Block == NULL && AlignedSize <= Arena->Size) {
+        Arena->Block = CXPLAT_ALLOC_NONPAGED(Arena->Size, QUIC_POOL_CONN_ARENA);
+    }
+
+    if (Arena->Block == NULL || AlignedSize > Arena->Size - Arena->Used) {
+        return CXPLAT_ALLOC_NONPAGED(Size, Tag);
+    }
+
+    Arena->LastOffset = Arena->Used;
+    Arena->Used += AlignedSize;
+    return Arena->Block + Arena->LastOffset;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaFree(
+    _Inout_ QUIC_CONN_ARENA* Arena,
+    _In_opt_ const void* Buffer,
+    _In_ uint32_t Tag
+    )
+{
+    if (Arena->Block == NULL ||
+        (const uint8_t*)Buffer < Arena->Block ||
+        (const uint8_t*)Buffer >= Arena->Block + Arena->Size) {
+        CXPLAT_FREE(Buffer, Tag);
+        return;
+    }
+
+    //
+    // Only the last allocation can be returned to the block. The memory of the
+    // others is reclaimed when the arena is uninitialized.
+    //
+    const uint32_t Offset = (uint32_t)((const uint8_t*)Buffer - Arena->Block);
+    CXPLAT_DBG_ASSERT(Offset < Arena->Used);
+    if (Offset == Arena->LastOffset && Arena->LastOffset != Arena->Used) {
+        Arena->Used = Arena->LastOffset;
+    }
+    UNREFERENCED_PARAMETER(Tag);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicConnArenaBlockSize(
+    _In_ uint32_t Footprint
+    )
+{
+    if (Footprint == 0) {
+        Footprint = QUIC_CONN_ARENA_DEFAULT_FOOTPRINT;
+    }
+
+    //
+    // Leave some headroom over the typical footprint, so that most connections
+    // fit in the block.
+    //
+    uint32_t Size = Footprint + Footprint / 4;
+    Size = (Size + 63) & ~(uint32_t)63;
+    if (Size < QUIC_CONN_ARENA_MIN_SIZE) {
+        Size = QUIC_CONN_ARENA_MIN_SIZE;
+    } else if (Size > QUIC_CONN_ARENA_MAX_SIZE) {
+        Size = QUIC_CONN_ARENA_MAX_SIZE;
+    }
+    return Size;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaUpdateFootprint(
+    _In_ const QUIC_CONN_ARENA* Arena,
+    _Inout_ uint32_t* Footprint
+    )
+{
+    if (Arena->Size == 0 || Arena->Requested == 0) {
+        return; // Disabled or unused; nothing learned.
+    }
+
+    uint32_t Requested = Arena->Requested;
+    if (Requested > QUIC_CONN_ARENA_MAX_SIZE) {
+        Requested = QUIC_CONN_ARENA_MAX_SIZE;
+    }
+
+    //
+    // N.B. Connections of the same partition may be freed on different threads.
+    // The footprint is only a hint, so racing updates are tolerated.
+    //
+    const uint32_t Current = *Footprint;
+    *Footprint =
+        Current == 0 ?
+            Requested :
+            Current - Current / 8 + Requested / 8;
+}
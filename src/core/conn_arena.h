@@ -0,0 +1,129 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A bump allocator for the small allocations that live (at most) as long as
+    their connection, such as its CIDs. The arena hands out memory from a
+    single block, allocated on first use, and frees the whole block when the
+    connection is freed, instead of every allocation one by one.
+
+    The block is sized from the footprint of the connections freed before it
+    (tracked per partition), so that a typical connection only needs the one
+    block. Allocations that don't fit in the block fall back to the heap.
+
+    Freeing an allocation from the block only returns its memory if it was the
+    last one handed out; otherwise it's reclaimed with the rest of the block.
+
+    The arena isn't thread safe; it's used from the connection's context only.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The footprint assumed for the first connections of a partition.
+//
+#define QUIC_CONN_ARENA_DEFAULT_FOOTPRINT   512
+
+//
+// The bounds on the size of a block.
+//
+#define QUIC_CONN_ARENA_MIN_SIZE            128
+#define QUIC_CONN_ARENA_MAX_SIZE            4096
+
+typedef struct QUIC_CONN_ARENA {
+
+    //
+    // The block allocations are handed out from. NULL until the first one.
+    //
+    uint8_t* Block;
+
+    //
+    // The size of the block, or zero if the arena is disabled.
+    //
+    uint32_t Size;
+
+    //
+    // The number of bytes of the block handed out so far.
+    //
+    uint32_t Used;
+
+    //
+    // The offset of the last allocation handed out from the block.
+    //
+    uint32_t LastOffset;
+
+    //
+    // The number of bytes requested over the lifetime of the arena, including
+    // the ones that fell back to the heap.
+    //
+    uint32_t Requested;
+
+} QUIC_CONN_ARENA;
+
+//
+// Initializes the arena with a block of the given size. A zero size disables
+// the arena, so that all allocations go to the heap.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaInitialize(
+    _Out_ QUIC_CONN_ARENA* Arena,
+    _In_ uint32_t Size
+    );
+
+//
+// Frees the block, and everything still allocated from it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaUninitialize(
+    _In_ QUIC_CONN_ARENA* Arena
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+void*
+QuicConnArenaAlloc(
+    _Inout_ QUIC_CONN_ARENA* Arena,
+    _In_ size_t Size,
+    _In_ uint32_t Tag
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaFree(
+    _Inout_ QUIC_CONN_ARENA* Arena,
+    _In_opt_ const void* Buffer,
+    _In_ uint32_t Tag
+    );
+
+//
+// Returns the block size for a new connection, from the footprint learned so
+// far (zero if nothing was learned yet).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicConnArenaBlockSize(
+    _In_ uint32_t Footprint
+    );
+
+//
+// Folds the bytes requested from the arena into the learned footprint, as a
+// moving average.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnArenaUpdateFootprint(
+    _In_ const QUIC_CONN_ARENA* Arena,
+    _Inout_ uint32_t* Footprint
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -83,6 +83,10 @@ QuicConnAlloc(
 
     CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
     Connection->Partition = Partition;
+    QuicConnArenaInitialize(
+        &Connection->Arena,
+        MsQuicLib.EnableConnArena ?
+            QuicConnArenaBlockSize(Partition->ConnArenaFootprint) : 0);
 
 #if DEBUG
     InterlockedIncrement(&MsQuicLib.ConnectionCount);
@@ -114,6 +118,7 @@ QuicConnAlloc(
     Connection->AckDelayExponent = QUIC_ACK_DELAY_EXPONENT;
     Connection->PacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
     Connection->PeerPacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
+    Connection->PeerMinPacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
     Connection->ReorderingThreshold = QUIC_MIN_REORDERING_THRESHOLD;
     Connection->PeerReorderingThreshold = QUIC_MIN_REORDERING_THRESHOLD;
     Connection->PeerTransportParams.AckDelayExponent = QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT;
@@ -153,6 +158,9 @@ QuicConnAlloc(
     for (QUIC_CONN_TIMER_TYPE Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
         Connection->ExpirationTimes[Type] = UINT64_MAX;
     }
+    for (uint32_t i = 0; i < QUIC_CONN_TIMER_COARSE_COUNT; ++i) {
+        Connection->CoarseDeadlines[i] = UINT64_MAX;
+    }
 
     if (IsServer) {
 
@@ -197,7 +205,7 @@ QuicConnAlloc(
             CASTED_CLOG_BYTEARRAY(sizeof(Path->Route.RemoteAddress), &Path->Route.RemoteAddress));
 
         Path->DestCid =
-            QuicCidNewDestination(Packet->SourceCidLen, Packet->SourceCid);
+            QuicCidNewDestination(&Connection->Arena, Packet->SourceCidLen, Packet->SourceCid);
         if (Path->DestCid == NULL) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
             goto Error;
@@ -213,7 +221,7 @@ QuicConnAlloc(
             CASTED_CLOG_BYTEARRAY(Path->DestCid->CID.Length, Path->DestCid->CID.Data));
 
         QUIC_CID_HASH_ENTRY* SourceCid =
-            QuicCidNewSource(Connection, Packet->DestCidLen, Packet->DestCid);
+            QuicCidNewSource(Connection, &Connection->Arena, Packet->DestCidLen, Packet->DestCid);
         if (SourceCid == NULL) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
             goto Error;
@@ -238,7 +246,7 @@ QuicConnAlloc(
         Path->IsPeerValidated = TRUE;
         Path->Allowance = UINT32_MAX;
 
-        Path->DestCid = QuicCidNewRandomDestination();
+        Path->DestCid = QuicCidNewRandomDestination(&Connection->Arena);
         if (Path->DestCid == NULL) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
             goto Error;
@@ -283,7 +291,8 @@ Error:
         }
     }
     if (Packet != NULL && Connection->SourceCids.Next != NULL) {
-        CXPLAT_FREE(
+        QuicConnArenaFree(
+            &Connection->Arena,
             CXPLAT_CONTAINING_RECORD(
                 Connection->SourceCids.Next,
                 QUIC_CID_HASH_ENTRY,
@@ -297,7 +306,7 @@ Error:
                 CxPlatListRemoveHead(&Connection->DestCids),
                 QUIC_CID_LIST_ENTRY,
                 Link);
-        CXPLAT_FREE(CID, QUIC_POOL_CIDLIST);
+        QuicConnArenaFree(&Connection->Arena, CID, QUIC_POOL_CIDLIST);
     }
     QuicConnRelease(Connection, QUIC_CONN_REF_HANDLE_OWNER);
 
@@ -349,7 +358,7 @@ QuicConnFree(
                 CxPlatListRemoveHead(&Connection->DestCids),
                 QUIC_CID_LIST_ENTRY,
                 Link);
-        CXPLAT_FREE(CID, QUIC_POOL_CIDLIST);
+        QuicConnArenaFree(&Connection->Arena, CID, QUIC_POOL_CIDLIST);
     }
     QuicConnUnregister(Connection);
     if (Connection->Worker != NULL) {
@@ -392,7 +401,7 @@ QuicConnFree(
         CXPLAT_FREE(Connection->RemoteServerName, QUIC_POOL_SERVERNAME);
     }
     if (Connection->OrigDestCID != NULL) {
-        CXPLAT_FREE(Connection->OrigDestCID, QUIC_POOL_CID);
+        QuicConnArenaFree(&Connection->Arena, Connection->OrigDestCID, QUIC_POOL_CID);
     }
     if (Connection->HandshakeTP != NULL) {
         QuicCryptoTlsCleanupTransportParameters(Connection->HandshakeTP);
@@ -413,6 +422,8 @@ QuicConnFree(
     if (Connection->CloseReasonPhrase != NULL) {
         CXPLAT_FREE(Connection->CloseReasonPhrase, QUIC_POOL_CLOSE_REASON);
     }
+    QuicConnArenaUpdateFootprint(&Connection->Arena, &Partition->ConnArenaFootprint);
+    QuicConnArenaUninitialize(&Connection->Arena);
     Connection->State.Freed = TRUE;
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONNECTION, &Connection->DbgObjectLink);
@@ -885,6 +896,7 @@ QuicConnGenerateNewSourceCid(
         SourceCid =
             QuicCidNewRandomSource(
                 Connection,
+                &Connection->Arena,
                 Connection->ServerID,
                 Connection->PartitionID,
                 Connection->CibirId[0],
@@ -899,7 +911,7 @@ QuicConnGenerateNewSourceCid(
             return NULL;
         }
         if (!QuicBindingAddSourceConnectionID(Connection->Paths[0].Binding, SourceCid)) {
-            CXPLAT_FREE(SourceCid, QUIC_POOL_CIDHASH);
+            QuicConnArenaFree(&Connection->Arena, SourceCid, QUIC_POOL_CIDHASH);
             SourceCid = NULL;
             if (++TryCount > QUIC_CID_MAX_COLLISION_RETRY) {
                 QuicTraceEvent(
@@ -1220,6 +1232,21 @@ QuicConnTimerSetEx(
         (uint8_t)Type,
         Delay);
 
+    if (Type >= QUIC_CONN_TIMER_FIRST_COARSE) {
+        //
+        // Coarse timers (keep alive, idle and shutdown) are pushed out far more
+        // often than they fire; the idle timer on every received packet. So
+        // only the deadline is recorded when it moves later, and the timer
+        // stays armed at the earlier time. When that fires, the timer is just
+        // re-armed at the deadline (see QuicConnTimerExpired).
+        //
+        Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE] = NewExpirationTime;
+        if (Connection->ExpirationTimes[Type] != UINT64_MAX &&
+            Connection->ExpirationTimes[Type] <= NewExpirationTime) {
+            return;
+        }
+    }
+
     Connection->ExpirationTimes[Type] = NewExpirationTime;
     uint64_t NewEarliestExpirationTime  = QuicGetEarliestExpirationTime(Connection);
     if (NewEarliestExpirationTime != Connection->EarliestExpirationTime) {
@@ -1237,6 +1264,10 @@ QuicConnTimerCancel(
 {
     CXPLAT_DBG_ASSERT(Connection->EarliestExpirationTime <= Connection->ExpirationTimes[Type]);
 
+    if (Type >= QUIC_CONN_TIMER_FIRST_COARSE) {
+        Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE] = UINT64_MAX;
+    }
+
     if (Connection->EarliestExpirationTime == UINT64_MAX) {
         //
         // No timers are currently scheduled.
@@ -1280,8 +1311,22 @@ QuicConnTimerExpired(
     // on the fly. Note that we must not call any functions that might update the timer wheel.
     //
     for (QUIC_CONN_TIMER_TYPE Type = 0; Type < QUIC_CONN_TIMER_COUNT; ++Type) {
+        if (Connection->ExpirationTimes[Type] <= TimeNow &&
+            Type >= QUIC_CONN_TIMER_FIRST_COARSE &&
+            Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE] > TimeNow) {
+            //
+            // The coarse timer was pushed out since it was armed. Re-arm it at
+            // its deadline instead.
+            //
+            Connection->ExpirationTimes[Type] =
+                Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE];
+        }
+
         if (Connection->ExpirationTimes[Type] <= TimeNow) {
             Connection->ExpirationTimes[Type] = UINT64_MAX;
+            if (Type >= QUIC_CONN_TIMER_FIRST_COARSE) {
+                Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE] = UINT64_MAX;
+            }
             QuicTraceEvent(
                 ConnExpiredTimer,
                 "[conn][%p] %hhu expired",
@@ -1923,12 +1968,13 @@ QuicConnStart(
         SourceCid =
             QuicCidNewRandomSource(
                 Connection,
+                &Connection->Arena,
                 NULL,
                 Connection->PartitionID,
                 Connection->CibirId[0],
                 Connection->CibirId+2);
     } else {
-        SourceCid = QuicCidNewNullSource(Connection);
+        SourceCid = QuicCidNewNullSource(Connection, &Connection->Arena);
     }
     if (SourceCid == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
@@ -2522,7 +2568,8 @@ QuicConnSetConfiguration(
         // Save the original CID for later validation in the TP.
         //
         Connection->OrigDestCID =
-            CXPLAT_ALLOC_NONPAGED(
+            QuicConnArenaAlloc(
+                &Connection->Arena,
                 sizeof(QUIC_CID) +
                 DestCid->CID.Length,
                 QUIC_POOL_CID);
@@ -3407,9 +3454,10 @@ QuicConnUpdateDestCid(
             // so we must allocate a new one and free the old one.
             //
             CxPlatListEntryRemove(&DestCid->Link);
-            CXPLAT_FREE(DestCid, QUIC_POOL_CIDLIST);
+            QuicConnArenaFree(&Connection->Arena, DestCid, QUIC_POOL_CIDLIST);
             DestCid =
                 QuicCidNewDestination(
+                    &Connection->Arena,
                     Packet->SourceCidLen,
                     Packet->SourceCid);
             if (DestCid == NULL) {
@@ -3917,11 +3965,12 @@ QuicConnRecvHeader(
                 CXPLAT_DBG_ASSERT(QuicAddrCompare(&Path->Route.RemoteAddress, &Token.Encrypted.RemoteAddress));
 
                 if (Connection->OrigDestCID != NULL) {
-                    CXPLAT_FREE(Connection->OrigDestCID, QUIC_POOL_CID);
+                    QuicConnArenaFree(&Connection->Arena, Connection->OrigDestCID, QUIC_POOL_CID);
                 }
 
                 Connection->OrigDestCID =
-                    CXPLAT_ALLOC_NONPAGED(
+                    QuicConnArenaAlloc(
+                        &Connection->Arena,
                         sizeof(QUIC_CID) +
                         Token.Encrypted.OrigConnIdLength,
                         QUIC_POOL_CID);
@@ -3949,7 +3998,8 @@ QuicConnRecvHeader(
         if (Connection->OrigDestCID == NULL) {
 
             Connection->OrigDestCID =
-                CXPLAT_ALLOC_NONPAGED(
+                QuicConnArenaAlloc(
+                    &Connection->Arena,
                     sizeof(QUIC_CID) +
                     Packet->DestCidLen,
                     QUIC_POOL_CID);
@@ -4153,126 +4203,104 @@ QuicConnRecvPrepareDecrypt(
     return TRUE;
 }
 
-//
-// Decrypts the packet's payload and authenticates the whole packet. On
-// successful authentication of the packet, does some final processing of the
-// packet header (key and CID updates). Returns TRUE if the packet should
-// continue to be processed further.
-//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
-QuicConnRecvDecryptAndAuthenticate(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ QUIC_PATH* Path,
-    _In_ QUIC_RX_PACKET* Packet
+QuicConnRecvCanCheckForStatelessReset(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
     )
 {
-    CXPLAT_DBG_ASSERT(Packet->AvailBufferLength >= Packet->HeaderLength + Packet->PayloadLength);
-
-    const uint8_t* Payload = Packet->AvailBuffer + Packet->HeaderLength;
-
-    //
-    // We need to copy the end of the packet before trying decryption, as a
-    // failed decryption trashes the stateless reset token.
-    //
-    BOOLEAN CanCheckForStatelessReset = FALSE;
-    uint8_t PacketResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
-    if (QuicConnIsClient(Connection) &&
+    return
+        QuicConnIsClient(Connection) &&
         Packet->IsShortHeader &&
-        Packet->HeaderLength + Packet->PayloadLength >= QUIC_MIN_STATELESS_RESET_PACKET_LENGTH) {
-        CanCheckForStatelessReset = TRUE;
-        CxPlatCopyMemory(
-            PacketResetToken,
-            Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
-            QUIC_STATELESS_RESET_TOKEN_LENGTH);
-    }
-
-    CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
-
-    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-    QuicCryptoCombineIvAndPacketNumber(
-        Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->Iv,
-        (uint8_t*)&Packet->PacketNumber,
-        Iv);
+        Packet->HeaderLength + Packet->PayloadLength >= QUIC_MIN_STATELESS_RESET_PACKET_LENGTH;
+}
 
+//
+// Handles a packet that failed decryption. 'PacketResetToken', if present, is
+// a copy of the end of the packet from before the decryption was attempted, to
+// check if the packet was actually a stateless reset.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnRecvDecryptFailed(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_reads_opt_(QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        const uint8_t* PacketResetToken
+    )
+{
     //
-    // Decrypt the payload with the appropriate key.
+    // Check for a stateless reset packet.
     //
-    if (Packet->Encrypted) {
-        QuicTraceEvent(
-            PacketDecrypt,
-            "[pack][%llu] Decrypting",
-            Packet->PacketId);
-        if (QUIC_FAILED(
-            CxPlatDecrypt(
-                Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
-                Iv,
-                Packet->HeaderLength,   // HeaderLength
-                Packet->AvailBuffer,    // Header
-                Packet->PayloadLength,  // BufferLength
-                (uint8_t*)Payload))) {  // Buffer
-
+    if (PacketResetToken != NULL) {
+        for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
+                Entry != &Connection->DestCids;
+                Entry = Entry->Flink) {
             //
-            // Check for a stateless reset packet.
+            // Loop through all our stored stateless reset tokens to see if
+            // we have a match.
             //
-            if (CanCheckForStatelessReset) {
-                for (CXPLAT_LIST_ENTRY* Entry = Connection->DestCids.Flink;
-                        Entry != &Connection->DestCids;
-                        Entry = Entry->Flink) {
-                    //
-                    // Loop through all our stored stateless reset tokens to see if
-                    // we have a match.
-                    //
-                    QUIC_CID_LIST_ENTRY* DestCid =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_LIST_ENTRY,
-                            Link);
-                    if (DestCid->CID.HasResetToken &&
-                        !DestCid->CID.Retired &&
-                        memcmp(
-                            DestCid->ResetToken,
-                            PacketResetToken,
-                            QUIC_STATELESS_RESET_TOKEN_LENGTH) == 0) {
-                        QuicTraceLogVerbose(
-                            PacketRxStatelessReset,
-                            "[S][RX][-] SR %s",
-                            QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
-                        QuicTraceLogConnInfo(
-                            RecvStatelessReset,
-                            Connection,
-                            "Received stateless reset");
-                        QuicConnCloseLocally(
-                            Connection,
-                            QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
-                            (uint64_t)QUIC_STATUS_ABORTED,
-                            NULL);
-                        return FALSE;
-                    }
-                }
-            }
-
-            if (QuicTraceLogVerboseEnabled()) {
-                QuicPacketLogHeader(
+            QUIC_CID_LIST_ENTRY* DestCid =
+                CXPLAT_CONTAINING_RECORD(
+                    Entry,
+                    QUIC_CID_LIST_ENTRY,
+                    Link);
+            if (DestCid->CID.HasResetToken &&
+                !DestCid->CID.Retired &&
+                memcmp(
+                    DestCid->ResetToken,
+                    PacketResetToken,
+                    QUIC_STATELESS_RESET_TOKEN_LENGTH) == 0) {
+                QuicTraceLogVerbose(
+                    PacketRxStatelessReset,
+                    "[S][RX][-] SR %s",
+                    QuicCidBufToStr(PacketResetToken, QUIC_STATELESS_RESET_TOKEN_LENGTH).Buffer);
+                QuicTraceLogConnInfo(
+                    RecvStatelessReset,
                     Connection,
-                    TRUE,
-                    Connection->State.ShareBinding ? MsQuicLib.CidTotalLength : 0,
-                    Packet->PacketNumber,
-                    Packet->HeaderLength,
-                    Packet->AvailBuffer,
-                    Connection->Stats.QuicVersion);
-            }
-            Connection->Stats.Recv.DecryptionFailures++;
-            QuicPacketLogDrop(Connection, Packet, "Decryption failure");
-            QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL);
-            if (Connection->Stats.Recv.DecryptionFailures >= CXPLAT_AEAD_INTEGRITY_LIMIT) {
-                QuicConnTransportError(Connection, QUIC_ERROR_AEAD_LIMIT_REACHED);
+                    "Received stateless reset");
+                QuicConnCloseLocally(
+                    Connection,
+                    QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
+                    (uint64_t)QUIC_STATUS_ABORTED,
+                    NULL);
+                return;
             }
-
-            return FALSE;
         }
     }
 
+    if (QuicTraceLogVerboseEnabled()) {
+        QuicPacketLogHeader(
+            Connection,
+            TRUE,
+            Connection->State.ShareBinding ? MsQuicLib.CidTotalLength : 0,
+            Packet->PacketNumber,
+            Packet->HeaderLength,
+            Packet->AvailBuffer,
+            Connection->Stats.QuicVersion);
+    }
+    Connection->Stats.Recv.DecryptionFailures++;
+    QuicPacketLogDrop(Connection, Packet, "Decryption failure");
+    QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL);
+    if (Connection->Stats.Recv.DecryptionFailures >= CXPLAT_AEAD_INTEGRITY_LIMIT) {
+        QuicConnTransportError(Connection, QUIC_ERROR_AEAD_LIMIT_REACHED);
+    }
+}
+
+//
+// Does the final processing of the packet header (key and CID updates) after
+// the packet has been successfully decrypted and authenticated. Returns TRUE
+// if the packet should continue to be processed further.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvAuthenticated(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ QUIC_RX_PACKET* Packet
+    )
+{
     Connection->Stats.Recv.ValidPackets++;
 
     //
@@ -4431,6 +4459,74 @@ QuicConnRecvDecryptAndAuthenticate(
     return TRUE;
 }
 
+//
+// Decrypts the packet's payload and authenticates the whole packet. On
+// successful authentication of the packet, does some final processing of the
+// packet header (key and CID updates). Returns TRUE if the packet should
+// continue to be processed further.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvDecryptAndAuthenticate(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_PATH* Path,
+    _In_ QUIC_RX_PACKET* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(Packet->AvailBufferLength >= Packet->HeaderLength + Packet->PayloadLength);
+
+    const uint8_t* Payload = Packet->AvailBuffer + Packet->HeaderLength;
+
+    //
+    // We need to copy the end of the packet before trying decryption, as a
+    // failed decryption trashes the stateless reset token.
+    //
+    BOOLEAN CanCheckForStatelessReset = FALSE;
+    uint8_t PacketResetToken[QUIC_STATELESS_RESET_TOKEN_LENGTH];
+    if (QuicConnRecvCanCheckForStatelessReset(Connection, Packet)) {
+        CanCheckForStatelessReset = TRUE;
+        CxPlatCopyMemory(
+            PacketResetToken,
+            Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
+            QUIC_STATELESS_RESET_TOKEN_LENGTH);
+    }
+
+    CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
+
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+    QuicCryptoCombineIvAndPacketNumber(
+        Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->Iv,
+        (uint8_t*)&Packet->PacketNumber,
+        Iv);
+
+    //
+    // Decrypt the payload with the appropriate key.
+    //
+    if (Packet->Encrypted) {
+        QuicTraceEvent(
+            PacketDecrypt,
+            "[pack][%llu] Decrypting",
+            Packet->PacketId);
+        if (QUIC_FAILED(
+            CxPlatDecrypt(
+                Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
+                Iv,
+                Packet->HeaderLength,   // HeaderLength
+                Packet->AvailBuffer,    // Header
+                Packet->PayloadLength,  // BufferLength
+                (uint8_t*)Payload))) {  // Buffer
+
+            QuicConnRecvDecryptFailed(
+                Connection,
+                Packet,
+                CanCheckForStatelessReset ? PacketResetToken : NULL);
+            return FALSE;
+        }
+    }
+
+    return QuicConnRecvAuthenticated(Connection, Path, Packet);
+}
+
 //
 // Reads the frames in a packet, and if everything is successful marks the
 // packet for acknowledgement and returns TRUE.
@@ -4997,7 +5093,7 @@ QuicConnRecvFrames(
                 // Create the new destination connection ID.
                 //
                 QUIC_CID_LIST_ENTRY* DestCid =
-                    QuicCidNewDestination(Frame.Length, Frame.Buffer);
+                    QuicCidNewDestination(&Connection->Arena, Frame.Length, Frame.Buffer);
                 if (DestCid == NULL) {
                     QuicTraceEvent(
                         AllocFailure,
@@ -5079,7 +5175,7 @@ QuicConnRecvFrames(
                     &IsLastCid);
             if (SourceCid != NULL) {
                 BOOLEAN CidAlreadyRetired = SourceCid->CID.Retired;
-                CXPLAT_FREE(SourceCid, QUIC_POOL_CIDHASH);
+                QuicConnArenaFree(&Connection->Arena, SourceCid, QUIC_POOL_CIDHASH);
                 if (IsLastCid) {
                     QuicTraceEvent(
                         ConnError,
@@ -5545,6 +5641,116 @@ QuicConnRecvPostProcessing(
     }
 }
 
+typedef enum QUIC_RECV_DECRYPT_RESULT {
+    QUIC_RECV_DECRYPT_PREPARE_FAILED,   // Dropped before decryption.
+    QUIC_RECV_DECRYPT_PREPARED,         // Still needs to be decrypted on its own.
+    QUIC_RECV_DECRYPT_FAILED,
+    QUIC_RECV_DECRYPT_SUCCESS
+} QUIC_RECV_DECRYPT_RESULT;
+
+//
+// Removes header protection from and decrypts a batch of short header packets
+// that all use the same packet key. Stops after the first packet that needs a
+// different key (i.e. the peer's key phase changed), which must then be
+// decrypted on its own, after all the packets before it have been processed.
+// Returns the number of packets with a result.
+//
+// Note that all the packet numbers in the batch are decompressed before any of
+// the packets are processed, so the later ones are decompressed against a
+// slightly older largest packet number. This is fine since the batch is much
+// smaller than the smallest packet number window.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint8_t
+QuicConnRecvDecryptBatch(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint8_t BatchCount,
+    _In_reads_(BatchCount) QUIC_RX_PACKET** Packets,
+    _In_reads_(BatchCount * CXPLAT_HP_SAMPLE_LENGTH)
+        const uint8_t* HpMask,
+    _Out_writes_to_(BatchCount, return) QUIC_RECV_DECRYPT_RESULT* Results,
+    _Out_writes_(BatchCount * QUIC_STATELESS_RESET_TOKEN_LENGTH)
+        uint8_t* ResetTokens
+    )
+{
+    const QUIC_PACKET_KEY_TYPE KeyType = Packets[0]->KeyType;
+    const QUIC_PACKET_KEY* Key = Connection->Crypto.TlsState.ReadKeys[KeyType];
+    CXPLAT_CRYPT_BATCH_ENTRY Batch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t BatchIndex[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t EntryCount = 0;
+    uint8_t ResultCount = 0;
+
+    CXPLAT_DBG_ASSERT(Key != NULL);
+
+    while (ResultCount < BatchCount) {
+        const uint8_t i = ResultCount++;
+        QUIC_RX_PACKET* Packet = Packets[i];
+        CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
+
+        if (!QuicConnRecvPrepareDecrypt(
+                Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH)) {
+            Results[i] = QUIC_RECV_DECRYPT_PREPARE_FAILED;
+            continue;
+        }
+
+        if (!Packet->Encrypted || Packet->KeyType != KeyType) {
+            Results[i] = QUIC_RECV_DECRYPT_PREPARED;
+            break;
+        }
+
+        CXPLAT_DBG_ASSERT(Packet->AvailBufferLength >= Packet->HeaderLength + Packet->PayloadLength);
+        uint8_t* Payload = (uint8_t*)Packet->AvailBuffer + Packet->HeaderLength;
+
+        //
+        // The decryption happens in place, so save off what might be a
+        // stateless reset token first.
+        //
+        if (QuicConnRecvCanCheckForStatelessReset(Connection, Packet)) {
+            CxPlatCopyMemory(
+                ResetTokens + i * QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                Payload + Packet->PayloadLength - QUIC_STATELESS_RESET_TOKEN_LENGTH,
+                QUIC_STATELESS_RESET_TOKEN_LENGTH);
+        }
+
+        QuicTraceEvent(
+            PacketDecrypt,
+            "[pack][%llu] Decrypting",
+            Packet->PacketId);
+
+        CXPLAT_CRYPT_BATCH_ENTRY* Entry = &Batch[EntryCount];
+        QuicCryptoCombineIvAndPacketNumber(
+            Key->Iv, (uint8_t*)&Packet->PacketNumber, Entry->Iv);
+        Entry->AuthData = Packet->AvailBuffer;
+        Entry->AuthDataLength = Packet->HeaderLength;
+        Entry->Buffer = Payload;
+        Entry->BufferLength = Packet->PayloadLength;
+        BatchIndex[EntryCount++] = i;
+        Results[i] = QUIC_RECV_DECRYPT_SUCCESS;
+    }
+
+    //
+    // The batch decryption stops at the first failure, so just pick back up
+    // after it until all the packets are done.
+    //
+    uint8_t Offset = 0;
+    while (Offset < EntryCount) {
+        uint8_t DecryptedCount = 0;
+        if (QUIC_FAILED(
+            CxPlatDecryptBatch(
+                Key->PacketKey,
+                EntryCount - Offset,
+                Batch + Offset,
+                &DecryptedCount))) {
+            CXPLAT_DBG_ASSERT(Offset + DecryptedCount < EntryCount);
+            Results[BatchIndex[Offset + DecryptedCount]] = QUIC_RECV_DECRYPT_FAILED;
+            DecryptedCount++;
+        }
+        Offset += DecryptedCount;
+    }
+
+    return ResultCount;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnRecvDatagramBatch(
@@ -5588,14 +5794,48 @@ QuicConnRecvDatagramBatch(
         CxPlatZeroMemory(HpMask, BatchCount * CXPLAT_HP_SAMPLE_LENGTH);
     }
 
+    //
+    // Batches of short header packets generally all use the same key, so
+    // decrypt as many of them together as possible, up front. Any left over
+    // are handled one at a time below.
+    //
+    QUIC_RECV_DECRYPT_RESULT Results[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t ResetTokens[QUIC_STATELESS_RESET_TOKEN_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t ResultCount = 0;
+    if (BatchCount > 1) {
+        ResultCount =
+            QuicConnRecvDecryptBatch(
+                Connection, BatchCount, Packets, HpMask, Results, ResetTokens);
+    }
+
     for (uint8_t i = 0; i < BatchCount; ++i) {
         CXPLAT_DBG_ASSERT(Packets[i]->Allocated);
         CXPLAT_ECN_TYPE ECN = CXPLAT_ECN_FROM_TOS(Packets[i]->TypeOfService);
         Packet = Packets[i];
         CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
-        if (!QuicConnRecvPrepareDecrypt(
-                Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH) ||
-            !QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet)) {
+
+        BOOLEAN Authenticated;
+        if (i >= ResultCount) {
+            Authenticated =
+                QuicConnRecvPrepareDecrypt(
+                    Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH) &&
+                QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet);
+        } else if (Results[i] == QUIC_RECV_DECRYPT_PREPARED) {
+            Authenticated = QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet);
+        } else if (Results[i] == QUIC_RECV_DECRYPT_SUCCESS) {
+            Authenticated = QuicConnRecvAuthenticated(Connection, Path, Packet);
+        } else {
+            if (Results[i] == QUIC_RECV_DECRYPT_FAILED) {
+                QuicConnRecvDecryptFailed(
+                    Connection,
+                    Packet,
+                    QuicConnRecvCanCheckForStatelessReset(Connection, Packet) ?
+                        ResetTokens + i * QUIC_STATELESS_RESET_TOKEN_LENGTH : NULL);
+            }
+            Authenticated = FALSE;
+        }
+
+        if (!Authenticated) {
             if (Connection->State.CompatibleVerNegotiationAttempted &&
                 !Connection->State.CompatibleVerNegotiationCompleted) {
                 //
@@ -6220,24 +6460,70 @@ QuicConnProcessKeepAliveOperation(
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicConnUpdatePeerPacketTolerance(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ uint8_t NewPacketTolerance
+QuicConnUpdatePeerAckFrequency(
+    _In_ QUIC_CONNECTION* Connection
     )
 {
-    if (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY &&
-        Connection->PeerPacketTolerance != NewPacketTolerance) {
-        QuicTraceLogConnInfo(
-            UpdatePeerPacketTolerance,
-            Connection,
-            "Updating peer packet tolerance to %hhu",
-            NewPacketTolerance);
-        Connection->SendAckFreqSeqNum++;
-        Connection->PeerPacketTolerance = NewPacketTolerance;
+    if (!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY)) {
+        return;
+    }
+
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    uint32_t NewPacketTolerance = Connection->PeerMinPacketTolerance;
+    uint32_t NewAckDelayUs = Connection->PeerAckDelayUs;
+
+    if (Path->GotFirstRttSample) {
+        //
+        // Ask the peer for about QUIC_ACK_FREQUENCY_ACKS_PER_RTT ACKs per round
+        // trip: one per that fraction of the congestion window's packets, or
+        // of the RTT if fewer are in flight. The delay is only changed when
+        // it's off by more than a quarter, so that small changes in the RTT
+        // don't each need a new ACK_FREQUENCY frame.
+        //
+        NewPacketTolerance =
+            QuicConnCalculatePeerPacketTolerance(
+                QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl),
+                QuicPathGetDatagramPayloadSize(Path),
+                Connection->PeerMinPacketTolerance);
+
+        const uint32_t AckDelayUs =
+            QuicConnCalculatePeerAckDelay(
+                Path->SmoothedRtt,
+                MS_TO_US(Connection->PeerTransportParams.MaxAckDelay),
+                Connection->PeerTransportParams.MinAckDelay);
+        if ((uint64_t)AckDelayUs > (uint64_t)NewAckDelayUs + NewAckDelayUs / 4 ||
+            AckDelayUs < NewAckDelayUs - NewAckDelayUs / 4) {
+            NewAckDelayUs = AckDelayUs;
+        }
+    }
+
+    if (Connection->PeerPacketTolerance == NewPacketTolerance &&
+        Connection->PeerAckDelayUs == NewAckDelayUs) {
+        return;
+    }
+
+    if (NewPacketTolerance < Connection->PeerPacketTolerance) {
+        //
+        // The congestion window shrank, so get the peer to acknowledge what
+        // it already has right away instead of waiting for more packets.
+        //
         QuicSendSetSendFlag(
             &Connection->Send,
-            QUIC_CONN_SEND_FLAG_ACK_FREQUENCY);
+            QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK);
     }
+
+    QuicTraceLogConnInfo(
+        UpdatePeerPacketTolerance,
+        Connection,
+        "Updating peer packet tolerance to %hhu and max ACK delay to %u us",
+        (uint8_t)NewPacketTolerance,
+        NewAckDelayUs);
+    Connection->SendAckFreqSeqNum++;
+    Connection->PeerPacketTolerance = (uint8_t)NewPacketTolerance;
+    Connection->PeerAckDelayUs = NewAckDelayUs;
+    QuicSendSetSendFlag(
+        &Connection->Send,
+        QUIC_CONN_SEND_FLAG_ACK_FREQUENCY);
 }
 
 #define QUIC_CONN_BAD_START_STATE(CONN) (CONN->State.Started || CONN->State.ClosedLocally)
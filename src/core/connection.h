@@ -8,6 +8,10 @@
 #include "connection.h.clog.h"
 #endif
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_LISTENER QUIC_LISTENER;
 
 //
@@ -442,6 +446,13 @@ typedef struct QUIC_CONNECTION {
     BOOLEAN HasQueuedWork : 1;
     BOOLEAN HasPriorityWork : 1;
 
+    //
+    // Indicates the connection is moving to a new worker and isn't on either
+    // worker's queue until the new one takes it.
+    // N.B. Multi-threaded access, synchronized by worker's connection lock.
+    //
+    BOOLEAN WorkerMigrating : 1;
+
     //
     // Set of current reasons sending more packets is currently blocked.
     //
@@ -481,6 +492,12 @@ typedef struct QUIC_CONNECTION {
     //
     uint8_t PeerReorderingThreshold;
 
+    //
+    // The smallest packet tolerance we want the peer to use, raised when sends
+    // are scheduling limited so the peer doesn't acknowledge each batch.
+    //
+    uint8_t PeerMinPacketTolerance;
+
     //
     // DSCP value to set on all sends from this connection.
     // Default value of 0.
@@ -497,6 +514,13 @@ typedef struct QUIC_CONNECTION {
     //
     uint64_t NextRecvAckFreqSeqNum;
 
+    //
+    // The max ACK delay (in microseconds) we want the peer to use, or 0 to
+    // use our own. Requires the ACK_FREQUENCY extension/frame to be able to
+    // send to the peer.
+    //
+    uint32_t PeerAckDelayUs;
+
     //
     // The sequence number to use for the next source CID.
     //
@@ -543,6 +567,13 @@ typedef struct QUIC_CONNECTION {
     //
     uint64_t ExpirationTimes[QUIC_CONN_TIMER_COUNT];
 
+    //
+    // The actual deadline (absolute time in us) of each coarse timer, which
+    // may be later than the expiration time it's armed with in the timer
+    // wheel. UINT64_MAX if not set.
+    //
+    uint64_t CoarseDeadlines[QUIC_CONN_TIMER_COARSE_COUNT];
+
     //
     // Earliest expiration time of all timers types.
     //
@@ -601,6 +632,12 @@ typedef struct QUIC_CONNECTION {
     //
     QUIC_REMOTE_HASH_ENTRY* RemoteHashEntry;
 
+    //
+    // Backs the small allocations that don't outlive the connection, such as
+    // its CIDs.
+    //
+    QUIC_CONN_ARENA Arena;
+
     //
     // Transport parameters received from the peer.
     //
@@ -1644,13 +1681,69 @@ QuicConnQueueRouteCompletion(
     );
 
 //
-// Queues up an update to the packet tolerance we want the peer to use.
+// Calculates the packet tolerance we want the peer to use, so that it sends
+// about QUIC_ACK_FREQUENCY_ACKS_PER_RTT ACKs per congestion window. It's capped
+// at QUIC_MAX_PEER_PACKET_TOLERANCE and rounded down to a power of 2, so that
+// small changes in the congestion window don't each need a new ACK_FREQUENCY
+// frame, but is never below MinPacketTolerance.
+//
+QUIC_INLINE
+uint8_t
+QuicConnCalculatePeerPacketTolerance(
+    _In_ uint32_t CongestionWindow,
+    _In_ uint16_t DatagramPayloadSize,
+    _In_ uint8_t MinPacketTolerance
+    )
+{
+    uint32_t PacketTolerance =
+        CongestionWindow /
+        ((uint32_t)DatagramPayloadSize * QUIC_ACK_FREQUENCY_ACKS_PER_RTT);
+    if (PacketTolerance > QUIC_MAX_PEER_PACKET_TOLERANCE) {
+        PacketTolerance = QUIC_MAX_PEER_PACKET_TOLERANCE;
+    }
+    while (PacketTolerance & (PacketTolerance - 1)) {
+        PacketTolerance &= PacketTolerance - 1;
+    }
+    if (PacketTolerance < MinPacketTolerance) {
+        PacketTolerance = MinPacketTolerance;
+    }
+    return (uint8_t)PacketTolerance;
+}
+
+//
+// Calculates the max ACK delay (in microseconds) we want the peer to use, so
+// that it still sends about QUIC_ACK_FREQUENCY_ACKS_PER_RTT ACKs per RTT when
+// fewer packets are in flight. The peer's max_ack_delay is the most we ask
+// for, since that's the delay the PTO accounts for, and its min_ack_delay the
+// least.
+//
+QUIC_INLINE
+uint32_t
+QuicConnCalculatePeerAckDelay(
+    _In_ uint64_t SmoothedRtt,
+    _In_ uint64_t PeerMaxAckDelayUs,
+    _In_ uint64_t PeerMinAckDelayUs
+    )
+{
+    uint64_t AckDelayUs = SmoothedRtt / QUIC_ACK_FREQUENCY_ACKS_PER_RTT;
+    if (AckDelayUs > PeerMaxAckDelayUs) {
+        AckDelayUs = PeerMaxAckDelayUs;
+    }
+    if (AckDelayUs < PeerMinAckDelayUs) {
+        AckDelayUs = PeerMinAckDelayUs;
+    }
+    return (uint32_t)AckDelayUs;
+}
+
+//
+// Recalculates the packet tolerance and max ACK delay we want the peer to use
+// from the congestion window and RTT, and queues up an ACK_FREQUENCY frame if
+// they changed.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicConnUpdatePeerPacketTolerance(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ uint8_t NewPacketTolerance
+QuicConnUpdatePeerAckFrequency(
+    _In_ QUIC_CONNECTION* Connection
     );
 
 //
@@ -1740,3 +1833,7 @@ QuicMtuDiscoveryCheckSearchCompleteTimeout(
         }
     }
 }
+
+#if defined(__cplusplus)
+}
+#endif
@@ -246,7 +246,10 @@ QuicCryptoUninitialize(
     if (Crypto->TlsState.NegotiatedAlpn != NULL &&
         QuicConnIsServer(QuicCryptoGetConnection(Crypto))) {
         if (Crypto->TlsState.NegotiatedAlpn != Crypto->TlsState.SmallAlpnBuffer) {
-            CXPLAT_FREE(Crypto->TlsState.NegotiatedAlpn, QUIC_POOL_ALPN);
+            QuicConnArenaFree(
+                &QuicCryptoGetConnection(Crypto)->Arena,
+                Crypto->TlsState.NegotiatedAlpn,
+                QUIC_POOL_ALPN);
         }
         Crypto->TlsState.NegotiatedAlpn = NULL;
     }
@@ -1633,7 +1636,7 @@ QuicCryptoProcessTlsCompletion(
                 Connection,
                 InitialSourceCid->CID.SequenceNumber,
                 CASTED_CLOG_BYTEARRAY(InitialSourceCid->CID.Length, InitialSourceCid->CID.Data));
-            CXPLAT_FREE(InitialSourceCid, QUIC_POOL_CIDHASH);
+            QuicConnArenaFree(&Connection->Arena, InitialSourceCid, QUIC_POOL_CIDHASH);
         }
 
         //
@@ -3138,10 +3141,13 @@ QuicCryptoReNegotiateAlpn(
     }
 
     //
-    // Free current ALPN buffer if it's allocated on heap.
+    // Free current ALPN buffer if it's not the small, inline buffer.
     //
     if (Connection->Crypto.TlsState.NegotiatedAlpn != Connection->Crypto.TlsState.SmallAlpnBuffer) {
-        CXPLAT_FREE(Connection->Crypto.TlsState.NegotiatedAlpn, QUIC_POOL_ALPN);
+        QuicConnArenaFree(
+            &Connection->Arena,
+            Connection->Crypto.TlsState.NegotiatedAlpn,
+            QUIC_POOL_ALPN);
         Connection->Crypto.TlsState.NegotiatedAlpn = NULL;
     }
 
@@ -3150,7 +3156,11 @@ QuicCryptoReNegotiateAlpn(
     if (NegotiatedAlpnLength < TLS_SMALL_ALPN_BUFFER_SIZE) {
         NegotiatedAlpn = Connection->Crypto.TlsState.SmallAlpnBuffer;
     } else {
-        NegotiatedAlpn = CXPLAT_ALLOC_NONPAGED(NegotiatedAlpnLength + sizeof(uint8_t), QUIC_POOL_ALPN);
+        NegotiatedAlpn =
+            QuicConnArenaAlloc(
+                &Connection->Arena,
+                NegotiatedAlpnLength + sizeof(uint8_t),
+                QUIC_POOL_ALPN);
         if (NegotiatedAlpn == NULL) {
             QuicTraceEvent(
                 AllocFailure,
@@ -281,6 +281,52 @@ QuicLibrarySumPerfCounters(
         }
     }
 
+    //
+    // The pool counters are tracked by the pools themselves.
+    //
+    for (uint32_t ProcIndex = 0; ProcIndex < MsQuicLib.PartitionCount; ++ProcIndex) {
+        CXPLAT_POOL_STATISTICS Stats;
+        QuicPartitionGetPoolStatistics(&MsQuicLib.Partitions[ProcIndex], &Stats);
+        if (QUIC_PERF_COUNTER_POOL_ALLOC_HITS < CountersPerBuffer) {
+            Counters[QUIC_PERF_COUNTER_POOL_ALLOC_HITS] += (int64_t)Stats.AllocHitCount;
+        }
+        if (QUIC_PERF_COUNTER_POOL_ALLOC_MISSES < CountersPerBuffer) {
+            Counters[QUIC_PERF_COUNTER_POOL_ALLOC_MISSES] += (int64_t)Stats.AllocMissCount;
+        }
+    }
+
+#ifndef _KERNEL_MODE
+    //
+    // The event queue and zero-copy send counters are tracked by the platform
+    // worker pool, not the partitions, so add them in separately.
+    //
+    if (MsQuicLib.WorkerPool != NULL) {
+        const uint32_t WorkerCount = CxPlatWorkerPoolGetCount(MsQuicLib.WorkerPool);
+        for (uint32_t i = 0; i < WorkerCount; ++i) {
+            CXPLAT_WORKER_POOL_STATISTICS Stats;
+            CxPlatWorkerPoolGetStatistics(MsQuicLib.WorkerPool, i, &Stats);
+            if (QUIC_PERF_COUNTER_IO_RING_SUBMITS < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_IO_RING_SUBMITS] += (int64_t)Stats.EventQSubmitCount;
+            }
+            if (QUIC_PERF_COUNTER_IO_RING_WAKEUPS < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_IO_RING_WAKEUPS] += (int64_t)Stats.EventQWakeupCount;
+            }
+            if (QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS] += (int64_t)Stats.EventQRecvNoBufferCount;
+            }
+            if (QUIC_PERF_COUNTER_IO_RING_RECV_REARMS < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_IO_RING_RECV_REARMS] += (int64_t)Stats.EventQRecvRearmCount;
+            }
+            if (QUIC_PERF_COUNTER_SEND_ZERO_COPY < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_SEND_ZERO_COPY] += (int64_t)Stats.SendZeroCopyCount;
+            }
+            if (QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED < CountersPerBuffer) {
+                Counters[QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED] += (int64_t)Stats.SendZeroCopyCopiedCount;
+            }
+        }
+    }
+#endif
+
     //
     // Zero any counters that are still negative after summation.
     //
@@ -684,6 +730,7 @@ MsQuicLibraryLazyUninitialize(
 #endif
         CxPlatDataPathUninitialize(MsQuicLib.Datapath);
         MsQuicLib.Datapath = NULL;
+        MsQuicLib.PacingOffloadSupported = FALSE;
     }
 
 #if DEBUG
@@ -909,6 +956,8 @@ QuicLibraryLazyInitialize(
 
     CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
     InitConfig.EnableDscpOnRecv = MsQuicLib.EnableDscpOnRecv;
+    InitConfig.EnableZeroCopySend = MsQuicLib.EnableZeroCopySend;
+    InitConfig.EnablePacingOffload = MsQuicLib.EnablePacingOffload;
 
     Status =
         CxPlatDataPathInitialize(
@@ -923,6 +972,8 @@ QuicLibraryLazyInitialize(
             DataPathInitialized,
             "[data] Initialized, DatapathFeatures=%u",
             QuicLibraryGetDatapathFeatures());
+        MsQuicLib.PacingOffloadSupported =
+            !!(QuicLibraryGetDatapathFeatures() & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME);
         if (MsQuicLib.ExecutionConfig &&
             MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs != 0) {
             CxPlatDataPathUpdatePollingIdleTimeout(
@@ -1382,6 +1433,121 @@ QuicLibrarySetGlobalParam(
         break;
     }
 
+    case QUIC_PARAM_GLOBAL_DATAPATH_ZERO_COPY_SEND_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change the send mode after the datapath has been
+            // initialized.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnableZeroCopySend = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_PACING_OFFLOAD_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change the pacing mode after the datapath has
+            // been initialized.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnablePacingOffload = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_ENCODED_CIDS_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change the CID format once bindings may already
+            // have been created.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnableEncodedCids = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_CONN_ARENA_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Only applies to connections created from now on.
+        //
+        MsQuicLib.EnableConnArena = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_WORK_STEALING_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.EnableWorkStealing = *(BOOLEAN*)Buffer;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
     case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
 
         if (Buffer == NULL ||
@@ -2540,6 +2706,39 @@ QuicLibraryReleaseBinding(
     }
 }
 
+//
+// The maximum number of bindings reclaimed in one pass.
+//
+#define QUIC_LOOKUP_RECLAIM_BATCH_SIZE 16
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryReclaimLookups(
+    void
+    )
+{
+    QUIC_BINDING* Bindings[QUIC_LOOKUP_RECLAIM_BATCH_SIZE];
+    uint32_t BindingCount = 0;
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.DatapathLock);
+    for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Bindings.Flink;
+        Link != &MsQuicLib.Bindings && BindingCount < ARRAYSIZE(Bindings);
+        Link = Link->Flink) {
+
+        QUIC_BINDING* Binding = CXPLAT_CONTAINING_RECORD(Link, QUIC_BINDING, Link);
+        if (Binding->Lookup.RetiredCount != 0) {
+            Binding->RefCount++;
+            Bindings[BindingCount++] = Binding;
+        }
+    }
+    CxPlatDispatchLockRelease(&MsQuicLib.DatapathLock);
+
+    for (uint32_t i = 0; i < BindingCount; i++) {
+        QuicLookupReclaim(&Bindings[i]->Lookup);
+        QuicLibraryReleaseBinding(Bindings[i]);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicLibraryOnListenerRegistered(
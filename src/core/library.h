@@ -91,6 +91,38 @@ typedef struct QUIC_LIBRARY {
     //
     BOOLEAN EnableDscpOnRecv : 1;
 
+    //
+    // Whether the datapath will be initialized with zero-copy sends enabled.
+    //
+    BOOLEAN EnableZeroCopySend : 1;
+
+    //
+    // Whether the datapath will be initialized to pace sends in the kernel.
+    //
+    BOOLEAN EnablePacingOffload : 1;
+
+    //
+    // Whether the initialized datapath accepts send departure times, so that
+    // connections may queue up several pacing intervals per flush.
+    //
+    BOOLEAN PacingOffloadSupported : 1;
+
+    //
+    // Whether server CIDs encode a slot in the binding's lookup, so that they
+    // are routed to their connection without hashing.
+    //
+    BOOLEAN EnableEncodedCids : 1;
+
+    //
+    // Whether new connections allocate from a per-connection arena.
+    //
+    BOOLEAN EnableConnArena : 1;
+
+    //
+    // Whether idle workers take queued connections from loaded siblings.
+    //
+    BOOLEAN EnableWorkStealing : 1;
+
 #ifdef CxPlatVerifierEnabled
     //
     // The app or driver verifier is globally enabled.
@@ -218,6 +250,12 @@ typedef struct QUIC_LIBRARY {
     //
     CXPLAT_LIST_ENTRY Bindings;
 
+    //
+    // The number of lookups with retired objects still waiting to be freed.
+    // Workers periodically reclaim the bindings' lookups while non-zero.
+    //
+    long RetiringLookupCount;
+
     //
     // Contains all (server) connections currently not in an app's registration.
     //
@@ -458,6 +496,7 @@ _Success_(return != NULL)
 QUIC_CID_HASH_ENTRY*
 QuicCidNewRandomSource(
     _In_opt_ QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_CONN_ARENA* Arena,
     _In_reads_opt_(MsQuicLib.CidServerIdLength)
         const void* ServerID,
     _In_ uint16_t PartitionID,
@@ -472,7 +511,8 @@ QuicCidNewRandomSource(
 
     QUIC_CID_HASH_ENTRY* Entry =
         (QUIC_CID_HASH_ENTRY*)
-        CXPLAT_ALLOC_NONPAGED(
+        QuicConnArenaAlloc(
+            Arena,
             sizeof(QUIC_CID_HASH_ENTRY) +
             MsQuicLib.CidTotalLength,
             QUIC_POOL_CIDHASH);
@@ -500,6 +540,7 @@ QuicCidNewRandomSource(
         }
 
         CxPlatRandom(QUIC_CID_PAYLOAD_LENGTH - PrefixLength, Data);
+        Entry->CID.IsEncodable = PrefixLength == 0;
     }
 
     return Entry;
@@ -589,6 +630,16 @@ QuicLibraryReleaseBinding(
     _In_ QUIC_BINDING* Binding
     );
 
+//
+// Frees what the bindings' lookups retired, once no lock-free reader can still
+// be using it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryReclaimLookups(
+    void
+    );
+
 //
 // Called when a listener is created. Makes sure the library is ready to handle
 // incoming client handshakes.
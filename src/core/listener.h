@@ -69,6 +69,11 @@ typedef struct QUIC_LISTENER {
     //
     CXPLAT_LIST_ENTRY Link;
 
+    //
+    // The listener's entries in the binding's listener index, while registered.
+    //
+    QUIC_LISTENER_INDEX_ENTRY* IndexEntries;
+
     //
     // The top level registration.
     //
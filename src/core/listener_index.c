@@ -0,0 +1,291 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the index of listeners on a binding.
+
+--*/
+
+#include "precomp.h"
+
+QUIC_INLINE
+uint8_t
+QuicListenerIndexClass(
+    _In_ const QUIC_LISTENER* Listener
+    )
+{
+    if (QuicAddrGetFamily(&Listener->LocalAddress) == QUIC_ADDRESS_FAMILY_UNSPEC) {
+        return QUIC_LISTENER_INDEX_CLASS_UNSPEC;
+    }
+    return
+        Listener->WildCard ?
+            QUIC_LISTENER_INDEX_CLASS_WILDCARD : QUIC_LISTENER_INDEX_CLASS_SPECIFIC;
+}
+
+//
+// Hashes the parts of the key that are relevant for the class: the family for
+// wild cards, and the family and IP for specific addresses.
+//
+QUIC_INLINE
+uint32_t
+QuicListenerIndexHash(
+    _In_ uint8_t Class,
+    _In_ const QUIC_ADDR* Address,
+    _In_ uint8_t AlpnLength,
+    _In_reads_(AlpnLength)
+        const uint8_t* Alpn
+    )
+{
+    uint32_t Hash = AlpnLength == 0 ? 0 : CxPlatHashSimple(AlpnLength, Alpn);
+    Hash = (Hash * 31) + Class;
+    if (Class != QUIC_LISTENER_INDEX_CLASS_UNSPEC) {
+        const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Address);
+        Hash = (Hash * 31) + (uint32_t)Family;
+        if (Class == QUIC_LISTENER_INDEX_CLASS_SPECIFIC) {
+            if (Family == QUIC_ADDRESS_FAMILY_INET) {
+                Hash ^=
+                    CxPlatHashSimple(
+                        sizeof(Address->Ipv4.sin_addr),
+                        (const uint8_t*)&Address->Ipv4.sin_addr);
+            } else {
+                Hash ^=
+                    CxPlatHashSimple(
+                        sizeof(Address->Ipv6.sin6_addr),
+                        (const uint8_t*)&Address->Ipv6.sin6_addr);
+            }
+        }
+    }
+    return Hash;
+}
+
+QUIC_INLINE
+BOOLEAN
+QuicListenerIndexEntryMatches(
+    _In_ const QUIC_LISTENER_INDEX_ENTRY* Entry,
+    _In_ uint8_t Class,
+    _In_ const QUIC_ADDR* Address,
+    _In_ uint8_t AlpnLength,
+    _In_reads_(AlpnLength)
+        const uint8_t* Alpn
+    )
+{
+    if (Entry->Class != Class ||
+        Entry->AlpnLength != AlpnLength ||
+        (AlpnLength != 0 && memcmp(Entry->Alpn, Alpn, AlpnLength) != 0)) {
+        return FALSE;
+    }
+    if (Class == QUIC_LISTENER_INDEX_CLASS_UNSPEC) {
+        return TRUE;
+    }
+    const QUIC_ADDR* ListenerAddress = &Entry->Listener->LocalAddress;
+    if (QuicAddrGetFamily(ListenerAddress) != QuicAddrGetFamily(Address)) {
+        return FALSE;
+    }
+    return
+        Class == QUIC_LISTENER_INDEX_CLASS_WILDCARD ||
+        QuicAddrCompareIp(ListenerAddress, Address);
+}
+
+//
+// Returns the first listener (by class, then by registration order) with an
+// entry for the key, if it comes before 'Best'.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+const QUIC_LISTENER_INDEX_ENTRY*
+QuicListenerIndexLookup(
+    _In_ const QUIC_LISTENER_INDEX* Index,
+    _In_ uint8_t Class,
+    _In_ const QUIC_ADDR* Address,
+    _In_ uint8_t AlpnLength,
+    _In_reads_(AlpnLength)
+        const uint8_t* Alpn,
+    _In_opt_ const QUIC_LISTENER_INDEX_ENTRY* Best
+    )
+{
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE* Table = (CXPLAT_HASHTABLE*)&Index->Table;
+    CXPLAT_HASHTABLE_ENTRY* TableEntry =
+        CxPlatHashtableLookup(
+            Table,
+            QuicListenerIndexHash(Class, Address, AlpnLength, Alpn),
+            &Context);
+
+    while (TableEntry != NULL) {
+        const QUIC_LISTENER_INDEX_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_LISTENER_INDEX_ENTRY, Entry);
+        if (QuicListenerIndexEntryMatches(Entry, Class, Address, AlpnLength, Alpn) &&
+            (Best == NULL ||
+             Entry->Class < Best->Class ||
+             (Entry->Class == Best->Class && Entry->Sequence < Best->Sequence))) {
+            Best = Entry;
+        }
+        TableEntry = CxPlatHashtableLookupNext(Table, &Context);
+    }
+
+    return Best;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicListenerIndexInitialize(
+    _Out_ QUIC_LISTENER_INDEX* Index
+    )
+{
+    Index->NextSequence = 0;
+    CxPlatZeroMemory(Index->ClassCount, sizeof(Index->ClassCount));
+    return CxPlatHashtableInitializeEx(&Index->Table, CXPLAT_HASH_MIN_SIZE);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicListenerIndexUninitialize(
+    _In_ QUIC_LISTENER_INDEX* Index
+    )
+{
+    CXPLAT_DBG_ASSERT(Index->Table.NumEntries == 0);
+    CxPlatHashtableUninitialize(&Index->Table);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicListenerIndexInsert(
+    _Inout_ QUIC_LISTENER_INDEX* Index,
+    _In_ QUIC_LISTENER* Listener
+    )
+{
+    CXPLAT_DBG_ASSERT(Listener->IndexEntries == NULL);
+
+    uint32_t EntryCount = 1; // The address entry.
+    for (uint16_t Offset = 0;
+        Offset < Listener->AlpnListLength;
+        Offset += 1 + Listener->AlpnList[Offset]) {
+        EntryCount++;
+    }
+
+    QUIC_LISTENER_INDEX_ENTRY* Entries =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LISTENER_INDEX_ENTRY) * EntryCount,
+            QUIC_POOL_LISTENER);
+    if (Entries == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    const uint8_t Class = QuicListenerIndexClass(Listener);
+    const uint32_t Sequence = Index->NextSequence++;
+    Index->ClassCount[Class]++;
+    const uint8_t* Alpn = Listener->AlpnList;
+
+    for (uint32_t i = 0; i < EntryCount; ++i) {
+        QUIC_LISTENER_INDEX_ENTRY* Entry = &Entries[i];
+        Entry->Listener = Listener;
+        Entry->Sequence = Sequence;
+        Entry->Class = Class;
+        if (i == 0) {
+            Entry->AlpnLength = 0;
+            Entry->Alpn = NULL;
+        } else {
+            Entry->AlpnLength = Alpn[0];
+            Entry->Alpn = Alpn + 1;
+            Alpn += 1 + Alpn[0];
+        }
+        CxPlatHashtableInsert(
+            &Index->Table,
+            &Entry->Entry,
+            QuicListenerIndexHash(
+                Class,
+                &Listener->LocalAddress,
+                Entry->AlpnLength,
+                Entry->Alpn),
+            NULL);
+    }
+
+    Listener->IndexEntries = Entries;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicListenerIndexRemove(
+    _Inout_ QUIC_LISTENER_INDEX* Index,
+    _In_ QUIC_LISTENER* Listener
+    )
+{
+    QUIC_LISTENER_INDEX_ENTRY* Entries = Listener->IndexEntries;
+    CXPLAT_DBG_ASSERT(Entries != NULL);
+    CXPLAT_DBG_ASSERT(Index->ClassCount[Entries[0].Class] != 0);
+    Index->ClassCount[Entries[0].Class]--;
+
+    CxPlatHashtableRemove(&Index->Table, &Entries[0].Entry, NULL);
+    uint32_t i = 1;
+    for (uint16_t Offset = 0;
+        Offset < Listener->AlpnListLength;
+        Offset += 1 + Listener->AlpnList[Offset]) {
+        CxPlatHashtableRemove(&Index->Table, &Entries[i++].Entry, NULL);
+    }
+
+    CXPLAT_FREE(Entries, QUIC_POOL_LISTENER);
+    Listener->IndexEntries = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LISTENER*
+QuicListenerIndexFind(
+    _In_ const QUIC_LISTENER_INDEX* Index,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _In_ uint16_t ClientAlpnListLength,
+    _In_reads_(ClientAlpnListLength)
+        const uint8_t* ClientAlpnList,
+    _Out_ BOOLEAN* AddressMatched
+    )
+{
+    const QUIC_LISTENER_INDEX_ENTRY* Best = NULL;
+
+    while (ClientAlpnListLength != 0) {
+        const uint8_t AlpnLength = ClientAlpnList[0];
+        if (AlpnLength == 0 || (uint16_t)(AlpnLength + 1) > ClientAlpnListLength) {
+            break; // Malformed list.
+        }
+
+        //
+        // Classes after the best match so far can't win anymore.
+        //
+        const uint8_t LastClass =
+            Best == NULL ? QUIC_LISTENER_INDEX_CLASS_UNSPEC : Best->Class;
+        for (uint8_t Class = 0; Class <= LastClass; ++Class) {
+            if (Index->ClassCount[Class] == 0) {
+                continue;
+            }
+            Best =
+                QuicListenerIndexLookup(
+                    Index,
+                    Class,
+                    LocalAddress,
+                    AlpnLength,
+                    ClientAlpnList + 1,
+                    Best);
+        }
+
+        ClientAlpnListLength -= AlpnLength + 1;
+        ClientAlpnList += AlpnLength + 1;
+    }
+
+    if (Best != NULL) {
+        *AddressMatched = TRUE;
+        return Best->Listener;
+    }
+
+    *AddressMatched = FALSE;
+    for (uint8_t Class = 0; Class < QUIC_LISTENER_INDEX_CLASS_COUNT; ++Class) {
+        if (Index->ClassCount[Class] != 0 &&
+            QuicListenerIndexLookup(Index, Class, LocalAddress, 0, NULL, NULL) != NULL) {
+            *AddressMatched = TRUE;
+            break;
+        }
+    }
+
+    return NULL;
+}
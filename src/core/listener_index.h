@@ -0,0 +1,129 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Index of the listeners registered on a binding, used to find the listener
+    for a new connection without walking the whole (sorted) list of listeners.
+
+    Each listener is indexed once per ALPN, keyed by the ALPN and the address
+    it listens on: a specific IP of a family, the wild card IP of a family or
+    any family (unspecified). A new connection can then only match the entries
+    for the ALPNs offered by the client, with its local IP, the wild card of
+    its family or the unspecified family. Among those, the listener the list
+    walk would have found first wins: specific addresses before wild cards
+    before the unspecified family, and then the earliest registered.
+
+    Each listener also has an entry for its address alone (no ALPN), to tell
+    connections no listener matches by address from those no listener matches
+    by ALPN.
+
+    The index is protected by the binding's lock.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The address classes of listeners, in the order the binding's sorted list of
+// listeners matches them.
+//
+#define QUIC_LISTENER_INDEX_CLASS_SPECIFIC  0   // A specific IP of a family.
+#define QUIC_LISTENER_INDEX_CLASS_WILDCARD  1   // The wild card IP of a family.
+#define QUIC_LISTENER_INDEX_CLASS_UNSPEC    2   // Any family.
+#define QUIC_LISTENER_INDEX_CLASS_COUNT     3
+
+typedef struct QUIC_LISTENER_INDEX_ENTRY {
+
+    CXPLAT_HASHTABLE_ENTRY Entry;
+    QUIC_LISTENER* Listener;
+
+    //
+    // The listener's registration order in the index.
+    //
+    uint32_t Sequence;
+
+    //
+    // One of QUIC_LISTENER_INDEX_CLASS_*.
+    //
+    uint8_t Class;
+
+    //
+    // The ALPN, pointing into the listener's ALPN list. Zero length for the
+    // listener's address entry.
+    //
+    uint8_t AlpnLength;
+    const uint8_t* Alpn;
+
+} QUIC_LISTENER_INDEX_ENTRY;
+
+typedef struct QUIC_LISTENER_INDEX {
+
+    CXPLAT_HASHTABLE Table;
+
+    //
+    // Incremented for every listener inserted, to order the listeners in
+    // registration order.
+    //
+    uint32_t NextSequence;
+
+    //
+    // The number of listeners of each class, to skip the classes without any.
+    //
+    uint32_t ClassCount[QUIC_LISTENER_INDEX_CLASS_COUNT];
+
+} QUIC_LISTENER_INDEX;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicListenerIndexInitialize(
+    _Out_ QUIC_LISTENER_INDEX* Index
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicListenerIndexUninitialize(
+    _In_ QUIC_LISTENER_INDEX* Index
+    );
+
+//
+// Adds the listener, for all of its ALPNs. The listener's address and ALPNs
+// must not change until it's removed.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicListenerIndexInsert(
+    _Inout_ QUIC_LISTENER_INDEX* Index,
+    _In_ QUIC_LISTENER* Listener
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicListenerIndexRemove(
+    _Inout_ QUIC_LISTENER_INDEX* Index,
+    _In_ QUIC_LISTENER* Listener
+    );
+
+//
+// Returns the listener for a new connection to the local address, sharing
+// an ALPN with the client's ALPN list, or NULL. On failure, 'AddressMatched'
+// indicates whether any listener matched the address.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LISTENER*
+QuicListenerIndexFind(
+    _In_ const QUIC_LISTENER_INDEX* Index,
+    _In_ const QUIC_ADDR* LocalAddress,
+    _In_ uint16_t ClientAlpnListLength,
+    _In_reads_(ClientAlpnListLength)
+        const uint8_t* ClientAlpnList,
+    _Out_ BOOLEAN* AddressMatched
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -16,11 +16,45 @@ Abstract:
 
 typedef struct QUIC_CACHEALIGN QUIC_PARTITIONED_HASHTABLE {
 
-    CXPLAT_DISPATCH_RW_LOCK RwLock;
-    CXPLAT_HASHTABLE Table;
+    //
+    // The number of tables in the array this table is the first of. Lets
+    // lock-free readers use the array they loaded, even while it's being
+    // replaced.
+    //
+    uint16_t PartitionCount;
+    QUIC_CID_TABLE Table;
 
 } QUIC_PARTITIONED_HASHTABLE;
 
+typedef enum QUIC_LOOKUP_RETIRED_TYPE {
+
+    QUIC_LOOKUP_RETIRED_CONNECTION,     // A lookup table reference
+    QUIC_LOOKUP_RETIRED_CID_STORE,
+    QUIC_LOOKUP_RETIRED_SLOT_ARRAY,
+    QUIC_LOOKUP_RETIRED_HASH_TABLES,
+
+} QUIC_LOOKUP_RETIRED_TYPE;
+
+typedef struct QUIC_LOOKUP_RETIRED {
+
+    void* Object;
+
+    //
+    // The epoch the object was retired in.
+    //
+    long Epoch;
+
+    uint16_t Type; // QUIC_LOOKUP_RETIRED_TYPE
+
+    //
+    // The number of tables, for QUIC_LOOKUP_RETIRED_HASH_TABLES.
+    //
+    uint16_t PartitionCount;
+
+} QUIC_LOOKUP_RETIRED;
+
+#define QUIC_LOOKUP_RETIRED_INITIAL_CAPACITY 16
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicLookupInsertLocalCid(
@@ -30,6 +64,78 @@ QuicLookupInsertLocalCid(
     _In_ BOOLEAN UpdateRefCount
     );
 
+#ifndef _KERNEL_MODE
+
+//
+// Adds a lookup lock acquisition that had to wait, and the time it waited, to
+// the perf counters.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicLookupLockWaited(
+    _In_ uint64_t TimeStart
+    )
+{
+    QUIC_PARTITION* Partition = QuicLibraryGetCurrentPartition();
+    QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_LOOKUP_LOCK_WAITS);
+    QuicPerfCounterAdd(
+        Partition,
+        QUIC_PERF_COUNTER_LOOKUP_LOCK_WAIT_US,
+        (int64_t)CxPlatTimeDiff64(TimeStart, CxPlatTimeUs64()));
+}
+
+//
+// Acquires a lookup lock, only timing the acquisition if the lock is
+// contended.
+//
+#define QuicLookupLockAcquireShared(Lock, PrevIrql) \
+    do { \
+        if (!CxPlatDispatchRwLockTryAcquireShared(Lock, PrevIrql)) { \
+            const uint64_t TimeStart = CxPlatTimeUs64(); \
+            CxPlatDispatchRwLockAcquireShared(Lock, PrevIrql); \
+            QuicLookupLockWaited(TimeStart); \
+        } \
+    } while (0)
+
+#define QuicLookupLockAcquireExclusive(Lock, PrevIrql) \
+    do { \
+        if (!CxPlatDispatchRwLockTryAcquireExclusive(Lock, PrevIrql)) { \
+            const uint64_t TimeStart = CxPlatTimeUs64(); \
+            CxPlatDispatchRwLockAcquireExclusive(Lock, PrevIrql); \
+            QuicLookupLockWaited(TimeStart); \
+        } \
+    } while (0)
+
+#else
+
+//
+// Waits aren't counted in kernel mode, where the dispatch locks are spin locks
+// acquired at DISPATCH_LEVEL.
+//
+#define QuicLookupLockAcquireShared(Lock, PrevIrql) \
+    CxPlatDispatchRwLockAcquireShared(Lock, PrevIrql)
+
+#define QuicLookupLockAcquireExclusive(Lock, PrevIrql) \
+    CxPlatDispatchRwLockAcquireExclusive(Lock, PrevIrql)
+
+#endif
+
+//
+// Returns the remote hash shard for the hash. Uses the high bits of the hash,
+// as the shard's hash table buckets use the low bits.
+//
+QUIC_INLINE
+QUIC_REMOTE_HASH_SHARD*
+QuicLookupGetRemoteHashShard(
+    _In_ QUIC_REMOTE_HASH_SHARD* Shards,
+    _In_ uint16_t ShardCount,
+    _In_ uint32_t Hash
+    )
+{
+    return &Shards[((Hash >> 16) * ShardCount) >> 16];
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLookupInitialize(
@@ -38,6 +144,214 @@ QuicLookupInitialize(
 {
     CxPlatZeroMemory(Lookup, sizeof(QUIC_LOOKUP));
     CxPlatDispatchRwLockInitialize(&Lookup->RwLock);
+    QuicCidSlotTableInitialize(&Lookup->Slots);
+}
+
+//
+// Frees a partitioned hash table array. No readers may still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFreeHashTable(
+    _In_ QUIC_PARTITIONED_HASHTABLE* Tables,
+    _In_ uint16_t PartitionCount
+    )
+{
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        QuicCidTableUninitialize(&Tables[i].Table);
+    }
+    CXPLAT_FREE(Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFreeRemoteHashShards(
+    _In_ QUIC_REMOTE_HASH_SHARD* Shards,
+    _In_ uint16_t ShardCount
+    )
+{
+    for (uint16_t i = 0; i < ShardCount; i++) {
+        CXPLAT_DBG_ASSERT(Shards[i].Table.NumEntries == 0);
+        CxPlatHashtableUninitialize(&Shards[i].Table);
+        CxPlatDispatchRwLockUninitialize(&Shards[i].RwLock);
+    }
+    CXPLAT_FREE(Shards, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+//
+// Allocates one remote hash shard per partition.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_REMOTE_HASH_SHARD*
+QuicLookupAllocRemoteHashShards(
+    _In_ uint16_t ShardCount
+    )
+{
+    QUIC_REMOTE_HASH_SHARD* Shards =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_REMOTE_HASH_SHARD) * ShardCount,
+            QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Shards == NULL) {
+        return NULL;
+    }
+
+    uint16_t i;
+    for (i = 0; i < ShardCount; i++) {
+        if (!CxPlatHashtableInitializeEx(&Shards[i].Table, CXPLAT_HASH_MIN_SIZE)) {
+            break;
+        }
+        CxPlatDispatchRwLockInitialize(&Shards[i].RwLock);
+    }
+
+    if (i != ShardCount) {
+        QuicLookupFreeRemoteHashShards(Shards, i);
+        return NULL;
+    }
+
+    return Shards;
+}
+
+//
+// Frees a retired object. No readers may still be accessing it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFreeRetired(
+    _In_ const QUIC_LOOKUP_RETIRED* Retired
+    )
+{
+    switch (Retired->Type) {
+    case QUIC_LOOKUP_RETIRED_CONNECTION:
+        QuicConnRelease((QUIC_CONNECTION*)Retired->Object, QUIC_CONN_REF_LOOKUP_RESULT);
+        break;
+    case QUIC_LOOKUP_RETIRED_CID_STORE:
+        QuicCidTableFreeStore((QUIC_CID_TABLE_STORE*)Retired->Object);
+        break;
+    case QUIC_LOOKUP_RETIRED_SLOT_ARRAY:
+        QuicCidSlotTableFreeArray((QUIC_CID_SLOT_ARRAY*)Retired->Object);
+        break;
+    default:
+        QuicLookupFreeHashTable(
+            (QUIC_PARTITIONED_HASHTABLE*)Retired->Object, Retired->PartitionCount);
+        break;
+    }
+}
+
+//
+// Queues an object removed from the tables to be freed once no lock-free
+// reader can still be accessing it. Requires the RwLock to be held
+// exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupRetire(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_LOOKUP_RETIRED_TYPE Type,
+    _In_ void* Object,
+    _In_ uint16_t PartitionCount
+    )
+{
+    if (Type == QUIC_LOOKUP_RETIRED_CONNECTION) {
+        //
+        // The reference is held on as a lookup result instead, so that the
+        // connection is handed to its worker to be freed, if it turns out to
+        // be the last one.
+        //
+        QuicConnAddRef((QUIC_CONNECTION*)Object, QUIC_CONN_REF_LOOKUP_RESULT);
+        QuicConnRelease((QUIC_CONNECTION*)Object, QUIC_CONN_REF_LOOKUP_TABLE);
+    }
+
+    QUIC_LOOKUP_RETIRED Retired = {
+        Object, QuicCidEpochCurrent(&Lookup->Epoch), (uint16_t)Type, PartitionCount
+    };
+
+    if (Lookup->RetiredCount == Lookup->RetiredCapacity) {
+        const uint32_t NewCapacity =
+            Lookup->RetiredCapacity == 0 ?
+                QUIC_LOOKUP_RETIRED_INITIAL_CAPACITY : Lookup->RetiredCapacity * 2;
+        QUIC_LOOKUP_RETIRED* NewRetired =
+            CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_LOOKUP_RETIRED) * NewCapacity,
+                QUIC_POOL_LOOKUP_HASHTABLE);
+        if (NewRetired == NULL) {
+            //
+            // Out of memory, so wait for the readers right away instead.
+            //
+            QuicCidEpochSynchronize(&Lookup->Epoch);
+            QuicLookupFreeRetired(&Retired);
+            return;
+        }
+        if (Lookup->Retired != NULL) {
+            CxPlatCopyMemory(
+                NewRetired,
+                Lookup->Retired,
+                sizeof(QUIC_LOOKUP_RETIRED) * Lookup->RetiredCount);
+            CXPLAT_FREE(Lookup->Retired, QUIC_POOL_LOOKUP_HASHTABLE);
+        }
+        Lookup->Retired = NewRetired;
+        Lookup->RetiredCapacity = NewCapacity;
+    }
+
+    if (Lookup->RetiredCount == 0) {
+        InterlockedIncrement(&MsQuicLib.RetiringLookupCount);
+    }
+    Lookup->Retired[Lookup->RetiredCount++] = Retired;
+}
+
+//
+// Frees the retired objects no reader can still be accessing, without waiting
+// for any reader. Requires the RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupReclaimInt(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    if (Lookup->RetiredCount == 0) {
+        return;
+    }
+
+    //
+    // Readers that might have seen an object retired in some epoch have all
+    // left once the epoch has advanced twice since.
+    //
+    long Current = QuicReadAcquire(&Lookup->Epoch.Epoch);
+    while (Current - Lookup->Retired[0].Epoch < 2 &&
+           QuicCidEpochTryAdvance(&Lookup->Epoch)) {
+        Current++;
+    }
+
+    uint32_t Count = 0;
+    while (Count < Lookup->RetiredCount &&
+           Current - Lookup->Retired[Count].Epoch >= 2) {
+        QuicLookupFreeRetired(&Lookup->Retired[Count++]);
+    }
+
+    if (Count == 0) {
+        return;
+    }
+
+    Lookup->RetiredCount -= Count;
+    if (Lookup->RetiredCount == 0) {
+        InterlockedDecrement(&MsQuicLib.RetiringLookupCount);
+    } else {
+        CxPlatMoveMemory(
+            Lookup->Retired,
+            Lookup->Retired + Count,
+            sizeof(QUIC_LOOKUP_RETIRED) * Lookup->RetiredCount);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupReclaim(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    QuicLookupLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupReclaimInt(Lookup);
+    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -48,72 +362,136 @@ QuicLookupUninitialize(
 {
     CXPLAT_DBG_ASSERT(Lookup->CidCount == 0);
 
+    if (Lookup->RetiredCount != 0) {
+        //
+        // The binding is going away, so there are no new readers, and only the
+        // ones still leaving have to be waited for.
+        //
+        QuicCidEpochSynchronize(&Lookup->Epoch);
+        for (uint32_t i = 0; i < Lookup->RetiredCount; i++) {
+            QuicLookupFreeRetired(&Lookup->Retired[i]);
+        }
+        Lookup->RetiredCount = 0;
+        InterlockedDecrement(&MsQuicLib.RetiringLookupCount);
+    }
+    if (Lookup->Retired != NULL) {
+        CXPLAT_FREE(Lookup->Retired, QUIC_POOL_LOOKUP_HASHTABLE);
+    }
+
     if (Lookup->PartitionCount == 0) {
         CXPLAT_DBG_ASSERT(Lookup->SINGLE.Connection == NULL);
     } else {
         CXPLAT_DBG_ASSERT(Lookup->HASH.Tables != NULL);
+#if DEBUG
         for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
-            QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[i];
-            CXPLAT_DBG_ASSERT(Table->Table.NumEntries == 0);
-#pragma warning(push)
-#pragma warning(disable:6001)
-            CxPlatHashtableUninitialize(&Table->Table);
-#pragma warning(pop)
-            CxPlatDispatchRwLockUninitialize(&Table->RwLock);
+            CXPLAT_DBG_ASSERT(Lookup->HASH.Tables[i].Table.Count == 0);
         }
-        CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
+#endif
+        QuicLookupFreeHashTable(Lookup->HASH.Tables, Lookup->PartitionCount);
     }
 
-    if (Lookup->MaximizePartitioning) {
-        CXPLAT_DBG_ASSERT(Lookup->RemoteHashTable.NumEntries == 0);
-        CxPlatHashtableUninitialize(&Lookup->RemoteHashTable);
+    QuicCidSlotTableUninitialize(&Lookup->Slots);
+
+    if (Lookup->Epoch.Readers != NULL) {
+        QuicCidEpochUninitialize(&Lookup->Epoch);
+    }
+
+    if (Lookup->RemoteHashShards != NULL) {
+        QuicLookupFreeRemoteHashShards(
+            Lookup->RemoteHashShards, Lookup->RemoteHashShardCount);
     }
 
     CxPlatDispatchRwLockUninitialize(&Lookup->RwLock);
 }
 
 //
-// Allocates and initializes a new partitioned hash table.
+// Allocates and initializes a new partitioned hash table, sized for
+// 'CidCount' CIDs in total.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
+QUIC_PARTITIONED_HASHTABLE*
 QuicLookupCreateHashTable(
-    _In_ QUIC_LOOKUP* Lookup,
-    _In_range_(>, 0) uint16_t PartitionCount
+    _In_range_(>, 0) uint16_t PartitionCount,
+    _In_ uint32_t CidCount
     )
 {
-    CXPLAT_DBG_ASSERT(Lookup->LookupTable == NULL);
     CXPLAT_FRE_ASSERT(PartitionCount > 0);
 
-    Lookup->HASH.Tables =
+    QUIC_PARTITIONED_HASHTABLE* Tables =
         CXPLAT_ALLOC_NONPAGED(
             sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount,
             QUIC_POOL_LOOKUP_HASHTABLE);
 
-    if (Lookup->HASH.Tables != NULL) {
-
-        uint16_t Cleanup = 0;
-        uint8_t Failed = FALSE;
+    if (Tables != NULL) {
         for (uint16_t i = 0; i < PartitionCount; i++) {
-            if (!CxPlatHashtableInitializeEx(&Lookup->HASH.Tables[i].Table, CXPLAT_HASH_MIN_SIZE)) {
-                Cleanup = i;
-                Failed = TRUE;
+            Tables[i].PartitionCount = PartitionCount;
+            if (!QuicCidTableInitialize(&Tables[i].Table, CidCount / PartitionCount)) {
+                QuicLookupFreeHashTable(Tables, i);
+                Tables = NULL;
                 break;
             }
-            CxPlatDispatchRwLockInitialize(&Lookup->HASH.Tables[i].RwLock);
         }
-        if (Failed) {
-            for (uint16_t i = 0; i < Cleanup; i++) {
-                CxPlatHashtableUninitialize(&Lookup->HASH.Tables[i].Table);
-            }
-            CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
-            Lookup->HASH.Tables = NULL;
+    }
+
+    return Tables;
+}
+
+//
+// Returns the partition the CID belongs to.
+//
+QUIC_INLINE
+uint16_t
+QuicLookupPartitionIndex(
+    _In_reads_(QUIC_CID_PID_LENGTH + MsQuicLib.CidServerIdLength)
+        const uint8_t* const CID,
+    _In_ uint16_t PartitionCount
+    )
+{
+    CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
+    uint16_t PartitionIndex;
+    CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
+    PartitionIndex &= MsQuicLib.PartitionMask;
+    PartitionIndex %= PartitionCount;
+    return PartitionIndex;
+}
+
+//
+// Inserts a CID into the partitioned hash table. If the table has already
+// been published to readers, waits for them before freeing any storage the
+// insert replaced. Requires the RwLock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupInsertIntoHashTable(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_PARTITIONED_HASHTABLE* Tables,
+    _In_ BOOLEAN Published,
+    _In_reads_(Length)
+        const uint8_t* const CID,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
+
+    QUIC_CID_TABLE* Table =
+        &Tables[QuicLookupPartitionIndex(CID, Tables->PartitionCount)].Table;
+
+    QUIC_CID_TABLE_STORE* RetiredStore;
+    if (!QuicCidTableInsert(Table, CID, Length, Hash, Connection, &RetiredStore)) {
+        return FALSE;
+    }
+
+    if (RetiredStore != NULL) {
+        if (Published) {
+            QuicLookupRetire(Lookup, QUIC_LOOKUP_RETIRED_CID_STORE, RetiredStore, 0);
         } else {
-            Lookup->PartitionCount = PartitionCount;
+            QuicCidTableFreeStore(RetiredStore);
         }
     }
 
-    return Lookup->HASH.Tables != NULL;
+    return TRUE;
 }
 
 //
@@ -154,19 +532,27 @@ QuicLookupRebalance(
 
         uint16_t PreviousPartitionCount = Lookup->PartitionCount;
         void* PreviousLookup = Lookup->LookupTable;
-        Lookup->LookupTable = NULL;
 
         CXPLAT_DBG_ASSERT(PartitionCount != 0);
 
-        if (!QuicLookupCreateHashTable(Lookup, PartitionCount)) {
-            Lookup->LookupTable = PreviousLookup;
+        if (Lookup->Epoch.Readers == NULL &&
+            !QuicCidEpochInitialize(&Lookup->Epoch)) {
             return FALSE;
         }
 
         //
-        // Move the CIDs to the new table.
+        // The new tables are fully built before readers are switched over to
+        // them, since readers of the previous tables don't take the lock.
         //
 
+        QUIC_PARTITIONED_HASHTABLE* Tables =
+            QuicLookupCreateHashTable(PartitionCount, Lookup->CidCount);
+        if (Tables == NULL) {
+            return FALSE;
+        }
+
+        BOOLEAN Success = TRUE;
+
         if (PreviousPartitionCount == 0) {
 
             //
@@ -178,17 +564,23 @@ QuicLookupRebalance(
                 CXPLAT_SLIST_ENTRY* Entry =
                     ((QUIC_CONNECTION*)PreviousLookup)->SourceCids.Next;
 
-                while (Entry != NULL) {
+                while (Success && Entry != NULL) {
                     QUIC_CID_HASH_ENTRY *CID =
                         CXPLAT_CONTAINING_RECORD(
                             Entry,
                             QUIC_CID_HASH_ENTRY,
                             Link);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
+                    if (CID->CID.IsInLookupTable) {
+                        Success =
+                            QuicLookupInsertIntoHashTable(
+                                Lookup,
+                                Tables,
+                                FALSE,
+                                CID->CID.Data,
+                                CID->CID.Length,
+                                CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
+                                CID->Connection);
+                    }
                     Entry = Entry->Next;
                 }
             }
@@ -196,43 +588,48 @@ QuicLookupRebalance(
         } else {
 
             //
-            // Changes the number of partitioned tables. Remove all the CIDs
-            // from the old tables and insert them into the new tables.
+            // Changes the number of partitioned tables. Copy all the CIDs
+            // from the old tables into the new tables.
             //
 
             QUIC_PARTITIONED_HASHTABLE* PreviousTable = PreviousLookup;
-            for (uint16_t i = 0; i < PreviousPartitionCount; i++) {
-                CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableEnumerateBegin(&PreviousTable[i].Table, &Enumerator);
-#pragma warning(pop)
-                while (TRUE) {
-                    CXPLAT_HASHTABLE_ENTRY* Entry =
-                        CxPlatHashtableEnumerateNext(&PreviousTable[i].Table, &Enumerator);
-                    if (Entry == NULL) {
-                        CxPlatHashtableEnumerateEnd(&PreviousTable[i].Table, &Enumerator);
-                        break;
-                    }
-                    CxPlatHashtableRemove(&PreviousTable[i].Table, Entry, NULL);
-
-                    QUIC_CID_HASH_ENTRY *CID =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Entry);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
+            for (uint16_t i = 0; Success && i < PreviousPartitionCount; i++) {
+                uint32_t Index = 0;
+                const QUIC_CID_TABLE_SLOT* Slot;
+                while (Success &&
+                    (Slot = QuicCidTableEnumerateNext(&PreviousTable[i].Table, &Index)) != NULL) {
+                    Success =
+                        QuicLookupInsertIntoHashTable(
+                            Lookup,
+                            Tables,
+                            FALSE,
+                            Slot->Data,
+                            Slot->Length,
+                            CxPlatHashSimple(Slot->Length, Slot->Data),
+                            Slot->Connection);
                 }
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableUninitialize(&PreviousTable[i].Table);
-#pragma warning(pop)
             }
-            CXPLAT_FREE(PreviousTable, QUIC_POOL_LOOKUP_HASHTABLE);
+        }
+
+        if (!Success) {
+            QuicLookupFreeHashTable(Tables, PartitionCount);
+            return FALSE;
+        }
+
+        //
+        // Publish the new tables. The table pointer must be visible before the
+        // partition count, as readers only look at the tables once they see a
+        // non-zero count.
+        //
+        QuicWritePtrRelease(&Lookup->HASH.Tables, Tables);
+        QuicWriteRelease16(&Lookup->PartitionCount, PartitionCount);
+
+        if (PreviousPartitionCount != 0) {
+            QuicLookupRetire(
+                Lookup,
+                QUIC_LOOKUP_RETIRED_HASH_TABLES,
+                PreviousLookup,
+                PreviousPartitionCount);
         }
     }
 
@@ -247,17 +644,24 @@ QuicLookupMaximizePartitioning(
 {
     BOOLEAN Result = TRUE;
 
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
 
     if (!Lookup->MaximizePartitioning) {
-        Result =
-            CxPlatHashtableInitializeEx(
-                &Lookup->RemoteHashTable, CXPLAT_HASH_MIN_SIZE);
-        if (Result) {
+        const uint16_t ShardCount = MsQuicLib.PartitionCount;
+        QUIC_REMOTE_HASH_SHARD* Shards = QuicLookupAllocRemoteHashShards(ShardCount);
+        if (Shards == NULL) {
+            Result = FALSE;
+        } else {
             Lookup->MaximizePartitioning = TRUE;
             Result = QuicLookupRebalance(Lookup, NULL);
-            if (!Result) {
-                CxPlatHashtableUninitialize(&Lookup->RemoteHashTable);
+            if (Result) {
+                //
+                // Publish the shards to readers that don't take the lock.
+                //
+                Lookup->RemoteHashShardCount = ShardCount;
+                QuicWritePtrRelease(&Lookup->RemoteHashShards, Shards);
+            } else {
+                QuicLookupFreeRemoteHashShards(Shards, ShardCount);
                 Lookup->MaximizePartitioning = FALSE;
             }
         }
@@ -299,36 +703,25 @@ QuicCidMatchConnection(
 }
 
 //
-// Uses the hash and destination connection ID to look up the connection in the
-// hash table. Returns the pointer to the connection if found; NULL otherwise.
+// Returns the connection of a CID that encodes its lookup slot, or NULL. Must
+// be in an epoch read section or hold the RwLock exclusively.
 //
-_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
 QUIC_CONNECTION*
-QuicHashLookupConnection(
-    _In_ CXPLAT_HASHTABLE* Table,
-    _In_reads_(Length)
-        const uint8_t* const DestCid,
-    _In_ uint8_t Length,
-    _In_ uint32_t Hash
+QuicLookupFindConnectionBySlot(
+    _In_ const QUIC_LOOKUP* Lookup,
+    _In_reads_(CIDLen)
+        const uint8_t* const CID,
+    _In_ uint8_t CIDLen
     )
 {
-    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
-    CXPLAT_HASHTABLE_ENTRY* TableEntry =
-        CxPlatHashtableLookup(Table, Hash, &Context);
-
-    while (TableEntry != NULL) {
-        QUIC_CID_HASH_ENTRY* CIDEntry =
-            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CID_HASH_ENTRY, Entry);
-
-        if (CIDEntry->CID.Length == Length &&
-            memcmp(DestCid, CIDEntry->CID.Data, Length) == 0) {
-            return CIDEntry->Connection;
-        }
-
-        TableEntry = CxPlatHashtableLookupNext(Table, &Context);
+    if (CIDLen != MsQuicLib.CidTotalLength) {
+        return NULL;
     }
-
-    return NULL;
+    return
+        QuicCidSlotTableLookup(
+            &Lookup->Slots,
+            CID + MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -360,23 +753,17 @@ QuicLookupFindConnectionByLocalCidInternal(
         //
         // Use the destination connection ID to get the index into the
         // partitioned hash table array, and look up the connection in that
-        // hash table.
+        // hash table. This may run without the lock, so the partition count
+        // is taken from the loaded table array itself.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireShared(&Table->RwLock, PrevIrql);
+        const QUIC_PARTITIONED_HASHTABLE* Tables =
+            QuicReadPtrAcquire(&Lookup->HASH.Tables);
         Connection =
-            QuicHashLookupConnection(
-                &Table->Table,
+            QuicCidTableLookup(
+                &Tables[QuicLookupPartitionIndex(CID, Tables->PartitionCount)].Table,
                 CID,
                 CIDLen,
                 Hash);
-        CxPlatDispatchRwLockReleaseShared(&Table->RwLock, PrevIrql);
     }
 
 #if QUIC_DEBUG_HASHTABLE_LOOKUP
@@ -400,12 +787,13 @@ QuicLookupFindConnectionByLocalCidInternal(
 }
 
 //
-// Requires Lookup->RwLock to be held (shared).
+// Requires the Shard->RwLock to be held (shared).
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByRemoteHashInternal(
     _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_REMOTE_HASH_SHARD* Shard,
     _In_ const QUIC_ADDR* const RemoteAddress,
     _In_ uint8_t RemoteCidLength,
     _In_reads_(RemoteCidLength)
@@ -413,9 +801,10 @@ QuicLookupFindConnectionByRemoteHashInternal(
     _In_ uint32_t Hash
     )
 {
+    UNREFERENCED_PARAMETER(Lookup);
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
     CXPLAT_HASHTABLE_ENTRY* TableEntry =
-        CxPlatHashtableLookup(&Lookup->RemoteHashTable, Hash, &Context);
+        CxPlatHashtableLookup(&Shard->Table, Hash, &Context);
 
     while (TableEntry != NULL) {
         QUIC_REMOTE_HASH_ENTRY* Entry =
@@ -435,7 +824,7 @@ QuicLookupFindConnectionByRemoteHashInternal(
             return Entry->Connection;
         }
 
-        TableEntry = CxPlatHashtableLookupNext(&Lookup->RemoteHashTable, &Context);
+        TableEntry = CxPlatHashtableLookupNext(&Shard->Table, &Context);
     }
 
 #if QUIC_DEBUG_HASHTABLE_LOOKUP
@@ -449,6 +838,37 @@ QuicLookupFindConnectionByRemoteHashInternal(
     return NULL;
 }
 
+//
+// Replaces the random payload of the CID with an encoded slot of the lookup,
+// if one can be allocated. Requires the Lookup->RwLock to be exlusively held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupEncodeLocalCid(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    )
+{
+    QUIC_CID_SLOT_ARRAY* RetiredArray;
+    if (!QuicCidSlotTableInsert(
+            &Lookup->Slots,
+            SourceCid->Connection,
+            SourceCid->CID.Data + MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH,
+            &RetiredArray)) {
+        //
+        // Out of slots or memory. The CID keeps its random payload and goes
+        // into the hash tables instead.
+        //
+        return;
+    }
+
+    if (RetiredArray != NULL) {
+        QuicLookupRetire(Lookup, QUIC_LOOKUP_RETIRED_SLOT_ARRAY, RetiredArray, 0);
+    }
+
+    SourceCid->CID.IsInSlotTable = TRUE;
+}
+
 //
 // Inserts a source connection ID into the lookup table. Requires the
 // Lookup->RwLock to be exlusively held.
@@ -474,26 +894,20 @@ QuicLookupInsertLocalCid(
             Lookup->SINGLE.Connection = SourceCid->Connection;
         }
 
-    } else {
-        CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
-
+    } else if (!SourceCid->CID.IsInSlotTable) {
         //
         // Insert the source connection ID into the hash table.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableInsert(
-            &Table->Table,
-            &SourceCid->Entry,
-            Hash,
-            NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+        if (!QuicLookupInsertIntoHashTable(
+                Lookup,
+                Lookup->HASH.Tables,
+                TRUE,
+                SourceCid->CID.Data,
+                SourceCid->CID.Length,
+                Hash,
+                SourceCid->Connection)) {
+            return FALSE;
+        }
     }
 
     if (UpdateRefCount) {
@@ -516,12 +930,13 @@ QuicLookupInsertLocalCid(
 }
 
 //
-// Requires the Lookup->RwLock to be exlusively held.
+// Requires the Shard->RwLock to be exlusively held.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicLookupInsertRemoteHash(
     _In_ QUIC_LOOKUP* Lookup,
+    _In_ QUIC_REMOTE_HASH_SHARD* Shard,
     _In_ uint32_t Hash,
     _In_ QUIC_CONNECTION* Connection,
     _In_ const QUIC_ADDR* const RemoteAddress,
@@ -541,6 +956,7 @@ QuicLookupInsertRemoteHash(
 
     Entry->Connection = Connection;
     Entry->RemoteAddress = *RemoteAddress;
+    Entry->ShardIndex = (uint16_t)(Shard - Lookup->RemoteHashShards);
     Entry->RemoteCidLength = RemoteCidLength;
     CxPlatCopyMemory(
         Entry->RemoteCid,
@@ -548,7 +964,7 @@ QuicLookupInsertRemoteHash(
         RemoteCidLength);
 
     CxPlatHashtableInsert(
-        &Lookup->RemoteHashTable,
+        &Shard->Table,
         &Entry->Entry,
         Hash,
         NULL);
@@ -605,21 +1021,33 @@ QuicLookupRemoveLocalCidInt(
             //
             Lookup->SINGLE.Connection = NULL;
         }
+    } else if (SourceCid->CID.IsInSlotTable) {
+        //
+        // Release the slot the CID encodes. Bumping the slot's generation
+        // keeps the CID from routing to a later user of the slot.
+        //
+        QuicCidSlotTableRemove(
+            &Lookup->Slots,
+            SourceCid->CID.Data + MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
+        SourceCid->CID.IsInSlotTable = FALSE;
+
     } else {
         CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
 
         //
-        // Remove the source connection ID from the multi-hash table.
+        // Remove the source connection ID from the multi-hash table. Lock-free
+        // readers might still be looking at it until the next epoch.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableRemove(&Table->Table, &SourceCid->Entry, NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+        uint16_t PartitionIndex =
+            QuicLookupPartitionIndex(SourceCid->CID.Data, Lookup->PartitionCount);
+        BOOLEAN Removed =
+            QuicCidTableRemove(
+                &Lookup->HASH.Tables[PartitionIndex].Table,
+                SourceCid->CID.Data,
+                SourceCid->CID.Length,
+                CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data));
+        CXPLAT_DBG_ASSERT(Removed);
+        UNREFERENCED_PARAMETER(Removed);
     }
 }
 
@@ -632,22 +1060,54 @@ QuicLookupFindConnectionByLocalCid(
     _In_ uint8_t CIDLen
     )
 {
-    uint32_t Hash = CxPlatHashSimple(CIDLen, CID);
+    QUIC_CONNECTION* ExistingConnection;
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+    if (QuicReadAcquire16(&Lookup->PartitionCount) != 0) {
+        //
+        // Partitioned lookups never go back to a single connection, so the
+        // tables can be used without the lock. The epoch keeps the tables and
+        // the lookup table's connection references alive until the
+        // connection found here is referenced.
+        //
+        long* EpochReader = QuicCidEpochEnter(&Lookup->Epoch);
 
-    QUIC_CONNECTION* ExistingConnection =
-        QuicLookupFindConnectionByLocalCidInternal(
-            Lookup,
-            CID,
-            CIDLen,
-            Hash);
+        //
+        // CIDs that encode their slot don't need to be hashed. The hash
+        // tables hold all the others, such as the client's original CID or
+        // CIDs moved over from another binding.
+        //
+        ExistingConnection = QuicLookupFindConnectionBySlot(Lookup, CID, CIDLen);
+        if (ExistingConnection == NULL) {
+            ExistingConnection =
+                QuicLookupFindConnectionByLocalCidInternal(
+                    Lookup,
+                    CID,
+                    CIDLen,
+                    CxPlatHashSimple(CIDLen, CID));
+        }
 
-    if (ExistingConnection != NULL) {
-        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-    }
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
 
-    CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+        QuicCidEpochExit(EpochReader);
+
+    } else {
+        QuicLookupLockAcquireShared(&Lookup->RwLock, PrevIrql);
+
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                CID,
+                CIDLen,
+                CxPlatHashSimple(CIDLen, CID));
+
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+
+        CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+    }
 
     return ExistingConnection;
 }
@@ -662,29 +1122,31 @@ QuicLookupFindConnectionByRemoteHash(
         const uint8_t* const RemoteCid
     )
 {
-    uint32_t Hash = QuicPacketHash(RemoteAddress, RemoteCidLength, RemoteCid);
+    QUIC_REMOTE_HASH_SHARD* Shards = QuicReadPtrAcquire(&Lookup->RemoteHashShards);
+    if (Shards == NULL) {
+        return NULL;
+    }
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+    uint32_t Hash = QuicPacketHash(RemoteAddress, RemoteCidLength, RemoteCid);
+    QUIC_REMOTE_HASH_SHARD* Shard =
+        QuicLookupGetRemoteHashShard(Shards, Lookup->RemoteHashShardCount, Hash);
 
-    QUIC_CONNECTION* ExistingConnection;
-    if (Lookup->MaximizePartitioning) {
-        ExistingConnection =
-            QuicLookupFindConnectionByRemoteHashInternal(
-                Lookup,
-                RemoteAddress,
-                RemoteCidLength,
-                RemoteCid,
-                Hash);
+    QuicLookupLockAcquireShared(&Shard->RwLock, PrevIrql);
 
-        if (ExistingConnection != NULL) {
-            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-        }
+    QUIC_CONNECTION* ExistingConnection =
+        QuicLookupFindConnectionByRemoteHashInternal(
+            Lookup,
+            Shard,
+            RemoteAddress,
+            RemoteCidLength,
+            RemoteCid,
+            Hash);
 
-    } else {
-        ExistingConnection = NULL;
+    if (ExistingConnection != NULL) {
+        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
     }
 
-    CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+    CxPlatDispatchRwLockReleaseShared(&Shard->RwLock, PrevIrql);
 
     return ExistingConnection;
 }
@@ -699,7 +1161,7 @@ QuicLookupFindConnectionByRemoteAddr(
     QUIC_CONNECTION* ExistingConnection = NULL;
     UNREFERENCED_PARAMETER(RemoteAddress); // Can't even validate this for single connection lookups right now.
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireShared(&Lookup->RwLock, PrevIrql);
 
     if (Lookup->PartitionCount == 0) {
         //
@@ -732,18 +1194,41 @@ QuicLookupAddLocalCid(
 {
     BOOLEAN Result;
     QUIC_CONNECTION* ExistingConnection;
-    uint32_t Hash = CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data);
 
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
 
     CXPLAT_DBG_ASSERT(!SourceCid->CID.IsInLookupTable);
+    CXPLAT_DBG_ASSERT(!SourceCid->CID.IsInSlotTable);
 
-    ExistingConnection =
-        QuicLookupFindConnectionByLocalCidInternal(
-            Lookup,
-            SourceCid->CID.Data,
-            SourceCid->CID.Length,
-            Hash);
+    if (MsQuicLib.EnableEncodedCids &&
+        SourceCid->CID.IsEncodable &&
+        Lookup->PartitionCount != 0 &&
+        SourceCid->CID.Length == MsQuicLib.CidTotalLength) {
+        QuicLookupEncodeLocalCid(Lookup, SourceCid);
+    }
+
+    uint32_t Hash = CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data);
+
+    //
+    // A CID that was just encoded is unique among the slots, so it only needs
+    // to be checked against the hash tables.
+    //
+    ExistingConnection = NULL;
+    if (!SourceCid->CID.IsInSlotTable) {
+        ExistingConnection =
+            QuicLookupFindConnectionBySlot(
+                Lookup,
+                SourceCid->CID.Data,
+                SourceCid->CID.Length);
+    }
+    if (ExistingConnection == NULL) {
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                SourceCid->CID.Data,
+                SourceCid->CID.Length,
+                Hash);
+    }
 
     if (ExistingConnection == NULL) {
         Result =
@@ -759,6 +1244,13 @@ QuicLookupAddLocalCid(
         }
     }
 
+    if (!Result && SourceCid->CID.IsInSlotTable) {
+        QuicCidSlotTableRemove(
+            &Lookup->Slots,
+            SourceCid->CID.Data + MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
+        SourceCid->CID.IsInSlotTable = FALSE;
+    }
+
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
 
     return Result;
@@ -779,41 +1271,47 @@ QuicLookupAddRemoteHash(
 
     BOOLEAN Result;
     QUIC_CONNECTION* ExistingConnection;
+
+    QUIC_REMOTE_HASH_SHARD* Shards = QuicReadPtrAcquire(&Lookup->RemoteHashShards);
+    if (Shards == NULL) {
+        *Collision = NULL;
+        return FALSE;
+    }
+
     uint32_t Hash = QuicPacketHash(RemoteAddress, RemoteCidLength, RemoteCid);
+    QUIC_REMOTE_HASH_SHARD* Shard =
+        QuicLookupGetRemoteHashShard(Shards, Lookup->RemoteHashShardCount, Hash);
 
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Shard->RwLock, PrevIrql);
 
-    if (Lookup->MaximizePartitioning) {
-        ExistingConnection =
-            QuicLookupFindConnectionByRemoteHashInternal(
+    ExistingConnection =
+        QuicLookupFindConnectionByRemoteHashInternal(
+            Lookup,
+            Shard,
+            RemoteAddress,
+            RemoteCidLength,
+            RemoteCid,
+            Hash);
+
+    if (ExistingConnection == NULL) {
+        Result =
+            QuicLookupInsertRemoteHash(
                 Lookup,
+                Shard,
+                Hash,
+                Connection,
                 RemoteAddress,
                 RemoteCidLength,
                 RemoteCid,
-                Hash);
-
-        if (ExistingConnection == NULL) {
-            Result =
-                QuicLookupInsertRemoteHash(
-                    Lookup,
-                    Hash,
-                    Connection,
-                    RemoteAddress,
-                    RemoteCidLength,
-                    RemoteCid,
-                    TRUE);
-            *Collision = NULL;
-        } else {
-            Result = FALSE;
-            *Collision = ExistingConnection;
-            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-        }
+                TRUE);
+        *Collision = NULL;
     } else {
         Result = FALSE;
-        *Collision = NULL;
+        *Collision = ExistingConnection;
+        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
     }
 
-    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+    CxPlatDispatchRwLockReleaseExclusive(&Shard->RwLock, PrevIrql);
 
     return Result;
 }
@@ -826,12 +1324,23 @@ QuicLookupRemoveLocalCid(
     _In_ CXPLAT_SLIST_ENTRY** Entry
     )
 {
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
     QuicLookupRemoveLocalCidInt(Lookup, SourceCid);
     SourceCid->CID.IsInLookupTable = FALSE;
     *Entry = (*Entry)->Next;
-    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
-    QuicConnRelease(SourceCid->Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+    if (Lookup->PartitionCount != 0) {
+        //
+        // Lock-free readers might still find the connection through the
+        // removed CID, so its reference is only released once they can't.
+        //
+        QuicLookupRetire(
+            Lookup, QUIC_LOOKUP_RETIRED_CONNECTION, SourceCid->Connection, 0);
+        QuicLookupReclaimInt(Lookup);
+        CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+    } else {
+        CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+        QuicConnRelease(SourceCid->Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -842,18 +1351,20 @@ QuicLookupRemoveRemoteHash(
     )
 {
     QUIC_CONNECTION* Connection = RemoteHashEntry->Connection;
-    CXPLAT_DBG_ASSERT(Lookup->MaximizePartitioning);
+    CXPLAT_DBG_ASSERT(Lookup->RemoteHashShards != NULL);
+    CXPLAT_DBG_ASSERT(RemoteHashEntry->ShardIndex < Lookup->RemoteHashShardCount);
+    QUIC_REMOTE_HASH_SHARD* Shard = &Lookup->RemoteHashShards[RemoteHashEntry->ShardIndex];
 
     QuicLibraryOnHandshakeConnectionRemoved();
 
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Shard->RwLock, PrevIrql);
     CXPLAT_DBG_ASSERT(Connection->RemoteHashEntry != NULL);
     CxPlatHashtableRemove(
-        &Lookup->RemoteHashTable,
+        &Shard->Table,
         &RemoteHashEntry->Entry,
         NULL);
     Connection->RemoteHashEntry = NULL;
-    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+    CxPlatDispatchRwLockReleaseExclusive(&Shard->RwLock, PrevIrql);
 
     CXPLAT_FREE(RemoteHashEntry, QUIC_POOL_REMOTE_HASH);
     QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
@@ -868,7 +1379,7 @@ QuicLookupRemoveLocalCids(
 {
     uint8_t ReleaseRefCount = 0;
 
-    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+    QuicLookupLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
     while (Connection->SourceCids.Next != NULL) {
         QUIC_CID_HASH_ENTRY *CID =
             CXPLAT_CONTAINING_RECORD(
@@ -878,10 +1389,21 @@ QuicLookupRemoveLocalCids(
         if (CID->CID.IsInLookupTable) {
             QuicLookupRemoveLocalCidInt(Lookup, CID);
             CID->CID.IsInLookupTable = FALSE;
-            ReleaseRefCount++;
+            if (Lookup->PartitionCount != 0) {
+                //
+                // Lock-free readers might still find the connection through
+                // the removed CID, so its reference is only released once
+                // they can't.
+                //
+                QuicLookupRetire(
+                    Lookup, QUIC_LOOKUP_RETIRED_CONNECTION, Connection, 0);
+            } else {
+                ReleaseRefCount++;
+            }
         }
-        CXPLAT_FREE(CID, QUIC_POOL_CIDHASH);
+        QuicConnArenaFree(&Connection->Arena, CID, QUIC_POOL_CIDHASH);
     }
+    QuicLookupReclaimInt(Lookup);
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
 
     for (uint8_t i = 0; i < ReleaseRefCount; i++) {
@@ -900,7 +1422,7 @@ QuicLookupMoveLocalConnectionIDs(
 {
     CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
 
-    CxPlatDispatchRwLockAcquireExclusive(&LookupSrc->RwLock, PrevIrql1);
+    QuicLookupLockAcquireExclusive(&LookupSrc->RwLock, PrevIrql1);
     while (Entry != NULL) {
         QUIC_CID_HASH_ENTRY *CID =
             CXPLAT_CONTAINING_RECORD(
@@ -915,7 +1437,7 @@ QuicLookupMoveLocalConnectionIDs(
     }
     CxPlatDispatchRwLockReleaseExclusive(&LookupSrc->RwLock, PrevIrql1);
 
-    CxPlatDispatchRwLockAcquireExclusive(&LookupDest->RwLock, PrevIrql2);
+    QuicLookupLockAcquireExclusive(&LookupDest->RwLock, PrevIrql2);
 #pragma prefast(suppress:6001, "SAL doesn't understand ref counts")
     Entry = Connection->SourceCids.Next;
     while (Entry != NULL) {
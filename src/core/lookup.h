@@ -5,18 +5,34 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
+typedef struct QUIC_LOOKUP_RETIRED QUIC_LOOKUP_RETIRED;
 
 typedef struct QUIC_REMOTE_HASH_ENTRY {
 
     CXPLAT_HASHTABLE_ENTRY Entry;
     QUIC_CONNECTION* Connection;
     QUIC_ADDR RemoteAddress;
+    uint16_t ShardIndex;
     uint8_t RemoteCidLength;
     uint8_t RemoteCid[0];
 
 } QUIC_REMOTE_HASH_ENTRY;
 
+//
+// A shard of the remote hash lookup, with its own lock.
+//
+typedef struct QUIC_CACHEALIGN QUIC_REMOTE_HASH_SHARD {
+
+    CXPLAT_DISPATCH_RW_LOCK RwLock;
+    CXPLAT_HASHTABLE Table;
+
+} QUIC_REMOTE_HASH_SHARD;
+
 //
 // Lookup table for connections.
 //
@@ -34,16 +50,41 @@ typedef struct QUIC_LOOKUP {
     uint32_t CidCount;
 
     //
-    // Lock for accessing the lookup data.
+    // Lock for accessing the lookup data. Local CID lookups don't take it once
+    // the lookup is partitioned.
     //
     CXPLAT_DISPATCH_RW_LOCK RwLock;
 
     //
     // The number of partitions used for lookup tables. Value of 0 (default)
-    // indicates only a single connection (may be NULL) is bound.
+    // indicates only a single connection (may be NULL) is bound. Only ever
+    // increases, and may be read without the lock.
     //
     uint16_t PartitionCount;
 
+    //
+    // Protects lock-free local CID lookups in the partitioned tables.
+    // Initialized when the lookup is first partitioned.
+    //
+    QUIC_CID_EPOCH Epoch;
+
+    //
+    // Slots of the CIDs that encode them, used before the partitioned tables.
+    // Protected by the same epoch.
+    //
+    QUIC_CID_SLOT_TABLE Slots;
+
+    //
+    // Storage and connection references that were removed from the tables,
+    // but that lock-free readers might still be using, in the order they were
+    // retired. Freed once the epoch has advanced past all those readers.
+    // Protected by the RwLock.
+    //
+    uint32_t RetiredCount;
+    uint32_t RetiredCapacity;
+    _Field_size_(RetiredCapacity)
+    QUIC_LOOKUP_RETIRED* Retired;
+
     //
     // Local CID lookup.
     //
@@ -65,9 +106,15 @@ typedef struct QUIC_LOOKUP {
     };
 
     //
-    // Remote Hash lookup.
+    // Remote Hash lookup, for connections still in the handshake. Sharded by
+    // the (Toeplitz) remote hash, so that handshakes from different flows,
+    // which RSS spreads across partitions, don't contend on a single lock.
+    // Allocated when partitioning is maximized and never freed before the
+    // lookup, so it may be read without the lookup lock.
     //
-    CXPLAT_HASHTABLE RemoteHashTable;
+    uint16_t RemoteHashShardCount;
+    _Field_size_(RemoteHashShardCount)
+    QUIC_REMOTE_HASH_SHARD* RemoteHashShards;
 
 } QUIC_LOOKUP;
 
@@ -190,6 +237,16 @@ QuicLookupRemoveLocalCids(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Frees what the lookup retired, once no lock-free reader can still be using
+// it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupReclaim(
+    _In_ QUIC_LOOKUP* Lookup
+    );
+
 //
 // Moves all the connection's local CIDs from the one lookup to another.
 //
@@ -200,3 +257,7 @@ QuicLookupMoveLocalConnectionIDs(
     _In_ QUIC_LOOKUP* LookupDest,
     _In_ QUIC_CONNECTION* Connection
     );
+
+#if defined(__cplusplus)
+}
+#endif
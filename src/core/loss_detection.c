@@ -95,18 +95,26 @@ QuicLossValidate(
     )
 {
     uint32_t AckElicitingPackets = 0;
-    QUIC_SENT_PACKET_METADATA** Tail = &LossDetection->SentPackets;
-    while (*Tail) {
-        CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
-        if ((*Tail)->Flags.IsAckEliciting) {
+    uint32_t SentPackets = 0;
+    const QUIC_SENT_PACKET_RING* Ring = &LossDetection->SentPackets;
+    const QUIC_SENT_PACKET_METADATA* Packet = QuicSentPacketRingFirst(Ring);
+    while (Packet != NULL) {
+        CXPLAT_DBG_ASSERT(!Packet->Flags.Freed);
+        if (Packet->Flags.IsAckEliciting) {
             AckElicitingPackets++;
         }
-        Tail = &((*Tail)->Next);
+        SentPackets++;
+        const QUIC_SENT_PACKET_METADATA* Next =
+            Ring->Indexed ?
+                QuicSentPacketRingNext(Ring, Packet->PacketNumber + 1) :
+                Packet->Next;
+        CXPLAT_DBG_ASSERT(Next == NULL || Next->PacketNumber > Packet->PacketNumber);
+        Packet = Next;
     }
-    CXPLAT_DBG_ASSERT(Tail == LossDetection->SentPacketsTail);
+    CXPLAT_DBG_ASSERT(Ring->Count == SentPackets);
     CXPLAT_DBG_ASSERT(LossDetection->PacketsInFlight == AckElicitingPackets);
 
-    Tail = &LossDetection->LostPackets;
+    QUIC_SENT_PACKET_METADATA** Tail = &LossDetection->LostPackets;
     while (*Tail) {
         CXPLAT_DBG_ASSERT(!(*Tail)->Flags.Freed);
         Tail = &((*Tail)->Next);
@@ -123,8 +131,7 @@ QuicLossDetectionInitialize(
     _Inout_ QUIC_LOSS_DETECTION* LossDetection
     )
 {
-    LossDetection->SentPackets = NULL;
-    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
+    QuicSentPacketRingInitialize(&LossDetection->SentPackets);
     LossDetection->LostPackets = NULL;
     LossDetection->LostPacketsTail = &LossDetection->LostPackets;
     QuicLossDetectionInitializeInternalState(LossDetection);
@@ -138,9 +145,9 @@ QuicLossDetectionUninitialize(
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
 
-    while (LossDetection->SentPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-        LossDetection->SentPackets = LossDetection->SentPackets->Next;
+    QUIC_SENT_PACKET_METADATA* Packet;
+    while ((Packet = QuicSentPacketRingFirst(&LossDetection->SentPackets)) != NULL) {
+        QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet);
 
         if (Packet->Flags.IsAckEliciting) {
             QuicTraceLogVerbose(
@@ -153,8 +160,10 @@ QuicLossDetectionUninitialize(
 
         QuicLossDetectionOnPacketDiscarded(LossDetection, Packet, FALSE);
     }
+    QuicSentPacketRingUninitialize(&LossDetection->SentPackets);
+
     while (LossDetection->LostPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+        Packet = LossDetection->LostPackets;
         LossDetection->LostPackets = LossDetection->LostPackets->Next;
 
         QuicTraceLogVerbose(
@@ -186,15 +195,14 @@ QuicLossDetectionReset(
     // Throw away any outstanding packets.
     //
 
-    while (LossDetection->SentPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
-        LossDetection->SentPackets = LossDetection->SentPackets->Next;
+    QUIC_SENT_PACKET_METADATA* Packet;
+    while ((Packet = QuicSentPacketRingFirst(&LossDetection->SentPackets)) != NULL) {
+        QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet);
         QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
     }
-    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
 
     while (LossDetection->LostPackets != NULL) {
-        QUIC_SENT_PACKET_METADATA* Packet = LossDetection->LostPackets;
+        Packet = LossDetection->LostPackets;
         LossDetection->LostPackets = LossDetection->LostPackets->Next;
         QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
     }
@@ -214,9 +222,12 @@ QuicLossDetectionOldestOutstandingPacket(
     _In_ QUIC_LOSS_DETECTION* LossDetection
     )
 {
-    QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
+    QUIC_SENT_PACKET_METADATA* Packet =
+        QuicSentPacketRingFirst(&LossDetection->SentPackets);
     while (Packet != NULL && !Packet->Flags.IsAckEliciting) {
-        Packet = Packet->Next;
+        Packet =
+            QuicSentPacketRingNext(
+                &LossDetection->SentPackets, Packet->PacketNumber + 1);
     }
     return Packet;
 }
@@ -419,14 +430,24 @@ QuicLossDetectionOnPacketSent(
         sizeof(QUIC_SENT_PACKET_METADATA) +
         sizeof(QUIC_SENT_FRAME_METADATA) * TempSentPacket->FrameCount);
 
-    LossDetection->LargestSentPacketNumber = TempSentPacket->PacketNumber;
-
     //
-    // Add to the outstanding-packet queue.
+    // Add to the outstanding packets.
     //
     SentPacket->Next = NULL;
-    *LossDetection->SentPacketsTail = SentPacket;
-    LossDetection->SentPacketsTail = &SentPacket->Next;
+    if (!QuicSentPacketRingAdd(&LossDetection->SentPackets, SentPacket)) {
+        //
+        // Same as above, the packet can't be tracked so its data is lost.
+        //
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Sent packet ring",
+            (uint64_t)LossDetection->SentPackets.Capacity * 2 * sizeof(QUIC_SENT_PACKET_METADATA*));
+        QuicLossDetectionRetransmitFrames(LossDetection, SentPacket, TRUE);
+        return;
+    }
+
+    LossDetection->LargestSentPacketNumber = TempSentPacket->PacketNumber;
 
     CXPLAT_DBG_ASSERT(
         SentPacket->Flags.KeyType != QUIC_PACKET_KEY_0_RTT ||
@@ -611,7 +632,7 @@ QuicLossDetectionOnPacketAcknowledged(
                 QUIC_CID_VALIDATE_NULL(Connection, DestCid);
                 CXPLAT_DBG_ASSERT(Connection->RetiredDestCidCount > 0);
                 Connection->RetiredDestCidCount--;
-                CXPLAT_FREE(DestCid, QUIC_POOL_CIDLIST);
+                QuicConnArenaFree(&Connection->Arena, DestCid, QUIC_POOL_CIDLIST);
             }
             break;
         }
@@ -943,7 +964,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 2);
         while ((Packet = LossDetection->LostPackets) != NULL &&
                 Packet->PacketNumber < LossDetection->LargestAck &&
-                CxPlatTimeDiff64(Packet->SentTime, TimeNow) > TwoPto) {
+                !CxPlatTimeAtOrBefore64(TimeNow, Packet->SentTime + TwoPto)) {
             QuicTraceLogVerbose(
                 PacketTxForget,
                 "[%c][TX][%llu] Forgetting",
@@ -959,7 +980,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
         QuicLossValidate(LossDetection);
     }
 
-    if (LossDetection->SentPackets != NULL) {
+    if (!QuicSentPacketRingIsEmpty(&LossDetection->SentPackets)) {
         //
         // Remove "suspect" packets inferred lost from out-of-order ACKs.
         // The spec has:
@@ -972,10 +993,10 @@ QuicLossDetectionDetectAndHandleLostPackets(
         uint64_t Rtt = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
         uint64_t TimeReorderThreshold = QUIC_TIME_REORDER_THRESHOLD(Rtt);
         uint64_t LargestLostPacketNumber = 0;
-        QUIC_SENT_PACKET_METADATA* PrevPacket = NULL;
-        Packet = LossDetection->SentPackets;
-        while (Packet != NULL) {
+        uint64_t PacketNumber = 0;
+        while ((Packet = QuicSentPacketRingNext(&LossDetection->SentPackets, PacketNumber)) != NULL) {
 
+            PacketNumber = Packet->PacketNumber + 1;
             BOOLEAN NonretransmittableHandshakePacket =
                 !Packet->Flags.IsAckEliciting &&
                 Packet->Flags.KeyType < QUIC_PACKET_KEY_1_RTT;
@@ -983,8 +1004,6 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 QuicKeyTypeToEncryptLevel(Packet->Flags.KeyType);
 
             if (EncryptLevel > LossDetection->LargestAckEncryptLevel) {
-                PrevPacket = Packet;
-                Packet = Packet->Next;
                 continue;
             }
 
@@ -1035,22 +1054,11 @@ QuicLossDetectionDetectAndHandleLostPackets(
             }
 
             LargestLostPacketNumber = Packet->PacketNumber;
-            if (PrevPacket == NULL) {
-                LossDetection->SentPackets = Packet->Next;
-                if (Packet->Next == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            } else {
-                PrevPacket->Next = Packet->Next;
-                if (Packet->Next == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            }
+            QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet);
 
+            Packet->Next = NULL;
             *LossDetection->LostPacketsTail = Packet;
             LossDetection->LostPacketsTail = &Packet->Next;
-            Packet = Packet->Next;
-            *LossDetection->LostPacketsTail = NULL;
         }
 
         QuicLossValidate(LossDetection);
@@ -1058,10 +1066,10 @@ QuicLossDetectionDetectAndHandleLostPackets(
         if (LostRetransmittableBytes > 0) {
             if (LossDetection->ProbeCount > QUIC_PERSISTENT_CONGESTION_THRESHOLD) {
                 //
-                // On persistent congestion, reset the peer's packet tolerance
-                // back to the default.
+                // On persistent congestion, reset the peer's minimum packet
+                // tolerance back to the default.
                 //
-                QuicConnUpdatePeerPacketTolerance(Connection, QUIC_MIN_ACK_SEND_NUMBER);
+                Connection->PeerMinPacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
             }
 
             QUIC_LOSS_EVENT LossEvent = {
@@ -1073,6 +1081,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
             };
 
             QuicCongestionControlOnDataLost(&Connection->CongestionControl, &LossEvent);
+            QuicConnUpdatePeerAckFrequency(Connection);
             //
             // Send packets from any previously blocked streams.
             //
@@ -1149,23 +1158,12 @@ QuicLossDetectionDiscardPackets(
 
     QuicLossValidate(LossDetection);
 
-    PrevPacket = NULL;
-    Packet = LossDetection->SentPackets;
-    while (Packet != NULL) {
-        QUIC_SENT_PACKET_METADATA* NextPacket = Packet->Next;
+    uint64_t PacketNumber = 0;
+    while ((Packet = QuicSentPacketRingNext(&LossDetection->SentPackets, PacketNumber)) != NULL) {
+        PacketNumber = Packet->PacketNumber + 1;
 
         if (Packet->Flags.KeyType == KeyType) {
-            if (PrevPacket != NULL) {
-                PrevPacket->Next = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            } else {
-                LossDetection->SentPackets = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            }
+            QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet);
 
             QuicTraceLogVerbose(
                 PacketTxAckedImplicit,
@@ -1187,12 +1185,6 @@ QuicLossDetectionDiscardPackets(
             QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, Packet, TRUE, TimeNow, 0);
 
             QuicSentPacketPoolReturnPacketMetadata(Packet, Connection);
-
-            Packet = NextPacket;
-
-        } else {
-            PrevPacket = Packet;
-            Packet = NextPacket;
         }
     }
 
@@ -1234,31 +1226,19 @@ QuicLossDetectionOnZeroRttRejected(
     )
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
-    QUIC_SENT_PACKET_METADATA* PrevPacket;
     QUIC_SENT_PACKET_METADATA* Packet;
+    uint64_t PacketNumber = 0;
     uint32_t CountRetransmittableBytes = 0;
 
     //
     // Marks all the packets as lost so they can be retransmitted immediately.
     //
 
-    PrevPacket = NULL;
-    Packet = LossDetection->SentPackets;
-    while (Packet != NULL) {
-        QUIC_SENT_PACKET_METADATA* NextPacket = Packet->Next;
+    while ((Packet = QuicSentPacketRingNext(&LossDetection->SentPackets, PacketNumber)) != NULL) {
+        PacketNumber = Packet->PacketNumber + 1;
 
         if (Packet->Flags.KeyType == QUIC_PACKET_KEY_0_RTT) {
-            if (PrevPacket != NULL) {
-                PrevPacket->Next = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &PrevPacket->Next;
-                }
-            } else {
-                LossDetection->SentPackets = NextPacket;
-                if (NextPacket == NULL) {
-                    LossDetection->SentPacketsTail = &LossDetection->SentPackets;
-                }
-            }
+            QuicSentPacketRingRemove(&LossDetection->SentPackets, Packet);
 
             QuicTraceLogVerbose(
                 PacketTx0RttRejected,
@@ -1272,12 +1252,6 @@ QuicLossDetectionOnZeroRttRejected(
             CountRetransmittableBytes += Packet->PacketLength;
 
             QuicLossDetectionRetransmitFrames(LossDetection, Packet, TRUE);
-
-            Packet = NextPacket;
-
-        } else {
-            PrevPacket = Packet;
-            Packet = NextPacket;
         }
     }
 
@@ -1323,7 +1297,7 @@ QuicLossDetectionProcessAckBlocks(
     *InvalidAckBlock = FALSE;
 
     QUIC_SENT_PACKET_METADATA** LostPacketsStart = &LossDetection->LostPackets;
-    QUIC_SENT_PACKET_METADATA** SentPacketsStart = &LossDetection->SentPackets;
+    QUIC_SENT_PACKET_RING* SentPackets = &LossDetection->SentPackets;
     QUIC_SENT_PACKET_METADATA* LargestAckedPacket = NULL;
 
     uint32_t i = 0;
@@ -1409,36 +1383,34 @@ QuicLossDetectionProcessAckBlocks(
 
 CheckSentPackets:
         //
-        // Now find all the acknowledged packets in the SentPackets list.
+        // Now find all the acknowledged packets in the outstanding packets,
+        // starting directly at the ACK block's slot in the ring.
         //
-        if (*SentPacketsStart != NULL) {
-            while (*SentPacketsStart && (*SentPacketsStart)->PacketNumber < AckBlock->Low) {
-                SentPacketsStart = &((*SentPacketsStart)->Next);
-            }
-
-            QUIC_SENT_PACKET_METADATA** End = SentPacketsStart;
-            while (*End && (*End)->PacketNumber <= QuicRangeGetHigh(AckBlock)) {
-
-                if ((*End)->Flags.IsAckEliciting) {
+        if (!QuicSentPacketRingIsEmpty(SentPackets)) {
+            uint64_t PacketNumber = AckBlock->Low;
+            QUIC_SENT_PACKET_METADATA* SentPacket;
+            BOOLEAN Removed = FALSE;
+            while ((SentPacket = QuicSentPacketRingNext(SentPackets, PacketNumber)) != NULL &&
+                    SentPacket->PacketNumber <= QuicRangeGetHigh(AckBlock)) {
+
+                PacketNumber = SentPacket->PacketNumber + 1;
+                if (SentPacket->Flags.IsAckEliciting) {
                     LossDetection->PacketsInFlight--;
-                    AckedRetransmittableBytes += (*End)->PacketLength;
+                    AckedRetransmittableBytes += SentPacket->PacketLength;
                 }
-                LargestAckedPacket = *End;
-                End = &((*End)->Next);
-            }
+                LargestAckedPacket = SentPacket;
 
-            if (SentPacketsStart != End) {
                 //
-                // Remove the ACKed packets from the outstanding packet list.
+                // Move the ACKed packet from the outstanding packets.
                 //
-                *AckedPacketsTail = *SentPacketsStart;
-                AckedPacketsTail = End;
-                *SentPacketsStart = *End;
-                *End = NULL;
-                if (End == LossDetection->SentPacketsTail) {
-                    LossDetection->SentPacketsTail = SentPacketsStart;
-                }
+                QuicSentPacketRingRemove(SentPackets, SentPacket);
+                SentPacket->Next = NULL;
+                *AckedPacketsTail = SentPacket;
+                AckedPacketsTail = &SentPacket->Next;
+                Removed = TRUE;
+            }
 
+            if (Removed) {
                 QuicLossValidate(LossDetection);
             }
         }
@@ -1637,6 +1609,7 @@ CheckSentPackets:
             //
             QuicSendQueueFlush(&Connection->Send, REASON_CONGESTION_CONTROL);
         }
+        QuicConnUpdatePeerAckFrequency(Connection);
     }
 
     LossDetection->ProbeCount = 0;
@@ -1763,6 +1736,14 @@ QuicLossDetectionScheduleProbe(
     Connection->Send.TailLossProbeNeeded = TRUE;
 
     if (Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT) {
+        if (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
+            //
+            // Have the peer acknowledge the probes right away instead of
+            // waiting for its packet tolerance or ACK delay.
+            //
+            QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK);
+        }
+
         //
         // Check to see if any streams have fresh data to send out.
         //
@@ -1784,7 +1765,7 @@ QuicLossDetectionScheduleProbe(
     // Not enough new stream data exists to fill the probing packets. Schedule
     // retransmits if possible.
     //
-    QUIC_SENT_PACKET_METADATA* Packet = LossDetection->SentPackets;
+    QUIC_SENT_PACKET_METADATA* Packet = QuicSentPacketRingFirst(&LossDetection->SentPackets);
     while (Packet != NULL) {
         if (Packet->Flags.IsAckEliciting) {
             QuicTraceLogVerbose(
@@ -1804,7 +1785,7 @@ QuicLossDetectionScheduleProbe(
                 return;
             }
         }
-        Packet = Packet->Next;
+        Packet = QuicSentPacketRingNext(&LossDetection->SentPackets, Packet->PacketNumber + 1);
     }
 
     //
@@ -1850,11 +1831,17 @@ QuicLossDetectionProcessTimerOperation(
 
     uint64_t TimeNow = CxPlatTimeUs64();
 
+    //
+    // Paced packets may still be waiting for their departure time, so don't
+    // take the difference with a send time that might be ahead of now.
+    //
     if (OldestPacket != NULL &&
-        CxPlatTimeDiff64(OldestPacket->SentTime, TimeNow) >=
-            MS_TO_US((uint64_t)Connection->Settings.DisconnectTimeoutMs)) {
+        CxPlatTimeAtOrBefore64(
+            OldestPacket->SentTime +
+                MS_TO_US((uint64_t)Connection->Settings.DisconnectTimeoutMs),
+            TimeNow)) {
         //
-        // OldestPacket has been in the SentPackets list for at least
+        // OldestPacket has been outstanding for at least
         // DisconnectTimeoutUs without an ACK for either OldestPacket or for any
         // packets sent more than the reordering threshold after it. Assume the
         // path is dead and close the connection.
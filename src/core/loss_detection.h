@@ -58,20 +58,19 @@ typedef struct QUIC_LOSS_DETECTION {
     uint64_t TotalBytesSentAtLastAck;
 
     //
-    // N.B.: SentPackets and LostPackets are generally kept in ascending packet
-    // number order, and packets in the LostPackets list generally have smaller
-    // numbers than those in the SentPackets list. The only case this is not
-    // true is during the handshake. Since multiple encryption levels are used
-    // in parallel, higher numbered packets in lower encryption levels can be
-    // "lost" sooner than the higher encryption levels.
+    // N.B.: LostPackets is generally kept in ascending packet number order,
+    // and packets in the LostPackets list generally have smaller numbers than
+    // those in SentPackets. The only case this is not true is during the
+    // handshake. Since multiple encryption levels are used in parallel, higher
+    // numbered packets in lower encryption levels can be "lost" sooner than
+    // the higher encryption levels.
     //
 
     //
-    // Outstanding packets.
+    // Outstanding packets, indexed by packet number.
     //
     uint64_t LargestSentPacketNumber;
-    QUIC_SENT_PACKET_METADATA* SentPackets;
-    QUIC_SENT_PACKET_METADATA** SentPacketsTail;
+    QUIC_SENT_PACKET_RING SentPackets;
 
     //
     // Lost packets. The purpose of this list is to remember packets a little
@@ -33,10 +33,9 @@ QuicOperationQueueInitialize(
     _Inout_ QUIC_OPERATION_QUEUE* OperQ
     )
 {
-    OperQ->ActivelyProcessing = FALSE;
-    CxPlatDispatchLockInitialize(&OperQ->Lock);
+    OperQ->Inbox = QUIC_OPERATION_QUEUE_IDLE;
+    CxPlatListInitializeHead(&OperQ->PriorityList);
     CxPlatListInitializeHead(&OperQ->List);
-    OperQ->PriorityTail = &OperQ->List.Flink;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -45,10 +44,9 @@ QuicOperationQueueUninitialize(
     _In_ QUIC_OPERATION_QUEUE* OperQ
     )
 {
-    UNREFERENCED_PARAMETER(OperQ);
+    CXPLAT_DBG_ASSERT(OperQ->Inbox == NULL || OperQ->Inbox == QUIC_OPERATION_QUEUE_IDLE);
+    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&OperQ->PriorityList));
     CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&OperQ->List));
-    CXPLAT_DBG_ASSERT(OperQ->PriorityTail == &OperQ->List.Flink);
-    CxPlatDispatchLockUninitialize(&OperQ->Lock);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -141,25 +139,49 @@ QuicOperationFree(
     CxPlatPoolFree(Oper);
 }
 
+//
+// Pushes the operation onto the inbox. Returns TRUE if the queue was idle, in
+// which case the caller must schedule the queue to be drained.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
-QuicOperationEnqueue(
+QuicOperationPush(
     _In_ QUIC_OPERATION_QUEUE* OperQ,
     _In_ QUIC_PARTITION* Partition,
-    _In_ QUIC_OPERATION* Oper
+    _In_ QUIC_OPERATION* Oper,
+    _In_ QUIC_OPERATION_LANE Lane
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
 #if DEBUG
     CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(&OperQ->List, &Oper->Link);
-    CxPlatDispatchLockRelease(&OperQ->Lock);
+    Oper->Lane = (uint8_t)Lane;
+
+    void* Head = QuicReadPtrNoFence(&OperQ->Inbox);
+    while (TRUE) {
+        Oper->Link.Flink =
+            Head == QUIC_OPERATION_QUEUE_IDLE ? NULL : &((QUIC_OPERATION*)Head)->Link;
+        void* Previous = InterlockedCompareExchangePointer(&OperQ->Inbox, Oper, Head);
+        if (Previous == Head) {
+            break;
+        }
+        Head = Previous;
+    }
+
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
-    return StartProcessing;
+    return Head == QUIC_OPERATION_QUEUE_IDLE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicOperationEnqueue(
+    _In_ QUIC_OPERATION_QUEUE* OperQ,
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_OPERATION* Oper
+    )
+{
+    return QuicOperationPush(OperQ, Partition, Oper, QUIC_OPERATION_LANE_NORMAL);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -170,18 +192,7 @@ QuicOperationEnqueuePriority(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-#if DEBUG
-    CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
-#endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(*OperQ->PriorityTail, &Oper->Link);
-    OperQ->PriorityTail = &Oper->Link.Flink;
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
-    return StartProcessing;
+    return QuicOperationPush(OperQ, Partition, Oper, QUIC_OPERATION_LANE_PRIORITY);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -192,20 +203,57 @@ QuicOperationEnqueueFront(
     _In_ QUIC_OPERATION* Oper
     )
 {
-    BOOLEAN StartProcessing;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-#if DEBUG
-    CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
-#endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertHead(&OperQ->List, &Oper->Link);
-    if (OperQ->PriorityTail == &OperQ->List.Flink) {
-        OperQ->PriorityTail = &Oper->Link.Flink;
+    return QuicOperationPush(OperQ, Partition, Oper, QUIC_OPERATION_LANE_FRONT);
+}
+
+//
+// Moves everything in the inbox to the lanes, with a single exchange. The inbox
+// is left empty, but not idle.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicOperationQueueTakeInbox(
+    _In_ QUIC_OPERATION_QUEUE* OperQ
+    )
+{
+    void* Head = InterlockedExchangePointer(&OperQ->Inbox, NULL);
+    if (Head == NULL || Head == QUIC_OPERATION_QUEUE_IDLE) {
+        return;
+    }
+
+    //
+    // The inbox is newest first, so reverse it to restore the push order.
+    //
+    CXPLAT_LIST_ENTRY* Entry = &((QUIC_OPERATION*)Head)->Link;
+    CXPLAT_LIST_ENTRY* Oldest = NULL;
+    while (Entry != NULL) {
+        CXPLAT_LIST_ENTRY* Next = Entry->Flink;
+        Entry->Flink = Oldest;
+        Oldest = Entry;
+        Entry = Next;
+    }
+
+    while (Oldest != NULL) {
+        QUIC_OPERATION* Oper = CXPLAT_CONTAINING_RECORD(Oldest, QUIC_OPERATION, Link);
+        Oldest = Oldest->Flink;
+        if (Oper->Lane == QUIC_OPERATION_LANE_FRONT) {
+            CxPlatListInsertHead(&OperQ->PriorityList, &Oper->Link);
+        } else if (Oper->Lane == QUIC_OPERATION_LANE_PRIORITY) {
+            CxPlatListInsertTail(&OperQ->PriorityList, &Oper->Link);
+        } else {
+            CxPlatListInsertTail(&OperQ->List, &Oper->Link);
+        }
     }
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
-    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
-    return StartProcessing;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicOperationHasPriority(
+    _In_ QUIC_OPERATION_QUEUE* OperQ
+    )
+{
+    QuicOperationQueueTakeInbox(OperQ);
+    return !CxPlatListIsEmpty(&OperQ->PriorityList);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -215,28 +263,43 @@ QuicOperationDequeue(
     _In_ QUIC_PARTITION* Partition
     )
 {
-    QUIC_OPERATION* Oper;
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-    if (CxPlatListIsEmpty(&OperQ->List)) {
-        OperQ->ActivelyProcessing = FALSE;
-        Oper = NULL;
-    } else {
-        OperQ->ActivelyProcessing = TRUE;
-        Oper =
-            CXPLAT_CONTAINING_RECORD(
-                CxPlatListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
-#if DEBUG
-        Oper->Link.Flink = NULL;
-#endif
-        if (OperQ->PriorityTail == &Oper->Link.Flink) {
-            OperQ->PriorityTail = &OperQ->List.Flink;
-        }
+    //
+    // Take anything pushed since the inbox was last taken first, so that
+    // priority and front operations don't wait behind the normal operations
+    // already taken.
+    //
+    const void* Inbox = OperQ->Inbox;
+    if (Inbox != NULL && Inbox != QUIC_OPERATION_QUEUE_IDLE) {
+        QuicOperationQueueTakeInbox(OperQ);
     }
-    CxPlatDispatchLockRelease(&OperQ->Lock);
 
-    if (Oper != NULL) {
-        QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, -1);
+    CXPLAT_LIST_ENTRY* Entry;
+    while (TRUE) {
+        if (!CxPlatListIsEmpty(&OperQ->PriorityList)) {
+            Entry = CxPlatListRemoveHead(&OperQ->PriorityList);
+            break;
+        }
+        if (!CxPlatListIsEmpty(&OperQ->List)) {
+            Entry = CxPlatListRemoveHead(&OperQ->List);
+            break;
+        }
+
+        //
+        // Both lanes are drained. Mark the queue idle if nothing more was
+        // pushed; otherwise, take what was.
+        //
+        if (InterlockedCompareExchangePointer(
+                &OperQ->Inbox, QUIC_OPERATION_QUEUE_IDLE, NULL) == NULL) {
+            return NULL;
+        }
+        QuicOperationQueueTakeInbox(OperQ);
     }
+
+    QUIC_OPERATION* Oper = CXPLAT_CONTAINING_RECORD(Entry, QUIC_OPERATION, Link);
+#if DEBUG
+    Oper->Link.Flink = NULL;
+#endif
+    QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, -1);
     return Oper;
 }
 
@@ -250,11 +313,12 @@ QuicOperationQueueClear(
     CXPLAT_LIST_ENTRY OldList;
     CxPlatListInitializeHead(&OldList);
 
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-    OperQ->ActivelyProcessing = FALSE;
-    CxPlatListMoveItems(&OperQ->List, &OldList);
-    OperQ->PriorityTail = &OperQ->List.Flink;
-    CxPlatDispatchLockRelease(&OperQ->Lock);
+    do {
+        QuicOperationQueueTakeInbox(OperQ);
+        CxPlatListMoveItems(&OperQ->PriorityList, &OldList);
+        CxPlatListMoveItems(&OperQ->List, &OldList);
+    } while (InterlockedCompareExchangePointer(
+                &OperQ->Inbox, QUIC_OPERATION_QUEUE_IDLE, NULL) != NULL);
 
     int64_t OperationsDequeued = 0;
 
@@ -9,6 +9,10 @@
 #include "operation.h.clog.h"
 #endif
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_SEND_REQUEST QUIC_SEND_REQUEST;
 
 //
@@ -181,6 +185,10 @@ typedef enum QUIC_CONN_TIMER_TYPE {
     QUIC_CONN_TIMER_PACING,
     QUIC_CONN_TIMER_ACK_DELAY,
     QUIC_CONN_TIMER_LOSS_DETECTION,
+
+    //
+    // Coarse timers; must be last. See QuicConnTimerSetEx.
+    //
     QUIC_CONN_TIMER_KEEP_ALIVE,
     QUIC_CONN_TIMER_IDLE,
     QUIC_CONN_TIMER_SHUTDOWN,
@@ -189,6 +197,9 @@ typedef enum QUIC_CONN_TIMER_TYPE {
 
 } QUIC_CONN_TIMER_TYPE;
 
+#define QUIC_CONN_TIMER_FIRST_COARSE    QUIC_CONN_TIMER_KEEP_ALIVE
+#define QUIC_CONN_TIMER_COARSE_COUNT    (QUIC_CONN_TIMER_COUNT - QUIC_CONN_TIMER_FIRST_COARSE)
+
 typedef struct QUIC_STATELESS_CONTEXT {
     QUIC_BINDING* Binding;
     QUIC_WORKER* Worker;
@@ -218,6 +229,11 @@ typedef struct QUIC_OPERATION {
     //
     BOOLEAN FreeAfterProcess;
 
+    //
+    // The part of the queue the operation was enqueued to (QUIC_OPERATION_LANE).
+    //
+    uint8_t Lane;
+
     union {
         struct {
             void* Reserved; // Nothing.
@@ -286,22 +302,38 @@ QuicOperLog(
     }
 }
 
+typedef enum QUIC_OPERATION_LANE {
+    QUIC_OPERATION_LANE_FRONT,      // Head of the priority operations.
+    QUIC_OPERATION_LANE_PRIORITY,   // Tail of the priority operations.
+    QUIC_OPERATION_LANE_NORMAL      // Tail of the normal operations.
+} QUIC_OPERATION_LANE;
+
+//
+// The value of the queue's inbox when the queue is empty and not being drained.
+//
+#define QUIC_OPERATION_QUEUE_IDLE ((void*)(size_t)1)
+
 //
 // A queue of operations to be executed for a connection.
 //
+// Producers push operations onto the inbox, a lock-free stack, with a single
+// compare and swap. The consumer takes the whole inbox with a single exchange
+// and sorts it into the priority and normal lanes, which only it touches.
+//
 typedef struct QUIC_OPERATION_QUEUE {
 
     //
-    // TRUE if the queue is being drained.
+    // The operations pushed since the consumer last took the inbox, newest
+    // first, linked through Link.Flink. QUIC_OPERATION_QUEUE_IDLE if the queue
+    // is empty and not being drained.
     //
-    BOOLEAN ActivelyProcessing;
+    void* volatile Inbox;
 
     //
-    // Queue of pending operations.
+    // Operations taken from the inbox, in the order they will be processed.
     //
-    CXPLAT_DISPATCH_LOCK Lock;
+    CXPLAT_LIST_ENTRY PriorityList;
     CXPLAT_LIST_ENTRY List;
-    CXPLAT_LIST_ENTRY** PriorityTail; // Tail of the priority queue.
 
 } QUIC_OPERATION_QUEUE;
 
@@ -343,20 +375,14 @@ QuicOperationFree(
     );
 
 //
-// Returns TRUE if the operation queue has priority operations queued.
+// Returns TRUE if the operation queue has priority operations queued. Only
+// called by the consumer.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_INLINE
 BOOLEAN
 QuicOperationHasPriority(
     _In_ QUIC_OPERATION_QUEUE* OperQ
-    )
-{
-    CxPlatDispatchLockAcquire(&OperQ->Lock);
-    BOOLEAN HasPriorityWork = (&OperQ->List.Flink != OperQ->PriorityTail);
-    CxPlatDispatchLockRelease(&OperQ->Lock);
-    return HasPriorityWork;
-}
+    );
 
 //
 // Enqueues an operation. Returns TRUE if the queue was previously empty and not
@@ -396,7 +422,8 @@ QuicOperationEnqueueFront(
     );
 
 //
-// Dequeues an operation. Returns NULL if the queue is empty.
+// Dequeues an operation. Returns NULL if the queue is empty. Only called by the
+// consumer.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_OPERATION*
@@ -414,3 +441,7 @@ QuicOperationQueueClear(
     _In_ QUIC_OPERATION_QUEUE* OperQ,
     _In_ QUIC_PARTITION* Partition
     );
+
+#if defined(__cplusplus)
+}
+#endif
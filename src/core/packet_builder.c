@@ -120,9 +120,25 @@ QuicPacketBuilderInitialize(
             QUIC_CID_HASH_ENTRY,
             Link);
 
+    Builder->PacingOffload =
+        MsQuicLib.PacingOffloadSupported &&
+        Connection->Settings.PacingEnabled &&
+        !Connection->Settings.XdpEnabled;
+    Builder->TxTime = 0;
+
     uint64_t TimeNow = CxPlatTimeUs64();
     uint64_t TimeSinceLastSend;
     if (Connection->Send.LastFlushTimeValid) {
+        if (CxPlatTimeAtOrBefore64(TimeNow, Connection->Send.LastFlushTime)) {
+            //
+            // Previously paced packets are still waiting in the datapath for
+            // their departure time. Queue behind them to keep them in order.
+            //
+            TimeNow = Connection->Send.LastFlushTime;
+            if (Builder->PacingOffload) {
+                Builder->TxTime = TimeNow;
+            }
+        }
         TimeSinceLastSend =
             CxPlatTimeDiff64(Connection->Send.LastFlushTime, TimeNow);
     } else {
@@ -149,6 +165,7 @@ QuicPacketBuilderCleanup(
     )
 {
     CXPLAT_DBG_ASSERT(Builder->SendData == NULL);
+    CXPLAT_DBG_ASSERT(Builder->ExtentCount == 0);
 
     if (Builder->PacketBatchSent && Builder->PacketBatchRetransmittable) {
         QuicLossDetectionUpdateTimer(&Builder->Connection->LossDetection, FALSE);
@@ -172,7 +189,8 @@ QuicPacketBuilderPrepare(
     _Inout_ QUIC_PACKET_BUILDER* Builder,
     _In_ QUIC_PACKET_KEY_TYPE NewPacketKeyType,
     _In_ BOOLEAN IsTailLossProbe,
-    _In_ BOOLEAN IsPathMtuDiscovery
+    _In_ BOOLEAN IsPathMtuDiscovery,
+    _In_ BOOLEAN IsCongestionControlled
     )
 {
     QUIC_CONNECTION* Connection = Builder->Connection;
@@ -214,6 +232,16 @@ QuicPacketBuilderPrepare(
     CXPLAT_DBG_ASSERT(!IsPathMtuDiscovery || !IsTailLossProbe); // Never both.
     QuicPacketBuilderValidate(Builder, FALSE);
 
+    //
+    // Only congestion controlled packets wait for the paced departure time.
+    // Probes and packets that bypass congestion control (ACK-only or close)
+    // leave right away, so they can't share a send with paced packets.
+    //
+    const BOOLEAN Paced =
+        Builder->TxTime != 0 && IsCongestionControlled && !IsTailLossProbe;
+    const BOOLEAN PacedChanged =
+        Builder->SendData != NULL && Builder->SendDataPaced != Paced;
+
     //
     // Next, make sure the current QUIC packet matches the new packet type. If
     // the current one doesn't match, finalize it and then start a new one.
@@ -223,14 +251,14 @@ QuicPacketBuilderPrepare(
     const uint64_t PartitionShifted = ((uint64_t)Partition->Index + 1) << 40;
 
     BOOLEAN NewQuicPacket = FALSE;
-    if (Builder->PacketType != NewPacketType || IsPathMtuDiscovery ||
+    if (Builder->PacketType != NewPacketType || IsPathMtuDiscovery || PacedChanged ||
         (Builder->Datagram != NULL && (Builder->Datagram->Length - Builder->DatagramLength) < QUIC_MIN_PACKET_SPARE_SPACE)) {
         //
         // The current data cannot go in the current QUIC packet. Finalize the
         // current QUIC packet up so we can create another.
         //
         if (Builder->SendData != NULL) {
-            BOOLEAN FlushDatagrams = IsPathMtuDiscovery;
+            BOOLEAN FlushDatagrams = IsPathMtuDiscovery || PacedChanged;
             if (Builder->PacketType != NewPacketType &&
                 Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
                 FlushDatagrams = TRUE;
@@ -266,7 +294,8 @@ QuicPacketBuilderPrepare(
                 Builder->EcnEctSet ? CXPLAT_ECN_ECT_0 : CXPLAT_ECN_NON_ECT,
                 Builder->Connection->Registration->ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT ?
                     CXPLAT_SEND_FLAGS_MAX_THROUGHPUT : CXPLAT_SEND_FLAGS_NONE,
-                Connection->DSCP
+                Connection->DSCP,
+                Paced ? Builder->TxTime : 0
             };
             Builder->SendData =
                 CxPlatSendDataAlloc(Builder->Path->Binding->Socket, &SendConfig);
@@ -278,6 +307,7 @@ QuicPacketBuilderPrepare(
                     0);
                 goto Error;
             }
+            Builder->SendDataPaced = Paced;
             SendDataAllocated = TRUE;
         }
 
@@ -631,7 +661,8 @@ QuicPacketBuilderPrepareForControlFrames(
             Builder,
             PacketKeyType,
             IsTailLossProbe,
-            FALSE);
+            FALSE,
+            (SendFlags & ~QUIC_CONN_SEND_FLAGS_BYPASS_CC) != 0);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -646,6 +677,7 @@ QuicPacketBuilderPrepareForPathMtuDiscovery(
             Builder,
             QUIC_PACKET_KEY_1_RTT,
             FALSE,
+            TRUE,
             TRUE);
 }
 
@@ -673,27 +705,127 @@ QuicPacketBuilderPrepareForStreamFrames(
         PacketKeyType = QUIC_PACKET_KEY_1_RTT;
     }
 
-    return QuicPacketBuilderPrepare(Builder, PacketKeyType, IsTailLossProbe, FALSE);
+    return QuicPacketBuilderPrepare(Builder, PacketKeyType, IsTailLossProbe, FALSE, TRUE);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicPacketBuilderAddPayloadExtent(
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
+    _In_ const uint8_t* Destination,
+    _In_reads_bytes_(Length)
+        const uint8_t* Source,
+    _In_ uint16_t Length
+    )
+{
+#ifdef QUIC_FUZZER
+    //
+    // The fuzzer hook may rewrite the plaintext before it is encrypted.
+    //
+    UNREFERENCED_PARAMETER(Builder);
+    UNREFERENCED_PARAMETER(Destination);
+    UNREFERENCED_PARAMETER(Source);
+    UNREFERENCED_PARAMETER(Length);
+    return FALSE;
+#else
+    //
+    // Only short header packets are encrypted in batches, and only once the
+    // batch is complete, i.e. after all of their plaintext is written.
+    //
+    if (Length < QUIC_MIN_CRYPTO_EXTENT_LENGTH ||
+        Builder->ExtentCount == QUIC_MAX_CRYPTO_EXTENT_COUNT ||
+        Builder->PacketType != SEND_PACKET_SHORT_HEADER_TYPE ||
+        Builder->EncryptionOverhead == 0 ||
+        Builder->Connection->Paths[0].EncryptionOffloading) {
+        return FALSE;
+    }
+
+    const uint8_t* Payload =
+        Builder->Datagram->Buffer + Builder->PacketStart + Builder->HeaderLength;
+    CXPLAT_DBG_ASSERT(Destination >= Payload);
+    CXPLAT_DBG_ASSERT(Destination + Length <= Builder->Datagram->Buffer + Builder->Datagram->Length);
+
+    CXPLAT_CRYPT_EXTENT* Extent = &Builder->Extents[Builder->ExtentCount++];
+    Extent->Source = Source;
+    Extent->Offset = (uint16_t)(Destination - Payload);
+    Extent->Length = Length;
+    return TRUE;
+#endif
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicPacketBuilderFinalizeHeaderProtection(
+QuicPacketBuilderFinalizeCryptoBatch(
     _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
     CXPLAT_DBG_ASSERT(Builder->Key != NULL);
+    CXPLAT_DBG_ASSERT(Builder->BatchCount != 0);
+
+    //
+    // All the batched packets are short header packets on the same path, so
+    // they all have the same header length.
+    //
+    const uint16_t HeaderLength =
+        1 + Builder->Path->DestCid->CID.Length + Builder->PacketNumberLength;
+
+    CXPLAT_CRYPT_BATCH_ENTRY Batch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t ExtentIndex = 0;
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        QuicCryptoCombineIvAndPacketNumber(
+            Builder->Key->Iv,
+            (uint8_t*)&Builder->PacketNumberBatch[i],
+            Batch[i].Iv);
+        Batch[i].AuthData = Builder->HeaderBatch[i];
+        Batch[i].AuthDataLength = HeaderLength;
+        Batch[i].Buffer = Builder->HeaderBatch[i] + HeaderLength;
+        Batch[i].BufferLength = Builder->PayloadLengthBatch[i];
+        Batch[i].Extents = Builder->Extents + ExtentIndex;
+        Batch[i].ExtentCount = Builder->ExtentCountBatch[i];
+        ExtentIndex += Builder->ExtentCountBatch[i];
+    }
+    CXPLAT_DBG_ASSERT(ExtentIndex == Builder->ExtentCount);
+    Builder->ExtentCount = 0;
+    Builder->PacketExtentStart = 0;
 
     QUIC_STATUS Status;
+    if (QUIC_FAILED(
+        Status =
+        CxPlatEncryptBatch(
+            Builder->Key->PacketKey,
+            Builder->BatchCount,
+            Batch))) {
+        QuicConnFatalError(Builder->Connection, Status, "Encryption failure");
+        Builder->BatchCount = 0;
+        return;
+    }
+
+    if (!Builder->Connection->State.HeaderProtectionEnabled) {
+        Builder->BatchCount = 0;
+        return;
+    }
+
+    uint8_t CipherBatch[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
+    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+        //
+        // The sample starts 4 bytes after the start of the packet number.
+        //
+        CxPlatCopyMemory(
+            CipherBatch + i * CXPLAT_HP_SAMPLE_LENGTH,
+            Batch[i].Buffer - Builder->PacketNumberLength + 4,
+            CXPLAT_HP_SAMPLE_LENGTH);
+    }
+
     if (QUIC_FAILED(
         Status =
         CxPlatHpComputeMask(
             Builder->Key->HeaderKey,
             Builder->BatchCount,
-            Builder->CipherBatch,
+            CipherBatch,
             Builder->HpMask))) {
         CXPLAT_TEL_ASSERT(FALSE);
         QuicConnFatalError(Builder->Connection, Status, "HP failure");
+        Builder->BatchCount = 0;
         return;
     }
 
@@ -732,6 +864,7 @@ QuicPacketBuilderFinalize(
     QuicPacketBuilderValidate(Builder, FALSE);
 
     if (Builder->Datagram == NULL || Builder->Metadata->FrameCount == 0) {
+        CXPLAT_DBG_ASSERT(Builder->ExtentCount == Builder->PacketExtentStart);
         //
         // Nothing got framed into this packet. Undo the header of this
         // packet.
@@ -857,59 +990,70 @@ QuicPacketBuilderFinalize(
         PayloadLength += Builder->EncryptionOverhead;
         Builder->DatagramLength += Builder->EncryptionOverhead;
 
-        uint8_t* Payload = Header + Builder->HeaderLength;
-
-        uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-        QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
-
         QUIC_STATUS Status;
-        if (QUIC_FAILED(
-            Status =
-            CxPlatEncrypt(
-                Builder->Key->PacketKey,
-                Iv,
-                Builder->HeaderLength,
-                Header,
-                PayloadLength,
-                Payload))) {
-            QuicConnFatalError(Connection, Status, "Encryption failure");
-            goto Exit;
-        }
-
-        QuicTraceEvent(
-            PacketFinalize,
-            "[pack][%llu] Finalizing",
-            Builder->Metadata->PacketId);
+        if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
+            CXPLAT_DBG_ASSERT(
+                Builder->HeaderLength ==
+                1 + Builder->Path->DestCid->CID.Length + Builder->PacketNumberLength);
 
-        if (Connection->State.HeaderProtectionEnabled) {
+            //
+            // Batch the encryption and header protection for short header
+            // packets, as they all use the same keys.
+            //
 
-            uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+            Builder->HeaderBatch[Builder->BatchCount] = Header;
+            Builder->PacketNumberBatch[Builder->BatchCount] = Builder->Metadata->PacketNumber;
+            Builder->PayloadLengthBatch[Builder->BatchCount] = PayloadLength;
+            Builder->ExtentCountBatch[Builder->BatchCount] =
+                Builder->ExtentCount - Builder->PacketExtentStart;
+            Builder->PacketExtentStart = Builder->ExtentCount;
 
-            if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
+            QuicTraceEvent(
+                PacketFinalize,
+                "[pack][%llu] Finalizing",
+                Builder->Metadata->PacketId);
 
-                //
-                // Batch the header protection for short header packets.
-                //
+            if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
 
-                CxPlatCopyMemory(
-                    Builder->CipherBatch + Builder->BatchCount * CXPLAT_HP_SAMPLE_LENGTH,
-                    PnStart + 4,
-                    CXPLAT_HP_SAMPLE_LENGTH);
-                Builder->HeaderBatch[Builder->BatchCount] = Header;
+        } else {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+            CXPLAT_DBG_ASSERT(Builder->ExtentCount == 0);
+
+            uint8_t* Payload = Header + Builder->HeaderLength;
+
+            uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+            QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
+
+            if (QUIC_FAILED(
+                Status =
+                CxPlatEncrypt(
+                    Builder->Key->PacketKey,
+                    Iv,
+                    Builder->HeaderLength,
+                    Header,
+                    PayloadLength,
+                    Payload))) {
+                QuicConnFatalError(Connection, Status, "Encryption failure");
+                goto Exit;
+            }
 
-                if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
-                    QuicPacketBuilderFinalizeHeaderProtection(Builder);
-                }
+            QuicTraceEvent(
+                PacketFinalize,
+                "[pack][%llu] Finalizing",
+                Builder->Metadata->PacketId);
 
-            } else {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+            if (Connection->State.HeaderProtectionEnabled) {
 
                 //
                 // Individually do header protection for long header packets as
                 // they generally use different keys.
                 //
 
+                uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+
                 if (QUIC_FAILED(
                     Status =
                     CxPlatHpComputeMask(
@@ -945,6 +1089,15 @@ QuicPacketBuilderFinalize(
             !PacketSpace->AwaitingKeyPhaseConfirmation &&
             Connection->State.HandshakeConfirmed) {
 
+            //
+            // Packets already batched must be protected with the old keys.
+            // This is done first, as failing the connection below completes
+            // the send requests their extents still read from.
+            //
+            if (Builder->BatchCount != 0) {
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
+            }
+
             Status = QuicCryptoGenerateNewKeys(Connection);
             if (QUIC_FAILED(Status)) {
                 QuicTraceEvent(
@@ -981,7 +1134,15 @@ QuicPacketBuilderFinalize(
     //
     CXPLAT_DBG_ASSERT(Builder->Metadata->FrameCount != 0);
 
-    Builder->Metadata->SentTime = CxPlatTimeUs64();
+    //
+    // Paced packets are handed to the datapath ahead of time, so they are sent
+    // at their departure time, not now.
+    //
+    uint64_t SentTime = CxPlatTimeUs64();
+    if (Builder->SendDataPaced && CxPlatTimeAtOrBefore64(SentTime, Builder->TxTime)) {
+        SentTime = Builder->TxTime;
+    }
+    Builder->Metadata->SentTime = SentTime;
     Builder->Metadata->PacketLength =
         Builder->HeaderLength + PayloadLength;
     Builder->Metadata->Flags.EcnEctSet = Builder->EcnEctSet;
@@ -1032,7 +1193,7 @@ Exit:
 
         if (FlushBatchedDatagrams || CxPlatSendDataIsFull(Builder->SendData)) {
             if (Builder->BatchCount != 0) {
-                QuicPacketBuilderFinalizeHeaderProtection(Builder);
+                QuicPacketBuilderFinalizeCryptoBatch(Builder);
             }
             CXPLAT_DBG_ASSERT(Builder->TotalCountDatagrams > 0);
             QuicPacketBuilderSendBatch(Builder);
@@ -1072,6 +1233,64 @@ Exit:
     return CanKeepSending;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicPacketBuilderAddPacingInterval(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    )
+{
+    if (!Builder->PacingOffload) {
+        return FALSE;
+    }
+
+    QUIC_CONNECTION* Connection = Builder->Connection;
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    uint64_t TxTime = Builder->TxTime;
+    if (TxTime == 0 || CxPlatTimeAtOrBefore64(TxTime, TimeNow)) {
+        TxTime = TimeNow;
+    }
+    TxTime += QUIC_SEND_PACING_INTERVAL;
+
+    //
+    // Only queue a fraction of the RTT ahead, so the datapath doesn't hold on
+    // to packets the connection may want to send differently by then.
+    //
+    uint64_t Horizon = Builder->Path->SmoothedRtt / 4;
+    if (Horizon > QUIC_SEND_PACING_OFFLOAD_HORIZON) {
+        Horizon = QUIC_SEND_PACING_OFFLOAD_HORIZON;
+    }
+    if (CxPlatTimeDiff64(TimeNow, TxTime) > Horizon) {
+        return FALSE;
+    }
+
+    uint32_t SendAllowance =
+        QuicCongestionControlGetSendAllowance(
+            &Connection->CongestionControl,
+            QUIC_SEND_PACING_INTERVAL,
+            TRUE);
+    if (SendAllowance > Builder->Path->Allowance) {
+        SendAllowance = Builder->Path->Allowance;
+    }
+    if (SendAllowance == 0) {
+        return FALSE;
+    }
+
+    //
+    // The packets built so far leave at the current departure time, so send
+    // them off before starting the next interval.
+    //
+    if (Builder->SendData != NULL) {
+        QuicPacketBuilderFinalize(Builder, TRUE);
+        CXPLAT_DBG_ASSERT(Builder->SendData == NULL);
+    }
+
+    Builder->TxTime = TxTime;
+    Builder->SendAllowance = SendAllowance;
+    Connection->Send.LastFlushTime = TxTime;
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicPacketBuilderSendBatch(
@@ -41,11 +41,6 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     QUIC_PACKET_KEY* Key;
 
-    //
-    // Cipher text across multiple packets to batch header protection.
-    //
-    uint8_t CipherBatch[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
-
     //
     // Output header protection mask.
     //
@@ -57,6 +52,34 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t* HeaderBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
 
+    //
+    // Packet numbers of the batched packets, for computing their nonces.
+    //
+    uint64_t PacketNumberBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+    //
+    // Payload lengths (including encryption overhead) of the batched packets.
+    //
+    uint16_t PayloadLengthBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+    //
+    // Stream payload of the batched packets, followed by that of the current
+    // packet, still to be read from the app's send buffers when encrypting.
+    //
+    CXPLAT_CRYPT_EXTENT Extents[QUIC_MAX_CRYPTO_EXTENT_COUNT];
+
+    //
+    // The number of extents of each batched packet.
+    //
+    uint8_t ExtentCountBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+    //
+    // The number of extents in use, and the index of the first one of the
+    // current packet.
+    //
+    uint8_t ExtentCount;
+    uint8_t PacketExtentStart;
+
     //
     // Indicates a batch of packets has been sent.
     //
@@ -69,7 +92,7 @@ typedef struct QUIC_PACKET_BUILDER {
     uint8_t PacketBatchRetransmittable : 1;
 
     //
-    // The number of batched packets to do header protection on.
+    // The number of batched packets to encrypt and do header protection on.
     //
     uint8_t BatchCount : 4;
 
@@ -83,6 +106,17 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t WrittenConnectionCloseFrame : 1;
 
+    //
+    // Indicates paced packets are handed to the datapath ahead of time, with
+    // their departure times.
+    //
+    uint8_t PacingOffload : 1;
+
+    //
+    // Indicates the current send data leaves at TxTime instead of right away.
+    //
+    uint8_t SendDataPaced : 1;
+
     //
     // The total number of datagrams that have been created.
     //
@@ -148,6 +182,12 @@ typedef struct QUIC_PACKET_BUILDER {
 
     uint64_t BatchId;
 
+    //
+    // The departure time of the paced packets in the current batch, or zero to
+    // send them immediately. Only set when pacing is offloaded to the datapath.
+    //
+    uint64_t TxTime;
+
     //
     // Represents the metadata of the current QUIC packet.
     //
@@ -214,6 +254,21 @@ QuicPacketBuilderPrepareForStreamFrames(
     _In_ BOOLEAN IsTailLossProbe
     );
 
+//
+// Tries to defer copying the given stream payload into the current packet, so
+// that it is encrypted straight from the source instead. The source must stay
+// valid until the packet is sent. Returns FALSE if the caller must copy it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicPacketBuilderAddPayloadExtent(
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
+    _In_ const uint8_t* Destination,
+    _In_reads_bytes_(Length)
+        const uint8_t* Source,
+    _In_ uint16_t Length
+    );
+
 //
 // Finishes up the current packet so it can be sent.
 //
@@ -224,6 +279,17 @@ QuicPacketBuilderFinalize(
     _In_ BOOLEAN FlushBatchedDatagrams
     );
 
+//
+// Moves on to the next pacing interval, whose packets the datapath releases
+// one interval after the current ones. Returns FALSE if pacing isn't offloaded
+// or the next interval is past the offload horizon.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicPacketBuilderAddPacingInterval(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    );
+
 //
 // Returns TRUE if congestion control isn't currently blocking sends.
 //
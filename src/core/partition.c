@@ -74,6 +74,42 @@ QuicPartitionUninitialize(
     CxPlatHashFree(Partition->ResetTokenHash);
 }
 
+QUIC_INLINE
+void
+QuicPartitionAddPoolStatistics(
+    _In_ const CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_STATISTICS* Statistics
+    )
+{
+    CXPLAT_POOL_STATISTICS PoolStatistics;
+    CxPlatPoolGetStatistics(Pool, &PoolStatistics);
+    Statistics->AllocHitCount += PoolStatistics.AllocHitCount;
+    Statistics->AllocMissCount += PoolStatistics.AllocMissCount;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPartitionGetPoolStatistics(
+    _In_ const QUIC_PARTITION* Partition,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    )
+{
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+    QuicPartitionAddPoolStatistics(&Partition->ConnectionPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->TransportParamPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->PacketSpacePool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->StreamPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->DefaultReceiveBufferPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->SendRequestPool, Statistics);
+    for (size_t i = 0; i < ARRAYSIZE(Partition->SentPacketPool.Pools); ++i) {
+        QuicPartitionAddPoolStatistics(&Partition->SentPacketPool.Pools[i], Statistics);
+    }
+    QuicPartitionAddPoolStatistics(&Partition->ApiContextPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->StatelessContextPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->OperPool, Statistics);
+    QuicPartitionAddPoolStatistics(&Partition->AppBufferChunkPool, Statistics);
+}
+
 //
 // MUST be called while holding the per-partition StatelessRetryKeysLock to
 // ensure no-concurrent modification of the per-partition encryption key *AND*
@@ -94,6 +94,12 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     CXPLAT_POOL OperPool;                   // QUIC_OPERATION
     CXPLAT_POOL AppBufferChunkPool;         // QUIC_RECV_CHUNK
 
+    //
+    // The moving average of the bytes connections allocate from their arena,
+    // used to size the arena of new connections.
+    //
+    uint32_t ConnArenaFootprint;
+
     //
     // Per-processor performance counters.
     //
@@ -120,6 +126,16 @@ QuicPartitionUninitialize(
     _Inout_ QUIC_PARTITION* Partition
     );
 
+//
+// Sums the allocation statistics of all the partition's pools.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPartitionGetPoolStatistics(
+    _In_ const QUIC_PARTITION* Partition,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    );
+
 //
 // Returns the current stateless retry key.
 //
@@ -42,14 +42,18 @@
 // Internal Core Headers.
 //
 #include "quicdef.h"
+#include "conn_arena.h"
 #include "cid.h"
+#include "cid_table.h"
 #include "mtu_discovery.h"
 #include "path.h"
 #include "transport_params.h"
 #include "lookup.h"
+#include "listener_index.h"
 #include "timer_wheel.h"
 #include "settings.h"
 #include "sent_packet_metadata.h"
+#include "sent_packet_ring.h"
 #include "partition.h"
 #include "library.h"
 #include "operation.h"
@@ -60,6 +64,7 @@
 #include "range.h"
 #include "recv_buffer.h"
 #include "send_buffer.h"
+#include "send_request_index.h"
 #include "frame.h"
 #include "packet.h"
 #include "worker.h"
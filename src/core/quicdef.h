@@ -109,6 +109,17 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MIN_REORDERING_THRESHOLD           1
 
+//
+// The number of ACKs per round trip we ask the peer to send, via the
+// ACK_FREQUENCY frame, once the congestion window is large enough.
+//
+#define QUIC_ACK_FREQUENCY_ACKS_PER_RTT         4
+
+//
+// The largest packet tolerance we ask the peer to use.
+//
+#define QUIC_MAX_PEER_PACKET_TOLERANCE          64
+
 //
 // The size of the stateless reset token.
 //
@@ -153,6 +164,25 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_WORKER_QUEUE_DELAY             250
 
+//
+// When work stealing is enabled, the fraction (1 / N) of the maximum worker
+// queue delay a worker's average queue delay must reach before idle sibling
+// workers take connections from it.
+//
+#define QUIC_WORKER_STEAL_DELAY_DIVISOR         16
+
+//
+// How long (in us) a worker that took a connection from a sibling is not
+// itself stolen from, to keep connections from bouncing between workers.
+//
+#define QUIC_WORKER_STEAL_HOLD_TIME_US          100000
+
+//
+// How often (in us) workers free what the bindings' lookups retired, while
+// there is anything waiting.
+//
+#define QUIC_LOOKUP_RECLAIM_INTERVAL_US         10000
+
 //
 // The maximum number of simultaneous stateless operations that can be queued on
 // a single worker.
@@ -200,6 +230,27 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_CRYPTO_BATCH_COUNT             8
 
+//
+// The maximum number of stream payload ranges, across a crypto batch, that are
+// encrypted straight from the app's send buffers instead of being copied into
+// the packets first.
+//
+#define QUIC_MAX_CRYPTO_EXTENT_COUNT            8
+
+//
+// Stream payload ranges shorter than this are just copied into the packet. The
+// packet stays hot in the cache, so for the usual MTUs copying is cheaper than
+// the extra cipher calls needed to encrypt from a separate buffer.
+//
+#define QUIC_MIN_CRYPTO_EXTENT_LENGTH           4096
+
+//
+// The number of queued send requests a search for a stream offset may walk
+// past before the stream indexes its send requests. Retransmissions on streams
+// with deep send queues then find their data with a binary search instead.
+//
+#define QUIC_SEND_REQUEST_INDEX_THRESHOLD       16
+
 //
 // The maximum number of received packets that may be processed in a single
 // flush operation.
@@ -401,6 +452,12 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_SEND_PACING_INTERVAL               1000
 
+//
+// The maximum number of microseconds ahead of time that paced sends are handed
+// to the datapath, when pacing is offloaded to it.
+//
+#define QUIC_SEND_PACING_OFFLOAD_HORIZON        4000
+
 //
 // The maximum number of bytes to send in a given key phase
 // before performing a key phase update. Roughly, 274GB.
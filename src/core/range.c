@@ -8,6 +8,12 @@ Abstract:
     A set of unique 64-bit values, stored as an array of subranges ordered from
     smallest to largest.
 
+    The free space in the allocation may be both before and after the array.
+    Subranges are inserted or removed by moving whichever part of the array
+    before or after them is shorter, so dropping the smallest subranges (e.g.
+    as the holes in the acknowledged ranges of a stream's data get filled)
+    doesn't move the rest of the array.
+
 --*/
 
 #include "precomp.h"
@@ -15,6 +21,20 @@ Abstract:
 #include "range.c.clog.h"
 #endif
 
+//
+// Frees the subranges' allocation, which starts before the array if there is
+// free space at the front.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeFreeSubRanges(
+    _In_ QUIC_RANGE* Range
+    )
+{
+    QUIC_SUBRANGE* Allocation = Range->SubRanges - Range->FrontFreeLength;
+    CXPLAT_FREE(Allocation, QUIC_POOL_RANGE);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRangeInitialize(
@@ -27,6 +47,7 @@ QuicRangeInitialize(
     Range->MaxAllocSize = MaxAllocSize;
     CXPLAT_FRE_ASSERT(sizeof(QUIC_SUBRANGE) * QUIC_RANGE_INITIAL_SUB_COUNT < MaxAllocSize);
     Range->SubRanges = Range->PreAllocSubRanges;
+    Range->FrontFreeLength = 0;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -36,7 +57,7 @@ QuicRangeUninitialize(
     )
 {
     if (Range->AllocLength != QUIC_RANGE_INITIAL_SUB_COUNT) {
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QuicRangeFreeSubRanges(Range);
     }
 }
 
@@ -47,6 +68,8 @@ QuicRangeReset(
     )
 {
     Range->UsedLength = 0;
+    Range->SubRanges -= Range->FrontFreeLength;
+    Range->FrontFreeLength = 0;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -109,10 +132,11 @@ QuicRangeGrow(
     }
 
     if (Range->AllocLength != QUIC_RANGE_INITIAL_SUB_COUNT) {
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QuicRangeFreeSubRanges(Range);
     }
     Range->SubRanges = NewSubRanges;
     Range->AllocLength = NewAllocLength;
+    Range->FrontFreeLength = 0;
     Range->UsedLength++; // For the next write index.
 
     return TRUE;
@@ -131,7 +155,38 @@ QuicRangeMakeSpace(
 {
     CXPLAT_DBG_ASSERT(*Index <= Range->UsedLength);
 
-    if (Range->UsedLength == Range->AllocLength) {
+    if (Range->FrontFreeLength != 0) {
+        if (*Index < Range->UsedLength - *Index) {
+            //
+            // Fewer subranges before the index than after it, so move those
+            // down into the free space at the front.
+            //
+            Range->SubRanges--;
+            Range->FrontFreeLength--;
+            memmove(
+                Range->SubRanges,
+                Range->SubRanges + 1,
+                *Index * sizeof(QUIC_SUBRANGE));
+            Range->UsedLength++; // For the new write.
+            return Range->SubRanges + *Index;
+        }
+
+        if (Range->FrontFreeLength + Range->UsedLength == Range->AllocLength) {
+            //
+            // All the free space is at the front. Move the array down by half
+            // of it, so the next inserts near the end are cheap too.
+            //
+            const uint32_t Shift = (Range->FrontFreeLength + 1) / 2;
+            memmove(
+                Range->SubRanges - Shift,
+                Range->SubRanges,
+                Range->UsedLength * sizeof(QUIC_SUBRANGE));
+            Range->SubRanges -= Shift;
+            Range->FrontFreeLength -= Shift;
+        }
+    }
+
+    if (Range->UsedLength + Range->FrontFreeLength == Range->AllocLength) {
         if (!QuicRangeGrow(Range, *Index)) {
             //
             // We either can't or aren't allowed to grow any more. If we weren't
@@ -185,7 +240,19 @@ QuicRangeRemoveSubranges(
     CXPLAT_DBG_ASSERT(Count > 0);
     CXPLAT_DBG_ASSERT(Index + Count <= Range->UsedLength);
 
-    if (Index + Count < Range->UsedLength) {
+    if (Index < Range->UsedLength - Index - Count) {
+        //
+        // Fewer subranges before the removed ones than after them, so move
+        // those up instead.
+        //
+        memmove(
+            Range->SubRanges + Count,
+            Range->SubRanges,
+            Index * sizeof(QUIC_SUBRANGE));
+        Range->SubRanges += Count;
+        Range->FrontFreeLength += Count;
+
+    } else if (Index + Count < Range->UsedLength) {
         memmove(
             Range->SubRanges + Index,
             Range->SubRanges + Index + Count,
@@ -214,9 +281,10 @@ QuicRangeRemoveSubranges(
             NewSubRanges,
             Range->SubRanges,
             Range->UsedLength * sizeof(QUIC_SUBRANGE));
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QuicRangeFreeSubRanges(Range);
         Range->SubRanges = NewSubRanges;
         Range->AllocLength = NewAllocLength;
+        Range->FrontFreeLength = 0;
         return TRUE;
     }
 
@@ -363,12 +431,11 @@ QuicRangeAddRange(
 
         uint32_t RemoveCount = j - (i + 1);
         if (RemoveCount != 0) {
-            if (QuicRangeRemoveSubranges(Range, i + 1, RemoveCount)) {
-                //
-                // The subranges were reallocated, so update our Sub pointer.
-                //
-                Sub = QuicRangeGet(Range, i);
-            }
+            //
+            // The subranges may have moved, so update our Sub pointer.
+            //
+            (void)QuicRangeRemoveSubranges(Range, i + 1, RemoveCount);
+            Sub = QuicRangeGet(Range, i);
         }
     }
 
@@ -428,11 +495,12 @@ QuicRangeRemoveRange(
         // and the second part will be handled by the "left edge
         // overlaps" case.
         //
+        const QUIC_SUBRANGE Copy = *Sub;
         QUIC_SUBRANGE* NewSub = QuicRangeMakeSpace(Range, &i);
         if (NewSub == NULL) {
             return FALSE;
         }
-        *NewSub = *Sub;
+        *NewSub = Copy;
         Sub = NewSub;
     }
 
@@ -45,9 +45,10 @@ QuicRangeGetHigh(
 typedef struct QUIC_RANGE {
 
     //
-    // Array of subranges that represent the set of intervals.
+    // Array of subranges that represent the set of intervals. It starts
+    // 'FrontFreeLength' subranges into the allocation.
     //
-    _Field_size_(AllocLength)
+    _Field_size_(AllocLength - FrontFreeLength)
     QUIC_SUBRANGE* SubRanges;
 
     //
@@ -67,6 +68,14 @@ typedef struct QUIC_RANGE {
     _Field_range_(sizeof(QUIC_SUBRANGE), sizeof(QUIC_SUBRANGE) * QUIC_MAX_RANGE_ALLOC_SIZE)
     uint32_t MaxAllocSize;
 
+    //
+    // The number of free subranges in the allocation before the 'SubRanges'
+    // array. Removing subranges from the front of the array, or inserting
+    // subranges in the first half of it, grows or uses up this space instead
+    // of moving all the following subranges.
+    //
+    uint32_t FrontFreeLength;
+
     //
     // Allocates a number of subranges along with the parent object.
     //
@@ -300,7 +309,8 @@ QuicRangeAddRange(
 
 //
 // Removes a number of subranges from the range. Returns TRUE if the list was
-// shrunk (reallocated) because of the removal operation.
+// shrunk (reallocated) because of the removal operation. Subranges may move
+// even if it wasn't, so previously returned subranges must be looked up again.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
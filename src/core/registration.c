@@ -485,10 +485,10 @@ QuicRegistrationAcceptConnection(
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-void
-QuicRegistrationQueueNewConnection(
+QUIC_WORKER*
+QuicRegistrationGetPartitionWorker(
     _In_ QUIC_REGISTRATION* Registration,
-    _In_ QUIC_CONNECTION* Connection
+    _In_ const QUIC_CONNECTION* Connection
     )
 {
     uint16_t Index =
@@ -498,8 +498,18 @@ QuicRegistrationQueueNewConnection(
     // TODO - Look for other worker instead if the proposed worker is overloaded?
     //
 
+    return &Registration->WorkerPool->Workers[Index];
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRegistrationQueueNewConnection(
+    _In_ QUIC_REGISTRATION* Registration,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
     QuicWorkerAssignConnection(
-        &Registration->WorkerPool->Workers[Index],
+        QuicRegistrationGetPartitionWorker(Registration, Connection),
         Connection);
 }
 
@@ -250,6 +250,16 @@ QuicRegistrationAcceptConnection(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Returns the worker for the connection's partition.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_WORKER*
+QuicRegistrationGetPartitionWorker(
+    _In_ QUIC_REGISTRATION* Registration,
+    _In_ const QUIC_CONNECTION* Connection
+    );
+
 //
 // Queues a new (client or server) connection to be processed. The worker that
 // the connection is queued on is determined by the connection's partition ID.
@@ -913,7 +913,10 @@ QuicSendWriteFrames(
             QUIC_ACK_FREQUENCY_EX Frame;
             Frame.SequenceNumber = Connection->SendAckFreqSeqNum;
             Frame.AckElicitingThreshold = Connection->PeerPacketTolerance;
-            Frame.RequestedMaxAckDelay = MS_TO_US(QuicConnGetAckDelay(Connection));
+            Frame.RequestedMaxAckDelay =
+                Connection->PeerAckDelayUs != 0 ?
+                    Connection->PeerAckDelayUs :
+                    MS_TO_US(QuicConnGetAckDelay(Connection));
             Frame.ReorderingThreshold = Connection->PeerReorderingThreshold;
 
             if (QuicAckFrequencyFrameEncode(
@@ -934,6 +937,19 @@ QuicSendWriteFrames(
             }
         }
 
+        if (Send->SendFlags & QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK) {
+
+            if (Builder->DatagramLength < AvailableBufferLength) {
+                Builder->Datagram->Buffer[Builder->DatagramLength++] = QUIC_FRAME_IMMEDIATE_ACK;
+                Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK;
+                if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_IMMEDIATE_ACK, TRUE)) {
+                    return TRUE;
+                }
+            } else {
+                RanOutOfRoom = TRUE;
+            }
+        }
+
         if (Send->SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) {
             RanOutOfRoom = QuicDatagramWriteFrame(&Connection->Datagram, Builder);
             if (Builder->Metadata->FrameCount == QUIC_MAX_FRAMES_PER_PACKET) {
@@ -1333,16 +1349,34 @@ QuicSendFlush(
             SendFlags &= QUIC_CONN_SEND_FLAGS_BYPASS_CC;
             if (!SendFlags) {
                 if (QuicCongestionControlCanSend(&Connection->CongestionControl)) {
+                    if (QuicPacketBuilderAddPacingInterval(&Builder)) {
+                        //
+                        // The datapath holds the next pacing chunk until its
+                        // departure time, so keep writing it now.
+                        //
+                        continue;
+                    }
+
                     //
                     // The current pacing chunk is finished. We need to schedule a
-                    // new pacing send.
+                    // new pacing send. If later chunks are already queued in the
+                    // datapath, wake up one interval before the last one leaves.
                     //
+                    uint64_t PacingDelay = QUIC_SEND_PACING_INTERVAL;
+                    if (Builder.TxTime != 0) {
+                        const uint64_t TimeNow = CxPlatTimeUs64();
+                        if (CxPlatTimeAtOrBefore64(
+                                TimeNow + 2 * QUIC_SEND_PACING_INTERVAL, Builder.TxTime)) {
+                            PacingDelay =
+                                CxPlatTimeDiff64(TimeNow, Builder.TxTime) - QUIC_SEND_PACING_INTERVAL;
+                        }
+                    }
                     QuicConnAddOutFlowBlockedReason(
                         Connection, QUIC_FLOW_BLOCKED_PACING);
                     QuicConnTimerSet(
                         Connection,
                         QUIC_CONN_TIMER_PACING,
-                        QUIC_SEND_PACING_INTERVAL);
+                        PacingDelay);
                     Result = QUIC_SEND_DELAYED_PACING;
                 } else {
                     //
@@ -1501,14 +1535,15 @@ QuicSendFlush(
         //
         QuicSendQueueFlush(&Connection->Send, REASON_SCHEDULING);
 
-        if (Builder.TotalCountDatagrams + 1 > Connection->PeerPacketTolerance) {
+        if (Builder.TotalCountDatagrams + 1 > Connection->PeerMinPacketTolerance) {
             //
-            // We're scheduling limited, so we should tell the peer to use our
-            // (max) batch size + 1 as the peer tolerance as a hint that they
-            // should expect more than a single batch before needing to send an
-            // acknowledgment back.
+            // We're scheduling limited, so we should tell the peer to use at
+            // least our (max) batch size + 1 as the peer tolerance as a hint
+            // that they should expect more than a single batch before needing
+            // to send an acknowledgment back.
             //
-            QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams + 1);
+            Connection->PeerMinPacketTolerance = (uint8_t)(Builder.TotalCountDatagrams + 1);
+            QuicConnUpdatePeerAckFrequency(Connection);
         }
 
     } else if (Builder.TotalCountDatagrams > Connection->PeerPacketTolerance) {
@@ -1518,7 +1553,8 @@ QuicSendFlush(
         // packets.
         //
         // Temporarily disabled for now.
-        //QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams);
+        //Connection->PeerMinPacketTolerance = Builder.TotalCountDatagrams;
+        //QuicConnUpdatePeerAckFrequency(Connection);
     }
 
     //
@@ -145,6 +145,7 @@ QuicPacketTypeToEncryptLevelV2(
 #define QUIC_CONN_SEND_FLAG_ACK_FREQUENCY           0x00008000U
 #define QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED    0x00010000U
 #define QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED     0x00020000U
+#define QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK           0x00040000U
 #define QUIC_CONN_SEND_FLAG_DPLPMTUD                0x80000000U
 
 //
@@ -174,6 +175,7 @@ QuicPacketTypeToEncryptLevelV2(
     QUIC_CONN_SEND_FLAG_PING | \
     QUIC_CONN_SEND_FLAG_DATAGRAM | \
     QUIC_CONN_SEND_FLAG_ACK_FREQUENCY | \
+    QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK | \
     QUIC_CONN_SEND_FLAG_DPLPMTUD | \
     QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED | \
     QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED \
@@ -0,0 +1,152 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the index of a stream's queued send
+    requests.
+
+--*/
+
+#include "precomp.h"
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendRequestIndexInitialize(
+    _Out_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_opt_ QUIC_SEND_REQUEST* Requests
+    )
+{
+    uint32_t Count = 0;
+    for (QUIC_SEND_REQUEST* Req = Requests; Req != NULL; Req = Req->Next) {
+        Count++;
+    }
+
+    Index->Start = 0;
+    Index->End = 0;
+    Index->Capacity = QUIC_SEND_REQUEST_INDEX_MIN_CAPACITY;
+    while (Index->Capacity < 2 * Count) {
+        Index->Capacity *= 2;
+    }
+    Index->Requests =
+        CXPLAT_ALLOC_NONPAGED(
+            Index->Capacity * sizeof(QUIC_SEND_REQUEST*),
+            QUIC_POOL_SEND_REQUEST_INDEX);
+    if (Index->Requests == NULL) {
+        Index->Capacity = 0;
+        return FALSE;
+    }
+
+    for (QUIC_SEND_REQUEST* Req = Requests; Req != NULL; Req = Req->Next) {
+        Index->Requests[Index->End++] = Req;
+    }
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRequestIndexUninitialize(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index
+    )
+{
+    if (Index->Requests != NULL) {
+        CXPLAT_FREE(Index->Requests, QUIC_POOL_SEND_REQUEST_INDEX);
+        Index->Requests = NULL;
+    }
+    Index->Start = 0;
+    Index->End = 0;
+    Index->Capacity = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendRequestIndexAppend(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ QUIC_SEND_REQUEST* Request
+    )
+{
+    CXPLAT_DBG_ASSERT(Index->Requests != NULL);
+    CXPLAT_DBG_ASSERT(
+        Index->Start == Index->End ||
+        Index->Requests[Index->End - 1]->StreamOffset <= Request->StreamOffset);
+
+    if (Index->End == Index->Capacity) {
+        const uint32_t Count = Index->End - Index->Start;
+        if (Count <= Index->Capacity / 2) {
+            //
+            // At least half the array was freed from the front, so just move
+            // the requests back down.
+            //
+            CxPlatMoveMemory(
+                Index->Requests,
+                Index->Requests + Index->Start,
+                Count * sizeof(QUIC_SEND_REQUEST*));
+
+        } else {
+            const uint32_t NewCapacity = Index->Capacity * 2;
+            QUIC_SEND_REQUEST** NewRequests =
+                CXPLAT_ALLOC_NONPAGED(
+                    NewCapacity * sizeof(QUIC_SEND_REQUEST*),
+                    QUIC_POOL_SEND_REQUEST_INDEX);
+            if (NewRequests == NULL) {
+                QuicSendRequestIndexUninitialize(Index);
+                return FALSE;
+            }
+            CxPlatCopyMemory(
+                NewRequests,
+                Index->Requests + Index->Start,
+                Count * sizeof(QUIC_SEND_REQUEST*));
+            CXPLAT_FREE(Index->Requests, QUIC_POOL_SEND_REQUEST_INDEX);
+            Index->Requests = NewRequests;
+            Index->Capacity = NewCapacity;
+        }
+        Index->Start = 0;
+        Index->End = Count;
+    }
+
+    Index->Requests[Index->End++] = Request;
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRequestIndexRemoveFirst(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ const QUIC_SEND_REQUEST* Request
+    )
+{
+    CXPLAT_DBG_ASSERT(Index->Start < Index->End);
+    CXPLAT_DBG_ASSERT(Index->Requests[Index->Start] == Request);
+    UNREFERENCED_PARAMETER(Request);
+    if (++Index->Start == Index->End) {
+        Index->Start = Index->End = 0;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Ret_maybenull_
+QUIC_SEND_REQUEST*
+QuicSendRequestIndexFind(
+    _In_ const QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ uint64_t Offset
+    )
+{
+    //
+    // Binary search for the first request starting after the offset. The one
+    // before it is the last one starting at or before it.
+    //
+    uint32_t Low = Index->Start;
+    uint32_t High = Index->End;
+    while (Low < High) {
+        const uint32_t Mid = Low + (High - Low) / 2;
+        if (Index->Requests[Mid]->StreamOffset <= Offset) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    return Low == Index->Start ? NULL : Index->Requests[Low - 1];
+}
@@ -0,0 +1,107 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    An index of a stream's queued send requests, in stream offset order, used
+    to find the request containing a given offset (e.g. for a retransmission)
+    with a binary search instead of walking the request list.
+
+    Requests are only ever appended at the tail (as they are queued) and
+    removed from the head (as they are completed), so the index is a simple
+    array of request pointers with a moving start.
+
+    The index isn't thread safe; it's used from the connection's context only.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_SEND_REQUEST QUIC_SEND_REQUEST;
+
+//
+// The initial capacity of the index.
+//
+#define QUIC_SEND_REQUEST_INDEX_MIN_CAPACITY    64
+
+typedef struct QUIC_SEND_REQUEST_INDEX {
+
+    //
+    // The indexed requests, from Start to End (exclusive). NULL if the index
+    // isn't in use.
+    //
+    QUIC_SEND_REQUEST** Requests;
+
+    uint32_t Start;
+    uint32_t End;
+    uint32_t Capacity;
+
+} QUIC_SEND_REQUEST_INDEX;
+
+//
+// Indexes the given list of requests. Returns FALSE if the index couldn't be
+// allocated, in which case it isn't in use.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendRequestIndexInitialize(
+    _Out_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_opt_ QUIC_SEND_REQUEST* Requests
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRequestIndexUninitialize(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index
+    );
+
+QUIC_INLINE
+BOOLEAN
+QuicSendRequestIndexInUse(
+    _In_ const QUIC_SEND_REQUEST_INDEX* Index
+    )
+{
+    return Index->Requests != NULL;
+}
+
+//
+// Adds a request queued after all the indexed ones. If the index can't grow,
+// it is uninitialized and FALSE is returned.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendRequestIndexAppend(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ QUIC_SEND_REQUEST* Request
+    );
+
+//
+// Removes the first indexed request, which must be the given one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendRequestIndexRemoveFirst(
+    _Inout_ QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ const QUIC_SEND_REQUEST* Request
+    );
+
+//
+// Returns the last request starting at or before the offset (i.e. the one
+// containing it, unless it's past all the queued data), or NULL if the
+// offset is before all of them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Ret_maybenull_
+QUIC_SEND_REQUEST*
+QuicSendRequestIndexFind(
+    _In_ const QUIC_SEND_REQUEST_INDEX* Index,
+    _In_ uint64_t Offset
+    );
+
+#if defined(__cplusplus)
+}
+#endif
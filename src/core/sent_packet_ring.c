@@ -0,0 +1,238 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The following functions implement the ring of outstanding sent packets.
+
+--*/
+
+#include "precomp.h"
+
+CXPLAT_STATIC_ASSERT(
+    QUIC_SENT_PACKET_RING_MIN_CAPACITY % 64 == 0,
+    "Each word of the bitmap covers slots in one pass around the ring");
+
+//
+// Returns the index of the lowest bit set in a (non-zero) bitmap.
+//
+QUIC_INLINE
+uint32_t
+QuicSentPacketRingLowestSlot(
+    _In_ uint64_t Bitmap
+    )
+{
+    CXPLAT_DBG_ASSERT(Bitmap != 0);
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long Index;
+    _BitScanForward64(&Index, Bitmap);
+    return Index;
+#elif defined(_MSC_VER)
+    unsigned long Index;
+    if ((uint32_t)Bitmap != 0) {
+        _BitScanForward(&Index, (uint32_t)Bitmap);
+        return Index;
+    }
+    _BitScanForward(&Index, (uint32_t)(Bitmap >> 32));
+    return 32 + Index;
+#else
+    return (uint32_t)__builtin_ctzll(Bitmap);
+#endif
+}
+
+//
+// Reallocates the slots to fit a packet Index slots after the first one,
+// moving each packet to its slot in the new array.
+//
+static
+BOOLEAN
+QuicSentPacketRingResize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t Index
+    )
+{
+    if (Index >= UINT32_MAX / 2) {
+        return FALSE;
+    }
+    uint32_t NewCapacity =
+        Ring->Capacity == 0 ? QUIC_SENT_PACKET_RING_MIN_CAPACITY : Ring->Capacity;
+    while (NewCapacity <= Index) {
+        NewCapacity *= 2;
+    }
+    QUIC_SENT_PACKET_METADATA** NewPackets =
+        CXPLAT_ALLOC_NONPAGED(
+            NewCapacity * sizeof(QUIC_SENT_PACKET_METADATA*) + NewCapacity / 8,
+            QUIC_POOL_SENT_PACKET_RING);
+    if (NewPackets == NULL) {
+        return FALSE;
+    }
+    uint64_t* NewOccupied = (uint64_t*)(NewPackets + NewCapacity);
+    CxPlatZeroMemory(
+        NewPackets, NewCapacity * sizeof(QUIC_SENT_PACKET_METADATA*) + NewCapacity / 8);
+    for (uint64_t PacketNumber = Ring->FirstPacketNumber;
+         PacketNumber < Ring->FirstPacketNumber + Ring->Length;
+         ++PacketNumber) {
+        QUIC_SENT_PACKET_METADATA* Packet =
+            Ring->Packets[PacketNumber & (Ring->Capacity - 1)];
+        if (Packet != NULL) {
+            const uint32_t Slot = (uint32_t)PacketNumber & (NewCapacity - 1);
+            NewPackets[Slot] = Packet;
+            NewOccupied[Slot / 64] |= 1ull << (Slot % 64);
+        }
+    }
+    if (Ring->Packets != NULL) {
+        CXPLAT_FREE(Ring->Packets, QUIC_POOL_SENT_PACKET_RING);
+    }
+    Ring->Packets = NewPackets;
+    Ring->Occupied = NewOccupied;
+    Ring->Capacity = NewCapacity;
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingInitialize(
+    _Out_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    Ring->List = NULL;
+    Ring->ListTail = &Ring->List;
+    Ring->Packets = NULL;
+    Ring->Occupied = NULL;
+    Ring->FirstPacketNumber = 0;
+    Ring->Length = 0;
+    Ring->Capacity = 0;
+    Ring->Count = 0;
+    Ring->Indexed = FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    CXPLAT_DBG_ASSERT(Ring->Count == 0);
+    if (Ring->Packets != NULL) {
+        CXPLAT_FREE(Ring->Packets, QUIC_POOL_SENT_PACKET_RING);
+        Ring->Packets = NULL;
+        Ring->Occupied = NULL;
+    }
+    Ring->Capacity = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Ret_maybenull_
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingFind(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    )
+{
+    CXPLAT_DBG_ASSERT(Ring->Indexed);
+    CXPLAT_DBG_ASSERT(PacketNumber >= Ring->FirstPacketNumber);
+    const uint64_t End = Ring->FirstPacketNumber + Ring->Length;
+    while (PacketNumber < End) {
+        const uint32_t Slot = (uint32_t)PacketNumber & (Ring->Capacity - 1);
+        const uint64_t Bitmap = Ring->Occupied[Slot / 64] >> (Slot % 64);
+        if (Bitmap != 0) {
+            PacketNumber += QuicSentPacketRingLowestSlot(Bitmap);
+            break;
+        }
+        PacketNumber += 64 - (Slot % 64);
+    }
+
+    //
+    // A bit found past the end of the ring is for one of the first packets,
+    // wrapped around into the same word, not a later one.
+    //
+    return
+        PacketNumber < End ?
+            Ring->Packets[PacketNumber & (Ring->Capacity - 1)] : NULL;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSentPacketRingAddSlow(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    if (Ring->Indexed) {
+        if (!QuicSentPacketRingResize(
+                Ring, Packet->PacketNumber - Ring->FirstPacketNumber)) {
+            return FALSE;
+        }
+        return QuicSentPacketRingAdd(Ring, Packet);
+    }
+
+    //
+    // The list is full, so move its packets into the slots. If they can't be
+    // allocated, the packets just stay in the list until it fills up again.
+    //
+    CXPLAT_DBG_ASSERT(Ring->Count == QUIC_SENT_PACKET_RING_LIST_MAX);
+    const uint64_t FirstPacketNumber = Ring->List->PacketNumber;
+    CXPLAT_DBG_ASSERT(Ring->Length == 0);
+    if (Packet->PacketNumber - FirstPacketNumber >= Ring->Capacity) {
+        if (!QuicSentPacketRingResize(Ring, Packet->PacketNumber - FirstPacketNumber)) {
+            Packet->Next = NULL;
+            *Ring->ListTail = Packet;
+            Ring->ListTail = &Packet->Next;
+            Ring->Count++;
+            return TRUE;
+        }
+    }
+
+    Ring->FirstPacketNumber = FirstPacketNumber;
+    for (QUIC_SENT_PACKET_METADATA* Listed = Ring->List;
+         Listed != NULL;
+         Listed = Listed->Next) {
+        const uint32_t Slot = (uint32_t)Listed->PacketNumber & (Ring->Capacity - 1);
+        Ring->Packets[Slot] = Listed;
+        Ring->Occupied[Slot / 64] |= 1ull << (Slot % 64);
+        Ring->Length = (uint32_t)(Listed->PacketNumber - FirstPacketNumber) + 1;
+    }
+    Ring->List = NULL;
+    Ring->ListTail = &Ring->List;
+    Ring->Indexed = TRUE;
+
+    return QuicSentPacketRingAdd(Ring, Packet);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingRemoveSlow(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    QUIC_SENT_PACKET_METADATA* Packet =
+        QuicSentPacketRingFind(Ring, Ring->FirstPacketNumber);
+    CXPLAT_DBG_ASSERT(Packet != NULL);
+
+    if (Ring->Count > QUIC_SENT_PACKET_RING_LIST_MAX / 2) {
+        //
+        // Move the front up to the next packet.
+        //
+        Ring->Length -= (uint32_t)(Packet->PacketNumber - Ring->FirstPacketNumber);
+        Ring->FirstPacketNumber = Packet->PacketNumber;
+        return;
+    }
+
+    //
+    // Few enough packets are left to move them back to the list.
+    //
+    CXPLAT_DBG_ASSERT(Ring->List == NULL);
+    while (Packet != NULL) {
+        const uint32_t Slot = (uint32_t)Packet->PacketNumber & (Ring->Capacity - 1);
+        Ring->Packets[Slot] = NULL;
+        Ring->Occupied[Slot / 64] &= ~(1ull << (Slot % 64));
+        Packet->Next = NULL;
+        *Ring->ListTail = Packet;
+        Ring->ListTail = &Packet->Next;
+        Packet = QuicSentPacketRingFind(Ring, Packet->PacketNumber + 1);
+    }
+    Ring->Length = 0;
+    Ring->Indexed = FALSE;
+}
@@ -0,0 +1,291 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A ring of outstanding sent packets, indexed by packet number, used by loss
+    detection to find acknowledged packets directly from the ACK ranges and to
+    scan for lost packets over contiguous memory instead of walking a list.
+
+    Packets are only ever added with increasing packet numbers, so the ring
+    covers the packet numbers from the oldest outstanding packet to the newest
+    one added, each in the slot given by its low bits. Slots are NULL for
+    packet numbers that were skipped, or whose packets were acknowledged, lost
+    or discarded, and for all the slots past the newest packet. The front is
+    moved past NULL slots as packets are removed, so the first slot always
+    holds a packet. A bitmap of the slots holding packets lets scans skip over
+    the holes left by acknowledged packets a word at a time.
+
+    With only a few packets outstanding, keeping the slots and the bitmap up
+    to date costs more than walking a list of them does, so until more than
+    QUIC_SENT_PACKET_RING_LIST_MAX packets are outstanding they're kept in a
+    list (linked through their Next) instead, and they go back to the list
+    once no more than half as many are left.
+
+    The ring isn't thread safe; it's used from the connection's context only.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The initial capacity of the ring.
+//
+#define QUIC_SENT_PACKET_RING_MIN_CAPACITY      64
+
+//
+// The most packets kept in the list before they're moved into the ring.
+//
+#define QUIC_SENT_PACKET_RING_LIST_MAX          128
+
+typedef struct QUIC_SENT_PACKET_RING {
+
+    //
+    // The packets, in packet number order, while they aren't in the slots.
+    //
+    QUIC_SENT_PACKET_METADATA* List;
+    QUIC_SENT_PACKET_METADATA** ListTail;
+
+    //
+    // Capacity slots, holding the packets numbered from FirstPacketNumber to
+    // FirstPacketNumber + Length - 1, in the slots given by their packet
+    // numbers modulo Capacity, while Indexed. Capacity is always a power of
+    // 2, at least 64. The array is kept while the packets are in the list.
+    //
+    QUIC_SENT_PACKET_METADATA** Packets;
+
+    //
+    // A bit per slot, set if it holds a packet. Allocated with Packets.
+    //
+    uint64_t* Occupied;
+
+    uint64_t FirstPacketNumber;
+    uint32_t Length;
+    uint32_t Capacity;
+
+    //
+    // The number of packets in the ring.
+    //
+    uint32_t Count;
+
+    //
+    // The packets are in the slots, not the list.
+    //
+    BOOLEAN Indexed;
+
+} QUIC_SENT_PACKET_RING;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingInitialize(
+    _Out_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+//
+// Frees the ring. The packets in it must have already been removed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingUninitialize(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+QUIC_INLINE
+BOOLEAN
+QuicSentPacketRingIsEmpty(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    return Ring->Count == 0;
+}
+
+//
+// Returns the packet with the given packet number, or NULL if it isn't in the
+// ring.
+//
+QUIC_INLINE
+_Ret_maybenull_
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingGet(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (!Ring->Indexed) {
+        QUIC_SENT_PACKET_METADATA* Packet = Ring->List;
+        while (Packet != NULL && Packet->PacketNumber < PacketNumber) {
+            Packet = Packet->Next;
+        }
+        return Packet != NULL && Packet->PacketNumber == PacketNumber ? Packet : NULL;
+    }
+    if (PacketNumber < Ring->FirstPacketNumber ||
+        PacketNumber - Ring->FirstPacketNumber >= Ring->Length) {
+        return NULL;
+    }
+    return Ring->Packets[PacketNumber & (Ring->Capacity - 1)];
+}
+
+//
+// Returns the oldest packet in the ring, or NULL if it's empty.
+//
+QUIC_INLINE
+_Ret_maybenull_
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingFirst(
+    _In_ const QUIC_SENT_PACKET_RING* Ring
+    )
+{
+    return
+        Ring->Indexed ?
+            Ring->Packets[Ring->FirstPacketNumber & (Ring->Capacity - 1)] :
+            Ring->List;
+}
+
+//
+// Returns the packet in the slots numbered at or after the given packet
+// number, which must be in the ring's range, with the smallest packet number,
+// or NULL if there isn't one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Ret_maybenull_
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingFind(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    );
+
+//
+// Returns the packet numbered at or after the given packet number with the
+// smallest packet number, or NULL if there isn't one.
+//
+QUIC_INLINE
+_Ret_maybenull_
+QUIC_SENT_PACKET_METADATA*
+QuicSentPacketRingNext(
+    _In_ const QUIC_SENT_PACKET_RING* Ring,
+    _In_ uint64_t PacketNumber
+    )
+{
+    if (!Ring->Indexed) {
+        QUIC_SENT_PACKET_METADATA* Packet = Ring->List;
+        while (Packet != NULL && Packet->PacketNumber < PacketNumber) {
+            Packet = Packet->Next;
+        }
+        return Packet;
+    }
+    if (PacketNumber < Ring->FirstPacketNumber) {
+        PacketNumber = Ring->FirstPacketNumber;
+    } else if (PacketNumber - Ring->FirstPacketNumber >= Ring->Length) {
+        return NULL;
+    }
+    QUIC_SENT_PACKET_METADATA* Packet =
+        Ring->Packets[PacketNumber & (Ring->Capacity - 1)];
+    return Packet != NULL ? Packet : QuicSentPacketRingFind(Ring, PacketNumber);
+}
+
+//
+// Adds a packet to the ring when it's in the slots but doesn't fit them, or
+// when the list is full. Returns FALSE if the ring couldn't grow to hold it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSentPacketRingAddSlow(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    );
+
+//
+// Adds a packet numbered after all the ones in the ring. Returns FALSE if the
+// ring couldn't grow to hold it.
+//
+QUIC_INLINE
+BOOLEAN
+QuicSentPacketRingAdd(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    if (!Ring->Indexed) {
+        if (Ring->Count == QUIC_SENT_PACKET_RING_LIST_MAX) {
+            return QuicSentPacketRingAddSlow(Ring, Packet);
+        }
+        CXPLAT_DBG_ASSERT(
+            Ring->List == NULL ||
+            Packet->PacketNumber >
+                CXPLAT_CONTAINING_RECORD(
+                    Ring->ListTail, QUIC_SENT_PACKET_METADATA, Next)->PacketNumber);
+        Packet->Next = NULL;
+        *Ring->ListTail = Packet;
+        Ring->ListTail = &Packet->Next;
+        Ring->Count++;
+        return TRUE;
+    }
+
+    CXPLAT_DBG_ASSERT(Packet->PacketNumber >= Ring->FirstPacketNumber + Ring->Length);
+    const uint64_t Index = Packet->PacketNumber - Ring->FirstPacketNumber;
+    if (Index >= Ring->Capacity) {
+        return QuicSentPacketRingAddSlow(Ring, Packet);
+    }
+
+    //
+    // The slots of any skipped packet numbers are already NULL.
+    //
+    const uint32_t Slot = (uint32_t)Packet->PacketNumber & (Ring->Capacity - 1);
+    Ring->Packets[Slot] = Packet;
+    Ring->Occupied[Slot / 64] |= 1ull << (Slot % 64);
+    Ring->Length = (uint32_t)Index + 1;
+    Ring->Count++;
+    return TRUE;
+}
+
+//
+// Finishes removing a packet from the slots, moving the front up to the next
+// packet if it was the first, or moving the packets back to the list if only
+// a few are left.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSentPacketRingRemoveSlow(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring
+    );
+
+//
+// Removes the given packet, which must be in the ring.
+//
+QUIC_INLINE
+void
+QuicSentPacketRingRemove(
+    _Inout_ QUIC_SENT_PACKET_RING* Ring,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    CXPLAT_DBG_ASSERT(QuicSentPacketRingGet(Ring, Packet->PacketNumber) == Packet);
+    Ring->Count--;
+
+    if (!Ring->Indexed) {
+        QUIC_SENT_PACKET_METADATA** Prev = &Ring->List;
+        while (*Prev != Packet) {
+            Prev = &(*Prev)->Next;
+        }
+        if ((*Prev = Packet->Next) == NULL) {
+            Ring->ListTail = Prev;
+        }
+        return;
+    }
+
+    const uint32_t Slot = (uint32_t)Packet->PacketNumber & (Ring->Capacity - 1);
+    Ring->Packets[Slot] = NULL;
+    Ring->Occupied[Slot / 64] &= ~(1ull << (Slot % 64));
+    if (Packet->PacketNumber == Ring->FirstPacketNumber ||
+        Ring->Count <= QUIC_SENT_PACKET_RING_LIST_MAX / 2) {
+        QuicSentPacketRingRemoveSlow(Ring);
+    }
+}
+
+#if defined(__cplusplus)
+}
+#endif
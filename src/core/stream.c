@@ -214,6 +214,7 @@ QuicStreamFree(
 
     CXPLAT_DBG_ASSERT(Stream->ApiSendRequests == NULL);
     CXPLAT_DBG_ASSERT(Stream->SendRequests == NULL);
+    QuicSendRequestIndexUninitialize(&Stream->SendRequestIndex);
 
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_STREAM, &Stream->DbgObjectLink);
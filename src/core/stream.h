@@ -159,6 +159,7 @@ typedef union QUIC_STREAM_FLAGS {
         BOOLEAN InStreamTable           : 1;    // The stream is currently in the connection's table.
         BOOLEAN InWaitingList           : 1;    // The stream is currently in the waiting list for stream id FC.
         BOOLEAN DelayIdFcUpdate         : 1;    // Delay stream ID FC updates to StreamClose.
+        BOOLEAN SendRequestIndexFailed  : 1;    // Indexing the send requests failed; walk them instead.
     };
 } QUIC_STREAM_FLAGS;
 
@@ -321,6 +322,12 @@ typedef struct QUIC_STREAM {
     //
     QUIC_SEND_REQUEST* SendBookmark;
 
+    //
+    // Index of the queued send requests by stream offset. Only in use once a
+    // search (e.g. for a retransmission) had to walk a long request queue.
+    //
+    QUIC_SEND_REQUEST_INDEX SendRequestIndex;
+
     //
     // Shortcut pointer: NULL, or the next unbuffered send request.
     //
@@ -581,6 +581,11 @@ QuicStreamEnqueueSendRequest(
     *Stream->SendRequestsTail = SendRequest;
     Stream->SendRequestsTail = &SendRequest->Next;
 
+    if (QuicSendRequestIndexInUse(&Stream->SendRequestIndex) &&
+        !QuicSendRequestIndexAppend(&Stream->SendRequestIndex, SendRequest)) {
+        Stream->Flags.SendRequestIndexFailed = TRUE;
+    }
+
     QuicTraceLogStreamVerbose(
         SendQueued,
         Stream,
@@ -686,12 +691,15 @@ QuicStreamCopyFromSendRequests(
     _In_ QUIC_STREAM* Stream,
     _In_ uint64_t Offset,
     _Out_writes_bytes_(Len) uint8_t* Buf,
-    _In_range_(>, 0) uint16_t Len
+    _In_range_(>, 0) uint16_t Len,
+    _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
     //
     // Copies up to Len stream bytes starting at Offset from the noncontiguous
-    // send request queue into a contiguous frame buffer.
+    // send request queue into a contiguous frame buffer. Where possible, the
+    // copy is left to the packet builder, which then encrypts the bytes
+    // straight from the request buffers.
     //
 
     CXPLAT_DBG_ASSERT(Len > 0);
@@ -700,19 +708,37 @@ QuicStreamCopyFromSendRequests(
 
     //
     // Find the send request containing the first byte, using the bookmark if
-    // possible (if the caller is requesting bytes before the bookmark, e.g.
-    // for a retransmission, then we have to do a full search).
+    // possible. If the caller is requesting bytes before the bookmark (e.g.
+    // for a retransmission), or far past it, then search the index if there
+    // is one, or else walk the queue from the start. Indexing the queue once
+    // such walks get long keeps retransmissions on deep queues cheap. If the
+    // index can't be allocated, the stream sticks with walking the queue
+    // rather than retrying the allocation on every long walk.
     //
-    QUIC_SEND_REQUEST* Req;
-    if (Stream->SendBookmark != NULL &&
-        Stream->SendBookmark->StreamOffset <= Offset) {
-        Req = Stream->SendBookmark;
-    } else {
-        Req = Stream->SendRequests;
+    QUIC_SEND_REQUEST* Req = Stream->SendBookmark;
+    if (Req == NULL || Req->StreamOffset > Offset ||
+        (QuicSendRequestIndexInUse(&Stream->SendRequestIndex) &&
+         Req->StreamOffset + Req->TotalLength <= Offset)) {
+        Req = NULL;
+        if (QuicSendRequestIndexInUse(&Stream->SendRequestIndex)) {
+            Req = QuicSendRequestIndexFind(&Stream->SendRequestIndex, Offset);
+        }
+        if (Req == NULL) {
+            Req = Stream->SendRequests;
+        }
     }
+    uint32_t Walked = 0;
     while (Req->StreamOffset + Req->TotalLength <= Offset) {
         CXPLAT_DBG_ASSERT(Req->Next);
         Req = Req->Next;
+        Walked++;
+    }
+    if (Walked > QUIC_SEND_REQUEST_INDEX_THRESHOLD &&
+        !QuicSendRequestIndexInUse(&Stream->SendRequestIndex) &&
+        !Stream->Flags.SendRequestIndexFailed &&
+        !QuicSendRequestIndexInitialize(
+            &Stream->SendRequestIndex, Stream->SendRequests)) {
+        Stream->Flags.SendRequestIndexFailed = TRUE;
     }
 
     CXPLAT_DBG_ASSERT(Req);
@@ -743,7 +769,10 @@ QuicStreamCopyFromSendRequests(
         uint32_t BufferLeft = Req->Buffers[CurIndex].Length - (uint32_t)CurOffset;
         uint16_t CopyLength = Len < BufferLeft ? Len : (uint16_t)BufferLeft;
         CXPLAT_DBG_ASSERT(CopyLength > 0);
-        CxPlatCopyMemory(Buf, Req->Buffers[CurIndex].Buffer + CurOffset, CopyLength);
+        const uint8_t* Source = Req->Buffers[CurIndex].Buffer + CurOffset;
+        if (!QuicPacketBuilderAddPayloadExtent(Builder, Buf, Source, CopyLength)) {
+            CxPlatCopyMemory(Buf, Source, CopyLength);
+        }
         Len -= CopyLength;
         Buf += CopyLength;
 
@@ -782,9 +811,10 @@ QuicStreamWriteOneFrame(
     _Inout_ uint16_t* FramePayloadBytes,
     _Inout_ uint16_t* FrameBytes,
     _Out_writes_bytes_(*FrameBytes) uint8_t* Buffer,
-    _Inout_ QUIC_SENT_PACKET_METADATA* PacketMetadata
+    _Inout_ QUIC_PACKET_BUILDER* Builder
     )
 {
+    QUIC_SENT_PACKET_METADATA* PacketMetadata = Builder->Metadata;
     QUIC_STREAM_EX Frame = { FALSE, ExplicitDataLength, Stream->ID, Offset, 0, NULL };
     uint16_t HeaderLength = 0;
 
@@ -820,7 +850,7 @@ QuicStreamWriteOneFrame(
         }
         Frame.Data = Buffer + HeaderLength;
         QuicStreamCopyFromSendRequests(
-            Stream, Offset, (uint8_t*)Frame.Data, (uint16_t)Frame.Length);
+            Stream, Offset, (uint8_t*)Frame.Data, (uint16_t)Frame.Length, Builder);
         Stream->Connection->Stats.Send.TotalStreamBytes += Frame.Length;
     }
 
@@ -892,12 +922,13 @@ void
 QuicStreamWriteStreamFrames(
     _In_ QUIC_STREAM* Stream,
     _In_ BOOLEAN ExplicitDataLength,
-    _Inout_ QUIC_SENT_PACKET_METADATA* PacketMetadata,
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
     _Inout_ uint16_t* BufferLength,
     _Out_writes_bytes_(*BufferLength) uint8_t* Buffer
     )
 {
     QUIC_SEND* Send = &Stream->Connection->Send;
+    QUIC_SENT_PACKET_METADATA* PacketMetadata = Builder->Metadata;
     uint16_t BytesWritten = 0;
 
     //
@@ -995,7 +1026,7 @@ QuicStreamWriteStreamFrames(
             &FramePayloadBytes,
             &FrameBytes,
             Buffer + BytesWritten,
-            PacketMetadata);
+            Builder);
 
         BOOLEAN ExitLoop = FALSE;
 
@@ -1194,7 +1225,7 @@ QuicStreamSendWrite(
         QuicStreamWriteStreamFrames(
             Stream,
             IsInitial,
-            Builder->Metadata,
+            Builder,
             &StreamFrameLength,
             Builder->Datagram->Buffer + Builder->DatagramLength);
 
@@ -1521,6 +1552,9 @@ QuicStreamOnAck(
             Stream->SendRequests = Req->Next;
             if (Stream->SendRequests == NULL) {
                 Stream->SendRequestsTail = &Stream->SendRequests;
+                QuicSendRequestIndexUninitialize(&Stream->SendRequestIndex);
+            } else if (QuicSendRequestIndexInUse(&Stream->SendRequestIndex)) {
+                QuicSendRequestIndexRemoveFirst(&Stream->SendRequestIndex, Req);
             }
 
             QuicStreamCompleteSendRequest(Stream, Req, FALSE, TRUE);
@@ -1646,6 +1680,7 @@ QuicStreamCancelRequests(
         QuicStreamCompleteSendRequest(Stream, Req, TRUE, TRUE);
     }
     Stream->SendRequestsTail = &Stream->SendRequests;
+    QuicSendRequestIndexUninitialize(&Stream->SendRequestIndex);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
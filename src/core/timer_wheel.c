@@ -21,11 +21,15 @@ Abstract:
         The timer wheel itself doesn't care about anything other than that value
         from the connection.
 
-        Slots - This is a very simple hash table of time slots. Each slot holds
-        all connections with a next expiration time modulo the total slot count.
+        Levels - The timer wheel is hierarchical: each level is an array of 64
+        time slots, each the size of the whole level below (1 ms at the lowest
+        level, then 64 ms, ~4 s and ~4.4 min). A connection goes in the lowest
+        level that covers its next expiration time, relative to the time the
+        wheel has been advanced to. Times past the last level go to an overflow
+        list.
 
-        Slot Entry - Each slot is made up of a sorted, doubly-linked list of
-        connections.
+        Slot Entry - Each slot is made up of an unsorted, doubly-linked list of
+        connections. A bitmap per level tracks the slots that may be non-empty.
 
         Next Expiration - Along with all the connections in the timer wheel, the
         timer wheel also explicitly keeps track of the next expiration time and
@@ -35,14 +39,22 @@ Abstract:
     removal of any number of timers (and their associated connection).
 
     Insertion or update consists of getting the next expiration time from the
-    connection, calculating the correct slot and then doing an insert into the
-    slot's sorted list of connections. Additionally, the next expiration is
+    connection, calculating the correct level and slot and then appending to
+    the slot's list of connections. Additionally, the next expiration is
     updated if the new timer is the soonest to expire.
 
     Removal consists of removing the connection from the doubly-linked list and
     updating the timer wheel's next expiration if this connection was currently
     next to expire.
 
+    Advancing the timer wheel expires all the connections in the lowest level's
+    slots that have passed. Whenever the time reaches the start of an upper
+    level's slot, the slot is cascaded: its connections are inserted again,
+    which moves them down to lower levels. Only the lowest level has the
+    precision to know the exact next expiration time; when it's empty, the start
+    of the next upper level slot is used as the next expiration time instead,
+    which is when that slot is cascaded.
+
 --*/
 
 #include "precomp.h"
@@ -50,21 +62,60 @@ Abstract:
 #include "timer_wheel.c.clog.h"
 #endif
 
+#define QUIC_TIMER_WHEEL_SLOT_COUNT \
+    (QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_LEVEL_SLOTS)
+
 //
-// The initial count of slots in the timer wheel.
+// Helper to get the slot index for a given time (in ms) on a level.
 //
-#define QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT     32
+#define TICK_TO_SLOT_INDEX(Tick, Level) \
+    ((uint32_t)((Tick) >> ((Level) * QUIC_TIMER_WHEEL_LEVEL_BITS)) & \
+        (QUIC_TIMER_WHEEL_LEVEL_SLOTS - 1))
 
 //
-// On average, the max number of connections per slot.
+// Returns the index of the lowest slot set in a (non-zero) bitmap.
 //
-#define QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR    32
+QUIC_INLINE
+uint32_t
+QuicTimerWheelLowestSlot(
+    _In_ uint64_t Bitmap
+    )
+{
+    CXPLAT_DBG_ASSERT(Bitmap != 0);
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long Index;
+    _BitScanForward64(&Index, Bitmap);
+    return Index;
+#elif defined(_MSC_VER)
+    unsigned long Index;
+    if ((uint32_t)Bitmap != 0) {
+        _BitScanForward(&Index, (uint32_t)Bitmap);
+        return Index;
+    }
+    _BitScanForward(&Index, (uint32_t)(Bitmap >> 32));
+    return 32 + Index;
+#else
+    return (uint32_t)__builtin_ctzll(Bitmap);
+#endif
+}
 
 //
-// Helper to get the slot index for a given time.
+// Returns the time (in ms) a slot of a level starts at.
 //
-#define TIME_TO_SLOT_INDEX(TimerWheel, TimeUs) \
-    ((US_TO_MS(TimeUs) / 1000) % (TimerWheel)->SlotCount)
+QUIC_INLINE
+uint64_t
+QuicTimerWheelSlotStart(
+    _In_ const QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t Level,
+    _In_ uint32_t Index
+    )
+{
+    const uint32_t Shift = Level * QUIC_TIMER_WHEEL_LEVEL_BITS;
+    const uint32_t ParentShift = Shift + QUIC_TIMER_WHEEL_LEVEL_BITS;
+    return
+        ((TimerWheel->CurrentTick >> ParentShift) << ParentShift) +
+        ((uint64_t)Index << Shift);
+}
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -75,18 +126,20 @@ QuicTimerWheelInitialize(
     TimerWheel->NextExpirationTime = UINT64_MAX;
     TimerWheel->ConnectionCount = 0;
     TimerWheel->NextConnection = NULL;
-    TimerWheel->SlotCount = QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
+    TimerWheel->CurrentTick = US_TO_MS(CxPlatTimeUs64());
+    CxPlatZeroMemory(TimerWheel->Occupied, sizeof(TimerWheel->Occupied));
+    CxPlatListInitializeHead(&TimerWheel->Overflow);
     TimerWheel->Slots =
-        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
+        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
     if (TimerWheel->Slots == NULL) {
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots",
-            QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY));
+            QUIC_TIMER_WHEEL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY));
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_SLOT_COUNT; ++i) {
         CxPlatListInitializeHead(&TimerWheel->Slots[i]);
     }
 
@@ -100,8 +153,10 @@ QuicTimerWheelUninitialize(
     )
 {
     if (TimerWheel->Slots != NULL) {
-        for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
+        for (uint32_t i = 0; i <= QUIC_TIMER_WHEEL_SLOT_COUNT; ++i) {
+            CXPLAT_LIST_ENTRY* ListHead =
+                i == QUIC_TIMER_WHEEL_SLOT_COUNT ?
+                    &TimerWheel->Overflow : &TimerWheel->Slots[i];
             CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
             while (Entry != ListHead) {
                 QUIC_CONNECTION* Connection =
@@ -113,7 +168,7 @@ QuicTimerWheelUninitialize(
                 CXPLAT_DBG_ASSERT(!Connection);
                 Entry = Entry->Flink;
             }
-            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&TimerWheel->Slots[i]));
+            CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(ListHead));
         }
         CXPLAT_TEL_ASSERT(TimerWheel->ConnectionCount == 0);
         CXPLAT_TEL_ASSERT(TimerWheel->NextConnection == NULL);
@@ -123,88 +178,64 @@ QuicTimerWheelUninitialize(
     }
 }
 
+//
+// Inserts the connection in the slot for its expiration time, relative to the
+// time the timer wheel has been advanced to.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelResize(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+QuicTimerWheelInsert(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
     )
 {
-    uint32_t NewSlotCount = TimerWheel->SlotCount * 2;
-    if (NewSlotCount <= TimerWheel->SlotCount) {
-        //
-        // Max size has been reached.
-        //
-        return;
+    uint64_t Tick = US_TO_MS(Connection->EarliestExpirationTime);
+    if (Tick < TimerWheel->CurrentTick) {
+        Tick = TimerWheel->CurrentTick; // Already expired.
     }
 
-    CXPLAT_LIST_ENTRY* NewSlots =
-        CXPLAT_ALLOC_NONPAGED(NewSlotCount * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
-    if (NewSlots == NULL) {
-        QuicTraceEvent(
-            AllocFailure,
-            "Allocation of '%s' failed. (%llu bytes)", "timerwheel slots (realloc)",
-            NewSlotCount * sizeof(CXPLAT_LIST_ENTRY));
-        return;
-    }
-
-    QuicTraceLogVerbose(
-        TimerWheelResize,
-        "[time][%p] Resizing timer wheel (new slot count = %u).",
-        TimerWheel,
-        NewSlotCount);
-
-    for (uint32_t i = 0; i < NewSlotCount; ++i) {
-        CxPlatListInitializeHead(&NewSlots[i]);
+    //
+    // The connection goes in the lowest level where the expiration time and
+    // the current time only differ in the bits of the level's slot index.
+    //
+    const uint64_t Difference = Tick ^ TimerWheel->CurrentTick;
+    for (uint32_t Level = 0; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        if ((Difference >> ((Level + 1) * QUIC_TIMER_WHEEL_LEVEL_BITS)) == 0) {
+            const uint32_t Index = TICK_TO_SLOT_INDEX(Tick, Level);
+            CxPlatListInsertTail(
+                &TimerWheel->Slots[Level * QUIC_TIMER_WHEEL_LEVEL_SLOTS + Index],
+                &Connection->TimerLink);
+            TimerWheel->Occupied[Level] |= 1ull << Index;
+            return;
+        }
     }
 
-    uint32_t OldSlotCount = TimerWheel->SlotCount;
-    CXPLAT_LIST_ENTRY* OldSlots = TimerWheel->Slots;
-
-    TimerWheel->SlotCount = NewSlotCount;
-    TimerWheel->Slots = NewSlots;
-
-    for (uint32_t i = 0; i < OldSlotCount; ++i) {
-        //
-        // Iterate through each old slot, remove all connections and add them
-        // to the new slots.
-        //
-        while (!CxPlatListIsEmpty(&OldSlots[i])) {
-            QUIC_CONNECTION* Connection =
-                CXPLAT_CONTAINING_RECORD(
-                    CxPlatListRemoveHead(&OldSlots[i]),
-                    QUIC_CONNECTION,
-                    TimerLink);
-            uint64_t ExpirationTime = Connection->EarliestExpirationTime;
-            CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-            uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-            //
-            // Insert the connection into the slot, in the correct order. We search
-            // the slot's list in reverse order, with the assumption that most new
-            // timers will on average be later than existing ones.
-            //
-            CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-            CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
-
-            while (Entry != ListHead) {
-                QUIC_CONNECTION* ConnectionEntry =
-                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-                uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-
-                if (ExpirationTime > EntryExpirationTime) {
-                    break;
-                }
-
-                Entry = Entry->Blink;
-            }
+    CxPlatListInsertTail(&TimerWheel->Overflow, &Connection->TimerLink);
+}
 
-            //
-            // Insert after the current entry.
-            //
-            CxPlatListInsertHead(Entry, &Connection->TimerLink);
+//
+// Returns the lowest non-empty slot of the level, out of the given bitmap of
+// its slots, or UINT32_MAX if they're all empty. Clears the bits of the empty
+// slots found along the way.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t
+QuicTimerWheelFindSlot(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t Level,
+    _In_ uint64_t Bitmap
+    )
+{
+    while (Bitmap != 0) {
+        const uint32_t Index = QuicTimerWheelLowestSlot(Bitmap);
+        if (!CxPlatListIsEmpty(
+                &TimerWheel->Slots[Level * QUIC_TIMER_WHEEL_LEVEL_SLOTS + Index])) {
+            return Index;
         }
+        TimerWheel->Occupied[Level] &= ~(1ull << Index);
+        Bitmap &= Bitmap - 1;
     }
-    CXPLAT_FREE(OldSlots, QUIC_POOL_TIMERWHEEL);
+    return UINT32_MAX;
 }
 
 //
@@ -221,25 +252,48 @@ QuicTimerWheelUpdate(
     TimerWheel->NextConnection = NULL;
 
     //
-    // Loop over the slots to find the connection with the earliest
-    // expiration time.
+    // The lowest level slots are all at or after the current time, so the
+    // first non-empty one has the connection with the earliest expiration
+    // time.
     //
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        if (!CxPlatListIsEmpty(&TimerWheel->Slots[i])) {
+    uint32_t Index = QuicTimerWheelFindSlot(TimerWheel, 0, TimerWheel->Occupied[0]);
+    if (Index != UINT32_MAX) {
+        CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[Index];
+        for (CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+            Entry != ListHead;
+            Entry = Entry->Flink) {
             QUIC_CONNECTION* ConnectionEntry =
-                CXPLAT_CONTAINING_RECORD(
-                    TimerWheel->Slots[i].Flink,
-                    QUIC_CONNECTION,
-                    TimerLink);
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
             uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
             if (EntryExpirationTime < TimerWheel->NextExpirationTime) {
                 TimerWheel->NextExpirationTime = EntryExpirationTime;
                 TimerWheel->NextConnection = ConnectionEntry;
             }
         }
+
+    } else {
+        //
+        // Otherwise, wake up when the first upper level slot needs to be
+        // cascaded.
+        //
+        for (uint32_t Level = 1; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+            Index = QuicTimerWheelFindSlot(TimerWheel, Level, TimerWheel->Occupied[Level]);
+            if (Index != UINT32_MAX) {
+                TimerWheel->NextExpirationTime =
+                    MS_TO_US(QuicTimerWheelSlotStart(TimerWheel, Level, Index));
+                break;
+            }
+        }
+        if (TimerWheel->NextExpirationTime == UINT64_MAX &&
+            !CxPlatListIsEmpty(&TimerWheel->Overflow)) {
+            const uint32_t Shift =
+                QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_LEVEL_BITS;
+            TimerWheel->NextExpirationTime =
+                MS_TO_US(((TimerWheel->CurrentTick >> Shift) + 1) << Shift);
+        }
     }
 
-    if (TimerWheel->NextConnection == NULL) {
+    if (TimerWheel->NextExpirationTime == UINT64_MAX) {
         QuicTraceLogVerbose(
             TimerWheelNextExpirationNull,
             "[time][%p] Next Expiration = {NULL}.",
@@ -275,7 +329,12 @@ QuicTimerWheelRemoveConnection(
         Connection->TimerLink.Flink = NULL;
         TimerWheel->ConnectionCount--;
 
-        if (Connection == TimerWheel->NextConnection) {
+        //
+        // N.B. The next expiration time may just be a lower bound, which is
+        // also stale once the timer wheel is empty.
+        //
+        if (Connection == TimerWheel->NextConnection ||
+            TimerWheel->ConnectionCount == 0) {
             QuicTimerWheelUpdate(TimerWheel);
         }
 
@@ -309,12 +368,13 @@ QuicTimerWheelUpdateConnection(
                 TimerWheel,
                 Connection);
 
-            if (Connection == TimerWheel->NextConnection) {
+            TimerWheel->ConnectionCount--;
+            if (Connection == TimerWheel->NextConnection ||
+                TimerWheel->ConnectionCount == 0) {
                 QuicTimerWheelUpdate(TimerWheel);
             }
 
             QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
-            TimerWheel->ConnectionCount--;
             return; // Nothing else to do.
         }
 
@@ -335,33 +395,7 @@ QuicTimerWheelUpdateConnection(
 
     CXPLAT_DBG_ASSERT(ExpirationTime != UINT64_MAX);
     CXPLAT_DBG_ASSERT(!Connection->State.ShutdownComplete);
-    CXPLAT_DBG_ASSERT(TimerWheel->SlotCount != 0);
-    uint32_t SlotIndex = TIME_TO_SLOT_INDEX(TimerWheel, ExpirationTime);
-
-    //
-    // Insert the connection into the slot, in the correct order. We search
-    // the slot's list in reverse order, with the assumption that most new
-    // timers will on average be later than existing ones.
-    //
-    CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[SlotIndex];
-    CXPLAT_LIST_ENTRY* Entry = ListHead->Blink;
-
-    while (Entry != ListHead) {
-        QUIC_CONNECTION* ConnectionEntry =
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-        uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-
-        if (ExpirationTime > EntryExpirationTime) {
-            break;
-        }
-
-        Entry = Entry->Blink;
-    }
-
-    //
-    // Insert after the current entry.
-    //
-    CxPlatListInsertHead(Entry, &Connection->TimerLink);
+    QuicTimerWheelInsert(TimerWheel, Connection);
 
     QuicTraceLogVerbose(
         TimerWheelUpdateConnection,
@@ -384,14 +418,103 @@ QuicTimerWheelUpdateConnection(
     } else if (Connection == TimerWheel->NextConnection) {
         QuicTimerWheelUpdate(TimerWheel);
     }
+}
 
-    //
-    // Resize the timer wheel if we have too many connections for the
-    // current size.
-    //
-    if (TimerWheel->ConnectionCount >
-        TimerWheel->SlotCount * QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR) {
-        QuicTimerWheelResize(TimerWheel);
+//
+// Moves the connections of the slot that expire at or before TimeNow to the
+// output list.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelExpireSlot(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ CXPLAT_LIST_ENTRY* ListHead,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    )
+{
+    CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+    while (Entry != ListHead) {
+        QUIC_CONNECTION* ConnectionEntry =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+        Entry = Entry->Flink;
+        if (ConnectionEntry->EarliestExpirationTime > TimeNow) {
+            continue;
+        }
+        CxPlatListEntryRemove(&ConnectionEntry->TimerLink);
+        CxPlatListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
+        QuicConnAddRef(ConnectionEntry, QUIC_CONN_REF_WORKER);
+        QuicConnRelease(ConnectionEntry, QUIC_CONN_REF_TIMER_WHEEL);
+        TimerWheel->ConnectionCount--;
+    }
+}
+
+//
+// Returns the next time (in ms) an upper level slot (or the overflow list)
+// needs to be cascaded, or UINT64_MAX if there's none.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicTimerWheelNextCascade(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+    )
+{
+    for (uint32_t Level = 1; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        const uint32_t Current = TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, Level);
+        const uint32_t Index =
+            QuicTimerWheelFindSlot(
+                TimerWheel,
+                Level,
+                TimerWheel->Occupied[Level] & ~((2ull << Current) - 1));
+        if (Index != UINT32_MAX) {
+            return QuicTimerWheelSlotStart(TimerWheel, Level, Index);
+        }
+    }
+
+    if (!CxPlatListIsEmpty(&TimerWheel->Overflow)) {
+        const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_LEVEL_BITS;
+        return ((TimerWheel->CurrentTick >> Shift) + 1) << Shift;
+    }
+
+    return UINT64_MAX;
+}
+
+//
+// Called when the current time reaches the start of upper level slots, to
+// move their connections down to the lower levels.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelCascade(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+    )
+{
+    const uint64_t Tick = TimerWheel->CurrentTick;
+    CXPLAT_LIST_ENTRY ListHead;
+    CxPlatListInitializeHead(&ListHead);
+
+    if ((Tick & ((1ull << (QUIC_TIMER_WHEEL_LEVEL_COUNT * QUIC_TIMER_WHEEL_LEVEL_BITS)) - 1)) == 0) {
+        CxPlatListMoveItems(&TimerWheel->Overflow, &ListHead);
+    }
+
+    for (uint32_t Level = 1; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        if ((Tick & ((1ull << (Level * QUIC_TIMER_WHEEL_LEVEL_BITS)) - 1)) != 0) {
+            break; // The slots of the upper levels don't start now either.
+        }
+        const uint32_t Index = TICK_TO_SLOT_INDEX(Tick, Level);
+        CxPlatListMoveItems(
+            &TimerWheel->Slots[Level * QUIC_TIMER_WHEEL_LEVEL_SLOTS + Index],
+            &ListHead);
+        TimerWheel->Occupied[Level] &= ~(1ull << Index);
+    }
+
+    while (!CxPlatListIsEmpty(&ListHead)) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&ListHead),
+                QUIC_CONNECTION,
+                TimerLink);
+        QuicTimerWheelInsert(TimerWheel, Connection);
     }
 }
 
@@ -403,33 +526,60 @@ QuicTimerWheelGetExpired(
     _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
     )
 {
+    uint64_t NowTick = US_TO_MS(TimeNow);
+    if (NowTick < TimerWheel->CurrentTick) {
+        NowTick = TimerWheel->CurrentTick;
+    }
+
     //
-    // Iterate through every slot to find all the connections that now have
-    // expired timers.
+    // Advance the timer wheel to the current time. Every connection in the
+    // lowest level slots passed along the way has expired.
     //
-    BOOLEAN NeedsUpdate = FALSE;
-    for (uint32_t i = 0; i < TimerWheel->SlotCount; ++i) {
-        CXPLAT_LIST_ENTRY* ListHead = &TimerWheel->Slots[i];
-        CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
-        while (Entry != ListHead) {
-            QUIC_CONNECTION* ConnectionEntry =
-                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
-            uint64_t EntryExpirationTime = ConnectionEntry->EarliestExpirationTime;
-            if (EntryExpirationTime > TimeNow) {
-                break;
-            }
-            Entry = Entry->Flink;
-            CxPlatListEntryRemove(&ConnectionEntry->TimerLink);
-            CxPlatListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
-            if (ConnectionEntry == TimerWheel->NextConnection) {
-                NeedsUpdate = TRUE;
-            }
-            QuicConnAddRef(ConnectionEntry, QUIC_CONN_REF_WORKER);
-            QuicConnRelease(ConnectionEntry, QUIC_CONN_REF_TIMER_WHEEL);
-            TimerWheel->ConnectionCount--;
+    while (TimerWheel->CurrentTick < NowTick) {
+        const uint64_t LevelEnd =
+            (TimerWheel->CurrentTick | (QUIC_TIMER_WHEEL_LEVEL_SLOTS - 1)) + 1;
+        const uint32_t First = TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, 0);
+        const uint32_t Last =
+            TICK_TO_SLOT_INDEX((NowTick < LevelEnd ? NowTick : LevelEnd) - 1, 0);
+        uint64_t Bitmap =
+            TimerWheel->Occupied[0] & ((2ull << Last) - 1) & ~((1ull << First) - 1);
+        while (Bitmap != 0) {
+            const uint32_t Index = QuicTimerWheelLowestSlot(Bitmap);
+            QuicTimerWheelExpireSlot(
+                TimerWheel, &TimerWheel->Slots[Index], UINT64_MAX, OutputListHead);
+            TimerWheel->Occupied[0] &= ~(1ull << Index);
+            Bitmap &= Bitmap - 1;
+        }
+
+        if (NowTick < LevelEnd) {
+            TimerWheel->CurrentTick = NowTick;
+            break;
+        }
+
+        //
+        // The lowest level is now empty. Skip ahead to the next upper level
+        // slot to cascade, if it has started.
+        //
+        const uint64_t NextTick = QuicTimerWheelNextCascade(TimerWheel);
+        if (NextTick > NowTick) {
+            TimerWheel->CurrentTick = NowTick;
+            break;
         }
+        TimerWheel->CurrentTick = NextTick;
+        QuicTimerWheelCascade(TimerWheel);
     }
-    if (NeedsUpdate) {
-        QuicTimerWheelUpdate(TimerWheel);
+
+    //
+    // The current slot might also have timers that expire later in this ms.
+    //
+    const uint32_t Index = TICK_TO_SLOT_INDEX(TimerWheel->CurrentTick, 0);
+    if (TimerWheel->Occupied[0] & (1ull << Index)) {
+        QuicTimerWheelExpireSlot(
+            TimerWheel, &TimerWheel->Slots[Index], TimeNow, OutputListHead);
+        if (CxPlatListIsEmpty(&TimerWheel->Slots[Index])) {
+            TimerWheel->Occupied[0] &= ~(1ull << Index);
+        }
     }
+
+    QuicTimerWheelUpdate(TimerWheel);
 }
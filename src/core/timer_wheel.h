@@ -5,12 +5,27 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
+//
+// The timer wheel has several levels of slots. Each level has 64 slots, each
+// the size of the whole level below: 1 ms, 64 ms, ~4 s and ~4.4 min. Timers
+// beyond the last level (~4.7 hours) go to an overflow list.
+//
+#define QUIC_TIMER_WHEEL_LEVEL_BITS     6
+#define QUIC_TIMER_WHEEL_LEVEL_SLOTS    (1 << QUIC_TIMER_WHEEL_LEVEL_BITS)
+#define QUIC_TIMER_WHEEL_LEVEL_COUNT    4
+
 typedef struct QUIC_TIMER_WHEEL {
 
     //
-    // The expiration time (in us) for the next timer in the timer wheel.
+    // The expiration time (in us) for the next timer in the timer wheel. It
+    // may be earlier than the actual next timer if that one is still on an
+    // upper level (see NextConnection).
     //
     uint64_t NextExpirationTime;
 
@@ -20,20 +35,32 @@ typedef struct QUIC_TIMER_WHEEL {
     uint64_t ConnectionCount;
 
     //
-    // The connection with the timer that expires next.
+    // The connection with the timer that expires next, or NULL if only a lower
+    // bound for the next expiration time is known.
     //
     QUIC_CONNECTION* NextConnection;
 
     //
-    // The number of slots in the Slots array.
+    // The time (in ms) the timer wheel has been advanced to.
     //
-    uint32_t SlotCount;
+    uint64_t CurrentTick;
 
     //
-    // An array of slots in the timer wheel.
+    // Per level, the bitmap of the slots that may have connections in them.
+    //
+    uint64_t Occupied[QUIC_TIMER_WHEEL_LEVEL_COUNT];
+
+    //
+    // The slots of all the levels, lowest level first. Each slot is a
+    // (unsorted) list of connections.
     //
     CXPLAT_LIST_ENTRY* Slots;
 
+    //
+    // The connections with timers beyond the last level.
+    //
+    CXPLAT_LIST_ENTRY Overflow;
+
 } QUIC_TIMER_WHEEL;
 
 //
@@ -85,3 +112,7 @@ QuicTimerWheelGetExpired(
     _In_ uint64_t TimeNow,
     _Inout_ CXPLAT_LIST_ENTRY* ListHead
     );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,110 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the ACK frequency requested from the peer.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "AckFrequencyTest.cpp.clog.h"
+#endif
+
+const uint16_t PayloadSize = 1200;
+
+//
+// Congestion window worth Count packets for each ACK we ask for.
+//
+static uint32_t CwndForTolerance(uint32_t Count)
+{
+    return Count * PayloadSize * QUIC_ACK_FREQUENCY_ACKS_PER_RTT;
+}
+
+TEST(AckFrequencyTest, PacketToleranceFromCwnd)
+{
+    ASSERT_EQ(1u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(1), PayloadSize, 0));
+    ASSERT_EQ(2u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(2), PayloadSize, 0));
+    ASSERT_EQ(8u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(8), PayloadSize, 0));
+
+    //
+    // Partial packets don't count.
+    //
+    ASSERT_EQ(2u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(3) - 1, PayloadSize, 0));
+
+    //
+    // Larger datagrams mean fewer packets per congestion window.
+    //
+    ASSERT_EQ(4u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(8), 2 * PayloadSize, 0));
+}
+
+TEST(AckFrequencyTest, PacketToleranceRoundsDown)
+{
+    ASSERT_EQ(2u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(3), PayloadSize, 0));
+    ASSERT_EQ(4u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(7), PayloadSize, 0));
+    ASSERT_EQ(16u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(31), PayloadSize, 0));
+    ASSERT_EQ(32u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(33), PayloadSize, 0));
+}
+
+TEST(AckFrequencyTest, PacketToleranceClamped)
+{
+    ASSERT_EQ(
+        (uint32_t)QUIC_MAX_PEER_PACKET_TOLERANCE,
+        QuicConnCalculatePeerPacketTolerance(
+            CwndForTolerance(QUIC_MAX_PEER_PACKET_TOLERANCE), PayloadSize, 0));
+    ASSERT_EQ(
+        (uint32_t)QUIC_MAX_PEER_PACKET_TOLERANCE,
+        QuicConnCalculatePeerPacketTolerance(
+            CwndForTolerance(QUIC_MAX_PEER_PACKET_TOLERANCE + 1), PayloadSize, 0));
+    ASSERT_EQ(
+        (uint32_t)QUIC_MAX_PEER_PACKET_TOLERANCE,
+        QuicConnCalculatePeerPacketTolerance(
+            CwndForTolerance(1000), PayloadSize, 0));
+    ASSERT_EQ(
+        (uint32_t)QUIC_MAX_PEER_PACKET_TOLERANCE,
+        QuicConnCalculatePeerPacketTolerance(UINT32_MAX, PayloadSize, 0));
+}
+
+TEST(AckFrequencyTest, PacketToleranceMinimum)
+{
+    //
+    // A congestion window smaller than one packet per ACK still gets the
+    // minimum tolerance.
+    //
+    ASSERT_EQ(0u, QuicConnCalculatePeerPacketTolerance(PayloadSize, PayloadSize, 0));
+    ASSERT_EQ(
+        (uint32_t)QUIC_MIN_ACK_SEND_NUMBER,
+        QuicConnCalculatePeerPacketTolerance(
+            PayloadSize, PayloadSize, QUIC_MIN_ACK_SEND_NUMBER));
+
+    //
+    // The minimum wins over both the congestion window and the clamping.
+    //
+    ASSERT_EQ(5u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(4), PayloadSize, 5));
+    ASSERT_EQ(8u, QuicConnCalculatePeerPacketTolerance(CwndForTolerance(8), PayloadSize, 5));
+    ASSERT_EQ(100u, QuicConnCalculatePeerPacketTolerance(UINT32_MAX, PayloadSize, 100));
+}
+
+TEST(AckFrequencyTest, AckDelayFromRtt)
+{
+    const uint64_t MaxAckDelayUs = MS_TO_US(QUIC_TP_MAX_ACK_DELAY_DEFAULT);
+    const uint64_t MinAckDelayUs = 1000;
+
+    ASSERT_EQ(10000u, QuicConnCalculatePeerAckDelay(40000, MaxAckDelayUs, MinAckDelayUs));
+    ASSERT_EQ(2500u, QuicConnCalculatePeerAckDelay(10000, MaxAckDelayUs, MinAckDelayUs));
+
+    //
+    // Never more than the peer's max_ack_delay the PTO accounts for.
+    //
+    ASSERT_EQ(MaxAckDelayUs, QuicConnCalculatePeerAckDelay(200000, MaxAckDelayUs, MinAckDelayUs));
+    ASSERT_EQ(MaxAckDelayUs, QuicConnCalculatePeerAckDelay(UINT64_MAX, MaxAckDelayUs, MinAckDelayUs));
+
+    //
+    // Never less than the peer's min_ack_delay.
+    //
+    ASSERT_EQ(MinAckDelayUs, QuicConnCalculatePeerAckDelay(2000, MaxAckDelayUs, MinAckDelayUs));
+    ASSERT_EQ(MinAckDelayUs, QuicConnCalculatePeerAckDelay(0, MaxAckDelayUs, MinAckDelayUs));
+}
@@ -0,0 +1,411 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the lock-free local CID table.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "CidTableTest.cpp.clog.h"
+#endif
+
+#define CID_LENGTH 8
+
+//
+// Deterministic, well distributed CIDs.
+//
+static void MakeCid(uint64_t Index, uint8_t* Cid) {
+    uint64_t X = Index + 0x9e3779b97f4a7c15ull;
+    X = (X ^ (X >> 30)) * 0xbf58476d1ce4e5b9ull;
+    X = (X ^ (X >> 27)) * 0x94d049bb133111ebull;
+    X ^= X >> 31;
+    CxPlatCopyMemory(Cid, &X, CID_LENGTH);
+}
+
+static QUIC_CONNECTION* MakeConnection(uint64_t Index) {
+    return (QUIC_CONNECTION*)(uintptr_t)((Index + 1) * 8);
+}
+
+struct CidTable {
+    QUIC_CID_TABLE Table;
+    uint32_t Rehashes {0};
+    CidTable(uint32_t InitialCount = 0) {
+        EXPECT_TRUE(QuicCidTableInitialize(&Table, InitialCount));
+    }
+    ~CidTable() {
+        QuicCidTableUninitialize(&Table);
+    }
+    bool Insert(uint64_t Index) {
+        uint8_t Cid[CID_LENGTH];
+        MakeCid(Index, Cid);
+        QUIC_CID_TABLE_STORE* RetiredStore;
+        if (!QuicCidTableInsert(
+                &Table,
+                Cid,
+                CID_LENGTH,
+                CxPlatHashSimple(CID_LENGTH, Cid),
+                MakeConnection(Index),
+                &RetiredStore)) {
+            return false;
+        }
+        if (RetiredStore != NULL) {
+            Rehashes++;
+            QuicCidTableFreeStore(RetiredStore);
+        }
+        return true;
+    }
+    bool Remove(uint64_t Index) {
+        uint8_t Cid[CID_LENGTH];
+        MakeCid(Index, Cid);
+        return
+            QuicCidTableRemove(
+                &Table, Cid, CID_LENGTH, CxPlatHashSimple(CID_LENGTH, Cid)) != FALSE;
+    }
+    QUIC_CONNECTION* Lookup(uint64_t Index) const {
+        uint8_t Cid[CID_LENGTH];
+        MakeCid(Index, Cid);
+        return QuicCidTableLookup(&Table, Cid, CID_LENGTH, CxPlatHashSimple(CID_LENGTH, Cid));
+    }
+    uint32_t SlotCount() const {
+        return (Table.Store->GroupMask + 1) * QUIC_CID_TABLE_GROUP_SIZE;
+    }
+};
+
+TEST(CidTableTest, InsertLookupRemove)
+{
+    const uint32_t Count = 1000;
+    CidTable Table;
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        ASSERT_EQ(nullptr, Table.Lookup(i));
+        ASSERT_TRUE(Table.Insert(i));
+        ASSERT_EQ(MakeConnection(i), Table.Lookup(i));
+    }
+    ASSERT_EQ(Count, Table.Table.Count);
+    ASSERT_NE(0u, Table.Rehashes);
+
+    for (uint32_t i = 0; i < Count; i += 2) {
+        ASSERT_TRUE(Table.Remove(i));
+        ASSERT_FALSE(Table.Remove(i));
+    }
+    ASSERT_EQ(Count / 2, Table.Table.Count);
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (i % 2 == 0) {
+            ASSERT_EQ(nullptr, Table.Lookup(i));
+        } else {
+            ASSERT_EQ(MakeConnection(i), Table.Lookup(i));
+        }
+    }
+}
+
+TEST(CidTableTest, DifferentLengths)
+{
+    CidTable Table;
+    uint8_t Cid[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+    MakeCid(1, Cid);
+    MakeCid(2, Cid + CID_LENGTH);
+
+    //
+    // Prefixes of the same CID are different CIDs.
+    //
+    QUIC_CID_TABLE_STORE* RetiredStore;
+    for (uint8_t Length = 4; Length <= QUIC_MAX_CONNECTION_ID_LENGTH_V1; ++Length) {
+        ASSERT_TRUE(
+            QuicCidTableInsert(
+                &Table.Table,
+                Cid,
+                Length,
+                CxPlatHashSimple(Length, Cid),
+                MakeConnection(Length),
+                &RetiredStore));
+        if (RetiredStore != NULL) {
+            QuicCidTableFreeStore(RetiredStore);
+        }
+    }
+    for (uint8_t Length = 4; Length <= QUIC_MAX_CONNECTION_ID_LENGTH_V1; ++Length) {
+        ASSERT_EQ(
+            MakeConnection(Length),
+            QuicCidTableLookup(&Table.Table, Cid, Length, CxPlatHashSimple(Length, Cid)));
+    }
+    ASSERT_EQ(
+        nullptr,
+        QuicCidTableLookup(&Table.Table, Cid, 3, CxPlatHashSimple(3, Cid)));
+}
+
+TEST(CidTableTest, DeletedSlotsAreReclaimed)
+{
+    CidTable Table;
+
+    //
+    // Keep a small working set while churning through many CIDs. Deleted
+    // slots are only reclaimed by rehashing, which must not grow the table.
+    //
+    const uint32_t WorkingSet = 32;
+    for (uint32_t i = 0; i < WorkingSet; ++i) {
+        ASSERT_TRUE(Table.Insert(i));
+    }
+    const uint32_t SlotCount = Table.SlotCount();
+
+    for (uint32_t i = WorkingSet; i < 100000; ++i) {
+        ASSERT_TRUE(Table.Remove(i - WorkingSet));
+        ASSERT_TRUE(Table.Insert(i));
+    }
+    ASSERT_EQ(WorkingSet, Table.Table.Count);
+    ASSERT_EQ(SlotCount, Table.SlotCount());
+    ASSERT_NE(0u, Table.Rehashes);
+
+    for (uint32_t i = 100000 - WorkingSet; i < 100000; ++i) {
+        ASSERT_EQ(MakeConnection(i), Table.Lookup(i));
+    }
+    ASSERT_EQ(nullptr, Table.Lookup(100000 - WorkingSet - 1));
+}
+
+TEST(CidTableTest, Enumerate)
+{
+    const uint32_t Count = 500;
+    CidTable Table;
+    for (uint32_t i = 0; i < Count; ++i) {
+        ASSERT_TRUE(Table.Insert(i));
+    }
+    for (uint32_t i = 0; i < Count; i += 3) {
+        ASSERT_TRUE(Table.Remove(i));
+    }
+
+    uint64_t Found = 0;
+    uint32_t Index = 0;
+    const QUIC_CID_TABLE_SLOT* Slot;
+    while ((Slot = QuicCidTableEnumerateNext(&Table.Table, &Index)) != NULL) {
+        ASSERT_EQ(CID_LENGTH, Slot->Length);
+        ASSERT_EQ(Slot->Connection, QuicCidTableLookup(
+            &Table.Table, Slot->Data, Slot->Length,
+            CxPlatHashSimple(Slot->Length, Slot->Data)));
+        Found++;
+    }
+    ASSERT_EQ(Table.Table.Count, Found);
+}
+
+struct CidTableReaderContext {
+    QUIC_CID_TABLE* Table;
+    QUIC_CID_EPOCH* Epoch;
+    uint32_t StableCount;
+    BOOLEAN volatile Stop;
+    long Failures;
+    uint64_t Lookups;
+    static CXPLAT_THREAD_CALLBACK(ReaderThread, Context) {
+        auto Ctx = (CidTableReaderContext*)Context;
+        uint64_t i = 0;
+        while (!Ctx->Stop) {
+            uint8_t Cid[CID_LENGTH];
+            MakeCid(i % Ctx->StableCount, Cid);
+            long* Reader = QuicCidEpochEnter(Ctx->Epoch);
+            QUIC_CONNECTION* Connection =
+                QuicCidTableLookup(Ctx->Table, Cid, CID_LENGTH, CxPlatHashSimple(CID_LENGTH, Cid));
+            QuicCidEpochExit(Reader);
+            if (Connection != MakeConnection(i % Ctx->StableCount)) {
+                InterlockedIncrement(&Ctx->Failures);
+            }
+            ++i;
+        }
+        Ctx->Lookups = i;
+        CXPLAT_THREAD_RETURN(0);
+    }
+};
+
+TEST(CidTableTest, ConcurrentReaders)
+{
+    //
+    // Readers continuously look up a stable set of CIDs without any lock,
+    // while the writer adds and removes other CIDs, forcing rehashes.
+    //
+    const uint32_t StableCount = 256;
+    CidTable Table;
+    QUIC_CID_EPOCH Epoch;
+    ASSERT_TRUE(QuicCidEpochInitialize(&Epoch));
+
+    for (uint32_t i = 0; i < StableCount; ++i) {
+        ASSERT_TRUE(Table.Insert(i));
+    }
+
+    CidTableReaderContext Context = { &Table.Table, &Epoch, StableCount, FALSE, 0, 0 };
+    const uint32_t ReaderCount = 4;
+    CXPLAT_THREAD Threads[ReaderCount];
+    CXPLAT_THREAD_CONFIG Config = { 0, 0, NULL, CidTableReaderContext::ReaderThread, &Context };
+    for (uint32_t i = 0; i < ReaderCount; ++i) {
+        ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Threads[i])));
+    }
+
+    uint32_t Rehashes = 0;
+    for (uint32_t Round = 0; Round < 20; ++Round) {
+        const uint64_t Base = StableCount + Round * 4096;
+        for (uint64_t i = Base; i < Base + 4096; ++i) {
+            uint8_t Cid[CID_LENGTH];
+            MakeCid(i, Cid);
+            QUIC_CID_TABLE_STORE* RetiredStore;
+            ASSERT_TRUE(
+                QuicCidTableInsert(
+                    &Table.Table, Cid, CID_LENGTH, CxPlatHashSimple(CID_LENGTH, Cid),
+                    MakeConnection(i), &RetiredStore));
+            if (RetiredStore != NULL) {
+                QuicCidEpochSynchronize(&Epoch);
+                QuicCidTableFreeStore(RetiredStore);
+                Rehashes++;
+            }
+        }
+        for (uint64_t i = Base; i < Base + 4096; ++i) {
+            ASSERT_TRUE(Table.Remove(i));
+        }
+    }
+
+    Context.Stop = TRUE;
+    for (uint32_t i = 0; i < ReaderCount; ++i) {
+        CxPlatThreadWait(&Threads[i]);
+        CxPlatThreadDelete(&Threads[i]);
+    }
+    QuicCidEpochUninitialize(&Epoch);
+
+    ASSERT_NE(0u, Rehashes);
+    ASSERT_NE(0u, Context.Lookups);
+    ASSERT_EQ(0, Context.Failures);
+}
+
+TEST(CidTableTest, EpochTryAdvance)
+{
+    QUIC_CID_EPOCH Epoch;
+    ASSERT_TRUE(QuicCidEpochInitialize(&Epoch));
+    const long Start = QuicCidEpochCurrent(&Epoch);
+
+    //
+    // A reader only holds the epoch back once it has advanced past the
+    // reader's own epoch.
+    //
+    long* Reader = QuicCidEpochEnter(&Epoch);
+    ASSERT_TRUE(QuicCidEpochTryAdvance(&Epoch));
+    ASSERT_FALSE(QuicCidEpochTryAdvance(&Epoch));
+    ASSERT_EQ(Start + 1, QuicCidEpochCurrent(&Epoch));
+    QuicCidEpochExit(Reader);
+    ASSERT_TRUE(QuicCidEpochTryAdvance(&Epoch));
+    ASSERT_TRUE(QuicCidEpochTryAdvance(&Epoch));
+    ASSERT_EQ(Start + 3, QuicCidEpochCurrent(&Epoch));
+
+    //
+    // Synchronizing still works after the readers were left behind by an
+    // advance.
+    //
+    Reader = QuicCidEpochEnter(&Epoch);
+    ASSERT_TRUE(QuicCidEpochTryAdvance(&Epoch));
+    QuicCidEpochExit(Reader);
+    QuicCidEpochSynchronize(&Epoch);
+    ASSERT_EQ(Start + 5, QuicCidEpochCurrent(&Epoch));
+
+    QuicCidEpochUninitialize(&Epoch);
+}
+
+struct CidSlotTable {
+    QUIC_CID_SLOT_TABLE Table;
+    uint32_t Grows {0};
+    CidSlotTable() {
+        QuicCidSlotTableInitialize(&Table);
+    }
+    ~CidSlotTable() {
+        QuicCidSlotTableUninitialize(&Table);
+    }
+    bool Insert(QUIC_CONNECTION* Connection, uint8_t* Payload) {
+        QUIC_CID_SLOT_ARRAY* RetiredArray;
+        if (!QuicCidSlotTableInsert(&Table, Connection, Payload, &RetiredArray)) {
+            return false;
+        }
+        if (RetiredArray != NULL) {
+            Grows++;
+            QuicCidSlotTableFreeArray(RetiredArray);
+        }
+        return true;
+    }
+    void Remove(const uint8_t* Payload) {
+        QuicCidSlotTableRemove(&Table, Payload);
+    }
+    QUIC_CONNECTION* Lookup(const uint8_t* Payload) const {
+        return QuicCidSlotTableLookup(&Table, Payload);
+    }
+};
+
+TEST(CidTableTest, SlotInsertLookupRemove)
+{
+    const uint32_t Count = 1000;
+    CidSlotTable Table;
+    uint8_t (*Payloads)[QUIC_CID_PAYLOAD_LENGTH] = new uint8_t[2 * Count][QUIC_CID_PAYLOAD_LENGTH];
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        ASSERT_TRUE(Table.Insert(MakeConnection(i), Payloads[i]));
+        ASSERT_EQ(MakeConnection(i), Table.Lookup(Payloads[i]));
+    }
+    ASSERT_NE(0u, Table.Grows);
+
+    for (uint32_t i = 0; i < Count; i += 2) {
+        Table.Remove(Payloads[i]);
+    }
+
+    //
+    // Reuse all the released slots. Their previous payloads must not route to
+    // the new connections.
+    //
+    for (uint32_t i = Count; i < Count + Count / 2; ++i) {
+        ASSERT_TRUE(Table.Insert(MakeConnection(i), Payloads[i]));
+    }
+
+    for (uint32_t i = 0; i < Count + Count / 2; ++i) {
+        if (i < Count && i % 2 == 0) {
+            ASSERT_EQ(nullptr, Table.Lookup(Payloads[i]));
+        } else {
+            ASSERT_EQ(MakeConnection(i), Table.Lookup(Payloads[i]));
+        }
+    }
+
+    delete [] Payloads;
+}
+
+TEST(CidTableTest, SlotRejectsForgedPayloads)
+{
+    const uint32_t Count = 1000;
+    CidSlotTable Table;
+    uint8_t (*Payloads)[QUIC_CID_PAYLOAD_LENGTH] = new uint8_t[Count][QUIC_CID_PAYLOAD_LENGTH];
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        ASSERT_TRUE(Table.Insert(MakeConnection(i), Payloads[i]));
+    }
+
+    //
+    // Flipping any bit of a valid payload must not route anywhere.
+    //
+    uint32_t Routed = 0;
+    for (uint32_t i = 0; i < Count; ++i) {
+        for (uint32_t Bit = 0; Bit < QUIC_CID_PAYLOAD_LENGTH * 8; ++Bit) {
+            uint8_t Payload[QUIC_CID_PAYLOAD_LENGTH];
+            CxPlatCopyMemory(Payload, Payloads[i], sizeof(Payload));
+            Payload[Bit / 8] ^= (uint8_t)(1 << (Bit % 8));
+            if (Table.Lookup(Payload) != nullptr) {
+                Routed++;
+            }
+        }
+    }
+    ASSERT_EQ(0u, Routed);
+
+    //
+    // Neither must random payloads.
+    //
+    for (uint64_t i = 0; i < 100000; ++i) {
+        uint8_t Payload[8];
+        MakeCid(i, Payload);
+        if (Table.Lookup(Payload) != nullptr) {
+            Routed++;
+        }
+    }
+    ASSERT_EQ(0u, Routed);
+
+    delete [] Payloads;
+}
@@ -0,0 +1,129 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the per-connection arena allocator.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "ConnArenaTest.cpp.clog.h"
+#endif
+
+struct ConnArenaScope {
+    QUIC_CONN_ARENA Arena;
+    ConnArenaScope(uint32_t Size) { QuicConnArenaInitialize(&Arena, Size); }
+    ~ConnArenaScope() { QuicConnArenaUninitialize(&Arena); }
+    bool Owns(const void* Buffer) const {
+        return
+            Arena.Block != nullptr &&
+            (const uint8_t*)Buffer >= Arena.Block &&
+            (const uint8_t*)Buffer < Arena.Block + Arena.Size;
+    }
+};
+
+TEST(ConnArenaTest, Disabled)
+{
+    ConnArenaScope Scope(0);
+    void* Buffer = QuicConnArenaAlloc(&Scope.Arena, 32, QUIC_POOL_TEST);
+    ASSERT_NE(nullptr, Buffer);
+    ASSERT_EQ(nullptr, Scope.Arena.Block);
+    ASSERT_EQ(0u, Scope.Arena.Requested);
+    QuicConnArenaFree(&Scope.Arena, Buffer, QUIC_POOL_TEST);
+
+    uint32_t Footprint = 100;
+    QuicConnArenaUpdateFootprint(&Scope.Arena, &Footprint);
+    ASSERT_EQ(100u, Footprint);
+}
+
+TEST(ConnArenaTest, BumpAndRewind)
+{
+    ConnArenaScope Scope(256);
+    ASSERT_EQ(nullptr, Scope.Arena.Block);
+
+    uint8_t* First = (uint8_t*)QuicConnArenaAlloc(&Scope.Arena, 13, QUIC_POOL_TEST);
+    ASSERT_NE(nullptr, First);
+    ASSERT_TRUE(Scope.Owns(First));
+    uint8_t* Second = (uint8_t*)QuicConnArenaAlloc(&Scope.Arena, 8, QUIC_POOL_TEST);
+    ASSERT_TRUE(Scope.Owns(Second));
+    ASSERT_EQ(First + 16, Second); // Aligned to 8 bytes.
+    ASSERT_EQ(24u, Scope.Arena.Used);
+
+    //
+    // Only the last allocation goes back to the block.
+    //
+    QuicConnArenaFree(&Scope.Arena, First, QUIC_POOL_TEST);
+    ASSERT_EQ(24u, Scope.Arena.Used);
+    QuicConnArenaFree(&Scope.Arena, Second, QUIC_POOL_TEST);
+    ASSERT_EQ(16u, Scope.Arena.Used);
+    ASSERT_EQ(Second, QuicConnArenaAlloc(&Scope.Arena, 4, QUIC_POOL_TEST));
+    ASSERT_EQ(32u, Scope.Arena.Requested);
+}
+
+TEST(ConnArenaTest, HeapFallback)
+{
+    ConnArenaScope Scope(128);
+
+    void* Buffers[16];
+    uint32_t InBlock = 0;
+    for (uint32_t i = 0; i < ARRAYSIZE(Buffers); ++i) {
+        Buffers[i] = QuicConnArenaAlloc(&Scope.Arena, 24, QUIC_POOL_TEST);
+        ASSERT_NE(nullptr, Buffers[i]);
+        memset(Buffers[i], (int)i, 24);
+        if (Scope.Owns(Buffers[i])) {
+            InBlock++;
+        }
+    }
+    ASSERT_EQ(128u / 24u, InBlock);
+    ASSERT_EQ(24u * ARRAYSIZE(Buffers), Scope.Arena.Requested);
+
+    void* Large = QuicConnArenaAlloc(&Scope.Arena, QUIC_CONN_ARENA_MAX_SIZE + 1, QUIC_POOL_TEST);
+    ASSERT_NE(nullptr, Large);
+    ASSERT_FALSE(Scope.Owns(Large));
+    QuicConnArenaFree(&Scope.Arena, Large, QUIC_POOL_TEST);
+
+    for (uint32_t i = 0; i < ARRAYSIZE(Buffers); ++i) {
+        ASSERT_EQ((uint8_t)i, ((uint8_t*)Buffers[i])[23]);
+        QuicConnArenaFree(&Scope.Arena, Buffers[i], QUIC_POOL_TEST);
+    }
+}
+
+TEST(ConnArenaTest, LearnFootprint)
+{
+    ASSERT_EQ(
+        QuicConnArenaBlockSize(QUIC_CONN_ARENA_DEFAULT_FOOTPRINT),
+        QuicConnArenaBlockSize(0));
+    ASSERT_EQ((uint32_t)QUIC_CONN_ARENA_MIN_SIZE, QuicConnArenaBlockSize(1));
+    ASSERT_EQ((uint32_t)QUIC_CONN_ARENA_MAX_SIZE, QuicConnArenaBlockSize(UINT16_MAX));
+    ASSERT_EQ(640u, QuicConnArenaBlockSize(500)); // Headroom, rounded up to 64.
+
+    uint32_t Footprint = 0;
+    {
+        ConnArenaScope Scope(QuicConnArenaBlockSize(Footprint));
+        QuicConnArenaUpdateFootprint(&Scope.Arena, &Footprint);
+        ASSERT_EQ(0u, Footprint); // Nothing allocated.
+
+        void* Buffer = QuicConnArenaAlloc(&Scope.Arena, 800, QUIC_POOL_TEST);
+        QuicConnArenaFree(&Scope.Arena, Buffer, QUIC_POOL_TEST);
+        QuicConnArenaUpdateFootprint(&Scope.Arena, &Footprint);
+        ASSERT_EQ(800u, Footprint);
+    }
+
+    //
+    // Later connections only move the footprint part of the way.
+    //
+    for (uint32_t i = 0; i < 64; ++i) {
+        ConnArenaScope Scope(QuicConnArenaBlockSize(Footprint));
+        void* Buffer = QuicConnArenaAlloc(&Scope.Arena, 160, QUIC_POOL_TEST);
+        QuicConnArenaFree(&Scope.Arena, Buffer, QUIC_POOL_TEST);
+        uint32_t Previous = Footprint;
+        QuicConnArenaUpdateFootprint(&Scope.Arena, &Footprint);
+        ASSERT_LE(Footprint, Previous);
+        ASSERT_GE(Footprint, 160u);
+    }
+    ASSERT_LT(Footprint, 200u);
+}
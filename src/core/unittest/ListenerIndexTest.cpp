@@ -0,0 +1,283 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the index of listeners on a binding.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "ListenerIndexTest.cpp.clog.h"
+#endif
+
+#include <vector>
+#include <algorithm>
+
+struct TestListener {
+    QUIC_LISTENER* Listener;
+    uint8_t AlpnList[256];
+    TestListener(const char* Address, std::initializer_list<const char*> Alpns) {
+        Listener = (QUIC_LISTENER*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_LISTENER), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Listener != nullptr);
+        CxPlatZeroMemory(Listener, sizeof(QUIC_LISTENER));
+        if (Address != nullptr) {
+            CXPLAT_FRE_ASSERT(QuicAddrFromString(Address, 4433, &Listener->LocalAddress));
+        }
+        Listener->WildCard =
+            Address == nullptr || QuicAddrIsWildCard(&Listener->LocalAddress);
+        uint16_t Length = 0;
+        for (const char* Alpn : Alpns) {
+            AlpnList[Length] = (uint8_t)strlen(Alpn);
+            CxPlatCopyMemory(AlpnList + Length + 1, Alpn, AlpnList[Length]);
+            Length += 1 + AlpnList[Length];
+        }
+        Listener->AlpnList = AlpnList;
+        Listener->AlpnListLength = Length;
+    }
+    ~TestListener() {
+        CXPLAT_FREE(Listener, QUIC_POOL_TEST);
+    }
+};
+
+struct ListenerIndex {
+    QUIC_LISTENER_INDEX Index;
+    ListenerIndex() {
+        EXPECT_TRUE(QuicListenerIndexInitialize(&Index));
+    }
+    ~ListenerIndex() {
+        QuicListenerIndexUninitialize(&Index);
+    }
+    void Insert(TestListener& Listener) {
+        ASSERT_EQ(QUIC_STATUS_SUCCESS, QuicListenerIndexInsert(&Index, Listener.Listener));
+    }
+    void Remove(TestListener& Listener) {
+        QuicListenerIndexRemove(&Index, Listener.Listener);
+    }
+    QUIC_LISTENER* Find(
+        const char* Address,
+        std::initializer_list<const char*> Alpns,
+        BOOLEAN* AddressMatched = nullptr
+        ) const {
+        QUIC_ADDR Addr;
+        CXPLAT_FRE_ASSERT(QuicAddrFromString(Address, 4433, &Addr));
+        uint8_t AlpnList[256];
+        uint16_t Length = 0;
+        for (const char* Alpn : Alpns) {
+            AlpnList[Length] = (uint8_t)strlen(Alpn);
+            CxPlatCopyMemory(AlpnList + Length + 1, Alpn, AlpnList[Length]);
+            Length += 1 + AlpnList[Length];
+        }
+        BOOLEAN Matched;
+        QUIC_LISTENER* Listener =
+            QuicListenerIndexFind(&Index, &Addr, Length, AlpnList, &Matched);
+        if (AddressMatched != nullptr) {
+            *AddressMatched = Matched;
+        }
+        return Listener;
+    }
+};
+
+//
+// The listeners in the order the binding keeps them in its list: by family in
+// descending order, specific addresses before wild cards and then in
+// registration order.
+//
+static std::vector<QUIC_LISTENER*>
+SortLikeBinding(
+    const std::vector<QUIC_LISTENER*>& Listeners
+    )
+{
+    std::vector<QUIC_LISTENER*> Sorted(Listeners);
+    std::stable_sort(Sorted.begin(), Sorted.end(),
+        [](const QUIC_LISTENER* A, const QUIC_LISTENER* B) {
+            const QUIC_ADDRESS_FAMILY FamilyA = QuicAddrGetFamily(&A->LocalAddress);
+            const QUIC_ADDRESS_FAMILY FamilyB = QuicAddrGetFamily(&B->LocalAddress);
+            if (FamilyA != FamilyB) {
+                return FamilyA > FamilyB;
+            }
+            return !A->WildCard && B->WildCard;
+        });
+    return Sorted;
+}
+
+//
+// The list walk QuicBindingGetListener used to do.
+//
+static QUIC_LISTENER*
+FindInList(
+    const std::vector<QUIC_LISTENER*>& Sorted,
+    const QUIC_ADDR* Addr,
+    uint16_t ClientAlpnListLength,
+    const uint8_t* ClientAlpnList
+    )
+{
+    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Addr);
+    for (QUIC_LISTENER* Listener : Sorted) {
+        const QUIC_ADDRESS_FAMILY ListenerFamily = QuicAddrGetFamily(&Listener->LocalAddress);
+        if (ListenerFamily != QUIC_ADDRESS_FAMILY_UNSPEC) {
+            if (Family != ListenerFamily ||
+                (!Listener->WildCard && !QuicAddrCompareIp(Addr, &Listener->LocalAddress))) {
+                continue;
+            }
+        }
+        const uint8_t* AlpnList = Listener->AlpnList;
+        uint16_t AlpnListLength = Listener->AlpnListLength;
+        while (AlpnListLength != 0) {
+            if (CxPlatTlsAlpnFindInList(
+                    ClientAlpnListLength, ClientAlpnList, AlpnList[0], AlpnList + 1) != NULL) {
+                return Listener;
+            }
+            AlpnListLength -= AlpnList[0] + 1;
+            AlpnList += AlpnList[0] + 1;
+        }
+    }
+    return NULL;
+}
+
+TEST(ListenerIndexTest, AddressPrecedence)
+{
+    ListenerIndex Index;
+    TestListener Unspec(nullptr, {"a"});
+    TestListener WildCard4("0.0.0.0", {"a"});
+    TestListener Specific4("10.0.0.1", {"a"});
+
+    Index.Insert(Unspec);
+    ASSERT_EQ(Unspec.Listener, Index.Find("10.0.0.1", {"a"}));
+    Index.Insert(WildCard4);
+    ASSERT_EQ(WildCard4.Listener, Index.Find("10.0.0.1", {"a"}));
+    Index.Insert(Specific4);
+    ASSERT_EQ(Specific4.Listener, Index.Find("10.0.0.1", {"a"}));
+    ASSERT_EQ(WildCard4.Listener, Index.Find("10.0.0.2", {"a"}));
+    ASSERT_EQ(Unspec.Listener, Index.Find("::1", {"a"}));
+    ASSERT_EQ(Specific4.Listener, Index.Find("10.0.0.1", {"b", "a"}));
+
+    Index.Remove(Specific4);
+    ASSERT_EQ(WildCard4.Listener, Index.Find("10.0.0.1", {"a"}));
+    Index.Remove(WildCard4);
+    Index.Remove(Unspec);
+    ASSERT_EQ(nullptr, Index.Find("10.0.0.1", {"a"}));
+}
+
+TEST(ListenerIndexTest, RegistrationOrder)
+{
+    //
+    // Like the list walk, the first registered listener matching any of the
+    // client's ALPNs wins, regardless of the client's ALPN order.
+    //
+    ListenerIndex Index;
+    TestListener First("0.0.0.0", {"x"});
+    TestListener Second("0.0.0.0", {"y", "z"});
+    Index.Insert(First);
+    Index.Insert(Second);
+
+    ASSERT_EQ(First.Listener, Index.Find("10.0.0.1", {"y", "x"}));
+    ASSERT_EQ(Second.Listener, Index.Find("10.0.0.1", {"z", "y"}));
+    ASSERT_EQ(Second.Listener, Index.Find("10.0.0.1", {"w", "z"}));
+
+    Index.Remove(First);
+    ASSERT_EQ(Second.Listener, Index.Find("10.0.0.1", {"y", "x"}));
+    Index.Remove(Second);
+}
+
+TEST(ListenerIndexTest, AddressMatched)
+{
+    ListenerIndex Index;
+    TestListener Specific6("fe80::1", {"a", "b"});
+    Index.Insert(Specific6);
+
+    BOOLEAN AddressMatched;
+    ASSERT_EQ(Specific6.Listener, Index.Find("fe80::1", {"b"}, &AddressMatched));
+    ASSERT_TRUE(AddressMatched);
+    ASSERT_EQ(nullptr, Index.Find("fe80::1", {"c"}, &AddressMatched));
+    ASSERT_TRUE(AddressMatched);
+    ASSERT_EQ(nullptr, Index.Find("fe80::2", {"a"}, &AddressMatched));
+    ASSERT_FALSE(AddressMatched);
+    ASSERT_EQ(nullptr, Index.Find("10.0.0.1", {"a"}, &AddressMatched));
+    ASSERT_FALSE(AddressMatched);
+
+    Index.Remove(Specific6);
+    ASSERT_EQ(nullptr, Index.Find("fe80::1", {"a"}, &AddressMatched));
+    ASSERT_FALSE(AddressMatched);
+}
+
+TEST(ListenerIndexTest, MatchesListWalk)
+{
+    //
+    // Registers random listeners, rejecting the ones the binding would reject
+    // for an ALPN conflict, and compares random lookups against the list walk.
+    //
+    const char* Addresses[] = {
+        nullptr, "0.0.0.0", "10.0.0.1", "10.0.0.2", "::", "fe80::1", "fe80::2"
+    };
+    const char* Alpns[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+    const uint32_t AddressCount = ARRAYSIZE(Addresses);
+    const uint32_t AlpnCount = ARRAYSIZE(Alpns);
+
+    srand(0x13);
+    for (uint32_t Round = 0; Round < 20; ++Round) {
+        ListenerIndex Index;
+        std::vector<TestListener*> All;
+        std::vector<QUIC_LISTENER*> Registered;
+
+        for (uint32_t i = 0; i < 40; ++i) {
+            const char* Address = Addresses[rand() % AddressCount];
+            TestListener* New =
+                new TestListener(Address, {Alpns[rand() % AlpnCount], Alpns[rand() % AlpnCount]});
+            All.push_back(New);
+
+            bool Conflict = false;
+            for (QUIC_LISTENER* Existing : Registered) {
+                const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(&New->Listener->LocalAddress);
+                if (Family == QuicAddrGetFamily(&Existing->LocalAddress) &&
+                    New->Listener->WildCard == Existing->WildCard &&
+                    (Family == QUIC_ADDRESS_FAMILY_UNSPEC ||
+                     QuicAddrCompareIp(&New->Listener->LocalAddress, &Existing->LocalAddress)) &&
+                    FindInList(
+                        {Existing}, &New->Listener->LocalAddress,
+                        New->Listener->AlpnListLength, New->Listener->AlpnList) != NULL) {
+                    Conflict = true;
+                    break;
+                }
+            }
+            if (!Conflict) {
+                Index.Insert(*New);
+                Registered.push_back(New->Listener);
+            }
+
+            if (Registered.size() > 4 && rand() % 4 == 0) {
+                const size_t Victim = rand() % Registered.size();
+                QuicListenerIndexRemove(&Index.Index, Registered[Victim]);
+                Registered.erase(Registered.begin() + Victim);
+            }
+        }
+
+        std::vector<QUIC_LISTENER*> Sorted = SortLikeBinding(Registered);
+        for (uint32_t i = 0; i < 200; ++i) {
+            const char* Address = Addresses[1 + rand() % (AddressCount - 1)];
+            QUIC_ADDR Addr;
+            ASSERT_TRUE(QuicAddrFromString(Address, 4433, &Addr));
+            uint8_t ClientAlpnList[6] = {
+                1, (uint8_t)Alpns[rand() % AlpnCount][0],
+                1, (uint8_t)Alpns[rand() % AlpnCount][0],
+                1, (uint8_t)Alpns[rand() % AlpnCount][0]
+            };
+            BOOLEAN AddressMatched;
+            ASSERT_EQ(
+                FindInList(Sorted, &Addr, sizeof(ClientAlpnList), ClientAlpnList),
+                QuicListenerIndexFind(
+                    &Index.Index, &Addr, sizeof(ClientAlpnList), ClientAlpnList,
+                    &AddressMatched));
+        }
+
+        for (QUIC_LISTENER* Listener : Registered) {
+            QuicListenerIndexRemove(&Index.Index, Listener);
+        }
+        for (TestListener* Listener : All) {
+            delete Listener;
+        }
+    }
+}
@@ -0,0 +1,234 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the connection operation queue.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "OperationTest.cpp.clog.h"
+#endif
+
+#include <chrono>
+
+struct OperationQueue {
+    QUIC_OPERATION_QUEUE OperQ;
+    QUIC_PARTITION* Partition;
+    QUIC_PARTITION PerfCounters; // Only the perf counters are used.
+    OperationQueue() : Partition(&PerfCounters) {
+        CxPlatZeroMemory(&PerfCounters, sizeof(PerfCounters));
+        QuicOperationQueueInitialize(&OperQ);
+    }
+    ~OperationQueue() {
+        QuicOperationQueueUninitialize(&OperQ);
+    }
+    QUIC_OPERATION* Dequeue() {
+        return QuicOperationDequeue(&OperQ, Partition);
+    }
+};
+
+static void InitializeOperations(QUIC_OPERATION* Opers, uint32_t Count)
+{
+    CxPlatZeroMemory(Opers, sizeof(QUIC_OPERATION) * Count);
+    for (uint32_t i = 0; i < Count; ++i) {
+        Opers[i].Type = QUIC_OPER_TYPE_FLUSH_SEND;
+    }
+}
+
+TEST(OperationTest, Lanes)
+{
+    OperationQueue Queue;
+    QUIC_OPERATION Opers[6];
+    InitializeOperations(Opers, ARRAYSIZE(Opers));
+
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+    ASSERT_TRUE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[0]));
+    ASSERT_FALSE(QuicOperationHasPriority(&Queue.OperQ));
+    ASSERT_FALSE(QuicOperationEnqueuePriority(&Queue.OperQ, Queue.Partition, &Opers[1]));
+    ASSERT_FALSE(QuicOperationEnqueueFront(&Queue.OperQ, Queue.Partition, &Opers[2]));
+    ASSERT_FALSE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[3]));
+    ASSERT_FALSE(QuicOperationEnqueuePriority(&Queue.OperQ, Queue.Partition, &Opers[4]));
+    ASSERT_FALSE(QuicOperationEnqueueFront(&Queue.OperQ, Queue.Partition, &Opers[5]));
+    ASSERT_TRUE(QuicOperationHasPriority(&Queue.OperQ));
+
+    //
+    // The latest front operation goes first, then the other priority
+    // operations, then the rest, each in order.
+    //
+    const uint32_t Expected[] = { 5, 2, 1, 4, 0, 3 };
+    for (uint32_t i = 0; i < ARRAYSIZE(Expected); ++i) {
+        ASSERT_EQ(&Opers[Expected[i]], Queue.Dequeue());
+        if (i == 3) {
+            ASSERT_FALSE(QuicOperationHasPriority(&Queue.OperQ));
+        }
+    }
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+}
+
+TEST(OperationTest, PriorityAfterTake)
+{
+    OperationQueue Queue;
+    QUIC_OPERATION Opers[5];
+    InitializeOperations(Opers, ARRAYSIZE(Opers));
+
+    //
+    // Priority and front operations pushed after the normal ones were taken
+    // from the inbox still go before them.
+    //
+    ASSERT_TRUE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[0]));
+    ASSERT_FALSE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[1]));
+    ASSERT_FALSE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[2]));
+    ASSERT_EQ(&Opers[0], Queue.Dequeue());
+    ASSERT_FALSE(QuicOperationEnqueuePriority(&Queue.OperQ, Queue.Partition, &Opers[3]));
+    ASSERT_EQ(&Opers[3], Queue.Dequeue());
+    ASSERT_FALSE(QuicOperationEnqueueFront(&Queue.OperQ, Queue.Partition, &Opers[4]));
+    ASSERT_EQ(&Opers[4], Queue.Dequeue());
+    ASSERT_EQ(&Opers[1], Queue.Dequeue());
+    ASSERT_EQ(&Opers[2], Queue.Dequeue());
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+}
+
+TEST(OperationTest, StartProcessing)
+{
+    OperationQueue Queue;
+    QUIC_OPERATION Opers[3];
+    InitializeOperations(Opers, ARRAYSIZE(Opers));
+
+    //
+    // Only the first operation after the queue went idle starts processing,
+    // including while the consumer is still draining.
+    //
+    ASSERT_TRUE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[0]));
+    ASSERT_EQ(&Opers[0], Queue.Dequeue());
+    ASSERT_FALSE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[1]));
+    ASSERT_EQ(&Opers[1], Queue.Dequeue());
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+    ASSERT_TRUE(QuicOperationEnqueuePriority(&Queue.OperQ, Queue.Partition, &Opers[2]));
+    ASSERT_EQ(&Opers[2], Queue.Dequeue());
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+
+    //
+    // Clearing leaves the queue idle. N.B. Operations not freed on clear must
+    // be API calls.
+    //
+    QUIC_API_CONTEXT ApiCtx;
+    CxPlatZeroMemory(&ApiCtx, sizeof(ApiCtx));
+    ApiCtx.Type = QUIC_API_TYPE_CONN_CLOSE;
+    Opers[0].Type = QUIC_OPER_TYPE_API_CALL;
+    Opers[0].API_CALL.Context = &ApiCtx;
+    ASSERT_TRUE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[0]));
+    QuicOperationQueueClear(&Queue.OperQ, Queue.Partition);
+    ASSERT_TRUE(QuicOperationEnqueue(&Queue.OperQ, Queue.Partition, &Opers[1]));
+    ASSERT_EQ(&Opers[1], Queue.Dequeue());
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+}
+
+struct OperationProducerContext {
+    OperationQueue* Queue;
+    QUIC_OPERATION* Opers;
+    uint32_t Count;
+    long volatile* Scheduled;
+    long volatile Failures;
+    uint32_t Signaled;
+    static CXPLAT_THREAD_CALLBACK(ProducerThread, Context) {
+        auto Ctx = (OperationProducerContext*)Context;
+        for (uint32_t i = 0; i < Ctx->Count; ++i) {
+            if (QuicOperationEnqueue(&Ctx->Queue->OperQ, Ctx->Queue->Partition, &Ctx->Opers[i])) {
+                Ctx->Signaled++;
+                //
+                // Like queuing the connection on its worker. Only one producer
+                // may do so until the queue goes idle again.
+                //
+                if (InterlockedIncrement(Ctx->Scheduled) != 1) {
+                    InterlockedIncrement(&Ctx->Failures);
+                }
+            }
+        }
+        CXPLAT_THREAD_RETURN(0);
+    }
+};
+
+//
+// Many threads queue operations on one connection, like app threads sending on
+// its streams, while the worker drains them.
+//
+TEST(OperationTest, ConcurrentProducers)
+{
+    const uint32_t ProducerCount = 8;
+    const uint32_t PerProducer = 64 * 1024;
+    OperationQueue Queue;
+    QUIC_OPERATION* Opers =
+        (QUIC_OPERATION*)CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_OPERATION) * ProducerCount * PerProducer,
+            QUIC_POOL_TEST);
+    ASSERT_NE(nullptr, Opers);
+    InitializeOperations(Opers, ProducerCount * PerProducer);
+
+    long volatile Scheduled = 0;
+    OperationProducerContext Contexts[ProducerCount];
+    CXPLAT_THREAD Threads[ProducerCount];
+    for (uint32_t i = 0; i < ProducerCount; ++i) {
+        Contexts[i] = { &Queue, Opers + i * PerProducer, PerProducer, &Scheduled, 0, 0 };
+        CXPLAT_THREAD_CONFIG Config = { 0, 0, NULL, OperationProducerContext::ProducerThread, &Contexts[i] };
+        ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Threads[i])));
+    }
+
+    uint32_t NextSequence[ProducerCount] = {0};
+    uint32_t Dequeued = 0;
+    uint32_t Drains = 0;
+    uint32_t OutOfOrder = 0;
+    auto LastProgress = std::chrono::steady_clock::now();
+    while (Dequeued < ProducerCount * PerProducer) {
+        if (Scheduled == 0) {
+            //
+            // Every operation must eventually be signaled by a producer.
+            //
+            if (std::chrono::steady_clock::now() - LastProgress > std::chrono::seconds(10)) {
+                break;
+            }
+            CxPlatSchedulerYield();
+            continue;
+        }
+        InterlockedDecrement(&Scheduled);
+        Drains++;
+
+        QUIC_OPERATION* Oper;
+        while ((Oper = Queue.Dequeue()) != NULL) {
+            const uint32_t Index = (uint32_t)(Oper - Opers);
+            const uint32_t Producer = Index / PerProducer;
+            if (Index % PerProducer != NextSequence[Producer]++) {
+                OutOfOrder++;
+            }
+            Dequeued++;
+        }
+        LastProgress = std::chrono::steady_clock::now();
+    }
+    for (uint32_t i = 0; i < ProducerCount; ++i) {
+        CxPlatThreadWait(&Threads[i]);
+        CxPlatThreadDelete(&Threads[i]);
+    }
+    uint32_t Signaled = 0;
+    for (uint32_t i = 0; i < ProducerCount; ++i) {
+        ASSERT_EQ(0, Contexts[i].Failures);
+        ASSERT_EQ(PerProducer, NextSequence[i]);
+        Signaled += Contexts[i].Signaled;
+    }
+    ASSERT_EQ(ProducerCount * PerProducer, Dequeued);
+    ASSERT_EQ(0u, OutOfOrder);
+    ASSERT_EQ(0, Scheduled);
+
+    //
+    // The worker drained the queue once for each time a producer found it
+    // idle, which can't be more often than there were operations.
+    //
+    ASSERT_EQ(Signaled, Drains);
+    ASSERT_LE(1u, Drains);
+    ASSERT_LE(Drains, Dequeued);
+    ASSERT_EQ(nullptr, Queue.Dequeue());
+    CXPLAT_FREE(Opers, QUIC_POOL_TEST);
+}
@@ -14,6 +14,8 @@ Abstract:
 #include "RangeTest.cpp.clog.h"
 #endif
 
+#include <vector>
+
 struct SmartRange {
     QUIC_RANGE range;
     SmartRange(uint32_t MaxAllocSize = QUIC_MAX_RANGE_ALLOC_SIZE) {
@@ -787,3 +789,66 @@ TEST(RangeTest, SearchRangeThree)
     ASSERT_EQ(index, 2);
 #endif
 }
+
+TEST(RangeTest, RandomLarge)
+{
+    //
+    // Large ranges, with free space at both ends of the array, checked against
+    // a bitmap after random changes all over them.
+    //
+    const uint32_t ValueCount = 32 * 1024;
+    std::vector<bool> Values(ValueCount, false);
+    SmartRange range;
+    uint64_t Min = 0;
+
+    srand(0x2323);
+    for (uint32_t Round = 0; Round < 20000; ++Round) {
+        const uint32_t Op = (uint32_t)rand() % 100;
+        const uint64_t Low = Min + (uint64_t)rand() % (ValueCount - Min);
+        const uint64_t Count =
+            CXPLAT_MIN(1 + (uint64_t)rand() % 4, ValueCount - Low);
+        if (Op < 70) {
+            ASSERT_TRUE(range.TryAdd(Low, Count));
+            for (uint64_t i = Low; i < Low + Count; ++i) {
+                Values[(size_t)i] = true;
+            }
+        } else if (Op < 90) {
+            ASSERT_TRUE(QuicRangeRemoveRange(&range.range, Low, Count));
+            for (uint64_t i = Low; i < Low + Count; ++i) {
+                Values[(size_t)i] = false;
+            }
+        } else if (Op < 99) {
+            if (QuicRangeSize(&range.range) != 0) {
+                const QUIC_SUBRANGE* First = QuicRangeGet(&range.range, 0);
+                for (uint64_t i = First->Low; i < First->Low + First->Count; ++i) {
+                    Values[(size_t)i] = false;
+                }
+                QuicRangeRemoveSubranges(&range.range, 0, 1);
+            }
+        } else if (Min + 64 < ValueCount) {
+            Min += (uint64_t)rand() % 64;
+            QuicRangeSetMin(&range.range, Min);
+            for (uint64_t i = 0; i < Min; ++i) {
+                Values[(size_t)i] = false;
+            }
+        }
+
+        if (Round % 97 == 0 || Round == 19999) {
+            uint64_t Next = 0;
+            for (uint32_t i = 0; i < QuicRangeSize(&range.range); ++i) {
+                const QUIC_SUBRANGE* Sub = QuicRangeGet(&range.range, i);
+                ASSERT_NE(0ull, Sub->Count);
+                ASSERT_TRUE(i == 0 || Sub->Low > Next); // Sorted and merged.
+                for (; Next < Sub->Low; ++Next) {
+                    ASSERT_FALSE(Values[(size_t)Next]);
+                }
+                for (; Next < Sub->Low + Sub->Count; ++Next) {
+                    ASSERT_TRUE(Values[(size_t)Next]);
+                }
+            }
+            for (; Next < ValueCount; ++Next) {
+                ASSERT_FALSE(Values[(size_t)Next]);
+            }
+        }
+    }
+}
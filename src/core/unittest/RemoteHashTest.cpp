@@ -0,0 +1,226 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the sharded remote hash lookup of handshaking connections.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "RemoteHashTest.cpp.clog.h"
+#endif
+
+extern "C"
+void
+MsQuicCalculatePartitionMask(
+    void
+    );
+
+const uint16_t ShardCount = 4;
+const uint32_t FlowCount = 64;
+const uint8_t RemoteCidLength = 8;
+
+struct RemoteHashLookup {
+    QUIC_LOOKUP Lookup;
+    QUIC_CONNECTION* Connections[FlowCount];
+    QUIC_ADDR RemoteAddresses[FlowCount];
+    uint8_t RemoteCids[FlowCount][RemoteCidLength];
+    uint16_t OldPartitionCount;
+    uint16_t OldPartitionMask;
+
+    RemoteHashLookup() {
+        OldPartitionCount = MsQuicLib.PartitionCount;
+        OldPartitionMask = MsQuicLib.PartitionMask;
+        MsQuicLib.PartitionCount = ShardCount;
+        MsQuicCalculatePartitionMask();
+
+        QuicLookupInitialize(&Lookup);
+        CXPLAT_FRE_ASSERT(QuicLookupMaximizePartitioning(&Lookup));
+
+        for (uint32_t i = 0; i < FlowCount; ++i) {
+            QUIC_CONNECTION* Connection =
+                (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+            CXPLAT_FRE_ASSERT(Connection != nullptr);
+            CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+            Connection->RefCount = 1;
+#if DEBUG
+            CxPlatRefInitializeMultiple(Connection->RefTypeBiasedCount, QUIC_CONN_REF_COUNT);
+#endif
+            Connections[i] = Connection;
+
+            //
+            // Flows share their addresses and CIDs in pairs, so the lookups
+            // have to compare both.
+            //
+            CxPlatZeroMemory(&RemoteAddresses[i], sizeof(QUIC_ADDR));
+            QuicAddrSetFamily(&RemoteAddresses[i], QUIC_ADDRESS_FAMILY_INET);
+            QuicAddrSetPort(&RemoteAddresses[i], (uint16_t)(10000 + i / 2));
+            CxPlatZeroMemory(RemoteCids[i], RemoteCidLength);
+            RemoteCids[i][0] = (uint8_t)(i % 2);
+            RemoteCids[i][1] = (uint8_t)(i / 4);
+        }
+    }
+
+    ~RemoteHashLookup() {
+        for (uint32_t i = 0; i < FlowCount; ++i) {
+            if (Connections[i]->RemoteHashEntry != NULL) {
+                QuicLookupRemoveRemoteHash(&Lookup, Connections[i]->RemoteHashEntry);
+            }
+            QUIC_CONNECTION* Connection = Connections[i];
+            CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+        }
+        QuicLookupUninitialize(&Lookup);
+        MsQuicLib.PartitionCount = OldPartitionCount;
+        MsQuicLib.PartitionMask = OldPartitionMask;
+    }
+
+    uint16_t ExpectedShard(uint32_t i) const {
+        const uint32_t Hash =
+            QuicPacketHash(&RemoteAddresses[i], RemoteCidLength, RemoteCids[i]);
+        return (uint16_t)(((Hash >> 16) * ShardCount) >> 16);
+    }
+
+    void Add(uint32_t i) {
+        QUIC_CONNECTION* Collision = (QUIC_CONNECTION*)1;
+        ASSERT_TRUE(
+            QuicLookupAddRemoteHash(
+                &Lookup, Connections[i], &RemoteAddresses[i], RemoteCidLength,
+                RemoteCids[i], &Collision));
+        ASSERT_EQ(nullptr, Collision);
+        ASSERT_NE(nullptr, Connections[i]->RemoteHashEntry);
+        ASSERT_EQ(ExpectedShard(i), Connections[i]->RemoteHashEntry->ShardIndex);
+    }
+
+    void Remove(uint32_t i) {
+        QuicLookupRemoveRemoteHash(&Lookup, Connections[i]->RemoteHashEntry);
+        ASSERT_EQ(nullptr, Connections[i]->RemoteHashEntry);
+    }
+
+    QUIC_CONNECTION* Find(uint32_t i) {
+        QUIC_CONNECTION* Connection =
+            QuicLookupFindConnectionByRemoteHash(
+                &Lookup, &RemoteAddresses[i], RemoteCidLength, RemoteCids[i]);
+        if (Connection != NULL) {
+            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+        return Connection;
+    }
+
+    void Validate() {
+        uint32_t EntryCount = 0;
+        for (uint32_t i = 0; i < FlowCount; ++i) {
+            const bool Added = Connections[i]->RemoteHashEntry != NULL;
+            ASSERT_EQ(Added ? Connections[i] : nullptr, Find(i));
+            EntryCount += Added ? 1 : 0;
+        }
+        uint32_t ShardEntryCount = 0;
+        for (uint16_t i = 0; i < Lookup.RemoteHashShardCount; ++i) {
+            ShardEntryCount += Lookup.RemoteHashShards[i].Table.NumEntries;
+        }
+        ASSERT_EQ(EntryCount, ShardEntryCount);
+    }
+};
+
+TEST(RemoteHashTest, AddFindRemove)
+{
+    RemoteHashLookup Flows;
+    ASSERT_EQ(ShardCount, Flows.Lookup.RemoteHashShardCount);
+    Flows.Validate();
+
+    for (uint32_t i = 0; i < FlowCount; ++i) {
+        Flows.Add(i);
+    }
+    Flows.Validate();
+
+    //
+    // The flows spread over the shards.
+    //
+    for (uint16_t i = 0; i < ShardCount; ++i) {
+        ASSERT_NE(0u, Flows.Lookup.RemoteHashShards[i].Table.NumEntries);
+    }
+
+    //
+    // Removing every other flow leaves the rest of each shard in place.
+    //
+    for (uint32_t i = 0; i < FlowCount; i += 2) {
+        Flows.Remove(i);
+    }
+    Flows.Validate();
+    for (uint32_t i = 0; i < FlowCount; i += 2) {
+        Flows.Add(i);
+    }
+    Flows.Validate();
+
+    for (uint32_t i = 0; i < FlowCount; ++i) {
+        Flows.Remove(i);
+    }
+    Flows.Validate();
+}
+
+TEST(RemoteHashTest, Collision)
+{
+    RemoteHashLookup Flows;
+    Flows.Add(0);
+
+    //
+    // Another connection for the same flow collides with the first one.
+    //
+    QUIC_CONNECTION* Collision = NULL;
+    ASSERT_FALSE(
+        QuicLookupAddRemoteHash(
+            &Flows.Lookup, Flows.Connections[1], &Flows.RemoteAddresses[0],
+            RemoteCidLength, Flows.RemoteCids[0], &Collision));
+    ASSERT_EQ(Flows.Connections[0], Collision);
+    QuicConnRelease(Collision, QUIC_CONN_REF_LOOKUP_RESULT);
+    ASSERT_EQ(nullptr, Flows.Connections[1]->RemoteHashEntry);
+    Flows.Validate();
+}
+
+TEST(RemoteHashTest, SameShard)
+{
+    RemoteHashLookup Flows;
+
+    //
+    // Find flows whose hashes land in the same shard.
+    //
+    uint32_t First = FlowCount, Second = FlowCount, Third = FlowCount;
+    for (uint32_t i = 0; i < FlowCount && Third == FlowCount; ++i) {
+        for (uint32_t j = i + 1; j < FlowCount && Third == FlowCount; ++j) {
+            if (Flows.ExpectedShard(i) != Flows.ExpectedShard(j)) {
+                continue;
+            }
+            for (uint32_t k = j + 1; k < FlowCount; ++k) {
+                if (Flows.ExpectedShard(i) == Flows.ExpectedShard(k)) {
+                    First = i;
+                    Second = j;
+                    Third = k;
+                    break;
+                }
+            }
+        }
+    }
+    ASSERT_NE(FlowCount, Third);
+
+    Flows.Add(First);
+    Flows.Add(Second);
+    Flows.Add(Third);
+    const uint16_t Shard = Flows.ExpectedShard(First);
+    ASSERT_EQ(3u, Flows.Lookup.RemoteHashShards[Shard].Table.NumEntries);
+    Flows.Validate();
+
+    //
+    // Removing one leaves the others in the shard found.
+    //
+    Flows.Remove(Second);
+    ASSERT_EQ(2u, Flows.Lookup.RemoteHashShards[Shard].Table.NumEntries);
+    Flows.Validate();
+    Flows.Remove(First);
+    ASSERT_EQ(1u, Flows.Lookup.RemoteHashShards[Shard].Table.NumEntries);
+    Flows.Validate();
+    Flows.Add(Second);
+    Flows.Validate();
+}
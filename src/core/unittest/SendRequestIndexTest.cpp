@@ -0,0 +1,153 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the index of a stream's queued send requests.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "SendRequestIndexTest.cpp.clog.h"
+#endif
+
+#include <deque>
+
+struct SendRequestQueue {
+    std::deque<QUIC_SEND_REQUEST*> Requests;
+    QUIC_SEND_REQUEST_INDEX Index;
+    uint64_t QueuedOffset;
+    SendRequestQueue() : QueuedOffset(0) {
+        CxPlatZeroMemory(&Index, sizeof(Index));
+    }
+    ~SendRequestQueue() {
+        QuicSendRequestIndexUninitialize(&Index);
+        for (QUIC_SEND_REQUEST* Req : Requests) {
+            delete Req;
+        }
+    }
+    void Queue(uint64_t Length) {
+        QUIC_SEND_REQUEST* Req = new QUIC_SEND_REQUEST;
+        CxPlatZeroMemory(Req, sizeof(*Req));
+        Req->StreamOffset = QueuedOffset;
+        Req->TotalLength = Length;
+        QueuedOffset += Length;
+        if (!Requests.empty()) {
+            Requests.back()->Next = Req;
+        }
+        Requests.push_back(Req);
+        if (QuicSendRequestIndexInUse(&Index)) {
+            ASSERT_TRUE(QuicSendRequestIndexAppend(&Index, Req));
+        }
+    }
+    void Complete() {
+        QUIC_SEND_REQUEST* Req = Requests.front();
+        Requests.pop_front();
+        if (QuicSendRequestIndexInUse(&Index)) {
+            QuicSendRequestIndexRemoveFirst(&Index, Req);
+        }
+        delete Req;
+    }
+    void BuildIndex() {
+        ASSERT_TRUE(
+            QuicSendRequestIndexInitialize(
+                &Index, Requests.empty() ? NULL : Requests.front()));
+    }
+    //
+    // The search the stream does without an index.
+    //
+    QUIC_SEND_REQUEST* Walk(uint64_t Offset) const {
+        QUIC_SEND_REQUEST* Req = Requests.front();
+        while (Req->StreamOffset + Req->TotalLength <= Offset) {
+            Req = Req->Next;
+        }
+        return Req;
+    }
+    //
+    // The request the stream copies from, after skipping any empty ones the
+    // index returned.
+    //
+    QUIC_SEND_REQUEST* Find(uint64_t Offset) const {
+        QUIC_SEND_REQUEST* Req = QuicSendRequestIndexFind(&Index, Offset);
+        while (Req != NULL && Req->StreamOffset + Req->TotalLength <= Offset) {
+            Req = Req->Next;
+        }
+        return Req;
+    }
+};
+
+TEST(SendRequestIndexTest, Empty)
+{
+    SendRequestQueue Queue;
+    ASSERT_FALSE(QuicSendRequestIndexInUse(&Queue.Index));
+    Queue.BuildIndex();
+    ASSERT_TRUE(QuicSendRequestIndexInUse(&Queue.Index));
+    ASSERT_EQ(nullptr, QuicSendRequestIndexFind(&Queue.Index, 0));
+    QuicSendRequestIndexUninitialize(&Queue.Index);
+    ASSERT_FALSE(QuicSendRequestIndexInUse(&Queue.Index));
+}
+
+TEST(SendRequestIndexTest, Find)
+{
+    SendRequestQueue Queue;
+    const uint64_t Lengths[] = { 100, 0, 50, 0, 0, 1, 200, 0 };
+    for (uint64_t Length : Lengths) {
+        Queue.Queue(Length);
+    }
+    Queue.BuildIndex();
+
+    for (uint64_t Offset = 0; Offset < Queue.QueuedOffset; ++Offset) {
+        ASSERT_EQ(Queue.Walk(Offset), Queue.Find(Offset));
+    }
+    ASSERT_EQ(Queue.Requests[0], QuicSendRequestIndexFind(&Queue.Index, 99));
+    ASSERT_EQ(Queue.Requests[2], QuicSendRequestIndexFind(&Queue.Index, 100));
+    ASSERT_EQ(Queue.Requests[5], QuicSendRequestIndexFind(&Queue.Index, 150));
+    ASSERT_EQ(Queue.Requests[7], QuicSendRequestIndexFind(&Queue.Index, 351));
+
+    Queue.Complete();
+    ASSERT_EQ(nullptr, QuicSendRequestIndexFind(&Queue.Index, 99));
+    for (uint64_t Offset = 100; Offset < Queue.QueuedOffset; ++Offset) {
+        ASSERT_EQ(Queue.Walk(Offset), Queue.Find(Offset));
+    }
+}
+
+TEST(SendRequestIndexTest, GrowAndCompact)
+{
+    SendRequestQueue Queue;
+    Queue.Queue(10);
+    Queue.BuildIndex();
+    const uint32_t InitialCapacity = Queue.Index.Capacity;
+
+    //
+    // A queue that stays short only moves its requests down the array.
+    //
+    for (uint32_t i = 0; i < 10 * InitialCapacity; ++i) {
+        Queue.Queue(1 + i % 7);
+        Queue.Complete();
+        ASSERT_EQ(Queue.Requests.front(), Queue.Find(Queue.Requests.front()->StreamOffset));
+    }
+    ASSERT_EQ(InitialCapacity, Queue.Index.Capacity);
+
+    //
+    // A growing queue grows the array.
+    //
+    for (uint32_t i = 0; i < 4 * InitialCapacity; ++i) {
+        Queue.Queue(i % 3);
+    }
+    ASSERT_LT(InitialCapacity, Queue.Index.Capacity);
+    ASSERT_EQ(Queue.Requests.size(), (size_t)(Queue.Index.End - Queue.Index.Start));
+    for (uint64_t Offset = Queue.Requests.front()->StreamOffset;
+         Offset < Queue.QueuedOffset;
+         ++Offset) {
+        ASSERT_EQ(Queue.Walk(Offset), Queue.Find(Offset));
+    }
+
+    while (!Queue.Requests.empty()) {
+        Queue.Complete();
+    }
+    ASSERT_EQ(0u, Queue.Index.Start);
+    ASSERT_EQ(0u, Queue.Index.End);
+}
@@ -0,0 +1,280 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the ring of outstanding sent packets.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "SentPacketRingTest.cpp.clog.h"
+#endif
+
+#include <map>
+
+struct SentPacketRing {
+    QUIC_SENT_PACKET_RING Ring;
+    std::map<uint64_t, QUIC_SENT_PACKET_METADATA*> Packets;
+    SentPacketRing() {
+        QuicSentPacketRingInitialize(&Ring);
+    }
+    ~SentPacketRing() {
+        for (auto& Entry : Packets) {
+            QuicSentPacketRingRemove(&Ring, Entry.second);
+            delete Entry.second;
+        }
+        QuicSentPacketRingUninitialize(&Ring);
+    }
+    void Add(uint64_t PacketNumber) {
+        QUIC_SENT_PACKET_METADATA* Packet = new QUIC_SENT_PACKET_METADATA;
+        CxPlatZeroMemory(Packet, sizeof(*Packet));
+        Packet->PacketNumber = PacketNumber;
+        ASSERT_TRUE(QuicSentPacketRingAdd(&Ring, Packet));
+        Packets[PacketNumber] = Packet;
+    }
+    void Remove(uint64_t PacketNumber) {
+        QUIC_SENT_PACKET_METADATA* Packet = Packets[PacketNumber];
+        Packets.erase(PacketNumber);
+        QuicSentPacketRingRemove(&Ring, Packet);
+        delete Packet;
+    }
+    void Validate() {
+        ASSERT_EQ(Packets.size(), (size_t)Ring.Count);
+        ASSERT_EQ(Packets.empty(), (bool)QuicSentPacketRingIsEmpty(&Ring));
+        if (Packets.empty()) {
+            ASSERT_EQ(nullptr, QuicSentPacketRingFirst(&Ring));
+            ASSERT_EQ(nullptr, QuicSentPacketRingNext(&Ring, 0));
+            return;
+        }
+        const uint64_t First = Packets.begin()->first;
+        const uint64_t Last = Packets.rbegin()->first;
+        if (Ring.Indexed) {
+            ASSERT_LT((size_t)QUIC_SENT_PACKET_RING_LIST_MAX / 2, Packets.size());
+            ASSERT_EQ(First, Ring.FirstPacketNumber);
+            ASSERT_LE(Last - First + 1, (uint64_t)Ring.Length);
+        }
+        ASSERT_EQ(Packets.begin()->second, QuicSentPacketRingFirst(&Ring));
+        for (uint64_t PacketNumber = First - CXPLAT_MIN(First, 2); PacketNumber <= Last + 2; ++PacketNumber) {
+            auto Entry = Packets.find(PacketNumber);
+            ASSERT_EQ(
+                Entry == Packets.end() ? nullptr : Entry->second,
+                QuicSentPacketRingGet(&Ring, PacketNumber));
+            auto Next = Packets.lower_bound(PacketNumber);
+            ASSERT_EQ(
+                Next == Packets.end() ? nullptr : Next->second,
+                QuicSentPacketRingNext(&Ring, PacketNumber));
+        }
+    }
+    void WalkNext(uint64_t PacketNumber) {
+        //
+        // Walks the ring with Next the way the ACK and loss scans do, checking
+        // every packet it returns.
+        //
+        auto Expected = Packets.lower_bound(PacketNumber);
+        QUIC_SENT_PACKET_METADATA* Packet;
+        while ((Packet = QuicSentPacketRingNext(&Ring, PacketNumber)) != NULL) {
+            ASSERT_NE(Packets.end(), Expected);
+            ASSERT_EQ(Expected->second, Packet);
+            PacketNumber = Packet->PacketNumber + 1;
+            ++Expected;
+        }
+        ASSERT_EQ(Packets.end(), Expected);
+    }
+    void Fill(uint64_t* NextPacketNumber, uint32_t Count) {
+        for (uint32_t i = 0; i < Count; ++i) {
+            Add((*NextPacketNumber)++);
+        }
+    }
+};
+
+TEST(SentPacketRingTest, Empty)
+{
+    SentPacketRing Ring;
+    Ring.Validate();
+    ASSERT_EQ(nullptr, QuicSentPacketRingGet(&Ring.Ring, 0));
+    ASSERT_EQ(nullptr, QuicSentPacketRingGet(&Ring.Ring, UINT64_MAX));
+    Ring.Add(1000);
+    Ring.Validate();
+    Ring.Remove(1000);
+    Ring.Validate();
+}
+
+TEST(SentPacketRingTest, SkippedPacketNumbers)
+{
+    //
+    // Both with the packets in the list, and in the slots (kept there by the
+    // packets added after them).
+    //
+    for (uint32_t Indexed = 0; Indexed < 2; ++Indexed) {
+        SentPacketRing Ring;
+        const uint64_t PacketNumbers[] = { 5, 6, 8, 9, 10, 14, 15, 17 };
+        for (uint64_t PacketNumber : PacketNumbers) {
+            Ring.Add(PacketNumber);
+            Ring.Validate();
+        }
+        uint64_t NextPacketNumber = 100;
+        if (Indexed) {
+            Ring.Fill(&NextPacketNumber, QUIC_SENT_PACKET_RING_LIST_MAX);
+            ASSERT_TRUE(Ring.Ring.Indexed);
+        }
+
+        //
+        // Removing the first packet trims the slots left empty in front.
+        //
+        const uint64_t Removes[] = { 9, 5, 17, 6, 14, 10, 8, 15 };
+        for (uint64_t PacketNumber : Removes) {
+            Ring.Remove(PacketNumber);
+            Ring.Validate();
+        }
+        ASSERT_EQ(Indexed != 0, (bool)Ring.Ring.Indexed);
+
+        //
+        // An empty ring starts over at the next packet number.
+        //
+        while (!Ring.Packets.empty()) {
+            Ring.Remove(Ring.Packets.begin()->first);
+        }
+        Ring.Add(1000000);
+        Ring.Add(1000002);
+        Ring.Validate();
+    }
+}
+
+TEST(SentPacketRingTest, ListAndIndexed)
+{
+    SentPacketRing Ring;
+    uint64_t NextPacketNumber = 0x12345;
+
+    //
+    // The packets are moved into the slots once there are more than fit in
+    // the list, and back to the list once no more than half as many are left.
+    //
+    Ring.Fill(&NextPacketNumber, QUIC_SENT_PACKET_RING_LIST_MAX);
+    ASSERT_FALSE(Ring.Ring.Indexed);
+    Ring.Validate();
+    Ring.Add(NextPacketNumber += 3);
+    ASSERT_TRUE(Ring.Ring.Indexed);
+    Ring.Validate();
+    Ring.WalkNext(0);
+    while (Ring.Packets.size() > QUIC_SENT_PACKET_RING_LIST_MAX / 2 + 1) {
+        Ring.Remove(std::next(Ring.Packets.begin(), Ring.Packets.size() / 2)->first);
+    }
+    ASSERT_TRUE(Ring.Ring.Indexed);
+    Ring.Validate();
+    Ring.Remove(Ring.Packets.begin()->first);
+    ASSERT_FALSE(Ring.Ring.Indexed);
+    Ring.Validate();
+    Ring.WalkNext(0);
+
+    //
+    // Going back to the slots reuses them if the packets fit.
+    //
+    const uint32_t Capacity = Ring.Ring.Capacity;
+    NextPacketNumber++;
+    Ring.Fill(&NextPacketNumber, QUIC_SENT_PACKET_RING_LIST_MAX / 2 + 1);
+    ASSERT_TRUE(Ring.Ring.Indexed);
+    ASSERT_EQ(Capacity, Ring.Ring.Capacity);
+    Ring.Validate();
+}
+
+TEST(SentPacketRingTest, WrapAndGrow)
+{
+    SentPacketRing Ring;
+    uint64_t NextPacketNumber = 0x12345;
+    Ring.Fill(&NextPacketNumber, QUIC_SENT_PACKET_RING_LIST_MAX + 1);
+    ASSERT_TRUE(Ring.Ring.Indexed);
+    const uint32_t InitialCapacity = Ring.Ring.Capacity;
+
+    //
+    // A window that stays the same size only moves around the ring.
+    //
+    for (uint32_t i = 0; i < 10 * InitialCapacity; ++i) {
+        Ring.Add(NextPacketNumber++);
+        Ring.Remove(Ring.Packets.begin()->first);
+    }
+    Ring.Validate();
+    ASSERT_EQ(InitialCapacity, Ring.Ring.Capacity);
+
+    //
+    // A growing window grows the ring, wherever the first packet is, and a
+    // gap larger than the ring does too.
+    //
+    for (uint32_t i = 0; i < 3 * InitialCapacity; ++i) {
+        Ring.Add(NextPacketNumber++);
+        if (i % 3 == 0) {
+            Ring.Remove(Ring.Packets.rbegin()->first);
+        }
+    }
+    Ring.Validate();
+    ASSERT_LT(InitialCapacity, Ring.Ring.Capacity);
+    NextPacketNumber += 4 * Ring.Ring.Capacity;
+    Ring.Add(NextPacketNumber);
+    Ring.Validate();
+}
+
+TEST(SentPacketRingTest, WrapIntoFirstWord)
+{
+    //
+    // The end of the ring wraps around into the bitmap word holding the first
+    // packet, so scans past the last packet must not find the first ones.
+    //
+    SentPacketRing Ring;
+    uint64_t NextPacketNumber = 0;
+    Ring.Fill(&NextPacketNumber, QUIC_SENT_PACKET_RING_LIST_MAX + 1);
+    ASSERT_TRUE(Ring.Ring.Indexed);
+    const uint32_t Capacity = Ring.Ring.Capacity;
+    Ring.Fill(&NextPacketNumber, Capacity - (uint32_t)NextPacketNumber);
+    for (uint64_t PacketNumber = 0; PacketNumber < 10; ++PacketNumber) {
+        Ring.Remove(PacketNumber);
+    }
+    Ring.Fill(&NextPacketNumber, 6);
+    for (uint64_t PacketNumber = Capacity; PacketNumber < Capacity + 6; ++PacketNumber) {
+        Ring.Remove(PacketNumber);
+    }
+    ASSERT_EQ(Capacity, Ring.Ring.Capacity);
+    ASSERT_EQ(10u, Ring.Ring.FirstPacketNumber);
+    ASSERT_EQ(nullptr, QuicSentPacketRingNext(&Ring.Ring, Capacity));
+    ASSERT_EQ(nullptr, QuicSentPacketRingNext(&Ring.Ring, Capacity + 1));
+    ASSERT_EQ(nullptr, QuicSentPacketRingNext(&Ring.Ring, Capacity + 5));
+    Ring.Validate();
+    Ring.WalkNext(0);
+    Ring.WalkNext(40);
+}
+
+TEST(SentPacketRingTest, Random)
+{
+    //
+    // The window grows and shrinks in turn, so the packets move between the
+    // list and the slots.
+    //
+    SentPacketRing Ring;
+    srand(0x24);
+    uint64_t NextPacketNumber = 0;
+    uint32_t IndexedRounds = 0;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        const int AddPercent = (i / 2048) % 2 == 0 ? 60 : 40;
+        if (Ring.Packets.empty() || rand() % 100 < AddPercent) {
+            NextPacketNumber += 1 + (rand() % 8 == 0 ? rand() % 4 : 0);
+            Ring.Add(NextPacketNumber);
+        } else {
+            auto Entry = Ring.Packets.lower_bound(NextPacketNumber - rand() % 128);
+            if (Entry == Ring.Packets.end()) {
+                Entry = Ring.Packets.begin();
+            }
+            Ring.Remove(Entry->first);
+        }
+        const uint64_t Back = rand() % 256;
+        Ring.WalkNext(NextPacketNumber > Back ? NextPacketNumber - Back : 0);
+        if (i % 512 == 0) {
+            Ring.Validate();
+        }
+        IndexedRounds += Ring.Ring.Indexed ? 1 : 0;
+    }
+    Ring.Validate();
+    ASSERT_LT(0u, IndexedRounds);
+    ASSERT_GT(20000u, IndexedRounds);
+}
@@ -0,0 +1,398 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for the timer wheel.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "TimerWheelTest.cpp.clog.h"
+#endif
+
+#include <random>
+#include <vector>
+
+struct TimerWheelScope {
+    QUIC_TIMER_WHEEL TimerWheel;
+    QUIC_CONNECTION* Connections;
+    uint32_t ConnectionCount;
+    uint64_t TimeNow;
+
+    TimerWheelScope(uint32_t Count) : ConnectionCount(Count) {
+        CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(QuicTimerWheelInitialize(&TimerWheel)));
+        TimeNow = CxPlatTimeUs64();
+        Connections =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_CONNECTION) * Count,
+                QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connections != nullptr);
+        CxPlatZeroMemory(Connections, sizeof(QUIC_CONNECTION) * Count);
+        for (uint32_t i = 0; i < Count; ++i) {
+            Connections[i].RefCount = 1;
+#if DEBUG
+            CxPlatRefInitializeMultiple(
+                Connections[i].RefTypeBiasedCount,
+                QUIC_CONN_REF_COUNT);
+#endif
+            Connections[i].EarliestExpirationTime = UINT64_MAX;
+        }
+    }
+
+    ~TimerWheelScope() {
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            QuicTimerWheelRemoveConnection(&TimerWheel, &Connections[i]);
+        }
+        QuicTimerWheelUninitialize(&TimerWheel);
+        CXPLAT_FREE(Connections, QUIC_POOL_TEST);
+    }
+
+    void Set(uint32_t i, uint64_t ExpirationTime) {
+        Connections[i].EarliestExpirationTime = ExpirationTime;
+        QuicTimerWheelUpdateConnection(&TimerWheel, &Connections[i]);
+    }
+
+    //
+    // Advances the time and returns the number of expired connections, after
+    // checking they have all expired.
+    //
+    uint32_t Advance(uint64_t TimeUs) {
+        TimeNow += TimeUs;
+        CXPLAT_LIST_ENTRY ExpiredTimers;
+        CxPlatListInitializeHead(&ExpiredTimers);
+        QuicTimerWheelGetExpired(&TimerWheel, TimeNow, &ExpiredTimers);
+        uint32_t Count = 0;
+        while (!CxPlatListIsEmpty(&ExpiredTimers)) {
+            CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&ExpiredTimers);
+            Entry->Flink = NULL;
+            QUIC_CONNECTION* Connection =
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+            EXPECT_LE(Connection->EarliestExpirationTime, TimeNow);
+            Connection->EarliestExpirationTime = UINT64_MAX;
+            //
+            // Drop the worker's reference, which is never the last one here.
+            //
+#if DEBUG
+            CxPlatRefDecrement(&Connection->RefTypeBiasedCount[QUIC_CONN_REF_WORKER]);
+#endif
+            Connection->RefCount--;
+            Count++;
+        }
+        return Count;
+    }
+};
+
+TEST(TimerWheelTest, Levels)
+{
+    TimerWheelScope Scope(5);
+    const uint64_t Start = Scope.TimeNow;
+    const uint64_t Delays[] = {
+        500,                        // Level 0
+        MS_TO_US(200),              // Level 1
+        S_TO_US(30),                // Level 2
+        S_TO_US(600),               // Level 3
+        S_TO_US(6ull * 60 * 60),    // Overflow
+    };
+    for (uint32_t i = 0; i < ARRAYSIZE(Delays); ++i) {
+        Scope.Set(i, Start + Delays[i]);
+    }
+    ASSERT_EQ(5u, Scope.TimerWheel.ConnectionCount);
+    ASSERT_EQ(Start + Delays[0], Scope.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(&Scope.Connections[0], Scope.TimerWheel.NextConnection);
+
+    for (uint32_t i = 0; i < ARRAYSIZE(Delays); ++i) {
+        //
+        // Follow the next expiration time, which may stop early to cascade,
+        // once per level and up to twice for the overflow list.
+        //
+        uint32_t Wakeups = 0;
+        uint32_t Expired = 0;
+        while (Expired == 0) {
+            const uint64_t Next = Scope.TimerWheel.NextExpirationTime;
+            ASSERT_NE(UINT64_MAX, Next);
+            ASSERT_LE(Next, Start + Delays[i]);
+            ASSERT_GT(Next, Scope.TimeNow);
+            Expired = Scope.Advance(Next - Scope.TimeNow);
+            ASSERT_LE(++Wakeups, QUIC_TIMER_WHEEL_LEVEL_COUNT + 2u);
+        }
+        ASSERT_EQ(1u, Expired);
+        ASSERT_EQ(Start + Delays[i], Scope.TimeNow);
+        ASSERT_EQ(UINT64_MAX, Scope.Connections[i].EarliestExpirationTime);
+    }
+    ASSERT_EQ(0u, Scope.TimerWheel.ConnectionCount);
+    ASSERT_EQ(UINT64_MAX, Scope.TimerWheel.NextExpirationTime);
+}
+
+TEST(TimerWheelTest, SubMillisecond)
+{
+    TimerWheelScope Scope(3);
+    const uint64_t Base = MS_TO_US(US_TO_MS(Scope.TimeNow) + 2);
+    Scope.Set(0, Base + 100);
+    Scope.Set(1, Base + 900);
+    Scope.Set(2, Base + 500);
+
+    ASSERT_EQ(0u, Scope.Advance(Base + 99 - Scope.TimeNow));
+    ASSERT_EQ(Base + 100, Scope.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(1u, Scope.Advance(1));
+    ASSERT_EQ(Base + 500, Scope.TimerWheel.NextExpirationTime);
+    ASSERT_EQ(&Scope.Connections[2], Scope.TimerWheel.NextConnection);
+    ASSERT_EQ(2u, Scope.Advance(400 + 400));
+}
+
+TEST(TimerWheelTest, Randomized)
+{
+    const uint32_t Count = 512;
+    TimerWheelScope Scope(Count);
+    std::mt19937_64 Rng(1234);
+    std::vector<uint64_t> Expected(Count, UINT64_MAX);
+
+    for (uint32_t Round = 0; Round < 20000; ++Round) {
+        const uint32_t i = (uint32_t)(Rng() % Count);
+        switch (Rng() % 8) {
+        case 0:
+            Scope.Set(i, UINT64_MAX);
+            Expected[i] = UINT64_MAX;
+            break;
+        case 1: { // Past or far future.
+            uint64_t Time =
+                Rng() % 2 ?
+                    Scope.TimeNow - Rng() % S_TO_US(10) :
+                    Scope.TimeNow + Rng() % S_TO_US(8ull * 60 * 60);
+            Scope.Set(i, Time);
+            Expected[i] = Time;
+            break;
+        }
+        case 2: { // Advance.
+            const uint64_t Step =
+                Rng() % 16 == 0 ? Rng() % S_TO_US(60ull * 60) : Rng() % MS_TO_US(500);
+            uint64_t Min = UINT64_MAX;
+            uint32_t ExpectedCount = 0;
+            for (uint32_t j = 0; j < Count; ++j) {
+                if (Expected[j] <= Scope.TimeNow + Step) {
+                    ExpectedCount++;
+                    Expected[j] = UINT64_MAX;
+                } else if (Expected[j] < Min) {
+                    Min = Expected[j];
+                }
+            }
+            ASSERT_EQ(ExpectedCount, Scope.Advance(Step));
+            ASSERT_LE(Scope.TimerWheel.NextExpirationTime, Min);
+            if (Min != UINT64_MAX) {
+                ASSERT_GT(Scope.TimerWheel.NextExpirationTime, Scope.TimeNow);
+            } else {
+                ASSERT_EQ(UINT64_MAX, Scope.TimerWheel.NextExpirationTime);
+            }
+            break;
+        }
+        default: { // Near future, like ACK, loss and idle timers.
+            uint64_t Time = Scope.TimeNow + Rng() % S_TO_US(40);
+            Scope.Set(i, Time);
+            Expected[i] = Time;
+            break;
+        }
+        }
+
+        uint64_t Min = UINT64_MAX;
+        for (uint32_t j = 0; j < Count; ++j) {
+            if (Expected[j] < Min) {
+                Min = Expected[j];
+            }
+        }
+        ASSERT_LE(Scope.TimerWheel.NextExpirationTime, Min);
+        if (Scope.TimerWheel.NextConnection != NULL) {
+            ASSERT_EQ(Min, Scope.TimerWheel.NextExpirationTime);
+        }
+    }
+}
+
+//
+// A connection whose timers are driven by its worker's timer wheel, the way
+// the worker does it.
+//
+struct ConnTimerScope {
+    QUIC_WORKER* Worker;
+    QUIC_CONNECTION* Connection;
+    uint64_t TimeNow;
+
+    ConnTimerScope() {
+        Worker = (QUIC_WORKER*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_WORKER), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Worker != nullptr);
+        CxPlatZeroMemory(Worker, sizeof(QUIC_WORKER));
+        CXPLAT_FRE_ASSERT(QUIC_SUCCEEDED(QuicTimerWheelInitialize(&Worker->TimerWheel)));
+        TimeNow = CxPlatTimeUs64();
+        Connection =
+            (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+        CXPLAT_FRE_ASSERT(Connection != nullptr);
+        CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+        Connection->RefCount = 1;
+#if DEBUG
+        CxPlatRefInitializeMultiple(Connection->RefTypeBiasedCount, QUIC_CONN_REF_COUNT);
+#endif
+        Connection->Worker = Worker;
+        Connection->EarliestExpirationTime = UINT64_MAX;
+        for (uint32_t i = 0; i < QUIC_CONN_TIMER_COUNT; ++i) {
+            Connection->ExpirationTimes[i] = UINT64_MAX;
+        }
+        for (uint32_t i = 0; i < QUIC_CONN_TIMER_COARSE_COUNT; ++i) {
+            Connection->CoarseDeadlines[i] = UINT64_MAX;
+        }
+    }
+
+    ~ConnTimerScope() {
+        QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+        QuicTimerWheelUninitialize(&Worker->TimerWheel);
+        QUIC_CONNECTION* TestConnection = Connection;
+        CXPLAT_FREE(TestConnection, QUIC_POOL_TEST);
+        QUIC_WORKER* TestWorker = Worker;
+        CXPLAT_FREE(TestWorker, QUIC_POOL_TEST);
+    }
+
+    void Set(QUIC_CONN_TIMER_TYPE Type, uint64_t Delay) {
+        QuicConnTimerSetEx(Connection, Type, Delay, TimeNow);
+    }
+
+    uint64_t Deadline(QUIC_CONN_TIMER_TYPE Type) const {
+        return Connection->CoarseDeadlines[Type - QUIC_CONN_TIMER_FIRST_COARSE];
+    }
+
+    //
+    // Checks the connection is armed in the wheel at the given time. The wheel
+    // only keeps the exact next expiration time for timers in its first level,
+    // so it's only checked as a lower bound.
+    //
+    void ValidateArmed(uint64_t ExpirationTime) const {
+        ASSERT_EQ(ExpirationTime, Connection->EarliestExpirationTime);
+        ASSERT_EQ(1u, Worker->TimerWheel.ConnectionCount);
+        ASSERT_LE(Worker->TimerWheel.NextExpirationTime, ExpirationTime);
+    }
+
+    //
+    // Advances the time and indicates the expired timers to the connection.
+    // Returns whether the connection's timers expired.
+    //
+    bool Advance(uint64_t TimeUs) {
+        TimeNow += TimeUs;
+        CXPLAT_LIST_ENTRY ExpiredTimers;
+        CxPlatListInitializeHead(&ExpiredTimers);
+        QuicTimerWheelGetExpired(&Worker->TimerWheel, TimeNow, &ExpiredTimers);
+        if (CxPlatListIsEmpty(&ExpiredTimers)) {
+            return false;
+        }
+        CXPLAT_LIST_ENTRY* Entry = CxPlatListRemoveHead(&ExpiredTimers);
+        Entry->Flink = NULL;
+        EXPECT_TRUE(CxPlatListIsEmpty(&ExpiredTimers));
+        EXPECT_EQ(Connection, CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink));
+        QuicConnTimerExpired(Connection, TimeNow);
+        //
+        // Drop the worker's reference, which is never the last one here.
+        //
+#if DEBUG
+        CxPlatRefDecrement(&Connection->RefTypeBiasedCount[QUIC_CONN_REF_WORKER]);
+#endif
+        Connection->RefCount--;
+        return true;
+    }
+};
+
+//
+// Pushing a coarse timer out only records its deadline; the timer stays armed
+// at the earlier time. Pulling it in re-arms it right away.
+//
+TEST(TimerWheelTest, CoarseTimerDeferred)
+{
+    ConnTimerScope Scope;
+    const uint64_t Start = Scope.TimeNow;
+
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    ASSERT_EQ(Start + MS_TO_US(10), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    ASSERT_EQ(Start + MS_TO_US(10), Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    Scope.ValidateArmed(Start + MS_TO_US(10));
+
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(1)));
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    ASSERT_EQ(Start + MS_TO_US(10), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    ASSERT_EQ(Start + MS_TO_US(11), Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    Scope.ValidateArmed(Start + MS_TO_US(10));
+
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(5));
+    ASSERT_EQ(Start + MS_TO_US(6), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    ASSERT_EQ(Start + MS_TO_US(6), Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    Scope.ValidateArmed(Start + MS_TO_US(6));
+
+    //
+    // Other timers are re-armed whenever they move.
+    //
+    Scope.Set(QUIC_CONN_TIMER_LOSS_DETECTION, MS_TO_US(2));
+    Scope.ValidateArmed(Start + MS_TO_US(3));
+    Scope.Set(QUIC_CONN_TIMER_LOSS_DETECTION, MS_TO_US(20));
+    ASSERT_EQ(Start + MS_TO_US(21), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_LOSS_DETECTION]);
+    Scope.ValidateArmed(Start + MS_TO_US(6));
+}
+
+//
+// When a coarse timer fires before its deadline, it's re-armed at the deadline
+// instead of being indicated.
+//
+TEST(TimerWheelTest, CoarseTimerRearmedOnExpiry)
+{
+    ConnTimerScope Scope;
+    const uint64_t Start = Scope.TimeNow;
+
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    Scope.Set(QUIC_CONN_TIMER_KEEP_ALIVE, MS_TO_US(20));
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(5)));
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    Scope.Set(QUIC_CONN_TIMER_KEEP_ALIVE, MS_TO_US(20));
+
+    ASSERT_TRUE(Scope.Advance(MS_TO_US(5)));
+    ASSERT_EQ(Start + MS_TO_US(15), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    ASSERT_EQ(Start + MS_TO_US(15), Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    ASSERT_EQ(Start + MS_TO_US(20), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_KEEP_ALIVE]);
+    ASSERT_EQ(Start + MS_TO_US(25), Scope.Deadline(QUIC_CONN_TIMER_KEEP_ALIVE));
+    Scope.ValidateArmed(Start + MS_TO_US(15));
+
+    //
+    // Pushed out again before the re-armed time, it's re-armed again.
+    //
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(4)));
+    ASSERT_TRUE(Scope.Advance(MS_TO_US(1)));
+    ASSERT_EQ(Start + MS_TO_US(20), Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    Scope.ValidateArmed(Start + MS_TO_US(20));
+}
+
+//
+// Canceling a coarse timer also drops its deadline, so the earlier armed time
+// neither fires nor re-arms it.
+//
+TEST(TimerWheelTest, CoarseTimerCancel)
+{
+    ConnTimerScope Scope;
+
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(1)));
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    QuicConnTimerCancel(Scope.Connection, QUIC_CONN_TIMER_IDLE);
+    ASSERT_EQ(UINT64_MAX, Scope.Connection->ExpirationTimes[QUIC_CONN_TIMER_IDLE]);
+    ASSERT_EQ(UINT64_MAX, Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    ASSERT_EQ(UINT64_MAX, Scope.Connection->EarliestExpirationTime);
+    ASSERT_EQ(0u, Scope.Worker->TimerWheel.ConnectionCount);
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(20)));
+
+    //
+    // With another timer still set, the connection is re-armed for that one.
+    //
+    const uint64_t Start = Scope.TimeNow;
+    Scope.Set(QUIC_CONN_TIMER_KEEP_ALIVE, MS_TO_US(30));
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(1)));
+    Scope.Set(QUIC_CONN_TIMER_IDLE, MS_TO_US(10));
+    QuicConnTimerCancel(Scope.Connection, QUIC_CONN_TIMER_IDLE);
+    ASSERT_EQ(UINT64_MAX, Scope.Deadline(QUIC_CONN_TIMER_IDLE));
+    Scope.ValidateArmed(Start + MS_TO_US(30));
+    ASSERT_FALSE(Scope.Advance(MS_TO_US(20)));
+}
@@ -0,0 +1,323 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Unit test for handing queued connections over between workers.
+
+--*/
+
+#include "main.h"
+#ifdef QUIC_CLOG
+#include "WorkerTest.cpp.clog.h"
+#endif
+
+extern "C"
+void
+MsQuicCalculatePartitionMask(
+    void
+    );
+
+const uint32_t ConnectionCount = 3;
+
+struct WorkerPair {
+    QUIC_WORKER_POOL* Pool; // The victim is worker 0 and the thief worker 1.
+    QUIC_WORKER& Victim;
+    QUIC_WORKER& Thief;
+    QUIC_PARTITION PerfCounters; // Only the perf counters are used.
+    QUIC_REGISTRATION* Registration;
+    QUIC_BINDING* Binding;
+    QUIC_CONNECTION* Connections[ConnectionCount];
+
+    WorkerPair() :
+        Pool(AllocatePool()), Victim(Pool->Workers[0]), Thief(Pool->Workers[1]) {
+        CxPlatZeroMemory(&PerfCounters, sizeof(PerfCounters));
+        InitializeWorker(&Victim);
+        InitializeWorker(&Thief);
+        Registration =
+            (QUIC_REGISTRATION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_REGISTRATION), QUIC_POOL_TEST);
+        CxPlatZeroMemory(Registration, sizeof(QUIC_REGISTRATION));
+        Registration->WorkerPool = Pool;
+        Binding = (QUIC_BINDING*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_BINDING), QUIC_POOL_TEST);
+        CxPlatZeroMemory(Binding, sizeof(QUIC_BINDING));
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            QUIC_CONNECTION* Connection =
+                (QUIC_CONNECTION*)CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), QUIC_POOL_TEST);
+            CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+            Connection->Registration = Registration;
+            Connection->Paths[0].Binding = Binding;
+            Connection->State.Connected = TRUE;
+            Connection->RefCount = 1;
+            for (uint32_t j = 0; j < QUIC_CONN_REF_COUNT; ++j) {
+                Connection->RefTypeBiasedCount[j] = 1;
+            }
+            Connections[i] = Connection;
+        }
+        Reset();
+    }
+
+    ~WorkerPair() {
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            QUIC_CONNECTION* Connection = Connections[i];
+            CXPLAT_FREE(Connection, QUIC_POOL_TEST);
+        }
+        QUIC_BINDING* TestBinding = Binding;
+        CXPLAT_FREE(TestBinding, QUIC_POOL_TEST);
+        QUIC_REGISTRATION* TestRegistration = Registration;
+        CXPLAT_FREE(TestRegistration, QUIC_POOL_TEST);
+        UninitializeWorker(&Thief);
+        UninitializeWorker(&Victim);
+        QUIC_WORKER_POOL* TestPool = Pool;
+        CXPLAT_FREE(TestPool, QUIC_POOL_TEST);
+    }
+
+    static QUIC_WORKER_POOL* AllocatePool() {
+        const size_t Size = sizeof(QUIC_WORKER_POOL) + 2 * sizeof(QUIC_WORKER);
+        QUIC_WORKER_POOL* NewPool =
+            (QUIC_WORKER_POOL*)CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_TEST);
+        CxPlatZeroMemory(NewPool, Size);
+        NewPool->WorkerCount = 2;
+        return NewPool;
+    }
+
+    void InitializeWorker(QUIC_WORKER* Worker) {
+        CxPlatZeroMemory(Worker, sizeof(*Worker));
+        Worker->Partition = &PerfCounters;
+        Worker->Enabled = TRUE;
+        CxPlatEventInitialize(&Worker->Ready, FALSE, FALSE);
+        CxPlatDispatchLockInitialize(&Worker->Lock);
+        CxPlatListInitializeHead(&Worker->Connections);
+        Worker->PriorityConnectionsTail = &Worker->Connections.Flink;
+        CxPlatListInitializeHead(&Worker->Listeners);
+        CxPlatListInitializeHead(&Worker->Operations);
+        QuicTimerWheelInitialize(&Worker->TimerWheel);
+    }
+
+    static void UninitializeWorker(QUIC_WORKER* Worker) {
+        QuicTimerWheelUninitialize(&Worker->TimerWheel);
+        CxPlatDispatchLockUninitialize(&Worker->Lock);
+        CxPlatEventUninitialize(Worker->Ready);
+    }
+
+    //
+    // Queues all the connections on the victim, which is loaded and asked for
+    // one of them by the idle thief.
+    //
+    void Reset() {
+        CxPlatListInitializeHead(&Victim.Connections);
+        Victim.PriorityConnectionsTail = &Victim.Connections.Flink;
+        CxPlatListInitializeHead(&Thief.Connections);
+        Thief.PriorityConnectionsTail = &Thief.Connections.Flink;
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            QUIC_CONNECTION* Connection = Connections[i];
+            Connection->Worker = &Victim;
+            Connection->Partition = Victim.Partition;
+            Connection->State.UpdateWorker = FALSE;
+            Connection->HasQueuedWork = TRUE;
+            Connection->HasPriorityWork = FALSE;
+            CxPlatListInsertTail(&Victim.Connections, &Connection->WorkerLink);
+        }
+        Victim.AverageQueueDelay = MsQuicLib.Settings.MaxWorkerQueueDelayUs;
+        Victim.LastStealTime = 0;
+        Victim.StealRequest = &Thief;
+        Thief.LastStealTime = 0;
+    }
+
+    //
+    // Checks that each connection is queued exactly once, on its own worker's
+    // queue, and with the priority connections if it has priority work.
+    //
+    void Validate() {
+        uint32_t Queued[ConnectionCount] = {0};
+        ValidateWorker(&Victim, Queued);
+        ValidateWorker(&Thief, Queued);
+        for (uint32_t i = 0; i < ConnectionCount; ++i) {
+            ASSERT_EQ(1u, Queued[i]);
+        }
+    }
+
+    void ValidateWorker(QUIC_WORKER* Worker, uint32_t* Queued) {
+        BOOLEAN InPriority = Worker->PriorityConnectionsTail != &Worker->Connections.Flink;
+        CXPLAT_LIST_ENTRY* Prev = &Worker->Connections;
+        for (CXPLAT_LIST_ENTRY* Entry = Worker->Connections.Flink;
+             Entry != &Worker->Connections;
+             Entry = Entry->Flink) {
+            ASSERT_EQ(Prev, Entry->Blink);
+            QUIC_CONNECTION* Connection =
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, WorkerLink);
+            uint32_t i = 0;
+            while (i < ConnectionCount && Connections[i] != Connection) {
+                ++i;
+            }
+            ASSERT_LT(i, ConnectionCount);
+            ASSERT_EQ(Worker, Connection->Worker);
+            ASSERT_EQ((bool)InPriority, (bool)Connection->HasPriorityWork);
+            Queued[i]++;
+            if (Worker->PriorityConnectionsTail == &Entry->Flink) {
+                InPriority = FALSE;
+            }
+            Prev = Entry;
+        }
+        ASSERT_EQ(Prev, Worker->Connections.Blink);
+        ASSERT_FALSE(InPriority);
+    }
+};
+
+TEST(WorkerTest, ShedConnection)
+{
+    WorkerPair Workers;
+
+    //
+    // The connection at the tail of the queue moves to the thief.
+    //
+    QUIC_CONNECTION* Tail = Workers.Connections[ConnectionCount - 1];
+    QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+    ASSERT_EQ(&Workers.Thief, Tail->Worker);
+    ASSERT_TRUE(Tail->State.UpdateWorker);
+    ASSERT_EQ(1u, Workers.Thief.StolenConnectionCount);
+    ASSERT_EQ(1u, Workers.Victim.ShedConnectionCount);
+    Workers.Validate();
+
+    //
+    // Nothing moves to a thief that's been disabled.
+    //
+    Workers.Reset();
+    Workers.Thief.Enabled = FALSE;
+    QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+    ASSERT_EQ(&Workers.Victim, Tail->Worker);
+    Workers.Validate();
+}
+
+TEST(WorkerTest, PartitionUpdateAfterSteal)
+{
+    WorkerPair Workers;
+    auto OldPartitionCount = MsQuicLib.PartitionCount;
+    auto OldPartitionMask = MsQuicLib.PartitionMask;
+    MsQuicLib.PartitionCount = 2;
+    MsQuicCalculatePartitionMask();
+
+    QUIC_CONNECTION* Tail = Workers.Connections[ConnectionCount - 1];
+    Tail->PartitionID = QuicPartitionIdCreate(0);
+    QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+    ASSERT_EQ(&Workers.Thief, Tail->Worker);
+    Tail->State.UpdateWorker = FALSE; // As when the thief first processes it.
+
+    //
+    // Packets received on the thief's partition move the connection to its
+    // partition's worker, which it's already on.
+    //
+    Tail->PartitionID = QuicPartitionIdCreate(1);
+    Tail->State.UpdateWorker = TRUE;
+    ASSERT_TRUE(QuicWorkerKeepConnection(&Workers.Thief, Tail));
+    ASSERT_FALSE(Tail->State.UpdateWorker);
+    ASSERT_EQ(&Workers.Thief, Tail->Worker);
+    Workers.Validate();
+
+    //
+    // Packets received back on the victim's partition still move it there.
+    //
+    Tail->PartitionID = QuicPartitionIdCreate(0);
+    Tail->State.UpdateWorker = TRUE;
+    ASSERT_FALSE(QuicWorkerKeepConnection(&Workers.Thief, Tail));
+    ASSERT_TRUE(Tail->State.UpdateWorker);
+    ASSERT_EQ(&Workers.Thief, Tail->Worker);
+
+    MsQuicLib.PartitionCount = OldPartitionCount;
+    MsQuicLib.PartitionMask = OldPartitionMask;
+}
+
+TEST(WorkerTest, QueuePriorityOnStaleWorker)
+{
+    WorkerPair Workers;
+
+    //
+    // Callers read the connection's worker without a lock, so they may still
+    // queue it on the worker it was just taken from.
+    //
+    QUIC_CONNECTION* Tail = Workers.Connections[ConnectionCount - 1];
+    QUIC_WORKER* StaleWorker = Tail->Worker;
+    QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+    ASSERT_EQ(&Workers.Thief, Tail->Worker);
+
+    QuicWorkerQueuePriorityConnection(StaleWorker, Tail);
+    ASSERT_TRUE(Tail->HasPriorityWork);
+    ASSERT_EQ(&Tail->WorkerLink.Flink, Workers.Thief.PriorityConnectionsTail);
+    ASSERT_EQ(&Workers.Victim.Connections.Flink, Workers.Victim.PriorityConnectionsTail);
+    Workers.Validate();
+}
+
+struct PriorityQueueContext {
+    QUIC_CONNECTION* Connection;
+    long volatile Started;
+    static CXPLAT_THREAD_CALLBACK(QueueThread, Context) {
+        auto Ctx = (PriorityQueueContext*)Context;
+        InterlockedIncrement(&Ctx->Started);
+        QUIC_CONNECTION* Connection = Ctx->Connection;
+        QuicWorkerQueuePriorityConnection(
+            (QUIC_WORKER*)QuicReadPtrNoFence((void**)&Connection->Worker),
+            Connection);
+        CXPLAT_THREAD_RETURN(0);
+    }
+};
+
+//
+// Another thread queues priority work on the connection being handed over,
+// like an app thread shutting it down, while the loaded worker sheds it. The
+// rounds alternate between the priority work being queued strictly before,
+// strictly after, and racing with the steal.
+//
+TEST(WorkerTest, QueuePriorityDuringSteal)
+{
+    WorkerPair Workers;
+    const uint32_t RoundCount = 1000;
+    QUIC_CONNECTION* Tail = Workers.Connections[ConnectionCount - 1];
+    uint32_t Stolen = 0;
+    uint32_t Kept = 0;
+
+    for (uint32_t i = 0; i < RoundCount; ++i) {
+        Workers.Reset();
+        PriorityQueueContext Context = { Tail, 0 };
+        CXPLAT_THREAD_CONFIG Config = { 0, 0, NULL, PriorityQueueContext::QueueThread, &Context };
+        CXPLAT_THREAD Thread;
+        if (i % 4 == 1) {
+            QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+        }
+        ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Thread)));
+        if (i % 4 == 0) {
+            CxPlatThreadWait(&Thread);
+        } else if (i % 4 == 2) {
+            while (Context.Started == 0) {
+                CxPlatSchedulerYield();
+            }
+        }
+        if (i % 4 != 1) {
+            QuicWorkerShedConnection(&Workers.Victim, CxPlatTimeUs64());
+        }
+        if (i % 4 != 0) {
+            CxPlatThreadWait(&Thread);
+        }
+        CxPlatThreadDelete(&Thread);
+
+        //
+        // Either the priority work got there first and kept the connection
+        // on its worker, or the connection moved and got its priority work
+        // on the new one.
+        //
+        ASSERT_TRUE(Tail->HasPriorityWork);
+        if (Tail->Worker == &Workers.Thief) {
+            Stolen++;
+            ASSERT_NE(0u, i % 4);
+        } else {
+            ASSERT_EQ(&Workers.Victim, Tail->Worker);
+            Kept++;
+            ASSERT_NE(1u, i % 4);
+        }
+        Workers.Validate();
+    }
+
+    ASSERT_EQ(RoundCount, Stolen + Kept);
+    ASSERT_LE(RoundCount / 4, Stolen);
+    ASSERT_LE(RoundCount / 4, Kept);
+}
@@ -172,9 +172,12 @@ QuicWorkerUninitialize(
         Worker);
 
     //
-    // Clean up the worker execution context.
+    // Clean up the worker execution context. N.B. The lock orders this with
+    // sibling workers handing over connections (see QuicWorkerShedConnection).
     //
+    CxPlatDispatchLockAcquire(&Worker->Lock);
     Worker->Enabled = FALSE;
+    CxPlatDispatchLockRelease(&Worker->Lock);
     if (Worker->ExecutionContext.Context) {
         QuicWorkerThreadWake(Worker);
         CxPlatEventWaitForever(Worker->Done);
@@ -250,6 +253,30 @@ QuicWorkerIsIdle(
         CxPlatListIsEmpty(&Worker->Operations);
 }
 
+//
+// Acquires the lock of the connection's worker and returns that worker. A
+// connection only changes workers while the lock of the worker it's leaving is
+// held, so the worker is checked again once its lock is held, and the new
+// worker's lock taken instead if the connection moved in the meantime.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_WORKER*
+QuicWorkerLockConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    QUIC_WORKER* CurrentWorker;
+    while ((CurrentWorker =
+                (QUIC_WORKER*)QuicReadPtrNoFence((void**)&Connection->Worker)) != Worker) {
+        CxPlatDispatchLockRelease(&Worker->Lock);
+        Worker = CurrentWorker;
+        CxPlatDispatchLockAcquire(&Worker->Lock);
+    }
+    return Worker;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerQueueConnection(
@@ -261,7 +288,7 @@ QuicWorkerQueueConnection(
     BOOLEAN ConnectionQueued = FALSE;
     BOOLEAN WakeWorkerThread = FALSE;
 
-    CxPlatDispatchLockAcquire(&Worker->Lock);
+    Worker = QuicWorkerLockConnection(Worker, Connection);
 
     if (!Connection->WorkerProcessing && !Connection->HasQueuedWork) {
         WakeWorkerThread = QuicWorkerIsIdle(Worker);
@@ -299,9 +326,17 @@ QuicWorkerQueuePriorityConnection(
     BOOLEAN ConnectionQueued = FALSE;
     BOOLEAN WakeWorkerThread = FALSE;
 
-    CxPlatDispatchLockAcquire(&Worker->Lock);
+    Worker = QuicWorkerLockConnection(Worker, Connection);
 
-    if (!Connection->WorkerProcessing && !Connection->HasPriorityWork) {
+    if (Connection->WorkerMigrating) {
+        //
+        // The connection is between workers and on neither's queue. The new
+        // worker queues it with priority once it takes it.
+        //
+        CXPLAT_DBG_ASSERT(Connection->HasQueuedWork);
+        Connection->HasPriorityWork = TRUE;
+
+    } else if (!Connection->WorkerProcessing && !Connection->HasPriorityWork) {
         if (!Connection->HasQueuedWork) { // Not already queued for normal priority work
             WakeWorkerThread = QuicWorkerIsIdle(Worker);
             Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
@@ -343,11 +378,13 @@ QuicWorkerMoveConnection(
     CXPLAT_DBG_ASSERT(Connection->Worker != NULL);
     CXPLAT_DBG_ASSERT(Connection->HasQueuedWork);
 
-    CxPlatDispatchLockAcquire(&Worker->Lock);
+    Worker = QuicWorkerLockConnection(Worker, Connection);
 
+    CXPLAT_DBG_ASSERT(Connection->WorkerMigrating);
+    Connection->WorkerMigrating = FALSE;
     const BOOLEAN WakeWorkerThread = QuicWorkerIsIdle(Worker);
     Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
-    if (IsPriority) {
+    if (IsPriority || Connection->HasPriorityWork) {
         CxPlatListInsertTail(*Worker->PriorityConnectionsTail, &Connection->WorkerLink);
         Worker->PriorityConnectionsTail = &Connection->WorkerLink.Flink;
         Connection->HasPriorityWork = TRUE;
@@ -552,6 +589,170 @@ QuicWorkerGetNextOperation(
     return Operation;
 }
 
+//
+// Returns TRUE if the queued connection may be moved to another worker. Only
+// established connections whose partition isn't pinned by RSS qualify.
+//
+BOOLEAN
+QuicWorkerCanStealConnection(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    return
+        Connection->Registration != NULL &&
+        !Connection->Registration->NoPartitioning &&
+        Connection->State.Connected &&
+        !Connection->State.ShutdownComplete &&
+        !Connection->State.UpdateWorker &&
+        !Connection->State.Partitioned &&
+        !Connection->HasPriorityWork &&
+        Connection->Paths[0].Binding != NULL &&
+        !Connection->Paths[0].Binding->Partitioned;
+}
+
+//
+// Called by an idle worker to ask its most loaded sibling for one of its
+// queued connections.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerRequestSteal(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    QUIC_WORKER_POOL* WorkerPool = Worker->WorkerPool;
+    QUIC_WORKER* Victim = NULL;
+    uint32_t MaxQueueDelay =
+        MsQuicLib.Settings.MaxWorkerQueueDelayUs / QUIC_WORKER_STEAL_DELAY_DIVISOR;
+
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        QUIC_WORKER* Sibling = &WorkerPool->Workers[i];
+        if (Sibling != Worker &&
+            Sibling->AverageQueueDelay >= MaxQueueDelay &&
+            QuicReadPtrNoFence(&Sibling->StealRequest) == NULL) {
+            MaxQueueDelay = Sibling->AverageQueueDelay;
+            Victim = Sibling;
+        }
+    }
+
+    if (Victim != NULL) {
+        //
+        // The sibling hands the connection over itself, as only its thread may
+        // remove the connection from its timer wheel.
+        //
+        InterlockedExchangePointer((void* volatile*)&Victim->StealRequest, Worker);
+    }
+}
+
+//
+// Hands the last queued connection over to the sibling worker asking for one,
+// if this worker is still loaded and the sibling still idle.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerShedConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_WORKER* Thief =
+        (QUIC_WORKER*)InterlockedFetchAndClearPointer((void* volatile*)&Worker->StealRequest);
+    if (Thief == NULL ||
+        Worker->AverageQueueDelay <
+            MsQuicLib.Settings.MaxWorkerQueueDelayUs / QUIC_WORKER_STEAL_DELAY_DIVISOR ||
+        CxPlatTimeDiff64(Worker->LastStealTime, TimeNow) < QUIC_WORKER_STEAL_HOLD_TIME_US ||
+        !QuicWorkerIsIdle(Thief)) {
+        return;
+    }
+
+    //
+    // Both workers' locks are held, always taken in address order, while the
+    // connection moves, so it's never seen off both queues. Anyone queuing it
+    // on this worker meanwhile then finds its new worker once they get the
+    // lock (see QuicWorkerLockConnection).
+    //
+    QUIC_WORKER* FirstWorker = Worker < Thief ? Worker : Thief;
+    QUIC_WORKER* SecondWorker = Worker < Thief ? Thief : Worker;
+    CxPlatDispatchLockAcquire(&FirstWorker->Lock);
+    CxPlatDispatchLockAcquire(&SecondWorker->Lock);
+
+    //
+    // Take the connection at the tail of the queue, which has the longest to
+    // wait, as long as it's not the only one queued.
+    //
+    QUIC_CONNECTION* Connection = NULL;
+    BOOLEAN WakeWorkerThread = FALSE;
+    if (Thief->Enabled &&
+        !CxPlatListIsEmpty(&Worker->Connections) &&
+        Worker->Connections.Flink != Worker->Connections.Blink) {
+        QUIC_CONNECTION* Tail =
+            CXPLAT_CONTAINING_RECORD(Worker->Connections.Blink, QUIC_CONNECTION, WorkerLink);
+        if (Worker->PriorityConnectionsTail != &Tail->WorkerLink.Flink &&
+            QuicWorkerCanStealConnection(Tail)) {
+            CXPLAT_DBG_ASSERT(!Tail->WorkerProcessing);
+            CXPLAT_DBG_ASSERT(!Tail->WorkerMigrating);
+            CXPLAT_DBG_ASSERT(Tail->HasQueuedWork);
+            Connection = Tail;
+            CxPlatListEntryRemove(&Connection->WorkerLink);
+
+            //
+            // Its timers move over to the new worker when it's first processed
+            // there, the same as when the partition changes. Its worker
+            // reference moves over with it.
+            //
+            QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+            QuicWorkerAssignConnection(Thief, Connection);
+            Connection->State.UpdateWorker = TRUE;
+            WakeWorkerThread = QuicWorkerIsIdle(Thief);
+            Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+            CxPlatListInsertTail(&Thief->Connections, &Connection->WorkerLink);
+            QuicTraceEvent(
+                ConnScheduleState,
+                "[conn][%p] Scheduling: %u",
+                Connection,
+                QUIC_SCHEDULE_QUEUED);
+            Thief->LastStealTime = TimeNow;
+            Thief->StolenConnectionCount++;
+        }
+    }
+
+    CxPlatDispatchLockRelease(&SecondWorker->Lock);
+    CxPlatDispatchLockRelease(&FirstWorker->Lock);
+
+    if (Connection == NULL) {
+        return;
+    }
+
+    Worker->ShedConnectionCount++;
+    QuicPerfCounterDecrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+    QuicPerfCounterIncrement(Thief->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+    QuicPerfCounterIncrement(Thief->Partition, QUIC_PERF_COUNTER_CONN_STOLEN);
+
+    if (WakeWorkerThread) {
+        QuicWorkerThreadWake(Thief);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerKeepConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(Connection->State.UpdateWorker);
+    CXPLAT_DBG_ASSERT(Connection->Worker == Worker);
+    if (QuicRegistrationGetPartitionWorker(Connection->Registration, Connection) != Worker) {
+        return FALSE;
+    }
+
+    //
+    // Its timers and the app's processor are already this worker's.
+    //
+    Connection->State.UpdateWorker = FALSE;
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicWorkerProcessTimers(
@@ -654,9 +855,12 @@ QuicWorkerProcessConnection(
     // Process some operations.
     //
     BOOLEAN StillHasPriorityWork = FALSE;
-    BOOLEAN StillHasWorkToDo =
-        QuicConnDrainOperations(Connection, &StillHasPriorityWork) | Connection->State.UpdateWorker;
+    BOOLEAN StillHasWorkToDo = QuicConnDrainOperations(Connection, &StillHasPriorityWork);
     Connection->WorkerThreadID = 0;
+    if (Connection->State.UpdateWorker &&
+        !QuicWorkerKeepConnection(Worker, Connection)) {
+        StillHasWorkToDo = TRUE;
+    }
 
     //
     // Determine whether the connection needs to be requeued.
@@ -689,6 +893,18 @@ QuicWorkerProcessConnection(
                 Connection,
                 QUIC_SCHEDULE_IDLE);
         }
+    } else {
+        //
+        // Now that we know we want to process this connection, assign it to
+        // the correct registration. It's on neither worker's queue until the
+        // new worker takes it, so it's marked as migrating until then, for
+        // anyone queuing it to leave its worker link alone. The worker changes
+        // under this worker's lock, so they then find the new one (see
+        // QuicWorkerLockConnection).
+        //
+        CXPLAT_FRE_ASSERT(Connection->Registration != NULL);
+        QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
+        Connection->WorkerMigrating = TRUE;
     }
     CxPlatDispatchLockRelease(&Worker->Lock);
 
@@ -697,14 +913,10 @@ QuicWorkerProcessConnection(
     if (DoneWithConnection) {
         if (Connection->State.UpdateWorker) {
             //
-            // Now that we know we want to process this connection, assign it
-            // to the correct registration. Remove it from the current worker's
-            // timer wheel, and it will be added to the new one, when first
-            // processed on the other worker.
+            // Remove it from the current worker's timer wheel, and it will be
+            // added to the new one, when first processed on the other worker.
             //
             QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
-            CXPLAT_FRE_ASSERT(Connection->Registration != NULL);
-            QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
             CXPLAT_DBG_ASSERT(Worker != Connection->Worker);
             QuicWorkerMoveConnection(Connection->Worker, Connection, StillHasPriorityWork);
         }
@@ -876,6 +1088,17 @@ QuicWorkerLoop(
         State->NoWorkCount = 0;
     }
 
+    if (QuicReadPtrNoFence(&Worker->StealRequest) != NULL) {
+        QuicWorkerShedConnection(Worker, State->TimeNow);
+    }
+
+    if (MsQuicLib.RetiringLookupCount != 0 &&
+        CxPlatTimeDiff64(Worker->LastLookupReclaimTime, State->TimeNow) >=
+            QUIC_LOOKUP_RECLAIM_INTERVAL_US) {
+        Worker->LastLookupReclaimTime = State->TimeNow;
+        QuicLibraryReclaimLookups();
+    }
+
     QUIC_CONNECTION* Connection = QuicWorkerGetNextConnection(Worker);
     if (Connection != NULL) {
         QuicWorkerProcessConnection(Worker, Connection, State->ThreadID, &State->TimeNow);
@@ -908,6 +1131,13 @@ QuicWorkerLoop(
         return TRUE;
     }
 
+    if (MsQuicLib.EnableWorkStealing && Worker->WorkerPool->WorkerCount > 1) {
+        //
+        // Out of work, so see if a sibling has more than it can handle.
+        //
+        QuicWorkerRequestSteal(Worker);
+    }
+
     if (MsQuicLib.ExecutionConfig &&
         (uint64_t)MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs >
             CxPlatTimeDiff64(State->LastWorkTime, State->TimeNow)) {
@@ -925,6 +1155,15 @@ QuicWorkerLoop(
     //
     Worker->IsActive = FALSE;
     Worker->ExecutionContext.NextTimeUs = Worker->TimerWheel.NextExpirationTime;
+    if (MsQuicLib.RetiringLookupCount != 0 &&
+        Worker->LastLookupReclaimTime + QUIC_LOOKUP_RECLAIM_INTERVAL_US <
+            Worker->ExecutionContext.NextTimeUs) {
+        //
+        // Wake up in time to free what the lookups retired.
+        //
+        Worker->ExecutionContext.NextTimeUs =
+            Worker->LastLookupReclaimTime + QUIC_LOOKUP_RECLAIM_INTERVAL_US;
+    }
     QuicTraceEvent(
         WorkerActivityStateUpdated,
         "[wrkr][%p] IsActive = %hhu, Arg = %u",
@@ -1015,6 +1254,7 @@ QuicWorkerPoolInitialize(
 
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     for (uint16_t i = 0; i < WorkerCount; i++) {
+        WorkerPool->Workers[i].WorkerPool = WorkerPool;
         Status =
             QuicWorkerInitialize(
                 Registration,
@@ -5,6 +5,10 @@
 
 --*/
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 //
 // A worker thread for draining queued operations on a connection.
 //
@@ -84,6 +88,33 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     uint32_t OperationCount;
     uint64_t DroppedOperationCount;
 
+    //
+    // The pool this worker is part of.
+    //
+    QUIC_WORKER_POOL* WorkerPool;
+
+    //
+    // An idle sibling worker waiting to be handed one of this worker's queued
+    // connections, when work stealing is enabled.
+    //
+    QUIC_WORKER* StealRequest;
+
+    //
+    // The last time (in us) this worker took a connection from a sibling.
+    //
+    uint64_t LastStealTime;
+
+    //
+    // The number of connections taken from, and given to, sibling workers.
+    //
+    uint64_t StolenConnectionCount;
+    uint64_t ShedConnectionCount;
+
+    //
+    // The last time (in us) this worker reclaimed the lookups' retired objects.
+    //
+    uint64_t LastLookupReclaimTime;
+
 } QUIC_WORKER;
 
 //
@@ -218,8 +249,37 @@ QuicWorkerQueueOperation(
     _In_ QUIC_OPERATION* Operation
     );
 
+//
+// Hands one of the worker's queued connections over to the idle sibling
+// worker that asked for one, if any, and if it's still worth it. Only called
+// from the worker's own thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerShedConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t TimeNow
+    );
+
+//
+// Called for a connection whose worker needs updating. Returns TRUE, and
+// clears the update, if the connection is already on the worker for its
+// partition. That happens when the worker took the connection from a sibling
+// and the connection then moved to this worker's partition.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerKeepConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 BOOLEAN
 QuicWorkerPoolIsInPartition(
     _In_ QUIC_WORKER_POOL* WorkerPool,
     _In_ uint16_t PartitionIndex
     );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -219,6 +219,9 @@ namespace Microsoft.Quic
         NO_IDEAL_PROC = 0x0008,
         HIGH_PRIORITY = 0x0010,
         AFFINITIZE = 0x0020,
+        IO_RING_SQPOLL = 0x0040,
+        IO_RING_DEFER = 0x0080,
+        BUSY_POLL = 0x0100,
     }
 
     internal unsafe partial struct QUIC_GLOBAL_EXECUTION_CONFIG
@@ -994,6 +997,17 @@ namespace Microsoft.Quic
         SEND_STATELESS_RETRY,
         CONN_LOAD_REJECT,
         LISTEN_QUEUE_DEPTH,
+        IO_RING_SUBMITS,
+        IO_RING_WAKEUPS,
+        IO_RING_RECV_NO_BUFFERS,
+        IO_RING_RECV_REARMS,
+        SEND_ZERO_COPY,
+        SEND_ZERO_COPY_COPIED,
+        LOOKUP_LOCK_WAITS,
+        LOOKUP_LOCK_WAIT_US,
+        POOL_ALLOC_HITS,
+        POOL_ALLOC_MISSES,
+        CONN_STOLEN,
         MAX,
     }
 
@@ -774,18 +774,20 @@ tracepoint(CLOG_CONNECTION_C, FailedRouteResolution , arg1, arg3);\
 
 /*----------------------------------------------------------
 // Decoder Ring for UpdatePeerPacketTolerance
-// [conn][%p] Updating peer packet tolerance to %hhu
+// [conn][%p] Updating peer packet tolerance to %hhu and max ACK delay to %u us
 // QuicTraceLogConnInfo(
-            UpdatePeerPacketTolerance,
-            Connection,
-            "Updating peer packet tolerance to %hhu",
-            NewPacketTolerance);
+        UpdatePeerPacketTolerance,
+        Connection,
+        "Updating peer packet tolerance to %hhu and max ACK delay to %u us",
+        (uint8_t)NewPacketTolerance,
+        NewAckDelayUs);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = NewPacketTolerance = arg3
+// arg3 = arg3 = (uint8_t)NewPacketTolerance = arg3
+// arg4 = arg4 = NewAckDelayUs = arg4
 ----------------------------------------------------------*/
-#ifndef _clog_4_ARGS_TRACE_UpdatePeerPacketTolerance
-#define _clog_4_ARGS_TRACE_UpdatePeerPacketTolerance(uniqueId, arg1, encoded_arg_string, arg3)\
-tracepoint(CLOG_CONNECTION_C, UpdatePeerPacketTolerance , arg1, arg3);\
+#ifndef _clog_5_ARGS_TRACE_UpdatePeerPacketTolerance
+#define _clog_5_ARGS_TRACE_UpdatePeerPacketTolerance(uniqueId, arg1, encoded_arg_string, arg3, arg4)\
+tracepoint(CLOG_CONNECTION_C, UpdatePeerPacketTolerance , arg1, arg3, arg4);\
 
 #endif
 
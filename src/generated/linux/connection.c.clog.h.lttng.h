@@ -821,22 +821,26 @@ TRACEPOINT_EVENT(CLOG_CONNECTION_C, FailedRouteResolution,
 
 /*----------------------------------------------------------
 // Decoder Ring for UpdatePeerPacketTolerance
-// [conn][%p] Updating peer packet tolerance to %hhu
+// [conn][%p] Updating peer packet tolerance to %hhu and max ACK delay to %u us
 // QuicTraceLogConnInfo(
-            UpdatePeerPacketTolerance,
-            Connection,
-            "Updating peer packet tolerance to %hhu",
-            NewPacketTolerance);
+        UpdatePeerPacketTolerance,
+        Connection,
+        "Updating peer packet tolerance to %hhu and max ACK delay to %u us",
+        (uint8_t)NewPacketTolerance,
+        NewAckDelayUs);
 // arg1 = arg1 = Connection = arg1
-// arg3 = arg3 = NewPacketTolerance = arg3
+// arg3 = arg3 = (uint8_t)NewPacketTolerance = arg3
+// arg4 = arg4 = NewAckDelayUs = arg4
 ----------------------------------------------------------*/
 TRACEPOINT_EVENT(CLOG_CONNECTION_C, UpdatePeerPacketTolerance,
     TP_ARGS(
         const void *, arg1,
-        unsigned char, arg3), 
+        unsigned char, arg3,
+        unsigned int, arg4), 
     TP_FIELDS(
         ctf_integer_hex(uint64_t, arg1, (uint64_t)arg1)
         ctf_integer(unsigned char, arg3, arg3)
+        ctf_integer(unsigned int, arg4, arg4)
     )
 )
 
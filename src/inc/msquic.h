@@ -277,6 +277,9 @@ typedef enum QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS {
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_NO_IDEAL_PROC    = 0x0008,
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_HIGH_PRIORITY    = 0x0010,
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_AFFINITIZE       = 0x0020,
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_SQPOLL   = 0x0040, // Linux io_uring only. Latency profile.
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_DEFER    = 0x0080, // Linux io_uring only. Throughput profile.
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL        = 0x0100, // Linux only. Kernel busy polls the NIC queues.
 } QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS)
@@ -287,7 +290,7 @@ DEFINE_ENUM_FLAG_OPERATORS(QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS)
 typedef struct QUIC_GLOBAL_EXECUTION_CONFIG {
 
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS Flags;
-    uint32_t PollingIdleTimeoutUs;      // Time before a polling thread, with no work to do, sleeps.
+    uint32_t PollingIdleTimeoutUs;      // Time before a polling thread, with no work to do, sleeps. Also the io_uring SQ poll thread idle time and the kernel busy poll time.
     uint32_t ProcessorCount;
     _Field_size_(ProcessorCount)
     uint16_t ProcessorList[1];          // List of processors to use for threads.
@@ -703,6 +706,17 @@ typedef enum QUIC_PERFORMANCE_COUNTERS {
     QUIC_PERF_COUNTER_SEND_STATELESS_RETRY, // Total stateless retry packets sent ever.
     QUIC_PERF_COUNTER_CONN_LOAD_REJECT,     // Total connections rejected due to worker load.
     QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH,   // Current listeners queued for processing.
+    QUIC_PERF_COUNTER_IO_RING_SUBMITS,      // Total io_uring submit system calls.
+    QUIC_PERF_COUNTER_IO_RING_WAKEUPS,      // Total io_uring SQ poll thread or single issuer wakeups.
+    QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS, // Total io_uring receives that found the buffer ring empty.
+    QUIC_PERF_COUNTER_IO_RING_RECV_REARMS,  // Total io_uring multishot receive re-arms.
+    QUIC_PERF_COUNTER_SEND_ZERO_COPY,       // Total zero-copy sends completed by the kernel.
+    QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED, // Total zero-copy sends the kernel copied anyway.
+    QUIC_PERF_COUNTER_LOOKUP_LOCK_WAITS,    // Total contended connection lookup lock acquisitions.
+    QUIC_PERF_COUNTER_LOOKUP_LOCK_WAIT_US,  // Total microseconds spent waiting for connection lookup locks.
+    QUIC_PERF_COUNTER_POOL_ALLOC_HITS,      // Total pool allocations that reused a free entry.
+    QUIC_PERF_COUNTER_POOL_ALLOC_MISSES,    // Total pool allocations that allocated a new entry.
+    QUIC_PERF_COUNTER_CONN_STOLEN,          // Total connections taken by idle workers from loaded workers.
     QUIC_PERF_COUNTER_MAX,
 } QUIC_PERFORMANCE_COUNTERS;
 
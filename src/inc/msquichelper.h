@@ -199,6 +199,17 @@ DumpMsQuicPerfCounters(
     printf("  SEND_STATELESS_RESET:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RESET]);
     printf("  SEND_STATELESS_RETRY:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_STATELESS_RETRY]);
     printf("  CONN_LOAD_REJECT:      %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_CONN_LOAD_REJECT]);
+    printf("  IO_RING_SUBMITS:       %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_IO_RING_SUBMITS]);
+    printf("  IO_RING_WAKEUPS:       %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_IO_RING_WAKEUPS]);
+    printf("  IO_RING_RECV_NO_BUFS:  %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS]);
+    printf("  IO_RING_RECV_REARMS:   %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_IO_RING_RECV_REARMS]);
+    printf("  SEND_ZERO_COPY:        %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_ZERO_COPY]);
+    printf("  SEND_ZERO_COPY_COPIED: %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED]);
+    printf("  LOOKUP_LOCK_WAITS:     %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_LOOKUP_LOCK_WAITS]);
+    printf("  LOOKUP_LOCK_WAIT_US:   %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_LOOKUP_LOCK_WAIT_US]);
+    printf("  POOL_ALLOC_HITS:       %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_POOL_ALLOC_HITS]);
+    printf("  POOL_ALLOC_MISSES:     %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_POOL_ALLOC_MISSES]);
+    printf("  CONN_STOLEN:           %llu\n", (unsigned long long)Counters[QUIC_PERF_COUNTER_CONN_STOLEN]);
 }
 
 //
@@ -126,6 +126,41 @@ typedef struct QUIC_PRIVATE_TRANSPORT_PARAMETER {
 //
 #define QUIC_PARAM_GLOBAL_DATAPATH_DSCP_RECV_ENABLED    0x81000007 // BOOLEAN
 
+//
+// Sets whether the datapath will use zero-copy sends (io_uring SEND_ZC or
+// MSG_ZEROCOPY) for large send batches, where supported by the platform.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_ZERO_COPY_SEND_ENABLED 0x81000008 // BOOLEAN
+
+//
+// Sets whether paced sends carry kernel departure times (SO_TXTIME), so that
+// several pacing intervals are queued per flush and released by the qdisc
+// (e.g. fq) instead of by the pacing timer. Only used where the datapath
+// supports it (Linux).
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_PACING_OFFLOAD_ENABLED 0x81000009 // BOOLEAN
+
+//
+// Sets whether server CIDs encode the connection's slot in the binding's
+// lookup (authenticated by a short MAC), so that received packets are routed
+// without hashing the CID. Other CIDs still go through the hash tables.
+//
+#define QUIC_PARAM_GLOBAL_ENCODED_CIDS_ENABLED          0x8100000A // BOOLEAN
+
+//
+// Sets whether new connections allocate their CIDs and other small,
+// connection-lifetime state from a per-connection arena, sized from the
+// footprint of previous connections and freed all at once with the connection.
+//
+#define QUIC_PARAM_GLOBAL_CONN_ARENA_ENABLED            0x8100000B // BOOLEAN
+
+//
+// Sets whether idle workers take queued connections from sibling workers whose
+// queue delay is high. Connections on partitioned (RSS-pinned) bindings are
+// never moved.
+//
+#define QUIC_PARAM_GLOBAL_WORK_STEALING_ENABLED         0x8100000C // BOOLEAN
+
 //
 // The different private parameters for Configuration.
 //
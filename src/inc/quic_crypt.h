@@ -310,6 +310,73 @@ CxPlatEncrypt(
         uint8_t* Buffer
     );
 
+//
+// A range of a payload to encrypt whose plaintext is read from a separate
+// buffer, instead of first being copied into the payload.
+//
+typedef struct CXPLAT_CRYPT_EXTENT {
+
+    //
+    // The plaintext of the range.
+    //
+    const uint8_t* Source;
+
+    //
+    // The offset and length of the range in the payload.
+    //
+    uint16_t Offset;
+    uint16_t Length;
+
+} CXPLAT_CRYPT_EXTENT;
+
+//
+// A single packet in a batch of AEAD operations that all use the same key.
+//
+typedef struct CXPLAT_CRYPT_BATCH_ENTRY {
+
+    //
+    // The per-packet nonce, as computed by QuicCryptoCombineIvAndPacketNumber.
+    //
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+
+    //
+    // The additional authenticated data (i.e. packet header).
+    //
+    const uint8_t* AuthData;
+
+    //
+    // The payload, including the space for CXPLAT_ENCRYPTION_OVERHEAD.
+    //
+    uint8_t* Buffer;
+
+    //
+    // Ranges of the payload to encrypt from elsewhere, sorted by offset. Only
+    // used for encryption.
+    //
+    const CXPLAT_CRYPT_EXTENT* Extents;
+
+    uint16_t AuthDataLength;
+    uint16_t BufferLength;
+    uint8_t ExtentCount;
+
+} CXPLAT_CRYPT_BATCH_ENTRY;
+
+//
+// Encrypts a batch of buffers with the same key. Each entry follows the same
+// rules as CxPlatEncrypt, except that the plaintext of its extents is read
+// from their sources, so the payload's bytes in those ranges need not be
+// initialized. On failure, the contents of all the buffers in the batch are
+// undefined.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch
+    );
+
 //
 // Decrypts buffer with the given key. 'BufferLength' is the full encrypted
 // payload length on input. On output, the length shrinks by
@@ -329,6 +396,23 @@ CxPlatDecrypt(
         uint8_t* Buffer
     );
 
+//
+// Decrypts a batch of buffers with the same key. Each entry follows the same
+// rules as CxPlatDecrypt. Decryption stops at the first entry that fails, and
+// 'DecryptedCount' returns the number of entries before it that were
+// successfully decrypted. The contents of the failed entry's buffer are then
+// undefined, and the entries after it are left untouched.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch,
+    _Out_ uint8_t* DecryptedCount
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
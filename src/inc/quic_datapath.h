@@ -436,6 +436,7 @@ typedef enum CXPLAT_DATAPATH_FEATURES {
     CXPLAT_DATAPATH_FEATURE_TTL                = 0x00000080,
     CXPLAT_DATAPATH_FEATURE_SEND_DSCP          = 0x00000100,
     CXPLAT_DATAPATH_FEATURE_RECV_DSCP          = 0x00000200,
+    CXPLAT_DATAPATH_FEATURE_SEND_TXTIME        = 0x00000400,
 } CXPLAT_DATAPATH_FEATURES;
 
 DEFINE_ENUM_FLAG_OPERATORS(CXPLAT_DATAPATH_FEATURES)
@@ -476,6 +477,20 @@ typedef struct CXPLAT_DATAPATH_INIT_CONFIG {
     // the Windows fast path causing a large performance regression.
     //
     BOOLEAN EnableDscpOnRecv;
+
+    //
+    // Whether the datapath will use zero-copy sends for large send batches.
+    // Zero-copy avoids the kernel copy of the payload, at the cost of an extra
+    // completion per send, so it is only used above a minimum send size.
+    //
+    BOOLEAN EnableZeroCopySend;
+
+    //
+    // Whether the datapath will hand send departure times to the kernel, which
+    // paces them out (e.g. the Linux fq qdisc). Supported when the datapath
+    // reports CXPLAT_DATAPATH_FEATURE_SEND_TXTIME.
+    //
+    BOOLEAN EnablePacingOffload;
 } CXPLAT_DATAPATH_INIT_CONFIG;
 
 //
@@ -758,6 +773,7 @@ typedef struct CXPLAT_SEND_CONFIG {
     uint8_t ECN; // CXPLAT_ECN_TYPE
     uint8_t Flags; // CXPLAT_SEND_FLAGS
     uint8_t DSCP; // CXPLAT_DSCP_TYPE
+    uint64_t TxTime; // Departure time (CxPlatTimeUs64), or 0 to send now
 } CXPLAT_SEND_CONFIG;
 
 //
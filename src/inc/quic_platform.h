@@ -161,6 +161,9 @@ typedef struct CXPLAT_SLIST_ENTRY {
 #define QUIC_POOL_DATAPATH_RSS_CONFIG       'F4cQ' // Qc4F - QUIC Datapath RSS configuration
 #define QUIC_POOL_TLS_AUX_DATA              '05cQ' // Qc50 - QUIC TLS Backing Aux data
 #define QUIC_POOL_TLS_RECORD_ENTRY          '15cQ' // Qc51 - QUIC TLS Backing Record storage
+#define QUIC_POOL_CONN_ARENA                '25cQ' // Qc52 - QUIC Connection arena block
+#define QUIC_POOL_SEND_REQUEST_INDEX        '35cQ' // Qc53 - QUIC Stream send request index
+#define QUIC_POOL_SENT_PACKET_RING          '45cQ' // Qc54 - QUIC Sent packet ring
 
 typedef enum CXPLAT_THREAD_FLAGS {
     CXPLAT_THREAD_FLAG_NONE               = 0x0000,
@@ -433,6 +436,22 @@ CxPlatListPopEntry(
 #include "quic_hashtable.h"
 #include "quic_toeplitz.h"
 
+//
+// Allocation statistics of a pool. Only the posix pools track them; they are
+// zero on Windows.
+//
+typedef struct CXPLAT_POOL_STATISTICS {
+    uint64_t AllocHitCount;     // Allocations that reused a free entry.
+    uint64_t AllocMissCount;    // Allocations that allocated a new entry.
+} CXPLAT_POOL_STATISTICS;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatPoolGetStatistics(
+    _In_ const CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    );
+
 #ifdef DEBUG
 void
 CxPlatSetAllocFailDenominator(
@@ -538,6 +557,15 @@ CxPlatWorkerPoolGetIdealProcessor(
     _In_ uint32_t Index // Into the worker pool
     );
 
+//
+// Returns the kernel busy poll time for the worker pool's sockets, or zero if
+// busy polling isn't enabled.
+//
+uint32_t
+CxPlatWorkerPoolGetBusyPollUs(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    );
+
 CXPLAT_EVENTQ*
 CxPlatWorkerPoolGetEventQ(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -556,6 +584,34 @@ CxPlatWorkerPoolWorkerPoll(
     _In_ QUIC_EXECUTION* Execution
     );
 
+typedef struct CXPLAT_WORKER_POOL_STATISTICS {
+    uint64_t EventQSubmitCount; // Submit system calls made for the event queue.
+    uint64_t EventQWakeupCount; // Wakeups of the event queue's submitter.
+    uint64_t EventQRecvNoBufferCount; // Receives that found a buffer ring empty.
+    uint64_t EventQRecvRearmCount; // Multishot receives re-armed.
+    uint64_t SendZeroCopyCount; // Zero-copy sends completed by the kernel.
+    uint64_t SendZeroCopyCopiedCount; // Zero-copy sends the kernel copied anyway.
+} CXPLAT_WORKER_POOL_STATISTICS;
+
+void
+CxPlatWorkerPoolGetStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index, // Into the worker pool
+    _Out_ CXPLAT_WORKER_POOL_STATISTICS* Statistics
+    );
+
+//
+// Adds zero-copy send completions processed on the worker's thread to its
+// statistics.
+//
+void
+CxPlatWorkerPoolAddSendZeroCopyStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index, // Into the worker pool
+    _In_ uint32_t CompletedCount,
+    _In_ uint32_t CopiedCount
+    );
+
 //
 // Supports more dynamic operations, but must be submitted to the platform worker
 // to manage.
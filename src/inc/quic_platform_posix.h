@@ -246,6 +246,17 @@ InterlockedExchangePointer(
     return __sync_lock_test_and_set(Target, Value);
 }
 
+QUIC_INLINE
+void*
+InterlockedCompareExchangePointer(
+    _Inout_ _Interlocked_operand_ void* volatile *Destination,
+    _In_opt_ void* ExChange,
+    _In_opt_ void* Comperand
+    )
+{
+    return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
+}
+
 QUIC_INLINE
 void*
 InterlockedFetchAndClearPointer(
@@ -295,6 +306,22 @@ InterlockedDecrement64(
 
 #define QuicReadLongPtrNoFence(p) __atomic_load_n((p), __ATOMIC_RELAXED)
 
+#define QuicReadAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+#define QuicWriteRelease(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define QuicReadAcquire16(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+#define QuicWriteRelease16(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define QuicReadAcquire64(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+#define QuicWriteRelease64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define QuicReadPtrAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+#define QuicWritePtrRelease(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
 //
 // Assertion interfaces.
 //
@@ -469,6 +496,12 @@ typedef CXPLAT_RW_LOCK CXPLAT_DISPATCH_RW_LOCK;
 
 #define CxPlatDispatchRwLockReleaseExclusive(Lock, PrevIrql) CxPlatRwLockReleaseExclusive(Lock)
 
+#define CxPlatDispatchRwLockTryAcquireShared(Lock, PrevIrql) \
+    (pthread_rwlock_tryrdlock(&(Lock)->RwLock) == 0)
+
+#define CxPlatDispatchRwLockTryAcquireExclusive(Lock, PrevIrql) \
+    (pthread_rwlock_trywrlock(&(Lock)->RwLock) == 0)
+
 //
 // Represents a QUIC memory pool used for fixed sized allocations.
 // This must be below the lock definitions.
@@ -486,10 +519,56 @@ CXPLAT_SLIST_ENTRY*
 CxPlatListPopEntry(
     _Inout_ CXPLAT_SLIST_ENTRY* ListHead
     );
+//
+// Pools cache free entries per processor, in magazines of a fixed number of
+// entries (as described by Bonwick and Adams, "Magazines and Vmem"). Each
+// processor's cache has a loaded and a previous magazine, so allocations and
+// frees only touch the processor's cache until both magazines are empty (or
+// full). Then full and empty magazines are exchanged with the pool's depot,
+// which is lock free.
+//
+// The number of full magazines the depot keeps starts small and doubles each
+// time entries it had to free for lack of room are needed again. Pruning the
+// pool shrinks it again.
+//
+// Pools initialized before the platform, or that fail to allocate their caches,
+// fall back to a single locked list of free entries.
+//
+
+#define CXPLAT_POOL_MAGAZINE_SIZE           16  // Entries per magazine
+#define CXPLAT_POOL_DEPOT_SIZE              64  // Magazines per depot
+#define CXPLAT_POOL_DEPOT_MIN_FULL_COUNT    4   // Initial full magazines limit
+
+typedef struct CXPLAT_POOL_HEADER CXPLAT_POOL_HEADER;
+
+typedef struct CXPLAT_POOL_MAGAZINE {
+
+    uint32_t Count;
+    CXPLAT_POOL_HEADER* Entries[CXPLAT_POOL_MAGAZINE_SIZE];
+
+} CXPLAT_POOL_MAGAZINE;
+
+typedef struct CXPLAT_POOL_CACHE {
+
+    //
+    // Threads may be preempted or migrate to another processor while using
+    // the cache, so it still needs a lock, but it's rarely contended.
+    //
+
+    CXPLAT_LOCK Lock;
+
+    CXPLAT_POOL_MAGAZINE* Loaded;
+    CXPLAT_POOL_MAGAZINE* Previous;
+
+    uint64_t AllocHitCount;
+    uint64_t AllocMissCount;
+
+} CXPLAT_POOL_CACHE;
+
 typedef struct CXPLAT_POOL {
 
     //
-    // List of free entries.
+    // List of free entries, only used if the pool has no caches.
     //
 
     CXPLAT_SLIST_ENTRY ListHead;
@@ -502,7 +581,6 @@ typedef struct CXPLAT_POOL {
 
     //
     // Lock to synchronize access to the List.
-    // LINUX_TODO: Check how to make this lock free?
     //
 
     CXPLAT_LOCK Lock;
@@ -519,6 +597,44 @@ typedef struct CXPLAT_POOL {
 
     uint32_t Tag;
 
+    //
+    // Per processor caches, each created the first time it's used. NULL if the
+    // pool uses the list instead.
+    //
+
+    uint32_t CacheCount;
+    CXPLAT_POOL_CACHE* volatile* Caches;
+
+    //
+    // The depot of full and empty magazines. A magazine is taken from a slot
+    // by exchanging it with NULL, so no ABA protection is needed.
+    //
+
+    CXPLAT_POOL_MAGAZINE* volatile FullMagazines[CXPLAT_POOL_DEPOT_SIZE];
+    CXPLAT_POOL_MAGAZINE* volatile EmptyMagazines[CXPLAT_POOL_DEPOT_SIZE];
+
+    //
+    // The number of full magazines in the depot, and how many it may keep.
+    //
+
+    long FullMagazineCount;
+    long FullMagazineLimit;
+
+    //
+    // Set when a full magazine's entries were freed because the depot was at
+    // its limit.
+    //
+
+    BOOLEAN Overflowed;
+
+    //
+    // Allocations not counted by the caches: the list's, and those made when
+    // the processor's cache couldn't be created.
+    //
+
+    int64_t AllocHitCount;
+    int64_t AllocMissCount;
+
 } CXPLAT_POOL;
 
 #define CXPLAT_MEMORY_ALIGNMENT 16
@@ -548,36 +664,35 @@ CxPlatGetAllocFailDenominator(
     );
 #endif
 
-QUIC_INLINE
 void
 CxPlatPoolInitialize(
     _In_ BOOLEAN IsPaged,
     _In_ uint32_t Size,
     _In_ uint32_t Tag,
     _Inout_ CXPLAT_POOL* Pool
-    )
-{
-    Pool->Size = Size + sizeof(CXPLAT_POOL_HEADER); // Add space for the pool header
-    Pool->Tag = Tag;
-    CxPlatLockInitialize(&Pool->Lock);
-    Pool->ListDepth = 0;
-    CxPlatZeroMemory(&Pool->ListHead, sizeof(Pool->ListHead));
-    UNREFERENCED_PARAMETER(IsPaged);
-}
+    );
 
-QUIC_INLINE
 void
 CxPlatPoolUninitialize(
     _Inout_ CXPLAT_POOL* Pool
-    )
-{
-    CXPLAT_POOL_HEADER* Entry;
-    while ((Entry = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead)) != NULL) {
-        CXPLAT_DBG_ASSERT(Entry->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
-        CxPlatFree(Entry, Pool->Tag);
-    }
-    CxPlatLockUninitialize(&Pool->Lock);
-}
+    );
+
+//
+// Returns a free entry from the pool, or NULL if it has none.
+//
+CXPLAT_POOL_HEADER*
+CxPlatPoolPopEntry(
+    _Inout_ CXPLAT_POOL* Pool
+    );
+
+//
+// Returns the entry to the pool, or FALSE if the pool has no room for it.
+//
+BOOLEAN
+CxPlatPoolPushEntry(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_HEADER* Header
+    );
 
 QUIC_INLINE
 void*
@@ -585,19 +700,14 @@ CxPlatPoolAlloc(
     _Inout_ CXPLAT_POOL* Pool
     )
 {
-    CxPlatLockAcquire(&Pool->Lock);
     CXPLAT_POOL_HEADER* Header =
     #if DEBUG
         CxPlatGetAllocFailDenominator() ? NULL : // No pool when using simulated alloc failures
     #endif
-        (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
+        CxPlatPoolPopEntry(Pool);
     if (Header != NULL) {
-        CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
         CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
-        Pool->ListDepth--;
-    }
-    CxPlatLockRelease(&Pool->Lock);
-    if (Header == NULL) {
+    } else {
         Header = (CXPLAT_POOL_HEADER*)CxPlatAlloc(Pool->Size, Pool->Tag);
         if (Header == NULL) {
             return NULL;
@@ -626,35 +736,15 @@ CxPlatPoolFree(
     }
     Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
 #endif
-    if (Pool->ListDepth >= CXPLAT_POOL_MAXIMUM_DEPTH) {
+    if (!CxPlatPoolPushEntry(Pool, Header)) {
         CxPlatFree(Header, Pool->Tag);
-    } else {
-        CxPlatLockAcquire(&Pool->Lock);
-        CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
-        Pool->ListDepth++;
-        CxPlatLockRelease(&Pool->Lock);
     }
 }
 
-QUIC_INLINE
 BOOLEAN
 CxPlatPoolPrune(
     _Inout_ CXPLAT_POOL* Pool
-    )
-{
-    CxPlatLockAcquire(&Pool->Lock);
-    void* Entry = CxPlatListPopEntry(&Pool->ListHead);
-    if (Entry != NULL) {
-        CXPLAT_FRE_ASSERT(Pool->ListDepth > 0);
-        Pool->ListDepth--;
-    }
-    CxPlatLockRelease(&Pool->Lock);
-    if (Entry == NULL) {
-        return FALSE;
-    }
-    CxPlatFree(Entry, Pool->Tag);
-    return TRUE;
-}
+    );
 
 //
 // Reference Count Interface
@@ -1006,6 +1096,8 @@ Exit:
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <poll.h>
 
 #if CXPLAT_USE_IO_URING // liburing
 #define LIBURING_INTERNAL
@@ -1018,21 +1110,6 @@ extern "C++" {
 } // extern "C++"
 #endif
 
-typedef struct CXPLAT_EVENTQ {
-    struct io_uring Ring;
-    //
-    // For rapid prototyping, use a lock to implement SQE single producer and
-    // validate CQE single consumer. If io_uring shows performance benefits,
-    // this can be optimized to use a different mechanism for multi-producer
-    // queueing.
-    //
-    CXPLAT_LOCK Lock;
-#if DEBUG
-    uint32_t CqContentionCount;
-    uint32_t SqContentionCount;
-#endif
-    BOOLEAN NeedsSubmit;
-} CXPLAT_EVENTQ;
 typedef struct io_uring_cqe* CXPLAT_CQE;
 typedef
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1058,33 +1135,127 @@ typedef struct CXPLAT_SQE {
 #endif
 } CXPLAT_SQE;
 
+typedef struct CXPLAT_EVENTQ {
+    struct io_uring Ring;
+    //
+    // For rapid prototyping, use a lock to implement SQE single producer and
+    // validate CQE single consumer. If io_uring shows performance benefits,
+    // this can be optimized to use a different mechanism for multi-producer
+    // queueing.
+    //
+    CXPLAT_LOCK Lock;
+#if DEBUG
+    uint32_t CqContentionCount;
+    uint32_t SqContentionCount;
+#endif
+    BOOLEAN NeedsSubmit;
+    //
+    // Set when the ring is created with IORING_SETUP_SINGLE_ISSUER. Only the
+    // issuer thread (the one that enabled the ring) may enter the kernel for
+    // the ring, so other threads leave their SQEs queued and ring the
+    // doorbell, an eventfd the ring itself polls, to have the issuer submit
+    // them.
+    //
+    BOOLEAN SingleIssuer;
+    BOOLEAN IssuerStarted;
+    pthread_t IssuerThread;
+    int DoorbellFd;
+    eventfd_t DoorbellValue;
+    CXPLAT_SQE DoorbellSqe;
+    //
+    // Statistics. Only updated with Lock held or by the issuer thread.
+    //
+    uint64_t SubmitCount;
+    uint64_t WakeupCount;
+    //
+    // Receive buffer ring statistics, updated by the datapath with Lock held.
+    //
+    uint64_t RecvNoBufferCount;
+    uint64_t RecvRearmCount;
+} CXPLAT_EVENTQ;
+
 #define CXPLAT_SQE_SIGNATURE_INITIALIZED    0x1010
 #define CXPLAT_SQE_SIGNATURE_UNINITIALIZED  0x3030
 
 typedef enum CXPLAT_IO_RING_BUF_GROUP {
     CxPlatIoRingBufGroupSend,
     CxPlatIoRingBufGroupRecv,
+    CxPlatIoRingBufGroupRecvSmall,
 } CXPLAT_IO_RING_BUF_GROUP;
 
+//
+// Ring setup profiles, selected through the global execution config.
+//
+#define CXPLAT_EVENTQ_FLAG_SQPOLL           0x0001 // Kernel thread polls the SQ.
+#define CXPLAT_EVENTQ_FLAG_SINGLE_ISSUER    0x0002 // Single issuer, deferred task work.
+
 QUIC_INLINE
 BOOLEAN
-CxPlatEventQInitialize(
-    _Out_ CXPLAT_EVENTQ* Queue
+CxPlatEventQInitializeEx(
+    _Out_ CXPLAT_EVENTQ* Queue,
+    _In_ uint32_t Flags,
+    _In_ uint32_t SqThreadIdleMs // Zero for the kernel default.
     )
 {
     CxPlatZeroMemory(Queue, sizeof(*Queue));
     CxPlatLockInitialize(&Queue->Lock);
+    Queue->DoorbellFd = -1;
     struct io_uring_params params;
 	memset(&params, 0, sizeof(params));
 	params.flags = 0
 #ifdef IORING_SETUP_SUBMIT_ALL
         | IORING_SETUP_SUBMIT_ALL
 #endif
+        ;
+    if (Flags & CXPLAT_EVENTQ_FLAG_SQPOLL) {
+        //
+        // The kernel rejects the task run flags in combination with SQPOLL,
+        // as the SQ thread runs the task work itself.
+        //
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = SqThreadIdleMs;
+    } else {
 #ifdef IORING_SETUP_COOP_TASKRUN
-        | IORING_SETUP_COOP_TASKRUN
+        params.flags |= IORING_SETUP_COOP_TASKRUN;
 #endif
-        ;
-    return 0 == io_uring_queue_init_params(4096, &Queue->Ring, &params); // TODO - make size configurable
+        if (Flags & CXPLAT_EVENTQ_FLAG_SINGLE_ISSUER) {
+#if defined(IORING_SETUP_SINGLE_ISSUER) && defined(IORING_SETUP_DEFER_TASKRUN)
+            //
+            // The ring starts disabled so that the worker thread, not the
+            // creating thread, becomes the issuer when it enables the ring.
+            //
+            Queue->DoorbellFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (Queue->DoorbellFd == -1) {
+                goto Error;
+            }
+            params.flags |=
+                IORING_SETUP_R_DISABLED |
+                IORING_SETUP_SINGLE_ISSUER |
+                IORING_SETUP_DEFER_TASKRUN;
+            Queue->SingleIssuer = TRUE;
+#else
+            goto Error;
+#endif
+        }
+    }
+    if (0 == io_uring_queue_init_params(4096, &Queue->Ring, &params)) { // TODO - make size configurable
+        return TRUE;
+    }
+Error:
+    if (Queue->DoorbellFd != -1) {
+        close(Queue->DoorbellFd);
+    }
+    CxPlatLockUninitialize(&Queue->Lock);
+    return FALSE;
+}
+
+QUIC_INLINE
+BOOLEAN
+CxPlatEventQInitialize(
+    _Out_ CXPLAT_EVENTQ* Queue
+    )
+{
+    return CxPlatEventQInitializeEx(Queue, 0, 0);
 }
 
 QUIC_INLINE
@@ -1094,6 +1265,9 @@ CxPlatEventQCleanup(
     )
 {
     io_uring_queue_exit(&Queue->Ring);
+    if (Queue->DoorbellFd != -1) {
+        close(Queue->DoorbellFd);
+    }
 }
 
 QUIC_INLINE
@@ -1117,17 +1291,53 @@ CxPlatEventGetSqe(
     return io_sqe;
 }
 
+QUIC_INLINE
+BOOLEAN
+CxPlatEventQIsIssuer(
+    _In_ const CXPLAT_EVENTQ* Queue
+    )
+{
+    return
+        !Queue->SingleIssuer ||
+        (Queue->IssuerStarted && pthread_equal(Queue->IssuerThread, pthread_self()));
+}
+
 QUIC_INLINE
 void
 CxPlatEventQSubmit(
     _In_ CXPLAT_EVENTQ* Queue
     )
 {
+    if (!CxPlatEventQIsIssuer(Queue)) {
+        //
+        // Only the issuer may submit. Leave the SQEs queued and ring the
+        // doorbell, unless a submit is already pending, in which case the
+        // issuer will pick these SQEs up with it.
+        //
+        if (!Queue->NeedsSubmit) {
+            Queue->NeedsSubmit = TRUE;
+            ++Queue->WakeupCount;
+            (void)eventfd_write(Queue->DoorbellFd, 1);
+        }
+        return;
+    }
 #if DEBUG
     CxPlatLockAcquire(&Queue->Lock);
     CXPLAT_DBG_ASSERT(Queue->SqContentionCount++ == 0);
     CxPlatLockRelease(&Queue->Lock);
 #endif
+    if (io_uring_sq_ready(&Queue->Ring) != 0) {
+        if (!(Queue->Ring.flags & IORING_SETUP_SQPOLL)) {
+            ++Queue->SubmitCount;
+        } else if (IO_URING_READ_ONCE(*Queue->Ring.sq.kflags) & IORING_SQ_NEED_WAKEUP) {
+            //
+            // The SQ thread went idle, so this submit has to enter the kernel
+            // to wake it up.
+            //
+            ++Queue->SubmitCount;
+            ++Queue->WakeupCount;
+        }
+    }
     io_uring_submit(&Queue->Ring);
 #if DEBUG
     CxPlatLockAcquire(&Queue->Lock);
@@ -1182,6 +1392,14 @@ CxPlatEventQDequeue(
         Queue->NeedsSubmit = FALSE;
         CxPlatLockRelease(&Queue->Lock);
     }
+    if (Queue->SingleIssuer && WaitTime == 0) {
+        //
+        // With deferred task work, completions are only posted to the CQ when
+        // the issuer enters the kernel for them. Waiting does that implicitly,
+        // but a non-blocking poll must ask explicitly.
+        //
+        (void)io_uring_get_events(&Queue->Ring);
+    }
     int result = io_uring_peek_batch_cqe(&Queue->Ring, Events, Count);
     if (result > 0 || WaitTime == 0) goto Exit;
     if (WaitTime != UINT32_MAX) {
@@ -1300,6 +1518,158 @@ CxPlatSqeCleanup(
     UNREFERENCED_PARAMETER(sqe);
 }
 
+QUIC_INLINE
+void
+CxPlatEventQArmDoorbell(
+    _In_ CXPLAT_EVENTQ* Queue
+    )
+{
+    struct io_uring_sqe* io_sqe = CxPlatEventGetSqe(Queue);
+    CXPLAT_FRE_ASSERT(io_sqe != NULL);
+    io_uring_prep_poll_multishot(io_sqe, Queue->DoorbellFd, POLLIN);
+    io_uring_sqe_set_data(io_sqe, &Queue->DoorbellSqe);
+    Queue->NeedsSubmit = TRUE;
+}
+
+QUIC_INLINE
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatEventQDoorbellCompletion(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    CXPLAT_EVENTQ* Queue =
+        CXPLAT_CONTAINING_RECORD(CxPlatCqeGetSqe(Cqe), CXPLAT_EVENTQ, DoorbellSqe);
+    (void)eventfd_read(Queue->DoorbellFd, &Queue->DoorbellValue);
+    if (!((*Cqe)->flags & IORING_CQE_F_MORE)) {
+        CxPlatLockAcquire(&Queue->Lock);
+        CxPlatEventQArmDoorbell(Queue);
+        CxPlatLockRelease(&Queue->Lock);
+    }
+}
+
+//
+// Called by the thread that drives the event queue, before it first dequeues,
+// to make itself the ring's issuer. No-op unless the ring is single issuer.
+//
+QUIC_INLINE
+void
+CxPlatEventQStartIssuer(
+    _In_ CXPLAT_EVENTQ* Queue
+    )
+{
+    if (!Queue->SingleIssuer) {
+        return;
+    }
+    CxPlatSqeInitialize(Queue, CxPlatEventQDoorbellCompletion, &Queue->DoorbellSqe);
+    CxPlatLockAcquire(&Queue->Lock);
+    CXPLAT_FRE_ASSERT(io_uring_enable_rings(&Queue->Ring) == 0);
+    Queue->IssuerThread = pthread_self();
+    Queue->IssuerStarted = TRUE;
+    CxPlatEventQArmDoorbell(Queue);
+    CxPlatLockRelease(&Queue->Lock);
+}
+
+//
+// Has the kernel busy poll the NIC queues of the ring's sockets, instead of
+// waiting for their interrupts. Must be called by the thread that drives the
+// event queue.
+//
+QUIC_INLINE
+BOOLEAN
+CxPlatEventQSetBusyPoll(
+    _In_ CXPLAT_EVENTQ* Queue,
+    _In_ uint32_t BusyPollUs
+    )
+{
+#ifdef IORING_REGISTER_NAPI
+    struct io_uring_napi Napi;
+    memset(&Napi, 0, sizeof(Napi));
+    Napi.busy_poll_to = BusyPollUs;
+    Napi.prefer_busy_poll = 1;
+    return io_uring_register_napi(&Queue->Ring, &Napi) == 0;
+#else
+    UNREFERENCED_PARAMETER(Queue);
+    UNREFERENCED_PARAMETER(BusyPollUs);
+    return FALSE;
+#endif
+}
+
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+(CXPLAT_EVENTQ_ISSUER_CALLBACK)(
+    _In_ void* Context
+    );
+
+typedef struct CXPLAT_EVENTQ_ISSUER_CALL {
+    CXPLAT_SQE Sqe;
+    CXPLAT_EVENT Completed;
+    CXPLAT_EVENTQ_ISSUER_CALLBACK* Callback;
+    void* Context;
+    QUIC_STATUS Status;
+} CXPLAT_EVENTQ_ISSUER_CALL;
+
+QUIC_INLINE
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatEventQIssuerCallCompletion(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    CXPLAT_EVENTQ_ISSUER_CALL* Call =
+        CXPLAT_CONTAINING_RECORD(CxPlatCqeGetSqe(Cqe), CXPLAT_EVENTQ_ISSUER_CALL, Sqe);
+    Call->Status = Call->Callback(Call->Context);
+    CxPlatEventSet(Call->Completed);
+}
+
+//
+// Runs the callback on the ring's issuer thread, and waits for it to complete.
+// Anything that registers resources with a single issuer ring must go through
+// here, as the kernel rejects registration by any other thread. For all other
+// rings, or when already on the issuer, the callback runs inline.
+//
+QUIC_INLINE
+QUIC_STATUS
+CxPlatEventQRunOnIssuer(
+    _In_ CXPLAT_EVENTQ* Queue,
+    _In_ CXPLAT_EVENTQ_ISSUER_CALLBACK* Callback,
+    _In_ void* Context
+    )
+{
+    QUIC_STATUS Status;
+    if (Queue->SingleIssuer) {
+        CxPlatLockAcquire(&Queue->Lock);
+        if (!Queue->IssuerStarted) {
+            //
+            // The ring is still disabled, so there is no issuer yet and any
+            // thread may register. Hold the lock so the issuer can't start
+            // in the meantime.
+            //
+            Status = Callback(Context);
+            CxPlatLockRelease(&Queue->Lock);
+            return Status;
+        }
+        CxPlatLockRelease(&Queue->Lock);
+
+        if (!CxPlatEventQIsIssuer(Queue)) {
+            CXPLAT_EVENTQ_ISSUER_CALL Call;
+            CxPlatSqeInitialize(Queue, CxPlatEventQIssuerCallCompletion, &Call.Sqe);
+            CxPlatEventInitialize(&Call.Completed, TRUE, FALSE);
+            Call.Callback = Callback;
+            Call.Context = Context;
+            Call.Status = QUIC_STATUS_OUT_OF_MEMORY;
+            if (CxPlatEventQEnqueue(Queue, &Call.Sqe)) {
+                CxPlatEventWaitForever(Call.Completed);
+            }
+            CxPlatEventUninitialize(Call.Completed);
+            CxPlatSqeCleanup(Queue, &Call.Sqe);
+            return Call.Status;
+        }
+    }
+    return Callback(Context);
+}
+
 #else // epoll
 
 typedef int CXPLAT_EVENTQ;
@@ -1344,6 +1714,30 @@ CxPlatEventQEnqueue(
     return eventfd_write(sqe->fd, 1) == 0;
 }
 
+//
+// Has the kernel busy poll the NIC queues of the epoll set's sockets, instead
+// of waiting for their interrupts.
+//
+QUIC_INLINE
+BOOLEAN
+CxPlatEventQSetBusyPoll(
+    _In_ CXPLAT_EVENTQ* queue,
+    _In_ uint32_t BusyPollUs
+    )
+{
+#ifdef EPIOCSPARAMS
+    struct epoll_params Params;
+    memset(&Params, 0, sizeof(Params));
+    Params.busy_poll_usecs = BusyPollUs;
+    Params.prefer_busy_poll = 1;
+    return ioctl(*queue, EPIOCSPARAMS, &Params) == 0;
+#else
+    UNREFERENCED_PARAMETER(queue);
+    UNREFERENCED_PARAMETER(BusyPollUs);
+    return FALSE;
+#endif
+}
+
 QUIC_INLINE
 uint32_t
 CxPlatEventQDequeue(
@@ -389,6 +389,14 @@ typedef EX_SPIN_LOCK CXPLAT_DISPATCH_RW_LOCK;
 #define QuicReadLongPtrNoFence ReadNoFence
 #endif
 #define QuicReadPtrNoFence ReadPointerNoFence
+#define QuicReadAcquire ReadAcquire
+#define QuicWriteRelease WriteRelease
+#define QuicReadAcquire16(p) ((uint16_t)ReadAcquire16((volatile SHORT*)(p)))
+#define QuicWriteRelease16(p, v) WriteRelease16((volatile SHORT*)(p), (SHORT)(v))
+#define QuicReadAcquire64 ReadAcquire64
+#define QuicWriteRelease64 WriteRelease64
+#define QuicReadPtrAcquire(p) ReadPointerAcquire((PVOID volatile*)(p))
+#define QuicWritePtrRelease(p, v) WritePointerRelease((PVOID volatile*)(p), (v))
 
 typedef LONG_PTR CXPLAT_REF_COUNT;
 
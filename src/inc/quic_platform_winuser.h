@@ -536,6 +536,8 @@ typedef SRWLOCK CXPLAT_DISPATCH_RW_LOCK;
 #define CxPlatDispatchRwLockAcquireExclusive(Lock, PrevIrql) AcquireSRWLockExclusive(Lock)
 #define CxPlatDispatchRwLockReleaseShared(Lock, PrevIrql) ReleaseSRWLockShared(Lock)
 #define CxPlatDispatchRwLockReleaseExclusive(Lock, PrevIrql) ReleaseSRWLockExclusive(Lock)
+#define CxPlatDispatchRwLockTryAcquireShared(Lock, PrevIrql) (TryAcquireSRWLockShared(Lock) != FALSE)
+#define CxPlatDispatchRwLockTryAcquireExclusive(Lock, PrevIrql) (TryAcquireSRWLockExclusive(Lock) != FALSE)
 
 //
 // Reference Count Interface
@@ -583,6 +585,26 @@ typedef SRWLOCK CXPLAT_DISPATCH_RW_LOCK;
 #define QuicReadPtrNoFence ReadPointerNoFence
 #endif
 
+#ifdef QUIC_RESTRICTED_BUILD
+#define QuicReadAcquire(p) (*(volatile LONG*)(p))
+#define QuicWriteRelease(p, v) (*(volatile LONG*)(p) = (v))
+#define QuicReadAcquire16(p) (*(volatile uint16_t*)(p))
+#define QuicWriteRelease16(p, v) (*(volatile uint16_t*)(p) = (v))
+#define QuicReadAcquire64(p) (*(volatile int64_t*)(p))
+#define QuicWriteRelease64(p, v) (*(volatile int64_t*)(p) = (v))
+#define QuicReadPtrAcquire(p) ((void*)(*(void* volatile*)(p)))
+#define QuicWritePtrRelease(p, v) (*(void* volatile*)(p) = (v))
+#else
+#define QuicReadAcquire ReadAcquire
+#define QuicWriteRelease WriteRelease
+#define QuicReadAcquire16(p) ((uint16_t)ReadAcquire16((volatile SHORT*)(p)))
+#define QuicWriteRelease16(p, v) WriteRelease16((volatile SHORT*)(p), (SHORT)(v))
+#define QuicReadAcquire64 ReadAcquire64
+#define QuicWriteRelease64 WriteRelease64
+#define QuicReadPtrAcquire(p) ReadPointerAcquire((PVOID volatile*)(p))
+#define QuicWritePtrRelease(p, v) WritePointerRelease((PVOID volatile*)(p), (v))
+#endif
+
 typedef LONG_PTR CXPLAT_REF_COUNT;
 
 QUIC_INLINE
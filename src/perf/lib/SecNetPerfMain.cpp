@@ -143,6 +143,14 @@ PrintHelp(
         "  -cpu:<cpu_index>         Specify the processor(s) to use.\n"
         "  -cipher:<value>          Decimal value of 1 or more QUIC_ALLOWED_CIPHER_SUITE_FLAGS.\n"
         "  -highpri:<0/1>           Configures MsQuic to run threads at high priority. (def:0)\n"
+        "  -zerocopy:<0/1>          Enables zero-copy sends for large send batches (epoll, iouring). (def:0)\n"
+        "  -pacingoffload:<0/1>     Hands paced sends to the kernel with departure times; needs the fq qdisc (epoll, iouring). (def:0)\n"
+        "  -encodedcids:<0/1>       Routes server CIDs through slots encoded in the CID instead of hashing. (def:0)\n"
+        "  -connarena:<0/1>         Allocates connection-lifetime state from a per-connection arena. (def:0)\n"
+        "  -worksteal:<0/1>         Lets idle workers take queued connections from loaded workers. (def:0)\n"
+        "  -ioring:<profile>        io_uring ring setup profile (iouring). Uses -pollidle as the SQ poll idle time.\n"
+        "                            - {default, sqpoll, defer}\n"
+        "  -busypoll:<0/1>          Enables kernel busy polling of the NIC queues (epoll, iouring). Uses -pollidle as the busy poll time. (def:0)\n"
         "  -dscp:<0-63>             Specify DSCP value to mark sent packets with. (def:0)\n"
         "\n",
         PERF_DEFAULT_PORT,
@@ -196,6 +204,81 @@ QuicMainStart(
         Settings.SetGlobal();
     }
 
+    uint8_t ZeroCopySend = 0;
+    if (TryGetValue(argc, argv, "zerocopy", &ZeroCopySend)) {
+        BOOLEAN Option = ZeroCopySend != 0;
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_DATAPATH_ZERO_COPY_SEND_ENABLED,
+                sizeof(Option),
+                &Option))) {
+            WriteOutput("Failed to set zero-copy send %d\n", Status);
+            return Status;
+        }
+    }
+
+    uint8_t PacingOffload = 0;
+    if (TryGetValue(argc, argv, "pacingoffload", &PacingOffload)) {
+        BOOLEAN Option = PacingOffload != 0;
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_DATAPATH_PACING_OFFLOAD_ENABLED,
+                sizeof(Option),
+                &Option))) {
+            WriteOutput("Failed to set pacing offload %d\n", Status);
+            return Status;
+        }
+    }
+
+    uint8_t EncodedCids = 0;
+    if (TryGetValue(argc, argv, "encodedcids", &EncodedCids)) {
+        BOOLEAN Option = EncodedCids != 0;
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_ENCODED_CIDS_ENABLED,
+                sizeof(Option),
+                &Option))) {
+            WriteOutput("Failed to set encoded CIDs %d\n", Status);
+            return Status;
+        }
+    }
+
+    uint8_t ConnArena = 0;
+    if (TryGetValue(argc, argv, "connarena", &ConnArena)) {
+        BOOLEAN Option = ConnArena != 0;
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_CONN_ARENA_ENABLED,
+                sizeof(Option),
+                &Option))) {
+            WriteOutput("Failed to set connection arena %d\n", Status);
+            return Status;
+        }
+    }
+
+    uint8_t WorkSteal = 0;
+    if (TryGetValue(argc, argv, "worksteal", &WorkSteal)) {
+        BOOLEAN Option = WorkSteal != 0;
+        if (QUIC_FAILED(
+            Status =
+            MsQuic->SetParam(
+                nullptr,
+                QUIC_PARAM_GLOBAL_WORK_STEALING_ENABLED,
+                sizeof(Option),
+                &Option))) {
+            WriteOutput("Failed to set work stealing %d\n", Status);
+            return Status;
+        }
+    }
+
     const char* CpuStr;
     if ((CpuStr = GetValue(argc, argv, "cpu")) != nullptr) {
         SetConfig = true;
@@ -228,6 +311,26 @@ QuicMainStart(
         SetConfig = true;
     }
 
+    uint8_t BusyPoll = 0;
+    if (TryGetValue(argc, argv, "busypoll", &BusyPoll) && BusyPoll) {
+        Config->Flags |= QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL;
+        SetConfig = true;
+    }
+
+    const char* IoRingStr = GetValue(argc, argv, "ioring");
+    if (IoRingStr != nullptr) {
+        if (IsValue(IoRingStr, "sqpoll")) {
+            Config->Flags |= QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_SQPOLL;
+            SetConfig = true;
+        } else if (IsValue(IoRingStr, "defer")) {
+            Config->Flags |= QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_DEFER;
+            SetConfig = true;
+        } else if (!IsValue(IoRingStr, "default")) {
+            WriteOutput("Failed to parse io_uring profile[%s]!\n", IoRingStr);
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+
     if (SetConfig &&
         QUIC_FAILED(
         Status =
@@ -468,6 +468,43 @@ CxPlatEncrypt(
     return NtStatusToQuicStatus(Status);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch
+    )
+{
+    //
+    // BCrypt has no multi-buffer AEAD interface, so just encrypt each entry
+    // with the same key handle. It can't encrypt from separate buffers either,
+    // so the extents are copied into the payload first.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        for (uint8_t j = 0; j < Batch[i].ExtentCount; ++j) {
+            CxPlatCopyMemory(
+                Batch[i].Buffer + Batch[i].Extents[j].Offset,
+                Batch[i].Extents[j].Source,
+                Batch[i].Extents[j].Length);
+        }
+        QUIC_STATUS Status =
+            CxPlatEncrypt(
+                Key,
+                Batch[i].Iv,
+                Batch[i].AuthDataLength,
+                Batch[i].AuthData,
+                Batch[i].BufferLength,
+                Batch[i].Buffer);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatDecrypt(
@@ -515,6 +552,36 @@ CxPlatDecrypt(
     return NtStatusToQuicStatus(Status);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch,
+    _Out_ uint8_t* DecryptedCount
+    )
+{
+    *DecryptedCount = 0;
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        QUIC_STATUS Status =
+            CxPlatDecrypt(
+                Key,
+                Batch[i].Iv,
+                Batch[i].AuthDataLength,
+                Batch[i].AuthData,
+                Batch[i].BufferLength,
+                Batch[i].Buffer);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+        ++*DecryptedCount;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -381,6 +381,136 @@ CxPlatEncrypt(
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// The stream offset the bulk of each extent is encrypted from is aligned to
+// this, which is a multiple of both the AES and ChaCha20 block sizes.
+//
+#define CXPLAT_CRYPT_EXTENT_ALIGNMENT 64
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch
+    )
+{
+    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+    OSSL_PARAM AlgParam[2];
+    int OutLen;
+
+    //
+    // OpenSSL doesn't expose a multi-buffer AEAD interface through its
+    // providers, so run the whole batch back to back on the same cipher
+    // context, only resetting the nonce between packets. The tag parameter is
+    // built once and just retargeted at each packet's tag.
+    //
+    AlgParam[0] = OSSL_PARAM_construct_octet_string("tag", NULL, CXPLAT_ENCRYPTION_OVERHEAD);
+    AlgParam[1] = OSSL_PARAM_construct_end();
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        CXPLAT_CRYPT_BATCH_ENTRY* Entry = &Batch[i];
+        CXPLAT_DBG_ASSERT(CXPLAT_ENCRYPTION_OVERHEAD <= Entry->BufferLength);
+
+        const uint16_t PlainTextLength = Entry->BufferLength - CXPLAT_ENCRYPTION_OVERHEAD;
+        uint8_t *Tag = Entry->Buffer + PlainTextLength;
+
+        if (EVP_EncryptInit_ex(CipherCtx, NULL, NULL, NULL, Entry->Iv) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptInit_ex failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        if (Entry->AuthData != NULL &&
+            EVP_EncryptUpdate(CipherCtx, NULL, &OutLen, Entry->AuthData, (int)Entry->AuthDataLength) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptUpdate (AD) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        //
+        // Encrypt the extents straight from their sources, and the rest of the
+        // payload in place, in order. The head of each extent is copied in
+        // place, so that its bulk starts at a multiple of the cipher's block
+        // size, which the ciphers process much faster.
+        //
+        uint16_t Offset = 0;
+        for (uint8_t j = 0; j < Entry->ExtentCount; ++j) {
+            const uint8_t* Source = Entry->Extents[j].Source;
+            uint16_t Start = Entry->Extents[j].Offset;
+            uint16_t Length = Entry->Extents[j].Length;
+            CXPLAT_DBG_ASSERT(Start >= Offset);
+            CXPLAT_DBG_ASSERT(Start + Length <= PlainTextLength);
+
+            uint16_t Head = (CXPLAT_CRYPT_EXTENT_ALIGNMENT - Start % CXPLAT_CRYPT_EXTENT_ALIGNMENT) % CXPLAT_CRYPT_EXTENT_ALIGNMENT;
+            if (Head > Length) {
+                Head = Length;
+            }
+            CxPlatCopyMemory(Entry->Buffer + Start, Source, Head);
+            Start += Head;
+            Source += Head;
+            Length -= Head;
+            if (Length == 0) {
+                continue;
+            }
+
+            if (Start > Offset &&
+                EVP_EncryptUpdate(CipherCtx, Entry->Buffer + Offset, &OutLen, Entry->Buffer + Offset, (int)(Start - Offset)) != 1) {
+                QuicTraceEvent(
+                    LibraryError,
+                    "[ lib] ERROR, %s.",
+                    "EVP_EncryptUpdate (Cipher) failed");
+                return QUIC_STATUS_TLS_ERROR;
+            }
+
+            if (EVP_EncryptUpdate(CipherCtx, Entry->Buffer + Start, &OutLen, Source, (int)Length) != 1) {
+                QuicTraceEvent(
+                    LibraryError,
+                    "[ lib] ERROR, %s.",
+                    "EVP_EncryptUpdate (Extent) failed");
+                return QUIC_STATUS_TLS_ERROR;
+            }
+
+            Offset = Start + Length;
+        }
+
+        if (PlainTextLength > Offset &&
+            EVP_EncryptUpdate(CipherCtx, Entry->Buffer + Offset, &OutLen, Entry->Buffer + Offset, (int)(PlainTextLength - Offset)) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        if (EVP_EncryptFinal_ex(CipherCtx, Tag, &OutLen) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_EncryptFinal_ex failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        AlgParam[0].data = Tag;
+        AlgParam[0].return_size = OSSL_PARAM_UNMODIFIED;
+
+        if (EVP_CIPHER_CTX_get_params(CipherCtx, AlgParam) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_CIPHER_CTX_get_params (GET_TAG) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatDecrypt(
@@ -455,6 +585,86 @@ CxPlatDecrypt(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint8_t BatchSize,
+    _Inout_updates_(BatchSize)
+        CXPLAT_CRYPT_BATCH_ENTRY* Batch,
+    _Out_ uint8_t* DecryptedCount
+    )
+{
+    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+    OSSL_PARAM AlgParam[2];
+    int OutLen;
+
+    *DecryptedCount = 0;
+
+    AlgParam[0] = OSSL_PARAM_construct_octet_string("tag", NULL, CXPLAT_ENCRYPTION_OVERHEAD);
+    AlgParam[1] = OSSL_PARAM_construct_end();
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        CXPLAT_CRYPT_BATCH_ENTRY* Entry = &Batch[i];
+        CXPLAT_DBG_ASSERT(CXPLAT_ENCRYPTION_OVERHEAD <= Entry->BufferLength);
+
+        const uint16_t CipherTextLength = Entry->BufferLength - CXPLAT_ENCRYPTION_OVERHEAD;
+        uint8_t *Tag = Entry->Buffer + CipherTextLength;
+
+        if (EVP_DecryptInit_ex(CipherCtx, NULL, NULL, NULL, Entry->Iv) != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "EVP_DecryptInit_ex failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        if (Entry->AuthData != NULL &&
+            EVP_DecryptUpdate(CipherCtx, NULL, &OutLen, Entry->AuthData, (int)Entry->AuthDataLength) != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "EVP_DecryptUpdate (AD) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        if (EVP_DecryptUpdate(CipherCtx, Entry->Buffer, &OutLen, Entry->Buffer, (int)CipherTextLength) != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "EVP_DecryptUpdate (Cipher) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        AlgParam[0].data = Tag;
+        AlgParam[0].return_size = OSSL_PARAM_UNMODIFIED;
+
+        if (EVP_CIPHER_CTX_set_params(CipherCtx, AlgParam) != 1) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "EVP_CIPHER_CTX_set_params (SET_TAG) failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        if (EVP_DecryptFinal_ex(CipherCtx, Tag, &OutLen) != 1) {
+            QuicTraceEvent(
+                LibraryErrorStatus,
+                "[ lib] ERROR, %u, %s.",
+                ERR_get_error(),
+                "EVP_DecryptFinal_ex failed");
+            return QUIC_STATUS_TLS_ERROR;
+        }
+
+        ++*DecryptedCount;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
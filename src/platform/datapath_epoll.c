@@ -90,6 +90,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_ADDR RemoteAddress;
 
+    //
+    // The kernel departure time (SCM_TXTIME) of the send, in nanoseconds, or
+    // zero to send immediately.
+    //
+    uint64_t TxTime;
+
     //
     // The current QUIC_BUFFER returned to the client for segmented sends.
     //
@@ -127,6 +133,28 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the send was made with MSG_ZEROCOPY, so the kernel may still
+    // reference the buffer after sendmsg returns.
+    //
+    uint8_t ZeroCopy : 1;
+
+    //
+    // The completion ID the kernel assigned to the zero-copy send.
+    //
+    uint32_t ZeroCopyId;
+
+    //
+    // Entry in the socket's zero-copy send list.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyEntry;
+
+    //
+    // References held by the sender and by the kernel for zero-copy sends.
+    // The last one released frees the send data.
+    //
+    CXPLAT_REF_COUNT ZeroCopyRefCount;
+
     //
     // Space for ancillary control data.
     //
@@ -136,6 +164,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -171,6 +202,17 @@ CXPLAT_EVENT_COMPLETION CxPlatSocketContextUninitializeEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatSocketContextFlushTxEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatSocketContextIoEventComplete;
 
+void
+CxPlatSocketContextZeroCopyComplete(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    );
+
+//
+// How long (in milliseconds) socket cleanup waits for the kernel to complete
+// outstanding zero-copy sends before closing the socket.
+//
+#define CXPLAT_ZERO_COPY_DRAIN_TIMEOUT_MS 100
+
 void
 CxPlatProcessorContextInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
@@ -198,7 +240,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -259,6 +300,34 @@ DataPathInitialize(
         Datapath->SendIoVecCount = CXPLAT_MAX_IO_BATCH_SIZE;
     }
 
+    if (InitConfig->EnableZeroCopySend) {
+#ifdef SO_ZEROCOPY
+        //
+        // Only segmented sends are large enough to be worth pinning, so
+        // zero-copy is only used along with send segmentation.
+        //
+        Datapath->ZeroCopySendEnabled =
+            !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+#endif
+        if (!Datapath->ZeroCopySendEnabled) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Zero-copy send not supported without send segmentation");
+        }
+    }
+
+    if (InitConfig->EnablePacingOffload) {
+#ifdef SO_TXTIME
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+#else
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "Pacing offload not supported");
+#endif
+    }
+
     Datapath->RecvBlockStride =
         ALIGN_UP_BY(sizeof(DATAPATH_RX_PACKET) + ClientRecvDataLength, CXPLAT_MEMORY_ALIGNMENT);
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
@@ -718,6 +787,36 @@ CxPlatSocketContextInitialize(
             goto Exit;
         }
 
+        CxPlatSocketConfigureBusyPoll(SocketContext);
+        CxPlatSocketConfigureTxTime(SocketContext);
+
+    #ifdef SO_ZEROCOPY
+        if (Datapath->ZeroCopySendEnabled) {
+            //
+            // Kernels before 5.0 don't support zero-copy for UDP sockets, in
+            // which case the socket just keeps copying its sends.
+            //
+            Option = TRUE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_ZEROCOPY,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    Binding,
+                    errno,
+                    "setsockopt(SO_ZEROCOPY) failed");
+            } else {
+                SocketContext->ZeroCopyEnabled = TRUE;
+            }
+        }
+    #endif
+
         //
         // Only set SO_REUSEPORT on a server socket, otherwise the client could be
         // assigned a server port (unless it's forcing sharing).
@@ -965,11 +1064,56 @@ CxPlatSocketContextUninitializeComplete(
 
     CXPLAT_DBG_ASSERT(SocketContext->AcceptSocket == NULL);
 
+#ifdef SO_ZEROCOPY
+    if (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        //
+        // The kernel sends zero-copy buffers straight from their pages, so
+        // they must not go back to the pool until it reports them done. Wait
+        // a bounded time for the outstanding completions.
+        //
+        const uint64_t StartTime = CxPlatTimeMs64();
+        CxPlatSocketContextZeroCopyComplete(SocketContext);
+        while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+            const uint64_t Elapsed = CxPlatTimeDiff64(StartTime, CxPlatTimeMs64());
+            if (Elapsed >= CXPLAT_ZERO_COPY_DRAIN_TIMEOUT_MS) {
+                break;
+            }
+            struct pollfd PollFd = { SocketContext->SocketFd, 0, 0 };
+            const int Result =
+                poll(&PollFd, 1, (int)(CXPLAT_ZERO_COPY_DRAIN_TIMEOUT_MS - Elapsed));
+            if (Result < 0 && errno != EINTR) {
+                break;
+            }
+            CxPlatSocketContextZeroCopyComplete(SocketContext);
+        }
+    }
+#endif
+
     if (SocketContext->SocketFd != INVALID_SOCKET) {
         epoll_ctl(*SocketContext->DatapathPartition->EventQ, EPOLL_CTL_DEL, SocketContext->SocketFd, NULL);
         close(SocketContext->SocketFd);
     }
 
+    while (!CxPlatListIsEmpty(&SocketContext->ZeroCopyQueue)) {
+        //
+        // The kernel never reported these done. Keep them out of the pool, so
+        // that no new send is written into pages still being transmitted.
+        //
+        CXPLAT_SEND_DATA* SendData =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&SocketContext->ZeroCopyQueue),
+                CXPLAT_SEND_DATA,
+                ZeroCopyEntry);
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            SendData->ZeroCopyId,
+            "zero-copy send not completed before close");
+        CXPLAT_POOL_HEADER* Header = (CXPLAT_POOL_HEADER*)SendData - 1;
+        CxPlatFree(Header, Header->Owner->Tag);
+    }
+
     if (SocketContext->SqeInitialized) {
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->ShutdownSqe);
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->IoSqe.Sqe);
@@ -977,6 +1121,7 @@ CxPlatSocketContextUninitializeComplete(
     }
 
     CxPlatLockUninitialize(&SocketContext->TxQueueLock);
+    CxPlatLockUninitialize(&SocketContext->ZeroCopyQueueLock);
     CxPlatRundownUninitialize(&SocketContext->UpcallRundown);
 
     if (SocketContext->DatapathPartition) {
@@ -1135,6 +1280,8 @@ SocketCreateUdp(
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatLockInitialize(&Binding->SocketContexts[i].TxQueueLock);
+        CxPlatListInitializeHead(&Binding->SocketContexts[i].ZeroCopyQueue);
+        CxPlatLockInitialize(&Binding->SocketContexts[i].ZeroCopyQueueLock);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
 
@@ -1265,6 +1412,8 @@ CxPlatSocketCreateTcpInternal(
     SocketContext->SocketFd = INVALID_SOCKET;
     CxPlatListInitializeHead(&SocketContext->TxQueue);
     CxPlatLockInitialize(&SocketContext->TxQueueLock);
+    CxPlatListInitializeHead(&SocketContext->ZeroCopyQueue);
+    CxPlatLockInitialize(&SocketContext->ZeroCopyQueueLock);
     CxPlatRundownInitialize(&SocketContext->UpcallRundown);
 
     CXPLAT_UDP_CONFIG Config = {
@@ -1431,6 +1580,8 @@ SocketCreateTcpListener(
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatLockInitialize(&Binding->SocketContexts[i].TxQueueLock);
+        CxPlatListInitializeHead(&Binding->SocketContexts[i].ZeroCopyQueue);
+        CxPlatLockInitialize(&Binding->SocketContexts[i].ZeroCopyQueueLock);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
 
@@ -1559,11 +1710,136 @@ SocketDelete(
 // Receive Path
 //
 
+//
+// Once this many zero-copy sends on a socket have completed, zero-copy is
+// turned off for the socket if the kernel copied nearly all of them anyway
+// (e.g. loopback or a NIC without scatter-gather), as pinning the pages is
+// then pure overhead.
+//
+#define CXPLAT_ZERO_COPY_PROBE_COUNT 64
+
+void
+CxPlatSocketContextZeroCopyComplete(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+#ifdef SO_ZEROCOPY
+    CXPLAT_LIST_ENTRY Completed;
+    CxPlatListInitializeHead(&Completed);
+    uint32_t CompletedCount = 0;
+    uint32_t CopiedCount = 0;
+
+    while (TRUE) {
+        alignas(8)
+        uint8_t ControlBuffer[
+            CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+        struct msghdr Mhdr = {0};
+        Mhdr.msg_control = ControlBuffer;
+        Mhdr.msg_controllen = sizeof(ControlBuffer);
+
+        if (recvmsg(SocketContext->SocketFd, &Mhdr, MSG_ERRQUEUE) < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                QuicTraceEvent(
+                    DatapathErrorStatus,
+                    "[data][%p] ERROR, %u, %s.",
+                    SocketContext->Binding,
+                    errno,
+                    "recvmsg(MSG_ERRQUEUE) failed");
+            }
+            break;
+        }
+
+        for (struct cmsghdr* CMsg = CMSG_FIRSTHDR(&Mhdr);
+             CMsg != NULL;
+             CMsg = CMSG_NXTHDR(&Mhdr, CMsg)) {
+            if (!(CMsg->cmsg_level == IPPROTO_IP && CMsg->cmsg_type == IP_RECVERR) &&
+                !(CMsg->cmsg_level == IPPROTO_IPV6 && CMsg->cmsg_type == IPV6_RECVERR)) {
+                continue;
+            }
+            CXPLAT_DBG_ASSERT_CMSG(CMsg, struct sock_extended_err);
+            const struct sock_extended_err* Err =
+                (const struct sock_extended_err*)CMSG_DATA(CMsg);
+            if (Err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || Err->ee_errno != 0) {
+                continue;
+            }
+
+            //
+            // The kernel reports the range of completion IDs [ee_info, ee_data]
+            // that are done with their buffers.
+            //
+            const uint32_t RangeStart = Err->ee_info;
+            const uint32_t RangeLength = Err->ee_data - Err->ee_info + 1;
+            CompletedCount += RangeLength;
+            if (Err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                CopiedCount += RangeLength;
+            }
+
+            CxPlatLockAcquire(&SocketContext->ZeroCopyQueueLock);
+            CXPLAT_LIST_ENTRY* Entry = SocketContext->ZeroCopyQueue.Flink;
+            while (Entry != &SocketContext->ZeroCopyQueue) {
+                CXPLAT_SEND_DATA* SendData =
+                    CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_SEND_DATA, ZeroCopyEntry);
+                Entry = Entry->Flink;
+                if (SendData->ZeroCopyId - RangeStart < RangeLength) {
+                    CxPlatListEntryRemove(&SendData->ZeroCopyEntry);
+                    CxPlatListInsertTail(&Completed, &SendData->ZeroCopyEntry);
+                }
+            }
+            CxPlatLockRelease(&SocketContext->ZeroCopyQueueLock);
+        }
+    }
+
+    while (!CxPlatListIsEmpty(&Completed)) {
+        CxPlatSendDataFree(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Completed),
+                CXPLAT_SEND_DATA,
+                ZeroCopyEntry));
+    }
+
+    if (CompletedCount == 0) {
+        return;
+    }
+
+    CxPlatWorkerPoolAddSendZeroCopyStatistics(
+        SocketContext->DatapathPartition->Datapath->WorkerPool,
+        SocketContext->DatapathPartition->PartitionIndex,
+        CompletedCount,
+        CopiedCount);
+
+    if (SocketContext->ZeroCopyCompletedCount < CXPLAT_ZERO_COPY_PROBE_COUNT) {
+        SocketContext->ZeroCopyCompletedCount += CompletedCount;
+        SocketContext->ZeroCopyCopiedCount += CopiedCount;
+        if (SocketContext->ZeroCopyCompletedCount >= CXPLAT_ZERO_COPY_PROBE_COUNT &&
+            SocketContext->ZeroCopyCopiedCount >=
+                SocketContext->ZeroCopyCompletedCount - SocketContext->ZeroCopyCompletedCount / 8) {
+            QuicTraceEvent(
+                DatapathErrorStatus,
+                "[data][%p] ERROR, %u, %s.",
+                SocketContext->Binding,
+                SocketContext->ZeroCopyCopiedCount,
+                "zero-copy sends copied by the kernel; disabling zero-copy");
+            SocketContext->ZeroCopyEnabled = FALSE;
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(SocketContext);
+#endif
+}
+
 void
 CxPlatSocketHandleErrors(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
     )
 {
+    if (SocketContext->Binding->Type == CXPLAT_SOCKET_UDP &&
+        SocketContext->DatapathPartition->Datapath->ZeroCopySendEnabled) {
+        //
+        // Zero-copy completions are delivered on the socket error queue.
+        //
+        CxPlatSocketContextZeroCopyComplete(SocketContext);
+    }
+
     int ErrNum = 0;
     socklen_t OptLen = sizeof(ErrNum);
     ssize_t Ret =
@@ -2043,10 +2319,13 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTime =
+            SocketContext->TxTimeEnabled && Config->TxTime != 0 ? US_TO_NS(Config->TxTime) : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopy = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
@@ -2061,6 +2340,9 @@ SendDataFree(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
+    if (SendData->ZeroCopy && !CxPlatRefDecrement(&SendData->ZeroCopyRefCount)) {
+        return; // The other of the sender and the kernel still uses the buffer.
+    }
     CxPlatPoolFree(SendData);
 }
 
@@ -2293,6 +2575,17 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTime != 0) {
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = SendData->TxTime;
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
@@ -2316,6 +2609,41 @@ CxPlatSendDataSendSegmented(
         msghdr.msg_controllen = SendData->ControlBufferLength;
     }
 
+#ifdef SO_ZEROCOPY
+    CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    if (SocketContext->ZeroCopyEnabled &&
+        SendData->TotalSize >= CXPLAT_ZERO_COPY_SEND_MIN_SIZE) {
+        //
+        // The kernel numbers successful zero-copy sends in the order it sees
+        // them, so keep the send and queue insertion atomic. Once queued, the
+        // send data is freed by whichever of SendDataFree and the error queue
+        // completion comes last.
+        //
+        BOOLEAN Sent = FALSE;
+        CxPlatLockAcquire(&SocketContext->ZeroCopyQueueLock);
+        if (sendmsg(SocketContext->SocketFd, &msghdr, MSG_ZEROCOPY) >= 0) {
+            SendData->ZeroCopy = TRUE;
+            SendData->ZeroCopyId = SocketContext->ZeroCopyNextId++;
+            CxPlatRefInitializeEx(&SendData->ZeroCopyRefCount, 2);
+            CxPlatListInsertTail(&SocketContext->ZeroCopyQueue, &SendData->ZeroCopyEntry);
+            Sent = TRUE;
+        }
+        const int Errno = errno;
+        CxPlatLockRelease(&SocketContext->ZeroCopyQueueLock);
+        if (Sent) {
+            return TRUE;
+        }
+        if (Errno != ENOBUFS) {
+            errno = Errno;
+            return FALSE;
+        }
+        //
+        // ENOBUFS means the socket is out of option memory for tracking
+        // zero-copy completions, so fall back to copying this one.
+        //
+    }
+#endif
+
     if (sendmsg(SendData->SocketContext->SocketFd, &msghdr, 0) < 0) {
         return FALSE;
     }
@@ -25,6 +25,7 @@ CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)
 typedef enum DATAPATH_CONTEXT_TYPE {
     DatapathContextRecv,
     DatapathContextSend,
+    DatapathContextRecvCancel,
 } DATAPATH_CONTEXT_TYPE;
 
 //
@@ -53,6 +54,11 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) DATAPATH_RX_IO_
     //
     CXPLAT_DATAPATH_PARTITION* DatapathPartition;
 
+    //
+    // The receive buffer group this block belongs to.
+    //
+    CXPLAT_RECV_BUFFER_GROUP* BufferGroup;
+
     //
     // An array of packets to represent the datagram and metadata returned to
     // the app.
@@ -79,6 +85,25 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) DATAPATH_RX_PAC
 
 } DATAPATH_RX_PACKET;
 
+//
+// The most sockets a batch of receive completions is coalesced across. Matches
+// the number of completions the worker dequeues at once.
+//
+#define CXPLAT_RECV_BATCH_MAX_SOCKETS 16
+
+//
+// Receives from a batch of completions, chained per socket so each socket
+// indicates them to the app all at once.
+//
+typedef struct CXPLAT_RECV_BATCH {
+    uint32_t SocketCount;
+    struct {
+        CXPLAT_SOCKET_CONTEXT* SocketContext;
+        CXPLAT_RECV_DATA* Head;
+        CXPLAT_RECV_DATA** Tail;
+    } Sockets[CXPLAT_RECV_BATCH_MAX_SOCKETS];
+} CXPLAT_RECV_BATCH;
+
 #if DEBUG
 
 typedef enum CXPLAT_SEND_DATA_STATE {
@@ -123,6 +148,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_ADDR RemoteAddress;
 
+    //
+    // The kernel departure time (SCM_TXTIME) of the send, in nanoseconds, or
+    // zero to send immediately.
+    //
+    uint64_t TxTime;
+
     //
     // The current QUIC_BUFFER returned to the client for segmented sends.
     //
@@ -160,6 +191,23 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the send data was allocated from the partition's registered
+    // send buffer pool instead of the SendBlockPool.
+    //
+    uint8_t RegisteredBuffer : 1;
+
+    //
+    // Indicates the send was submitted as a zero-copy send. The send data
+    // must not be freed until the notification completion arrives.
+    //
+    uint8_t ZeroCopy : 1;
+
+    //
+    // Indicates the zero-copy send references the registered fixed buffer.
+    //
+    uint8_t FixedBuffer : 1;
+
     //
     // The message header for the send.
     //
@@ -174,6 +222,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -216,7 +267,41 @@ const struct msghdr CxPlatRecvMsgHdr = {
     .msg_namelen = ALIGN_UP_BY(sizeof(QUIC_ADDR), CXPLAT_MEMORY_ALIGNMENT),
     .msg_controllen = CXPLAT_FIELD_SIZE(CXPLAT_RECV_MSG_CONTROL_BUFFER, Data),
 };
-const uint32_t RecvBufCount = 1024;
+
+//
+// Receive buffer groups start with their minimum number of slabs, grow a slab
+// at a time when the kernel runs out of buffers and shrink back a slab at a
+// time once they haven't run out for RecvBufferGroupShrinkDelayUs. Sockets
+// move from the small buffer group to the large one after receiving
+// RecvBurstThreshold datagrams within RecvBurstWindowUs.
+//
+const uint16_t RecvBuffersPerSlab = 128;
+const uint16_t RecvSmallBufferGroupMinSlabs = 8;
+const uint16_t RecvSmallBufferGroupMaxSlabs = 32;
+const uint16_t RecvLargeBufferGroupMinSlabs = 4;
+const uint16_t RecvLargeBufferGroupMaxSlabs = 16;
+const uint32_t RecvBufferGroupShrinkCheckInterval = 1024;
+const uint64_t RecvBufferGroupShrinkDelayUs = 10 * CXPLAT_MICROSEC_PER_SEC;
+const uint32_t RecvBurstThreshold = 32;
+const uint64_t RecvBurstWindowUs = CXPLAT_MICROSEC_PER_MS;
+const uint32_t ZeroCopySendBufCount = 256;
+const uint32_t FixedFileMaxCount = 16384;
+
+//
+// Switches an SQE prepared with the raw socket FD over to the socket's fixed
+// file slot, if it has one, to avoid the per-operation file reference.
+//
+void
+CxPlatSocketContextSetSqeFixedFile(
+    _In_ const CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _Inout_ struct io_uring_sqe* Sqe
+    )
+{
+    if (SocketContext->FixedFileIndex >= 0) {
+        Sqe->fd = SocketContext->FixedFileIndex;
+        Sqe->flags |= IOSQE_FIXED_FILE;
+    }
+}
 
 void
 CxPlatSocketIoStart(
@@ -244,14 +329,6 @@ CxPlatSocketAllocSqe(
     return io_sqe;
 }
 
-uint32_t
-CxPlatGetBufferPoolBufferSize(
-    _In_ const CXPLAT_REGISTERED_BUFFER_POOL* Pool
-    )
-{
-    return Pool->BufferSize;
-}
-
 uint8_t*
 CxPlatGetBufferPoolBuffer(
     _In_ const CXPLAT_REGISTERED_BUFFER_POOL* Pool,
@@ -261,85 +338,478 @@ CxPlatGetBufferPoolBuffer(
     return Pool->Buffers + (Index * Pool->BufferSize);
 }
 
+DATAPATH_RX_IO_BLOCK*
+CxPlatRecvBufferGroupGetBlock(
+    _In_ const CXPLAT_RECV_BUFFER_GROUP* Group,
+    _In_ uint32_t BufferIndex
+    )
+{
+    return
+        (DATAPATH_RX_IO_BLOCK*)
+            (Group->Slabs[BufferIndex / Group->BuffersPerSlab] +
+             (BufferIndex % Group->BuffersPerSlab) * Group->BlockSize);
+}
+
+//
+// Provides a buffer to the kernel. The caller must hold the group's lock and
+// advance the ring once all its buffers are added.
+//
 void
-CxPlatFreeBufferPool(
+CxPlatRecvBufferGroupAddUnderLock(
+    _In_ CXPLAT_RECV_BUFFER_GROUP* Group,
+    _In_ uint16_t BufferIndex,
+    _In_ int RingOffset
+    )
+{
+    io_uring_buf_ring_add(
+        Group->Ring,
+        (uint8_t*)CxPlatRecvBufferGroupGetBlock(Group, BufferIndex) + Group->BufferOffset,
+        Group->BlockSize - Group->BufferOffset,
+        BufferIndex,
+        io_uring_buf_ring_mask(Group->MaxSlabCount * Group->BuffersPerSlab),
+        RingOffset);
+}
+
+//
+// Adds a slab of buffers to the group, or puts the retiring slab back in
+// service. Returns FALSE if the group is already at its maximum size.
+//
+BOOLEAN
+CxPlatRecvBufferGroupGrow(
     _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
-    _In_ CXPLAT_IO_RING_BUF_GROUP BufferGroup,
-    _Inout_ CXPLAT_REGISTERED_BUFFER_POOL* Pool
+    _In_ CXPLAT_RECV_BUFFER_GROUP* Group
     )
 {
-    if (Pool->Buffers != NULL) {
-        io_uring_unregister_buf_ring(&DatapathPartition->EventQ->Ring, BufferGroup);
-        Pool->Buffers = NULL;
+    BOOLEAN Grown = FALSE;
+
+    CxPlatLockAcquire(&Group->Lock);
+
+    if (Group->ActiveSlabCount < Group->SlabCount) {
+        for (uint16_t i = 0; i < Group->ParkedCount; i++) {
+            CxPlatRecvBufferGroupAddUnderLock(Group, Group->ParkedBuffers[i], i);
+        }
+        io_uring_buf_ring_advance(Group->Ring, Group->ParkedCount);
+        Group->ParkedCount = 0;
+        Group->ActiveSlabCount = Group->SlabCount;
+        Grown = TRUE;
+
+    } else if (Group->SlabCount < Group->MaxSlabCount) {
+        const uint32_t SlabSize = Group->BuffersPerSlab * Group->BlockSize;
+        uint8_t* Slab;
+        if (posix_memalign((void**)&Slab, getpagesize(), SlabSize)) {
+            QuicTraceEvent(
+                AllocFailure,
+                "Allocation of '%s' failed. (%llu bytes)",
+                "CXPLAT_RECV_BUFFER_GROUP slab",
+                SlabSize);
+            goto Exit;
+        }
+
+        Group->Slabs[Group->SlabCount] = Slab;
+        for (uint16_t i = 0; i < Group->BuffersPerSlab; i++) {
+            const uint16_t BufferIndex = Group->SlabCount * Group->BuffersPerSlab + i;
+            DATAPATH_RX_IO_BLOCK* IoBlock = CxPlatRecvBufferGroupGetBlock(Group, BufferIndex);
+            IoBlock->BufferIndex = BufferIndex;
+            IoBlock->DatapathPartition = DatapathPartition;
+            IoBlock->BufferGroup = Group;
+            CxPlatRecvBufferGroupAddUnderLock(Group, BufferIndex, i);
+        }
+        io_uring_buf_ring_advance(Group->Ring, Group->BuffersPerSlab);
+        Group->SlabCount++;
+        Group->ActiveSlabCount++;
+        Grown = TRUE;
     }
-    if (Pool->Ring != NULL) {
-        free(Pool->Ring);
-        Pool->Ring = NULL;
+
+Exit:
+
+    CxPlatLockRelease(&Group->Lock);
+
+    return Grown;
+}
+
+//
+// Called on the issuer for every receive completion on the group. Every so
+// often, starts retiring the top slab if the group grew past its minimum size
+// and hasn't run out of buffers in a while.
+//
+void
+CxPlatRecvBufferGroupCheckShrink(
+    _In_ CXPLAT_RECV_BUFFER_GROUP* Group
+    )
+{
+    if (++Group->CompletionCount < RecvBufferGroupShrinkCheckInterval) {
+        return;
+    }
+    Group->CompletionCount = 0;
+
+    if (CxPlatTimeDiff64(Group->LastExhaustedTimeUs, CxPlatTimeUs64()) <
+            RecvBufferGroupShrinkDelayUs) {
+        return;
+    }
+
+    CxPlatLockAcquire(&Group->Lock);
+    if (Group->ActiveSlabCount == Group->SlabCount &&
+        Group->ActiveSlabCount > Group->MinSlabCount) {
+        Group->ActiveSlabCount--;
+    }
+    CxPlatLockRelease(&Group->Lock);
+}
+
+//
+// Gives a buffer back to the kernel once the app is done with it, or parks it
+// if its slab is being retired.
+//
+void
+CxPlatRecvBufferGroupReturn(
+    _In_ CXPLAT_RECV_BUFFER_GROUP* Group,
+    _In_ uint16_t BufferIndex
+    )
+{
+    CxPlatLockAcquire(&Group->Lock);
+    if (BufferIndex / Group->BuffersPerSlab < Group->ActiveSlabCount) {
+        CxPlatRecvBufferGroupAddUnderLock(Group, BufferIndex, 0);
+        io_uring_buf_ring_advance(Group->Ring, 1);
+    } else {
+        Group->ParkedBuffers[Group->ParkedCount++] = BufferIndex;
+        if (Group->ParkedCount == Group->BuffersPerSlab) {
+            //
+            // Every buffer of the retiring slab is out of the ring and back
+            // from the app, so the slab can be freed.
+            //
+            Group->SlabCount--;
+            free(Group->Slabs[Group->SlabCount]);
+            Group->Slabs[Group->SlabCount] = NULL;
+            Group->ParkedCount = 0;
+        }
     }
+    CxPlatLockRelease(&Group->Lock);
+}
+
+void
+CxPlatFreeRecvBufferGroup(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _Inout_ CXPLAT_RECV_BUFFER_GROUP* Group
+    )
+{
+    if (Group->Ring == NULL) {
+        return;
+    }
+    io_uring_unregister_buf_ring(&DatapathPartition->EventQ->Ring, Group->BufferGroup);
+    for (uint16_t i = 0; i < Group->SlabCount; i++) {
+        free(Group->Slabs[i]);
+        Group->Slabs[i] = NULL;
+    }
+    if (Group->ParkedBuffers != NULL) {
+        CXPLAT_FREE(Group->ParkedBuffers, QUIC_POOL_DATAPATH);
+        Group->ParkedBuffers = NULL;
+    }
+    free(Group->Ring);
+    Group->Ring = NULL;
+    CxPlatLockUninitialize(&Group->Lock);
 }
 
 QUIC_STATUS
-CxPlatCreateBufferPool(
+CxPlatCreateRecvBufferGroup(
     _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
-    _In_ uint32_t BufferSize,
-    _In_ uint32_t BufferCount,
     _In_ CXPLAT_IO_RING_BUF_GROUP BufferGroup,
-    _Out_ CXPLAT_REGISTERED_BUFFER_POOL* Pool
+    _In_ uint32_t BufferOffset,
+    _In_ uint32_t BufferSize,
+    _In_ uint16_t MinSlabCount,
+    _In_ uint16_t MaxSlabCount,
+    _Out_ CXPLAT_RECV_BUFFER_GROUP* Group
     )
 {
     int Result;
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    const uint32_t RingEntries = MaxSlabCount * RecvBuffersPerSlab;
+    const uint32_t RingSize = RingEntries * sizeof(struct io_uring_buf);
+
+    CXPLAT_DBG_ASSERT(MinSlabCount <= MaxSlabCount);
+    CXPLAT_DBG_ASSERT(MaxSlabCount <= CXPLAT_RECV_BUFFER_GROUP_MAX_SLABS);
+    CXPLAT_DBG_ASSERT((RingEntries & (RingEntries - 1)) == 0);
+
+    CxPlatZeroMemory(Group, sizeof(*Group));
+    CxPlatLockInitialize(&Group->Lock);
+    Group->BufferGroup = (uint16_t)BufferGroup;
+    Group->BuffersPerSlab = RecvBuffersPerSlab;
+    Group->MinSlabCount = MinSlabCount;
+    Group->MaxSlabCount = MaxSlabCount;
+    Group->BufferOffset = BufferOffset;
+    Group->BlockSize =
+        ALIGN_UP_BY(BufferOffset + BufferSize, CXPLAT_MEMORY_ALIGNMENT);
+
+    Group->ParkedBuffers =
+        CXPLAT_ALLOC_NONPAGED(
+            RecvBuffersPerSlab * sizeof(uint16_t), QUIC_POOL_DATAPATH);
+    if (Group->ParkedBuffers == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_RECV_BUFFER_GROUP parked buffers",
+            RecvBuffersPerSlab * sizeof(uint16_t));
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
 
-    CXPLAT_DBG_ASSERT(BufferSize % CXPLAT_MEMORY_ALIGNMENT == 0);
-
-    CxPlatZeroMemory(Pool, sizeof(*Pool));
-    CxPlatLockInitialize(&Pool->Lock);
-
-    Pool->TotalSize = BufferCount * (sizeof(struct io_uring_buf) + BufferSize);
-    if (posix_memalign(&Pool->Ring, getpagesize(), Pool->TotalSize)) {
+    if (posix_memalign(&Group->Ring, getpagesize(), RingSize)) {
+        Group->Ring = NULL;
         QuicTraceEvent(
             AllocFailure,
             "Allocation of '%s' failed. (%llu bytes)",
-            "CXPLAT_REGISTERED_BUFFER_POOL",
-            Pool->TotalSize);
+            "CXPLAT_RECV_BUFFER_GROUP ring",
+            RingSize);
         Status = QUIC_STATUS_OUT_OF_MEMORY;
         goto Exit;
     }
 
-    io_uring_buf_ring_init(Pool->Ring);
+    io_uring_buf_ring_init(Group->Ring);
 
     struct io_uring_buf_reg reg = (struct io_uring_buf_reg) {
-        .ring_addr = (uint64_t)Pool->Ring,
-        .ring_entries = BufferCount,
+        .ring_addr = (uint64_t)Group->Ring,
+        .ring_entries = RingEntries,
         .bgid = (uint16_t)BufferGroup
     };
 
     Result = io_uring_register_buf_ring(&DatapathPartition->EventQ->Ring, &reg, 0);
     if (Result) {
-        Status = errno;
+        Status = -Result;
         QuicTraceEvent(
             DatapathErrorStatus,
             "[data][%p] ERROR, %u, %s.",
             DatapathPartition,
             Status,
             "io_uring_register_buf_ring failed");
+        free(Group->Ring);
+        Group->Ring = NULL;
+        goto Exit;
+    }
+
+    for (uint16_t i = 0; i < MinSlabCount; i++) {
+        if (!CxPlatRecvBufferGroupGrow(DatapathPartition, Group)) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
             goto Exit;
+        }
+    }
+
+Exit:
+
+    if (QUIC_FAILED(Status)) {
+        if (Group->Ring != NULL) {
+            CxPlatFreeRecvBufferGroup(DatapathPartition, Group);
+        } else {
+            if (Group->ParkedBuffers != NULL) {
+                CXPLAT_FREE(Group->ParkedBuffers, QUIC_POOL_DATAPATH);
+                Group->ParkedBuffers = NULL;
+            }
+            CxPlatLockUninitialize(&Group->Lock);
+        }
+    }
+
+    return Status;
+}
+
+void
+CxPlatFreeSendBufferPool(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _Inout_ CXPLAT_REGISTERED_BUFFER_POOL* Pool
+    )
+{
+    DatapathPartition->SendFixedBuffersEnabled = FALSE;
+    if (DatapathPartition->SendFixedBuffersRegistered) {
+        io_uring_unregister_buffers(&DatapathPartition->EventQ->Ring);
+        DatapathPartition->SendFixedBuffersRegistered = FALSE;
+    }
+    if (Pool->Buffers != NULL) {
+        CxPlatLockUninitialize(&Pool->Lock);
+        free(Pool->Buffers);
+        Pool->Buffers = NULL;
+    }
+}
+
+QUIC_STATUS
+CxPlatCreateSendBufferPool(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _In_ uint32_t BufferSize,
+    _In_ uint32_t BufferCount,
+    _Out_ CXPLAT_REGISTERED_BUFFER_POOL* Pool
+    )
+{
+    int Result;
+
+    CxPlatZeroMemory(Pool, sizeof(*Pool));
+    CxPlatListInitializeHead(&Pool->FreeList);
+
+    BufferSize = ALIGN_UP_BY(BufferSize, CXPLAT_MEMORY_ALIGNMENT);
+    Pool->TotalSize = BufferCount * BufferSize;
+    if (posix_memalign((void**)&Pool->Buffers, getpagesize(), Pool->TotalSize)) {
+        Pool->Buffers = NULL;
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "CXPLAT_REGISTERED_BUFFER_POOL",
+            Pool->TotalSize);
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    CxPlatLockInitialize(&Pool->Lock);
+    Pool->BufferSize = BufferSize;
+
+    for (uint32_t i = 0; i < BufferCount; i++) {
+        CXPLAT_SEND_DATA* SendData =
+            (CXPLAT_SEND_DATA*)CxPlatGetBufferPoolBuffer(Pool, i);
+        CxPlatListInsertTail(&Pool->FreeList, &SendData->TxEntry);
     }
 
     //
-    // Review: we may also want to io_uring_register_buffers for
-    // io_uring_prep_send_zc_fixed.
+    // Register the whole pool as a single fixed buffer, so zero-copy sends
+    // don't need to pin and unpin the user pages for every send. Failing to
+    // register (e.g. due to RLIMIT_MEMLOCK) isn't fatal; zero-copy sends just
+    // won't reference the fixed buffer.
     //
+    struct iovec Iov = { .iov_base = Pool->Buffers, .iov_len = Pool->TotalSize };
+    Result = io_uring_register_buffers(&DatapathPartition->EventQ->Ring, &Iov, 1);
+    if (Result < 0) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            DatapathPartition,
+            -Result,
+            "io_uring_register_buffers failed");
+    } else {
+        DatapathPartition->SendFixedBuffersRegistered = TRUE;
+        DatapathPartition->SendFixedBuffersEnabled = TRUE;
+    }
 
-    Pool->Buffers = (uint8_t*)Pool->Ring + sizeof(struct io_uring_buf) * BufferCount;
-    Pool->BufferSize = BufferSize;
+    return QUIC_STATUS_SUCCESS;
+}
 
-Exit:
+void
+CxPlatFreeFixedFileTable(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    if (DatapathPartition->FixedFileFreeSlots != NULL) {
+        io_uring_unregister_files(&DatapathPartition->EventQ->Ring);
+        CXPLAT_FREE(DatapathPartition->FixedFileFreeSlots, QUIC_POOL_DATAPATH);
+        DatapathPartition->FixedFileFreeSlots = NULL;
+        CxPlatLockUninitialize(&DatapathPartition->FixedFileLock);
+    }
+}
 
-    if (QUIC_FAILED(Status)) {
-        CxPlatFreeBufferPool(DatapathPartition, BufferGroup, Pool);
+void
+CxPlatCreateFixedFileTable(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    int Result;
+    struct rlimit FileLimit;
+    uint32_t SlotCount = FixedFileMaxCount;
+
+    //
+    // The kernel limits the table size to RLIMIT_NOFILE.
+    //
+    if (getrlimit(RLIMIT_NOFILE, &FileLimit) == 0 && FileLimit.rlim_cur < SlotCount) {
+        SlotCount = (uint32_t)FileLimit.rlim_cur;
+    }
+
+    uint32_t* FreeSlots =
+        CXPLAT_ALLOC_NONPAGED(SlotCount * sizeof(uint32_t), QUIC_POOL_DATAPATH);
+    if (FreeSlots == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "FixedFileFreeSlots",
+            SlotCount * sizeof(uint32_t));
+        return;
     }
 
+    //
+    // Failing to register the table isn't fatal (e.g. the ring already has
+    // one); sockets just keep using their raw FDs.
+    //
+    Result = io_uring_register_files_sparse(&DatapathPartition->EventQ->Ring, SlotCount);
+    if (Result < 0) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            DatapathPartition,
+            -Result,
+            "io_uring_register_files_sparse failed");
+        CXPLAT_FREE(FreeSlots, QUIC_POOL_DATAPATH);
+        return;
+    }
+
+    for (uint32_t i = 0; i < SlotCount; i++) {
+        FreeSlots[i] = SlotCount - 1 - i;
+    }
+    CxPlatLockInitialize(&DatapathPartition->FixedFileLock);
+    DatapathPartition->FixedFileFreeCount = SlotCount;
+    DatapathPartition->FixedFileFreeSlots = FreeSlots;
+}
+
+//
+// Registers the partition's buffers and files with its ring. Must run on the
+// ring's issuer.
+//
+_Function_class_(CXPLAT_EVENTQ_ISSUER_CALLBACK)
+QUIC_STATUS
+CxPlatProcessorContextRegisterRing(
+    _In_ void* Context // CXPLAT_DATAPATH_PARTITION
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = (CXPLAT_DATAPATH_PARTITION*)Context;
+    CXPLAT_DATAPATH* Datapath = DatapathPartition->Datapath;
+    QUIC_STATUS Status;
+
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
+        Status =
+            CxPlatCreateRecvBufferGroup(
+                DatapathPartition, CxPlatIoRingBufGroupRecv,
+                Datapath->RecvBlockBufferOffset,
+                Datapath->RecvBlockSize - Datapath->RecvBlockBufferOffset,
+                RecvLargeBufferGroupMinSlabs, RecvLargeBufferGroupMaxSlabs,
+                &DatapathPartition->RecvBufferGroup);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+
+        Status =
+            CxPlatCreateRecvBufferGroup(
+                DatapathPartition, CxPlatIoRingBufGroupRecvSmall,
+                sizeof(DATAPATH_RX_IO_BLOCK) + Datapath->RecvBlockStride,
+                CXPLAT_SMALL_IO_BUFFER_SIZE,
+                RecvSmallBufferGroupMinSlabs, RecvSmallBufferGroupMaxSlabs,
+                &DatapathPartition->RecvSmallBufferGroup);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+    } else {
+        Status =
+            CxPlatCreateRecvBufferGroup(
+                DatapathPartition, CxPlatIoRingBufGroupRecv,
+                Datapath->RecvBlockBufferOffset,
+                Datapath->RecvBlockSize - Datapath->RecvBlockBufferOffset,
+                RecvSmallBufferGroupMinSlabs, RecvSmallBufferGroupMaxSlabs,
+                &DatapathPartition->RecvBufferGroup);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+    }
+
+    CxPlatCreateFixedFileTable(DatapathPartition);
+
+    if (Datapath->ZeroCopySendEnabled) {
+        Status =
+            CxPlatCreateSendBufferPool(
+                DatapathPartition, Datapath->SendDataSize, ZeroCopySendBufCount,
+                &DatapathPartition->SendRegisteredBufferPool);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+    }
+
+Exit:
+
     return Status;
 }
 
@@ -350,8 +820,6 @@ CxPlatProcessorContextInitialize(
     _Out_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
     )
 {
-    QUIC_STATUS Status;
-
     CXPLAT_DBG_ASSERT(Datapath != NULL);
     DatapathPartition->Datapath = Datapath;
     DatapathPartition->PartitionIndex = PartitionIndex;
@@ -361,32 +829,9 @@ CxPlatProcessorContextInitialize(
     CxPlatPoolInitialize(
         TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
 
-    Status =
-        CxPlatCreateBufferPool(
-            DatapathPartition, Datapath->RecvBlockSize, RecvBufCount,
-            CxPlatIoRingBufGroupRecv, &DatapathPartition->RecvRegisteredBufferPool);
-    if (QUIC_FAILED(Status)) {
-        goto Exit;
-    }
-
-    for (uint32_t i = 0; i < RecvBufCount; i++) {
-        DATAPATH_RX_IO_BLOCK* IoBlock =
-            (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
-                &DatapathPartition->RecvRegisteredBufferPool, i);
-        IoBlock->BufferIndex = i;
-        IoBlock->DatapathPartition = DatapathPartition;
-        io_uring_buf_ring_add(
-            DatapathPartition->RecvRegisteredBufferPool.Ring,
-            (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset,
-            CxPlatGetBufferPoolBufferSize(&DatapathPartition->RecvRegisteredBufferPool) -
-                DatapathPartition->Datapath->RecvBlockBufferOffset,
-            i, io_uring_buf_ring_mask(RecvBufCount), i);
-    }
-    io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, RecvBufCount);
-
-Exit:
-
-    return Status;
+    return
+        CxPlatEventQRunOnIssuer(
+            DatapathPartition->EventQ, CxPlatProcessorContextRegisterRing, DatapathPartition);
 }
 
 QUIC_STATUS
@@ -400,7 +845,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -461,6 +905,37 @@ DataPathInitialize(
         Datapath->SendIoVecCount = CXPLAT_MAX_IO_BATCH_SIZE;
     }
 
+    if (InitConfig->EnableZeroCopySend) {
+        //
+        // Zero-copy sendmsg is only available in newer kernels, so probe for
+        // it instead of failing every send later. The probe uses its own ring,
+        // as single issuer worker rings reject probes from this thread.
+        //
+        struct io_uring_probe* Probe = io_uring_get_probe();
+        if (Probe != NULL) {
+            Datapath->ZeroCopySendEnabled =
+                !!io_uring_opcode_supported(Probe, IORING_OP_SENDMSG_ZC);
+            io_uring_free_probe(Probe);
+        }
+        if (!Datapath->ZeroCopySendEnabled) {
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "Zero-copy send not supported by io_uring");
+        }
+    }
+
+    if (InitConfig->EnablePacingOffload) {
+#ifdef SO_TXTIME
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+#else
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "Pacing offload not supported");
+#endif
+    }
+
     Datapath->RecvBlockStride =
         ALIGN_UP_BY(sizeof(DATAPATH_RX_PACKET) + ClientRecvDataLength, CXPLAT_MEMORY_ALIGNMENT);
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
@@ -514,6 +989,25 @@ CxPlatDataPathRelease(
     }
 }
 
+//
+// Unregisters the partition's buffers and files from its ring. Must run on the
+// ring's issuer.
+//
+_Function_class_(CXPLAT_EVENTQ_ISSUER_CALLBACK)
+QUIC_STATUS
+CxPlatProcessorContextUnregisterRing(
+    _In_ void* Context // CXPLAT_DATAPATH_PARTITION
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = (CXPLAT_DATAPATH_PARTITION*)Context;
+    CxPlatFreeRecvBufferGroup(DatapathPartition, &DatapathPartition->RecvBufferGroup);
+    CxPlatFreeRecvBufferGroup(DatapathPartition, &DatapathPartition->RecvSmallBufferGroup);
+    CxPlatFreeSendBufferPool(
+        DatapathPartition, &DatapathPartition->SendRegisteredBufferPool);
+    CxPlatFreeFixedFileTable(DatapathPartition);
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 CxPlatProcessorContextRelease(
@@ -525,9 +1019,8 @@ CxPlatProcessorContextRelease(
         CXPLAT_DBG_ASSERT(!DatapathPartition->Uninitialized);
         DatapathPartition->Uninitialized = TRUE;
 #endif
-        CxPlatFreeBufferPool(
-            DatapathPartition, CxPlatIoRingBufGroupRecv,
-            &DatapathPartition->RecvRegisteredBufferPool);
+        (void)CxPlatEventQRunOnIssuer(
+            DatapathPartition->EventQ, CxPlatProcessorContextUnregisterRing, DatapathPartition);
         CxPlatPoolUninitialize(&DatapathPartition->SendBlockPool);
         CxPlatDataPathRelease(DatapathPartition->Datapath);
     }
@@ -558,11 +1051,29 @@ CxPlatSocketContextSqeInitialize(
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     CXPLAT_SOCKET* Binding = SocketContext->Binding;
     BOOLEAN ShutdownSqeInitialized = FALSE;
+    BOOLEAN IoSqeInitialized = FALSE;
 
     if (!CxPlatSqeInitialize(
             SocketContext->DatapathPartition->EventQ,
-            CxPlatSocketContextUninitializeEventComplete,
-            &SocketContext->ShutdownSqe)) {
+            CxPlatSocketContextUninitializeEventComplete,
+            &SocketContext->ShutdownSqe)) {
+        Status = errno;
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            Binding,
+            Status,
+            "CxPlatSqeInitialize failed");
+        goto Exit;
+    }
+    ShutdownSqeInitialized = TRUE;
+    CxPlatSocketIoStart(SocketContext, IoTagShutdown);
+
+    if (!CxPlatBatchSqeInitialize(
+            SocketContext->DatapathPartition->EventQ,
+            CxPlatSocketContextIoEventComplete,
+            &SocketContext->IoSqe.Sqe)) {
+        SocketContext->IoSqe.Context = (void*)DatapathContextRecv; // NOLINT performance-no-int-to-ptr
         Status = errno;
         QuicTraceEvent(
             DatapathErrorStatus,
@@ -572,14 +1083,12 @@ CxPlatSocketContextSqeInitialize(
             "CxPlatSqeInitialize failed");
         goto Exit;
     }
-    ShutdownSqeInitialized = TRUE;
-    CxPlatSocketIoStart(SocketContext, IoTagShutdown);
+    IoSqeInitialized = TRUE;
 
     if (!CxPlatBatchSqeInitialize(
             SocketContext->DatapathPartition->EventQ,
             CxPlatSocketContextIoEventComplete,
-            &SocketContext->IoSqe.Sqe)) {
-        SocketContext->IoSqe.Context = (void*)DatapathContextRecv; // NOLINT performance-no-int-to-ptr
+            &SocketContext->RecvCancelSqe.Sqe)) {
         Status = errno;
         QuicTraceEvent(
             DatapathErrorStatus,
@@ -589,12 +1098,16 @@ CxPlatSocketContextSqeInitialize(
             "CxPlatSqeInitialize failed");
         goto Exit;
     }
+    SocketContext->RecvCancelSqe.Context = (void*)DatapathContextRecvCancel; // NOLINT performance-no-int-to-ptr
 
     SocketContext->SqeInitialized = TRUE;
     return QUIC_STATUS_SUCCESS;
 
 Exit:
 
+    if (IoSqeInitialized) {
+        CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->IoSqe.Sqe);
+    }
     if (ShutdownSqeInitialized) {
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->ShutdownSqe);
     }
@@ -627,6 +1140,16 @@ CxPlatSocketContextInitialize(
     SocketContext->DatapathPartition = &Datapath->Partitions[PartitionIndex];
     CxPlatRefIncrement(&SocketContext->DatapathPartition->RefCount);
 
+    //
+    // With receive coalescing, sockets start out on the small buffer group
+    // and without GRO until they see a burst of traffic.
+    //
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
+        SocketContext->RecvBufferGroup = &SocketContext->DatapathPartition->RecvSmallBufferGroup;
+    } else {
+        SocketContext->RecvBufferGroup = &SocketContext->DatapathPartition->RecvBufferGroup;
+    }
+
     Status = CxPlatSocketContextSqeInitialize(SocketContext);
     if (QUIC_FAILED(Status) || SocketType == CXPLAT_SOCKET_TCP_SERVER) {
         goto Exit;
@@ -850,29 +1373,6 @@ CxPlatSocketContextInitialize(
             goto Exit;
         }
 
-    #ifdef UDP_GRO
-        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
-            Option = TRUE;
-            Result =
-                setsockopt(
-                    SocketContext->SocketFd,
-                    SOL_UDP,
-                    UDP_GRO,
-                    (const void*)&Option,
-                    sizeof(Option));
-            if (Result == SOCKET_ERROR) {
-                Status = errno;
-                QuicTraceEvent(
-                    DatapathErrorStatus,
-                    "[data][%p] ERROR, %u, %s.",
-                    Binding,
-                    Status,
-                    "setsockopt(UDP_GRO) failed");
-                goto Exit;
-            }
-        }
-    #endif
-
         //
         // The socket is shared by multiple QUIC endpoints, so increase the receive
         // buffer size.
@@ -896,6 +1396,9 @@ CxPlatSocketContextInitialize(
             goto Exit;
         }
 
+        CxPlatSocketConfigureBusyPoll(SocketContext);
+        CxPlatSocketConfigureTxTime(SocketContext);
+
         //
         // Only set SO_REUSEPORT on a server socket, otherwise the client could be
         // assigned a server port (unless it's forcing sharing).
@@ -1083,6 +1586,78 @@ CxPlatSocketRelease(
     }
 }
 
+_Function_class_(CXPLAT_EVENTQ_ISSUER_CALLBACK)
+QUIC_STATUS
+CxPlatSocketContextRegisterFixedFile(
+    _In_ void* Context // CXPLAT_SOCKET_CONTEXT
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = (CXPLAT_SOCKET_CONTEXT*)Context;
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    uint32_t Slot;
+    int Result;
+
+    CXPLAT_DBG_ASSERT(SocketContext->FixedFileIndex < 0);
+
+    if (DatapathPartition->FixedFileFreeSlots == NULL) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+    if (DatapathPartition->FixedFileFreeCount == 0) {
+        CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+        return QUIC_STATUS_SUCCESS;
+    }
+    Slot = DatapathPartition->FixedFileFreeSlots[--DatapathPartition->FixedFileFreeCount];
+    CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+
+    Result =
+        io_uring_register_files_update(
+            &DatapathPartition->EventQ->Ring, Slot, &SocketContext->SocketFd, 1);
+    if (Result != 1) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            Result < 0 ? -Result : 0,
+            "io_uring_register_files_update failed");
+        CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+        DatapathPartition->FixedFileFreeSlots[DatapathPartition->FixedFileFreeCount++] = Slot;
+        CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    SocketContext->FixedFileIndex = (int)Slot;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_Function_class_(CXPLAT_EVENTQ_ISSUER_CALLBACK)
+QUIC_STATUS
+CxPlatSocketContextUnregisterFixedFile(
+    _In_ void* Context // CXPLAT_SOCKET_CONTEXT
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext = (CXPLAT_SOCKET_CONTEXT*)Context;
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    const int InvalidFd = -1;
+
+    //
+    // Clear the slot so the table no longer holds a reference on the socket,
+    // then recycle it for the next socket on this partition.
+    //
+    (void)io_uring_register_files_update(
+        &DatapathPartition->EventQ->Ring, (unsigned)SocketContext->FixedFileIndex,
+        &InvalidFd, 1);
+
+    CxPlatLockAcquire(&DatapathPartition->FixedFileLock);
+    DatapathPartition->FixedFileFreeSlots[DatapathPartition->FixedFileFreeCount++] =
+        (uint32_t)SocketContext->FixedFileIndex;
+    CxPlatLockRelease(&DatapathPartition->FixedFileLock);
+
+    SocketContext->FixedFileIndex = -1;
+    return QUIC_STATUS_SUCCESS;
+}
+
 void
 CxPlatSocketContextUninitializeComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -1103,6 +1678,13 @@ CxPlatSocketContextUninitializeComplete(
 
     CXPLAT_DBG_ASSERT(SocketContext->AcceptSocket == NULL);
 
+    if (SocketContext->FixedFileIndex >= 0) {
+        (void)CxPlatEventQRunOnIssuer(
+            SocketContext->DatapathPartition->EventQ,
+            CxPlatSocketContextUnregisterFixedFile,
+            SocketContext);
+    }
+
     if (SocketContext->SocketFd != INVALID_SOCKET) {
         close(SocketContext->SocketFd);
     }
@@ -1110,6 +1692,7 @@ CxPlatSocketContextUninitializeComplete(
     if (SocketContext->SqeInitialized) {
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->ShutdownSqe);
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->IoSqe.Sqe);
+        CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->RecvCancelSqe.Sqe);
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->FlushTxSqe);
     }
 
@@ -1189,6 +1772,11 @@ CxPlatSocketContextUninitialize(
         CxPlatLockAcquire(&DatapathPartition->EventQ->Lock);
         Sqe = CxPlatSocketAllocSqe(SocketContext);
         CXPLAT_FRE_ASSERT(Sqe != NULL);
+        //
+        // Cancel by user data. This doesn't look up the socket's file, so it
+        // doesn't need the fixed file slot, which stays registered until all
+        // IO has completed.
+        //
         io_uring_prep_cancel(Sqe, &SocketContext->IoSqe.Sqe, IORING_ASYNC_CANCEL_ALL);
         io_uring_sqe_set_data(Sqe, &SocketContext->ShutdownSqe);
         CxPlatEventQSubmit(DatapathPartition->EventQ);
@@ -1197,6 +1785,46 @@ CxPlatSocketContextUninitialize(
     }
 }
 
+//
+// Moves the socket to the large receive buffer group and enables GRO. Only
+// safe while no receive is outstanding: datagrams already queued on the
+// socket aren't coalesced, so they fit in the large buffers, but coalesced
+// ones would be truncated by the small buffers.
+//
+void
+CxPlatSocketContextPromoteRecv(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+
+    if (SocketContext->RecvBufferGroup != &DatapathPartition->RecvSmallBufferGroup) {
+        return;
+    }
+
+#ifdef UDP_GRO
+    int Option = TRUE;
+    int Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            SOL_UDP,
+            UDP_GRO,
+            (const void*)&Option,
+            sizeof(Option));
+    if (Result == SOCKET_ERROR) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "setsockopt(UDP_GRO) failed");
+        return;
+    }
+
+    SocketContext->RecvBufferGroup = &DatapathPartition->RecvBufferGroup;
+#endif
+}
+
 void
 CxPlatSocketContextStartMultiRecvUnderLock(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -1207,6 +1835,11 @@ CxPlatSocketContextStartMultiRecvUnderLock(
     CXPLAT_DBG_ASSERT(!SocketContext->LockedFlags.MultiRecvStarted);
     CXPLAT_DBG_ASSERT(!SocketContext->LockedFlags.Shutdown);
 
+    if (SocketContext->LockedFlags.RecvPromotePending) {
+        SocketContext->LockedFlags.RecvPromotePending = FALSE;
+        CxPlatSocketContextPromoteRecv(SocketContext);
+    }
+
     struct io_uring_sqe* Sqe = CxPlatSocketAllocSqe(SocketContext);
     if (Sqe == NULL) {
         QuicTraceEvent(
@@ -1227,7 +1860,8 @@ CxPlatSocketContextStartMultiRecvUnderLock(
     io_uring_prep_recvmsg_multishot(
         Sqe, SocketContext->SocketFd, (struct msghdr*)&CxPlatRecvMsgHdr, MSG_TRUNC);
     Sqe->flags |= IOSQE_BUFFER_SELECT;
-    Sqe->buf_group = CxPlatIoRingBufGroupRecv;
+    Sqe->buf_group = SocketContext->RecvBufferGroup->BufferGroup;
+    CxPlatSocketContextSetSqeFixedFile(SocketContext, Sqe);
     io_uring_sqe_set_data(Sqe, &SocketContext->IoSqe.Sqe);
     CxPlatEventQSubmit(EventQ);
 
@@ -1306,6 +1940,7 @@ SocketCreateUdp(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
+        Binding->SocketContexts[i].FixedFileIndex = -1;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
@@ -1348,9 +1983,10 @@ SocketCreateUdp(
     *NewBinding = Binding;
 
     for (uint32_t i = 0; i < SocketCount; i++) {
-        //
-        // Review: the sockets can be registered with io_uring for better perf.
-        //
+        (void)CxPlatEventQRunOnIssuer(
+            Binding->SocketContexts[i].DatapathPartition->EventQ,
+            CxPlatSocketContextRegisterFixedFile,
+            &Binding->SocketContexts[i]);
         Binding->SocketContexts[i].IoStarted = TRUE;
         CxPlatSocketContextStartMultiRecv(&Binding->SocketContexts[i]);
     }
@@ -1490,11 +2126,104 @@ CxPlatSocketHandleErrors(
     }
 }
 
+void
+CxPlatSocketContextIndicateRecv(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ CXPLAT_RECV_DATA* DatagramChain
+    )
+{
+    if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
+        if (!SocketContext->Binding->PcpBinding) {
+            CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath->UdpHandlers.Receive);
+            SocketContext->Binding->Datapath->UdpHandlers.Receive(
+                SocketContext->Binding,
+                SocketContext->Binding->ClientContext,
+                DatagramChain);
+        } else{
+            CxPlatPcpRecvCallback(
+                SocketContext->Binding,
+                SocketContext->Binding->ClientContext,
+                DatagramChain);
+        }
+
+        CxPlatRundownRelease(&SocketContext->UpcallRundown);
+    } else {
+        RecvDataReturn(DatagramChain);
+    }
+}
+
+//
+// Indicates every socket's receives in the batch.
+//
+void
+CxPlatRecvBatchFlush(
+    _Inout_ CXPLAT_RECV_BATCH* RecvBatch
+    )
+{
+    while (RecvBatch->SocketCount > 0) {
+        const uint32_t i = --RecvBatch->SocketCount;
+        CxPlatSocketContextIndicateRecv(
+            RecvBatch->Sockets[i].SocketContext, RecvBatch->Sockets[i].Head);
+    }
+}
+
+//
+// Indicates a socket's receives in the batch ahead of the rest. This must
+// happen before processing any completion that could release the socket's
+// last IO reference, which only sockets that are shutting down have.
+//
+void
+CxPlatRecvBatchFlushSocket(
+    _Inout_ CXPLAT_RECV_BATCH* RecvBatch,
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    for (uint32_t i = 0; i < RecvBatch->SocketCount; i++) {
+        if (RecvBatch->Sockets[i].SocketContext == SocketContext) {
+            CXPLAT_RECV_DATA* DatagramChain = RecvBatch->Sockets[i].Head;
+            RecvBatch->Sockets[i] = RecvBatch->Sockets[--RecvBatch->SocketCount];
+            CxPlatSocketContextIndicateRecv(SocketContext, DatagramChain);
+            return;
+        }
+    }
+}
+
+void
+CxPlatRecvBatchAdd(
+    _Inout_ CXPLAT_RECV_BATCH* RecvBatch,
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ CXPLAT_RECV_DATA* DatagramHead,
+    _In_ CXPLAT_RECV_DATA** DatagramTail
+    )
+{
+    //
+    // Completions for the same socket are usually adjacent, so start the
+    // search from the most recently added socket.
+    //
+    for (uint32_t i = RecvBatch->SocketCount; i > 0; i--) {
+        if (RecvBatch->Sockets[i - 1].SocketContext == SocketContext) {
+            *RecvBatch->Sockets[i - 1].Tail = DatagramHead;
+            RecvBatch->Sockets[i - 1].Tail = DatagramTail;
+            return;
+        }
+    }
+
+    if (RecvBatch->SocketCount == CXPLAT_RECV_BATCH_MAX_SOCKETS) {
+        CxPlatRecvBatchFlush(RecvBatch);
+    }
+
+    const uint32_t i = RecvBatch->SocketCount++;
+    RecvBatch->Sockets[i].SocketContext = SocketContext;
+    RecvBatch->Sockets[i].Head = DatagramHead;
+    RecvBatch->Sockets[i].Tail = DatagramTail;
+}
+
 void
 CxPlatSocketContextRecvComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
     _Inout_ DATAPATH_RX_IO_BLOCK** IoBlocks,
-    _In_ struct msghdr* RecvMsgHdr
+    _In_ struct msghdr* RecvMsgHdr,
+    _Inout_ CXPLAT_RECV_BATCH* RecvBatch
     )
 {
     CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath == SocketContext->DatapathPartition->Datapath);
@@ -1633,28 +2362,74 @@ CxPlatSocketContextRecvComplete(
         return;
     }
 
-    if (CxPlatRundownAcquire(&SocketContext->UpcallRundown)) {
-        if (!SocketContext->Binding->PcpBinding) {
-            CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath->UdpHandlers.Receive);
-            SocketContext->Binding->Datapath->UdpHandlers.Receive(
-                SocketContext->Binding,
-                SocketContext->Binding->ClientContext,
-                DatagramHead);
-        } else{
-            CxPlatPcpRecvCallback(
-                SocketContext->Binding,
-                SocketContext->Binding->ClientContext,
-                DatagramHead);
-        }
+    CxPlatRecvBatchAdd(RecvBatch, SocketContext, DatagramHead, DatagramTail);
+}
 
-        CxPlatRundownRelease(&SocketContext->UpcallRundown);
+void
+CxPlatSocketContextRecvBuffersExhausted(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    CXPLAT_RECV_BUFFER_GROUP* Group = SocketContext->RecvBufferGroup;
+
+    ++DatapathPartition->EventQ->RecvNoBufferCount;
+    Group->LastExhaustedTimeUs = CxPlatTimeUs64();
+    (void)CxPlatRecvBufferGroupGrow(DatapathPartition, Group);
+
+    if (Group == &DatapathPartition->RecvSmallBufferGroup) {
+        SocketContext->LockedFlags.RecvPromotePending = TRUE;
+    }
+}
+
+//
+// Sockets on the small buffer group move to the large one once they receive a
+// burst of datagrams. The multishot receive can't change buffer groups, so
+// cancel it and let the re-arm pick up the new group.
+//
+void
+CxPlatSocketContextCheckRecvBurst(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    if (CxPlatTimeDiff64(SocketContext->RecvBurstStartUs, TimeNow) > RecvBurstWindowUs) {
+        SocketContext->RecvBurstStartUs = TimeNow;
+        SocketContext->RecvBurstCount = 0;
+    }
+
+    if (++SocketContext->RecvBurstCount < RecvBurstThreshold ||
+        SocketContext->LockedFlags.RecvPromotePending ||
+        SocketContext->LockedFlags.Shutdown) {
+        return;
+    }
+
+    SocketContext->LockedFlags.RecvPromotePending = TRUE;
+
+    struct io_uring_sqe* Sqe = CxPlatSocketAllocSqe(SocketContext);
+    if (Sqe == NULL) {
+        //
+        // The socket still moves over the next time the receive is re-armed.
+        //
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "CxPlatSocketAllocSqe failed");
+        return;
     }
+
+    io_uring_prep_cancel(Sqe, &SocketContext->IoSqe.Sqe, 0);
+    io_uring_sqe_set_data(Sqe, &SocketContext->RecvCancelSqe.Sqe);
+    CxPlatSocketIoStart(SocketContext, IoTagRecv);
 }
 
 void
 CxPlatSocketReceiveComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
-    _In_ CXPLAT_CQE Cqe
+    _In_ CXPLAT_CQE Cqe,
+    _Inout_ CXPLAT_RECV_BATCH* RecvBatch
     )
 {
     CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
@@ -1667,7 +2442,17 @@ CxPlatSocketReceiveComplete(
 
     if (Cqe->res == -ENOBUFS) {
         //
-        // Ignore packet loss indications for now.
+        // The buffer ring ran dry, which ends the multishot receive. Grow the
+        // group, and move the socket off the small buffers, before the receive
+        // is re-armed below.
+        //
+        CxPlatSocketContextRecvBuffersExhausted(SocketContext);
+        goto Exit;
+    }
+
+    if (Cqe->res == -ECANCELED) {
+        //
+        // Canceled by shutdown or to move the socket to another buffer group.
         //
         goto Exit;
     }
@@ -1682,11 +2467,10 @@ CxPlatSocketReceiveComplete(
 
     CXPLAT_DBG_ASSERT(Cqe->flags & IORING_CQE_F_BUFFER);
 
-    BufferIndex = Cqe->flags >> 16;
-    IoBlock =
-        (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
-            &DatapathPartition->RecvRegisteredBufferPool, BufferIndex);
-    IoPayload = (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
+    BufferIndex = Cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+    IoBlock = CxPlatRecvBufferGroupGetBlock(SocketContext->RecvBufferGroup, BufferIndex);
+    CXPLAT_DBG_ASSERT(IoBlock->BufferGroup == SocketContext->RecvBufferGroup);
+    IoPayload = (uint8_t*)IoBlock + SocketContext->RecvBufferGroup->BufferOffset;
     RecvMsgOut = io_uring_recvmsg_validate(IoPayload, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
     CXPLAT_FRE_ASSERT(RecvMsgOut != NULL); // Review: can this legally fail?
 
@@ -1710,7 +2494,12 @@ CxPlatSocketReceiveComplete(
     RecvIov.iov_len =
         io_uring_recvmsg_payload_length(RecvMsgOut, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
 
-    CxPlatSocketContextRecvComplete(SocketContext, &IoBlock, RecvMsgHdrs);
+    CxPlatRecvBufferGroupCheckShrink(SocketContext->RecvBufferGroup);
+    if (SocketContext->RecvBufferGroup == &DatapathPartition->RecvSmallBufferGroup) {
+        CxPlatSocketContextCheckRecvBurst(SocketContext);
+    }
+
+    CxPlatSocketContextRecvComplete(SocketContext, &IoBlock, RecvMsgHdrs, RecvBatch);
 
 Exit:
 
@@ -1719,6 +2508,7 @@ Exit:
         CXPLAT_DBG_ONLY(SocketContext->LockedFlags.MultiRecvStarted = FALSE);
 
         if (!SocketContext->LockedFlags.Shutdown) {
+            ++DatapathPartition->EventQ->RecvRearmCount;
             CxPlatSocketContextStartMultiRecvUnderLock(SocketContext);
         }
 
@@ -1737,20 +2527,11 @@ RecvDataReturn(
         DATAPATH_RX_IO_BLOCK* IoBlock =
             CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data)->IoBlock;
         if (InterlockedDecrement(&IoBlock->RefCount) == 0) {
-            CXPLAT_DATAPATH_PARTITION* DatapathPartition = IoBlock->DatapathPartition;
             //
             // Review: this is amenable to batching, but the added complexity
             // may not be worth it.
             //
-            CxPlatLockAcquire(&DatapathPartition->RecvRegisteredBufferPool.Lock);
-            io_uring_buf_ring_add(
-                DatapathPartition->RecvRegisteredBufferPool.Ring,
-                (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset,
-                CxPlatGetBufferPoolBufferSize(&DatapathPartition->RecvRegisteredBufferPool) -
-                    DatapathPartition->Datapath->RecvBlockBufferOffset,
-                IoBlock->BufferIndex, io_uring_buf_ring_mask(RecvBufCount), 0);
-            io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, 1);
-            CxPlatLockRelease(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+            CxPlatRecvBufferGroupReturn(IoBlock->BufferGroup, (uint16_t)IoBlock->BufferIndex);
         }
     }
 }
@@ -1789,7 +2570,26 @@ SendDataAlloc(
     CXPLAT_SOCKET_CONTEXT* SocketContext = (CXPLAT_SOCKET_CONTEXT*)Config->Route->Queue;
     CXPLAT_DBG_ASSERT(SocketContext->Binding == Socket);
     CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath == SocketContext->DatapathPartition->Datapath);
-    CXPLAT_SEND_DATA* SendData = CxPlatPoolAlloc(&SocketContext->DatapathPartition->SendBlockPool);
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    CXPLAT_SEND_DATA* SendData = NULL;
+    BOOLEAN RegisteredBuffer = FALSE;
+
+    if (Socket->Datapath->ZeroCopySendEnabled) {
+        CXPLAT_REGISTERED_BUFFER_POOL* Pool = &DatapathPartition->SendRegisteredBufferPool;
+        CxPlatLockAcquire(&Pool->Lock);
+        if (!CxPlatListIsEmpty(&Pool->FreeList)) {
+            SendData =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Pool->FreeList), CXPLAT_SEND_DATA, TxEntry);
+            RegisteredBuffer = TRUE;
+        }
+        CxPlatLockRelease(&Pool->Lock);
+    }
+
+    if (SendData == NULL) {
+        SendData = CxPlatPoolAlloc(&DatapathPartition->SendBlockPool);
+    }
+
     if (SendData != NULL) {
         SendData->SocketContext = SocketContext;
         SendData->ClientBuffer.Buffer = SendData->Buffer;
@@ -1805,10 +2605,15 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTime =
+            SocketContext->TxTimeEnabled && Config->TxTime != 0 ? US_TO_NS(Config->TxTime) : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->RegisteredBuffer = RegisteredBuffer;
+        SendData->ZeroCopy = FALSE;
+        SendData->FixedBuffer = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
@@ -1825,7 +2630,15 @@ SendDataFree(
     )
 {
     CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateFreed) != SendStateFreed);
-    CxPlatPoolFree(SendData);
+    if (SendData->RegisteredBuffer) {
+        CXPLAT_REGISTERED_BUFFER_POOL* Pool =
+            &SendData->SocketContext->DatapathPartition->SendRegisteredBufferPool;
+        CxPlatLockAcquire(&Pool->Lock);
+        CxPlatListInsertHead(&Pool->FreeList, &SendData->TxEntry);
+        CxPlatLockRelease(&Pool->Lock);
+    } else {
+        CxPlatPoolFree(SendData);
+    }
 }
 
 static
@@ -2019,6 +2832,17 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTime != 0) {
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = SendData->TxTime;
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
@@ -2039,12 +2863,10 @@ CxPlatSendDataSendSegmented(
         CxPlatLockAcquire(&DatapathPartition->EventQ->Lock);
     }
 
-    if (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
-        if (!AlreadyQueued) {
-            CxPlatListInsertTail(&SocketContext->TxQueue, &SendData->TxEntry);
-            CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateQueued) ==
-                SendStateAllocated);
-        }
+    if (!AlreadyQueued && !CxPlatListIsEmpty(&SocketContext->TxQueue)) {
+        CxPlatListInsertTail(&SocketContext->TxQueue, &SendData->TxEntry);
+        CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateQueued) ==
+            SendStateAllocated);
         Status = QUIC_STATUS_PENDING;
         goto Exit;
     }
@@ -2073,7 +2895,21 @@ CxPlatSendDataSendSegmented(
         SendData->MsgHdr.msg_controllen = SendData->ControlBufferLength;
     }
 
-    io_uring_prep_sendmsg(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+    SendData->ZeroCopy = FALSE;
+    SendData->FixedBuffer = FALSE;
+    if (DatapathPartition->Datapath->ZeroCopySendEnabled &&
+        SendData->TotalSize >= CXPLAT_ZERO_COPY_SEND_MIN_SIZE) {
+        io_uring_prep_sendmsg_zc(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+        SendData->ZeroCopy = TRUE;
+        if (SendData->RegisteredBuffer && DatapathPartition->SendFixedBuffersEnabled) {
+            Sqe->ioprio |= IORING_RECVSEND_FIXED_BUF;
+            Sqe->buf_index = 0;
+            SendData->FixedBuffer = TRUE;
+        }
+    } else {
+        io_uring_prep_sendmsg(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+    }
+    CxPlatSocketContextSetSqeFixedFile(SocketContext, Sqe);
     io_uring_sqe_set_data(Sqe, (void*)&SendData->Sqe);
     CxPlatBatchSqeInitialize(
         DatapathPartition->EventQ, CxPlatSocketContextIoEventComplete, &SendData->Sqe.Sqe);
@@ -2186,9 +3022,47 @@ CxPlatSocketContextSendComplete(
 {
     CXPLAT_SQE* Sqe = CxPlatCqeGetSqe(&Cqe);
     CXPLAT_SEND_DATA* SendData = CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SEND_DATA, Sqe);
+    BOOLEAN IoComplete = TRUE;
+
+    if (Cqe->flags & IORING_CQE_F_NOTIF) {
+        //
+        // The kernel released its last reference to the buffer of a zero-copy
+        // send, so the send data can finally be freed.
+        //
+        CXPLAT_DBG_ASSERT(SendData->ZeroCopy);
+        CxPlatSendDataFree(SendData);
+        CxPlatWorkerPoolAddSendZeroCopyStatistics(
+            SocketContext->DatapathPartition->Datapath->WorkerPool,
+            SocketContext->DatapathPartition->PartitionIndex,
+            1,
+            0);
+        CxPlatSocketIoComplete(SocketContext, IoTagSend);
+        return;
+    }
 
     CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateSendComplete) == SendStateSending);
-    CxPlatSendDataFree(SendData);
+
+    if (Cqe->flags & IORING_CQE_F_MORE) {
+        //
+        // The zero-copy send is done, but the buffer is still referenced by
+        // the kernel. The IO completes with the notification completion.
+        //
+        CXPLAT_DBG_ASSERT(SendData->ZeroCopy);
+        IoComplete = FALSE;
+    } else if (Cqe->res == -EINVAL && SendData->FixedBuffer &&
+               !SocketContext->LockedFlags.Shutdown) {
+        //
+        // Older kernels only support fixed buffers for non-vectored zero-copy
+        // sends. Stop using them on this partition and resend. The buffer
+        // stays registered until the pool is freed.
+        //
+        SocketContext->DatapathPartition->SendFixedBuffersEnabled = FALSE;
+        CxPlatListInsertHead(&SocketContext->TxQueue, &SendData->TxEntry);
+        CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateQueued) ==
+            SendStateSendComplete);
+    } else {
+        CxPlatSendDataFree(SendData);
+    }
     SendData = NULL;
 
     if (SocketContext->LockedFlags.Shutdown) {
@@ -2227,7 +3101,9 @@ CxPlatSocketContextSendComplete(
 
 Exit:
 
-    CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    if (IoComplete) {
+        CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -2254,6 +3130,8 @@ GetSocketContextFromSqe(
         return CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SOCKET_CONTEXT, IoSqe.Sqe);
     case DatapathContextSend:
         return CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SEND_DATA, Sqe)->SocketContext;
+    case DatapathContextRecvCancel:
+        return CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SOCKET_CONTEXT, RecvCancelSqe.Sqe);
     default:
         CXPLAT_DBG_ASSERT(FALSE);
         return NULL;
@@ -2270,6 +3148,8 @@ CxPlatSocketContextIoEventComplete(
     CXPLAT_SOCKET_CONTEXT* SocketContext = GetSocketContextFromSqe(Sqe);
     CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
     CXPLAT_EVENTQ* EventQ = DatapathPartition->EventQ;
+    CXPLAT_RECV_BATCH RecvBatch;
+    RecvBatch.SocketCount = 0;
 
     //
     // Review: this lazy thread ID initialization is not ideal. Instead,
@@ -2285,17 +3165,24 @@ CxPlatSocketContextIoEventComplete(
     while (TRUE) {
         CXPLAT_SOCKET_SQE* SocketSqe = CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SOCKET_SQE, Sqe);
 
+        if (SocketContext->LockedFlags.Shutdown) {
+            CxPlatRecvBatchFlushSocket(&RecvBatch, SocketContext);
+        }
+
         //
-        // Review: these functions could be unrolled to batch within an IO
-        // type on a socket.
+        // Receives are chained per socket in the batch and indicated once the
+        // batch is done.
         //
         switch ((DATAPATH_CONTEXT_TYPE)(uintptr_t)SocketSqe->Context) {
         case DatapathContextRecv:
-            CxPlatSocketReceiveComplete(SocketContext, *Cqes[0]);
+            CxPlatSocketReceiveComplete(SocketContext, *Cqes[0], &RecvBatch);
             break;
         case DatapathContextSend:
             CxPlatSocketContextSendComplete(SocketContext, *Cqes[0]);
             break;
+        case DatapathContextRecvCancel:
+            CxPlatSocketIoComplete(SocketContext, IoTagRecv);
+            break;
         default:
             CXPLAT_DBG_ASSERT(FALSE);
         }
@@ -2312,6 +3199,8 @@ CxPlatSocketContextIoEventComplete(
         SocketContext = GetSocketContextFromSqe(Sqe);
     }
 
+    CxPlatRecvBatchFlush(&RecvBatch);
+
     CxPlatEventQSubmit(EventQ);
 
     CxPlatLockRelease(&EventQ->Lock);
@@ -200,15 +200,49 @@ CxPlatSocketConfigureRss(
 #ifdef SO_ATTACH_REUSEPORT_CBPF
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     int Result = 0;
+    CXPLAT_DATAPATH* Datapath = SocketContext->Binding->Datapath;
 
-    struct sock_filter BpfCode[] = {
-        {BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF | SKF_AD_CPU}, // Load CPU number
-        {BPF_ALU | BPF_MOD, 0, 0, SocketCount}, // MOD by SocketCount
-        {BPF_RET | BPF_A, 0, 0, 0} // Return
-    };
+    //
+    // Each compare against a worker's processor takes two instructions, so
+    // fall back to the plain modulo when there are too many sockets.
+    //
+    struct sock_filter BpfCode[8 + 2 * CXPLAT_RSS_MAX_MAPPED_SOCKETS];
+    uint32_t Count = 0;
+
+    if (CxPlatWorkerPoolGetBusyPollUs(Datapath->WorkerPool) != 0) {
+        //
+        // Busy polling moves the NAPI processing onto whichever worker polls
+        // the NIC queue, so the CPU no longer identifies the queue. Select by
+        // the receive queue instead, which keeps each NAPI context on a single
+        // worker. Packets without a recorded queue fall through to the CPU.
+        //
+        BpfCode[Count++] = (struct sock_filter){BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF | SKF_AD_QUEUE};
+        BpfCode[Count++] = (struct sock_filter){BPF_JMP | BPF_JEQ | BPF_K, 2, 0, 0};
+        BpfCode[Count++] = (struct sock_filter){BPF_ALU | BPF_MOD, 0, 0, SocketCount};
+        BpfCode[Count++] = (struct sock_filter){BPF_RET | BPF_A, 0, 0, 0};
+    }
+
+    BpfCode[Count++] = (struct sock_filter){BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF | SKF_AD_CPU}; // Load CPU number
+    if (SocketCount <= CXPLAT_RSS_MAX_MAPPED_SOCKETS) {
+        //
+        // Steer to the socket whose worker runs on the receiving CPU, which
+        // only matches the CPU number when the workers use every processor
+        // in order.
+        //
+        for (uint32_t i = 0; i < SocketCount; ++i) {
+            const uint32_t IdealProcessor =
+                CxPlatWorkerPoolGetIdealProcessor(
+                    Datapath->WorkerPool, SocketContext[i].DatapathPartition->PartitionIndex);
+            BpfCode[Count++] = (struct sock_filter){BPF_JMP | BPF_JEQ | BPF_K, 0, 1, IdealProcessor};
+            BpfCode[Count++] = (struct sock_filter){BPF_RET | BPF_K, 0, 0, i};
+        }
+    }
+    BpfCode[Count++] = (struct sock_filter){BPF_ALU | BPF_MOD, 0, 0, SocketCount}; // MOD by SocketCount
+    BpfCode[Count++] = (struct sock_filter){BPF_RET | BPF_A, 0, 0, 0}; // Return
+    CXPLAT_DBG_ASSERT(Count <= ARRAYSIZE(BpfCode));
 
     struct sock_fprog BpfConfig = {0};
-	BpfConfig.len = ARRAYSIZE(BpfCode);
+	BpfConfig.len = (unsigned short)Count;
     BpfConfig.filter = BpfCode;
 
     Result =
@@ -236,6 +270,89 @@ CxPlatSocketConfigureRss(
 #endif
 }
 
+void
+CxPlatSocketConfigureBusyPoll(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    const uint32_t BusyPollUs =
+        CxPlatWorkerPoolGetBusyPollUs(SocketContext->Binding->Datapath->WorkerPool);
+    if (BusyPollUs == 0) {
+        return;
+    }
+
+    //
+    // Raising the busy poll time above net.core.busy_read needs
+    // CAP_NET_ADMIN. Without it, the socket relies on the event queue's own
+    // busy poll settings, so failures here aren't fatal.
+    //
+    int Option = (int)BusyPollUs;
+    if (setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_BUSY_POLL,
+            (const void*)&Option,
+            sizeof(Option)) == SOCKET_ERROR) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "setsockopt(SO_BUSY_POLL) failed");
+    }
+
+#ifdef SO_PREFER_BUSY_POLL
+    Option = TRUE;
+    if (setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_PREFER_BUSY_POLL,
+            (const void*)&Option,
+            sizeof(Option)) == SOCKET_ERROR) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "setsockopt(SO_PREFER_BUSY_POLL) failed");
+    }
+#endif
+}
+
+void
+CxPlatSocketConfigureTxTime(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    if (!(SocketContext->Binding->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME)) {
+        return;
+    }
+
+#ifdef SO_TXTIME
+    //
+    // The fq qdisc, which honors the departure times, runs on the monotonic
+    // clock, the same one CxPlatTimeUs64 reads. If the option is rejected,
+    // sends on this socket leave immediately and aren't paced by the kernel.
+    //
+    struct sock_txtime TxTime = { .clockid = CLOCK_MONOTONIC, .flags = 0 };
+    if (setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_TXTIME,
+            (const void*)&TxTime,
+            sizeof(TxTime)) == SOCKET_ERROR) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "setsockopt(SO_TXTIME) failed");
+    } else {
+        SocketContext->TxTimeEnabled = TRUE;
+    }
+#endif
+}
+
 void
 CxPlatSocketHandleError(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -8,10 +8,13 @@
 #pragma once
 
 #include <fcntl.h>
+#include <linux/errqueue.h>
 #include <linux/filter.h>
 #include <linux/in6.h>
+#include <linux/net_tstamp.h>
 #include <linux/stddef.h>
 #include <netinet/udp.h>
+#include <sys/resource.h>
 
 //
 // The maximum single buffer size for single packet/datagram IO payloads.
@@ -31,6 +34,13 @@
 //
 #define CXPLAT_MAX_IO_BATCH_SIZE ((uint16_t)(CXPLAT_LARGE_IO_BUFFER_SIZE / (1280 - CXPLAT_MIN_IPV6_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE)))
 
+//
+// The minimum total send size for which zero-copy sends are used. Below this,
+// the cost of pinning the pages and processing the extra completion outweighs
+// the cost of just copying the payload.
+//
+#define CXPLAT_ZERO_COPY_SEND_MIN_SIZE      0x2800
+
 #define CXPLAT_DBG_ASSERT_CMSG(CMsg, type) \
     CXPLAT_DBG_ASSERT((CMsg)->cmsg_len >= CMSG_LEN(sizeof(type)))
 
@@ -39,12 +49,35 @@ CxPlatDataPathCalculateFeatureSupport(
     _Inout_ CXPLAT_DATAPATH* Datapath
     );
 
+//
+// The most sockets the RSS program maps to their worker's processor.
+//
+#define CXPLAT_RSS_MAX_MAPPED_SOCKETS       256
+
 QUIC_STATUS
 CxPlatSocketConfigureRss(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
     _In_ uint32_t SocketCount
     );
 
+//
+// Sets the kernel busy poll options on a UDP socket, if busy polling is
+// enabled for the worker pool.
+//
+void
+CxPlatSocketConfigureBusyPoll(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    );
+
+//
+// Enables SO_TXTIME on a UDP socket, if the datapath hands send departure
+// times to the kernel.
+//
+void
+CxPlatSocketConfigureTxTime(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 DataPathUpdatePollingIdleTimeout(
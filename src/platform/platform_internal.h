@@ -731,6 +731,7 @@ CxPlatDpRawGetDatapathSize(
 #if defined(CX_PLATFORM_LINUX)
 
 typedef struct CXPLAT_DATAPATH_PARTITION CXPLAT_DATAPATH_PARTITION;
+typedef struct CXPLAT_RECV_BUFFER_GROUP CXPLAT_RECV_BUFFER_GROUP;
 
 typedef struct CXPLAT_SOCKET_SQE {
     CXPLAT_SQE Sqe;
@@ -770,6 +771,14 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     int SocketFd;
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // The slot of the socket in the ring's fixed file table, or -1 if the
+    // socket isn't registered.
+    //
+    int FixedFileIndex;
+#endif
+
     //
     // The submission queue event for shutdown.
     //
@@ -785,6 +794,25 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     CXPLAT_SQE FlushTxSqe;
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // The submission queue event for canceling the multishot receive, so it
+    // can be re-armed on a different buffer group.
+    //
+    CXPLAT_SOCKET_SQE RecvCancelSqe;
+
+    //
+    // The buffer group the multishot receive draws from.
+    //
+    CXPLAT_RECV_BUFFER_GROUP* RecvBufferGroup;
+
+    //
+    // Tracks bursts of datagrams received on the small buffer group.
+    //
+    uint64_t RecvBurstStartUs;
+    uint32_t RecvBurstCount;
+#endif
+
     //
     // The head of list containg all pending sends on this socket.
     //
@@ -800,6 +828,39 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     CXPLAT_RUNDOWN_REF UpcallRundown;
 
+#ifndef CXPLAT_USE_IO_URING
+    //
+    // The head of list containing MSG_ZEROCOPY sends whose buffers are still
+    // referenced by the kernel, in the order they were sent.
+    //
+    CXPLAT_LIST_ENTRY ZeroCopyQueue;
+
+    //
+    // Lock around the ZeroCopyQueue list. Zero-copy sends are made while
+    // holding it, so the queue order matches the completion IDs the kernel
+    // assigns.
+    //
+    CXPLAT_LOCK ZeroCopyQueueLock;
+
+    //
+    // The completion ID the kernel will assign to the next zero-copy send.
+    //
+    uint32_t ZeroCopyNextId;
+
+    //
+    // Zero-copy completions seen on the socket, and how many of them the
+    // kernel had to copy anyway.
+    //
+    uint32_t ZeroCopyCompletedCount;
+    uint32_t ZeroCopyCopiedCount;
+
+    //
+    // Indicates large sends on the socket use MSG_ZEROCOPY. Must not be a
+    // bitfield, as it is cleared on the completion path while sends read it.
+    //
+    BOOLEAN ZeroCopyEnabled;
+#endif
+
     //
     // The number of active IOs.
     //
@@ -819,6 +880,11 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     BOOLEAN IoStarted : 1;
 
+    //
+    // Indicates the socket accepts SCM_TXTIME departure times (SO_TXTIME).
+    //
+    BOOLEAN TxTimeEnabled : 1;
+
 #ifdef CXPLAT_USE_IO_URING
     struct {
         //
@@ -826,6 +892,12 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
         //
         BOOLEAN Shutdown : 1;
 
+        //
+        // Indicates the socket should move to the large receive buffer group
+        // the next time its multishot receive is armed.
+        //
+        BOOLEAN RecvPromotePending : 1;
+
 #if DEBUG
         //
         // Indicates if the socket socket has a multi recv outstanding.
@@ -913,8 +985,69 @@ typedef struct CXPLAT_REGISTERED_BUFFER_POOL {
     uint32_t BufferSize;
     uint32_t TotalSize;
     CXPLAT_LOCK Lock;
+
+    //
+    // List of free buffers, for pools that are registered as fixed buffers
+    // instead of being provided to the kernel through a buffer ring.
+    //
+    CXPLAT_LIST_ENTRY FreeList;
 } CXPLAT_REGISTERED_BUFFER_POOL;
 
+#define CXPLAT_RECV_BUFFER_GROUP_MAX_SLABS 32
+
+//
+// Receive buffers provided to the kernel through a buffer ring. The buffers
+// are allocated in slabs, so the group can grow when the kernel runs out of
+// buffers and shrink back once the pressure subsides. Only the top slab is
+// ever retired: its buffers are parked instead of being given back to the
+// ring, and the slab is freed once all of them are parked.
+//
+typedef struct CXPLAT_RECV_BUFFER_GROUP {
+    //
+    // The buffer ring, sized for the maximum number of slabs.
+    //
+    void* Ring;
+    uint8_t* Slabs[CXPLAT_RECV_BUFFER_GROUP_MAX_SLABS];
+
+    //
+    // Buffers of the retiring slab that have been returned by the app.
+    //
+    uint16_t* ParkedBuffers;
+    uint16_t ParkedCount;
+
+    //
+    // The buffer group ID the ring is registered with.
+    //
+    uint16_t BufferGroup;
+
+    uint16_t BuffersPerSlab;
+    uint16_t MinSlabCount;
+    uint16_t MaxSlabCount;
+
+    //
+    // The number of allocated slabs, and the number of those whose buffers
+    // are given back to the ring. They only differ while the top slab is
+    // being retired.
+    //
+    uint16_t SlabCount;
+    uint16_t ActiveSlabCount;
+
+    //
+    // The size of each DATAPATH_RX_IO_BLOCK and the offset of the raw buffer
+    // in it.
+    //
+    uint32_t BlockSize;
+    uint32_t BufferOffset;
+
+    //
+    // Only used by the ring's issuer, to decide when to shrink.
+    //
+    uint32_t CompletionCount;
+    uint64_t LastExhaustedTimeUs;
+
+    CXPLAT_LOCK Lock;
+} CXPLAT_RECV_BUFFER_GROUP;
+
 //
 // A per processor datapath context.
 //
@@ -952,9 +1085,13 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
 
 #ifdef CXPLAT_USE_IO_URING
     //
-    // Backing pool of registered buffers for the RecvBlockPool.
+    // Receive buffers provided to the kernel. Sockets start out on the small
+    // buffer group, which is only used with receive coalescing, and move to
+    // RecvBufferGroup, which is sized for the coalesced datagrams, once they
+    // see a burst of traffic.
     //
-    CXPLAT_REGISTERED_BUFFER_POOL RecvRegisteredBufferPool;
+    CXPLAT_RECV_BUFFER_GROUP RecvBufferGroup;
+    CXPLAT_RECV_BUFFER_GROUP RecvSmallBufferGroup;
 #endif
 
     //
@@ -965,9 +1102,32 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
 
 #ifdef CXPLAT_USE_IO_URING
     //
-    // Backing pool of registered buffers for the SendBlockPool.
+    // Backing pool of registered buffers for the SendBlockPool. Only used
+    // when zero-copy sends are enabled.
     //
     CXPLAT_REGISTERED_BUFFER_POOL SendRegisteredBufferPool;
+
+    //
+    // Indicates the SendRegisteredBufferPool is registered with the ring as a
+    // fixed buffer.
+    //
+    uint8_t SendFixedBuffersRegistered : 1;
+
+    //
+    // Indicates zero-copy sends may reference the registered fixed buffer
+    // directly. Cleared if the kernel rejects fixed buffer sends, while the
+    // buffer stays registered until the pool is freed.
+    //
+    uint8_t SendFixedBuffersEnabled : 1;
+
+    //
+    // Stack of free slots in the ring's sparse fixed file table, used to
+    // register the socket FDs of this partition. NULL if the table couldn't
+    // be registered.
+    //
+    uint32_t* FixedFileFreeSlots;
+    uint32_t FixedFileFreeCount;
+    CXPLAT_LOCK FixedFileLock;
 #endif
 
     //
@@ -1032,6 +1192,12 @@ typedef struct CXPLAT_DATAPATH {
 
     uint8_t ReserveAuxTcpSock : 1;
 
+    //
+    // Large sends use IORING_OP_SENDMSG_ZC instead of IORING_OP_SENDMSG, or
+    // MSG_ZEROCOPY with epoll.
+    //
+    uint8_t ZeroCopySendEnabled : 1;
+
     //
     // The per proc datapath contexts.
     //
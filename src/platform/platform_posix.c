@@ -295,6 +295,377 @@ CxPlatFree(
     free(Mem);
 }
 
+void
+CxPlatPoolInitialize(
+    _In_ BOOLEAN IsPaged,
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CxPlatZeroMemory(Pool, sizeof(*Pool));
+    Pool->Size = Size + sizeof(CXPLAT_POOL_HEADER); // Add space for the pool header
+    Pool->Tag = Tag;
+    Pool->FullMagazineLimit = CXPLAT_POOL_DEPOT_MIN_FULL_COUNT;
+    CxPlatLockInitialize(&Pool->Lock);
+    UNREFERENCED_PARAMETER(IsPaged);
+
+#ifndef DISABLE_CXPLAT_POOL
+    //
+    // The caches are indexed by the current processor, which requires the
+    // platform to be initialized.
+    //
+    if (CxPlatProcCount() != 0) {
+        Pool->Caches =
+            CxPlatAlloc(sizeof(CXPLAT_POOL_CACHE*) * CxPlatProcCount(), Tag);
+        if (Pool->Caches != NULL) {
+            CxPlatZeroMemory(
+                (void*)Pool->Caches, sizeof(CXPLAT_POOL_CACHE*) * CxPlatProcCount());
+            Pool->CacheCount = CxPlatProcCount();
+        }
+    }
+#endif
+}
+
+static
+void
+CxPlatPoolFreeMagazine(
+    _In_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    for (uint32_t i = 0; i < Magazine->Count; ++i) {
+        CXPLAT_DBG_ASSERT(Magazine->Entries[i]->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
+        CxPlatFree(Magazine->Entries[i], Pool->Tag);
+    }
+    CxPlatFree(Magazine, Pool->Tag);
+}
+
+void
+CxPlatPoolUninitialize(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    for (uint32_t i = 0; i < Pool->CacheCount; ++i) {
+        CXPLAT_POOL_CACHE* Cache = Pool->Caches[i];
+        if (Cache != NULL) {
+            if (Cache->Loaded != NULL) {
+                CxPlatPoolFreeMagazine(Pool, Cache->Loaded);
+            }
+            if (Cache->Previous != NULL) {
+                CxPlatPoolFreeMagazine(Pool, Cache->Previous);
+            }
+            CxPlatLockUninitialize(&Cache->Lock);
+            CxPlatFree(Cache, Pool->Tag);
+        }
+    }
+    if (Pool->Caches != NULL) {
+        CxPlatFree((void*)Pool->Caches, Pool->Tag);
+    }
+    for (uint32_t i = 0; i < CXPLAT_POOL_DEPOT_SIZE; ++i) {
+        if (Pool->FullMagazines[i] != NULL) {
+            CxPlatPoolFreeMagazine(Pool, Pool->FullMagazines[i]);
+        }
+        if (Pool->EmptyMagazines[i] != NULL) {
+            CxPlatPoolFreeMagazine(Pool, Pool->EmptyMagazines[i]);
+        }
+    }
+
+    CXPLAT_POOL_HEADER* Entry;
+    while ((Entry = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead)) != NULL) {
+        CXPLAT_DBG_ASSERT(Entry->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
+        CxPlatFree(Entry, Pool->Tag);
+    }
+    CxPlatLockUninitialize(&Pool->Lock);
+}
+
+static
+BOOLEAN
+CxPlatPoolDepotPush(
+    _Inout_updates_(CXPLAT_POOL_DEPOT_SIZE) CXPLAT_POOL_MAGAZINE* volatile* Slots,
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    for (uint32_t i = 0; i < CXPLAT_POOL_DEPOT_SIZE; ++i) {
+        if (Slots[i] == NULL &&
+            __sync_val_compare_and_swap(&Slots[i], (CXPLAT_POOL_MAGAZINE*)NULL, Magazine) == NULL) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolDepotPop(
+    _Inout_updates_(CXPLAT_POOL_DEPOT_SIZE) CXPLAT_POOL_MAGAZINE* volatile* Slots
+    )
+{
+    for (uint32_t i = 0; i < CXPLAT_POOL_DEPOT_SIZE; ++i) {
+        if (Slots[i] != NULL) {
+            CXPLAT_POOL_MAGAZINE* Magazine =
+                (CXPLAT_POOL_MAGAZINE*)InterlockedFetchAndClearPointer((void* volatile*)&Slots[i]);
+            if (Magazine != NULL) {
+                return Magazine;
+            }
+        }
+    }
+    return NULL;
+}
+
+static
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolGetFullMagazine(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_MAGAZINE* Magazine = NULL;
+    if (QuicReadAcquire(&Pool->FullMagazineCount) > 0) {
+        Magazine = CxPlatPoolDepotPop(Pool->FullMagazines);
+    }
+    if (Magazine != NULL) {
+        InterlockedDecrement(&Pool->FullMagazineCount);
+    } else if (Pool->Overflowed && InterlockedFetchAndClearBoolean(&Pool->Overflowed)) {
+        //
+        // Entries were freed for lack of room in the depot, and are needed
+        // again now. Let the depot keep more of them.
+        //
+        const long Limit = Pool->FullMagazineLimit;
+        if (Limit < CXPLAT_POOL_DEPOT_SIZE) {
+            InterlockedCompareExchange(
+                &Pool->FullMagazineLimit, CXPLAT_MIN(Limit * 2, CXPLAT_POOL_DEPOT_SIZE), Limit);
+        }
+    }
+    return Magazine;
+}
+
+static
+void
+CxPlatPoolPutFullMagazine(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    if (InterlockedIncrement(&Pool->FullMagazineCount) <= Pool->FullMagazineLimit &&
+        CxPlatPoolDepotPush(Pool->FullMagazines, Magazine)) {
+        return;
+    }
+
+    InterlockedDecrement(&Pool->FullMagazineCount);
+    Pool->Overflowed = TRUE;
+    for (uint32_t i = 0; i < Magazine->Count; ++i) {
+        CxPlatFree(Magazine->Entries[i], Pool->Tag);
+    }
+    Magazine->Count = 0;
+    if (!CxPlatPoolDepotPush(Pool->EmptyMagazines, Magazine)) {
+        CxPlatFree(Magazine, Pool->Tag);
+    }
+}
+
+static
+CXPLAT_POOL_CACHE*
+CxPlatPoolAcquireCache(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+#if defined(CX_PLATFORM_LINUX)
+    //
+    // Avoids the division in CxPlatProcCurrentNumber on this hot path.
+    //
+    uint32_t Processor = (uint32_t)sched_getcpu();
+    if (Processor >= Pool->CacheCount) {
+        Processor %= Pool->CacheCount;
+    }
+#else
+    const uint32_t Processor = CxPlatProcCurrentNumber();
+#endif
+    CXPLAT_POOL_CACHE* volatile* Slot = &Pool->Caches[Processor];
+    CXPLAT_POOL_CACHE* Cache = QuicReadPtrAcquire(Slot);
+    if (Cache == NULL) {
+        CXPLAT_POOL_CACHE* NewCache = CxPlatAlloc(sizeof(CXPLAT_POOL_CACHE), Pool->Tag);
+        if (NewCache == NULL) {
+            return NULL;
+        }
+        CxPlatZeroMemory(NewCache, sizeof(*NewCache));
+        CxPlatLockInitialize(&NewCache->Lock);
+        Cache = __sync_val_compare_and_swap(Slot, (CXPLAT_POOL_CACHE*)NULL, NewCache);
+        if (Cache == NULL) {
+            Cache = NewCache;
+        } else {
+            CxPlatLockUninitialize(&NewCache->Lock); // Another thread created it first.
+            CxPlatFree(NewCache, Pool->Tag);
+        }
+    }
+    CxPlatLockAcquire(&Cache->Lock);
+    return Cache;
+}
+
+static
+void
+CxPlatPoolReleaseCache(
+    _Inout_ CXPLAT_POOL_CACHE* Cache
+    )
+{
+    CxPlatLockRelease(&Cache->Lock);
+}
+
+CXPLAT_POOL_HEADER*
+CxPlatPoolPopEntry(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_HEADER* Header;
+
+    if (Pool->Caches == NULL) {
+        CxPlatLockAcquire(&Pool->Lock);
+        Header = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
+        if (Header != NULL) {
+            CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
+            Pool->ListDepth--;
+            Pool->AllocHitCount++;
+        } else {
+            Pool->AllocMissCount++;
+        }
+        CxPlatLockRelease(&Pool->Lock);
+        return Header;
+    }
+
+    CXPLAT_POOL_CACHE* Cache = CxPlatPoolAcquireCache(Pool);
+    if (Cache == NULL) {
+        InterlockedIncrement64(&Pool->AllocMissCount);
+        return NULL;
+    }
+
+    if (Cache->Loaded == NULL || Cache->Loaded->Count == 0) {
+        if (Cache->Previous != NULL && Cache->Previous->Count != 0) {
+            CXPLAT_POOL_MAGAZINE* Temp = Cache->Loaded;
+            Cache->Loaded = Cache->Previous;
+            Cache->Previous = Temp;
+        } else {
+            CXPLAT_POOL_MAGAZINE* Full = CxPlatPoolGetFullMagazine(Pool);
+            if (Full != NULL) {
+                if (Cache->Previous != NULL &&
+                    !CxPlatPoolDepotPush(Pool->EmptyMagazines, Cache->Previous)) {
+                    CxPlatFree(Cache->Previous, Pool->Tag);
+                }
+                Cache->Previous = Cache->Loaded;
+                Cache->Loaded = Full;
+            }
+        }
+    }
+
+    if (Cache->Loaded != NULL && Cache->Loaded->Count != 0) {
+        Header = Cache->Loaded->Entries[--Cache->Loaded->Count];
+        Cache->AllocHitCount++;
+    } else {
+        Header = NULL;
+        Cache->AllocMissCount++;
+    }
+
+    CxPlatPoolReleaseCache(Cache);
+    return Header;
+}
+
+BOOLEAN
+CxPlatPoolPushEntry(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ CXPLAT_POOL_HEADER* Header
+    )
+{
+    if (Pool->Caches == NULL) {
+        if (Pool->ListDepth >= CXPLAT_POOL_MAXIMUM_DEPTH) {
+            return FALSE;
+        }
+        CxPlatLockAcquire(&Pool->Lock);
+        CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
+        Pool->ListDepth++;
+        CxPlatLockRelease(&Pool->Lock);
+        return TRUE;
+    }
+
+    CXPLAT_POOL_CACHE* Cache = CxPlatPoolAcquireCache(Pool);
+    if (Cache == NULL) {
+        return FALSE;
+    }
+
+    if (Cache->Loaded == NULL || Cache->Loaded->Count == CXPLAT_POOL_MAGAZINE_SIZE) {
+        if (Cache->Previous != NULL && Cache->Previous->Count == 0) {
+            CXPLAT_POOL_MAGAZINE* Temp = Cache->Loaded;
+            Cache->Loaded = Cache->Previous;
+            Cache->Previous = Temp;
+        } else {
+            CXPLAT_POOL_MAGAZINE* Empty = CxPlatPoolDepotPop(Pool->EmptyMagazines);
+            if (Empty == NULL) {
+                Empty = CxPlatAlloc(sizeof(CXPLAT_POOL_MAGAZINE), Pool->Tag);
+                if (Empty == NULL) {
+                    CxPlatPoolReleaseCache(Cache);
+                    return FALSE;
+                }
+                Empty->Count = 0;
+            }
+            if (Cache->Previous != NULL) {
+                CxPlatPoolPutFullMagazine(Pool, Cache->Previous);
+            }
+            Cache->Previous = Cache->Loaded;
+            Cache->Loaded = Empty;
+        }
+    }
+
+    Cache->Loaded->Entries[Cache->Loaded->Count++] = Header;
+
+    CxPlatPoolReleaseCache(Cache);
+    return TRUE;
+}
+
+BOOLEAN
+CxPlatPoolPrune(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    if (Pool->Caches == NULL) {
+        CxPlatLockAcquire(&Pool->Lock);
+        void* Entry = CxPlatListPopEntry(&Pool->ListHead);
+        if (Entry != NULL) {
+            CXPLAT_FRE_ASSERT(Pool->ListDepth > 0);
+            Pool->ListDepth--;
+        }
+        CxPlatLockRelease(&Pool->Lock);
+        if (Entry == NULL) {
+            return FALSE;
+        }
+        CxPlatFree(Entry, Pool->Tag);
+        return TRUE;
+    }
+
+    if (Pool->FullMagazineLimit > CXPLAT_POOL_DEPOT_MIN_FULL_COUNT) {
+        InterlockedDecrement(&Pool->FullMagazineLimit);
+    }
+    CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolDepotPop(Pool->FullMagazines);
+    if (Magazine == NULL) {
+        return FALSE;
+    }
+    InterlockedDecrement(&Pool->FullMagazineCount);
+    CxPlatPoolFreeMagazine(Pool, Magazine);
+    return TRUE;
+}
+
+void
+CxPlatPoolGetStatistics(
+    _In_ const CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    )
+{
+    Statistics->AllocHitCount = (uint64_t)Pool->AllocHitCount;
+    Statistics->AllocMissCount = (uint64_t)Pool->AllocMissCount;
+    for (uint32_t i = 0; i < Pool->CacheCount; ++i) {
+        const CXPLAT_POOL_CACHE* Cache = QuicReadPtrAcquire(&Pool->Caches[i]);
+        if (Cache != NULL) {
+            Statistics->AllocHitCount += Cache->AllocHitCount;
+            Statistics->AllocMissCount += Cache->AllocMissCount;
+        }
+    }
+}
+
 void
 CxPlatRefInitialize(
     _Inout_ CXPLAT_REF_COUNT* RefCount
@@ -247,6 +247,17 @@ CxPlatRandom(
             0);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatPoolGetStatistics(
+    _In_ const CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Pool);
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics)); // Not tracked.
+}
+
 #ifdef DEBUG
 
 void
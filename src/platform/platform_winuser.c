@@ -492,6 +492,16 @@ CxPlatFree(
 #endif
 }
 
+void
+CxPlatPoolGetStatistics(
+    _In_ const CXPLAT_POOL* Pool,
+    _Out_ CXPLAT_POOL_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Pool);
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics)); // Not tracked.
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 CxPlatUtf8ToWideChar(
@@ -68,6 +68,12 @@ typedef struct QUIC_CACHEALIGN CXPLAT_WORKER {
     //
     CXPLAT_SLIST_ENTRY* ExecutionContexts;
 
+    //
+    // Zero-copy send completions reported by the datapath.
+    //
+    uint64_t SendZeroCopyCount;
+    uint64_t SendZeroCopyCopiedCount;
+
 #if DEBUG // Debug statistics
     uint64_t LoopCount;
     uint64_t EcPollCount;
@@ -75,6 +81,11 @@ typedef struct QUIC_CACHEALIGN CXPLAT_WORKER {
     uint64_t CqeCount;
 #endif
 
+    //
+    // The kernel busy poll time for the event queue, or zero if disabled.
+    //
+    uint32_t BusyPollUs;
+
     //
     // The ideal processor for the worker thread.
     //
@@ -108,6 +119,7 @@ typedef struct CXPLAT_WORKER_POOL {
 
     CXPLAT_RUNDOWN_REF Rundown;
     uint32_t WorkerCount;
+    uint32_t BusyPollUs;
 
 #if DEBUG
     //
@@ -160,25 +172,86 @@ UpdatePollCompletion(
     CxPlatUpdateExecutionContexts(Worker);
 }
 
+//
+// The kernel busy poll time used when the polling idle timeout isn't set.
+//
+#define CXPLAT_BUSY_POLL_DEFAULT_US 50
+
+static
+uint32_t
+CxPlatWorkerBusyPollUs(
+    _In_opt_ const QUIC_GLOBAL_EXECUTION_CONFIG* Config
+    )
+{
+    if (Config == NULL || !(Config->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL)) {
+        return 0;
+    }
+    return Config->PollingIdleTimeoutUs != 0 ?
+        Config->PollingIdleTimeoutUs : CXPLAT_BUSY_POLL_DEFAULT_US;
+}
+
+static
+BOOLEAN
+CxPlatWorkerEventQInitialize(
+    _Out_ CXPLAT_EVENTQ* EventQ,
+    _In_opt_ const QUIC_GLOBAL_EXECUTION_CONFIG* Config
+    )
+{
+#ifdef CXPLAT_USE_IO_URING
+    if (Config != NULL) {
+        uint32_t Flags = 0;
+        if (Config->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_SQPOLL) {
+            Flags |= CXPLAT_EVENTQ_FLAG_SQPOLL;
+        } else if (Config->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_DEFER) {
+            Flags |= CXPLAT_EVENTQ_FLAG_SINGLE_ISSUER;
+        }
+        if (Flags != 0) {
+            //
+            // The SQ thread idle time is in milliseconds, so round the polling
+            // timeout up to make sure a non-zero value stays non-zero.
+            //
+            const uint32_t SqThreadIdleMs =
+                (uint32_t)(((uint64_t)Config->PollingIdleTimeoutUs + 999) / 1000);
+            if (CxPlatEventQInitializeEx(EventQ, Flags, SqThreadIdleMs)) {
+                return TRUE;
+            }
+            //
+            // Older kernels don't support every profile (and SQPOLL may need
+            // extra privileges), so fall back to the default ring.
+            //
+            QuicTraceEvent(
+                LibraryError,
+                "[ lib] ERROR, %s.",
+                "CxPlatEventQInitializeEx (falling back to default profile)");
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(Config);
+#endif
+    return CxPlatEventQInitialize(EventQ);
+}
+
 BOOLEAN
 CxPlatWorkerPoolInitWorker(
     _Inout_ CXPLAT_WORKER* Worker,
     _In_ uint16_t IdealProcessor,
     _In_opt_ CXPLAT_EVENTQ* EventQ, // Only for external workers
-    _In_opt_ CXPLAT_THREAD_CONFIG* ThreadConfig // Only for internal workers
+    _In_opt_ CXPLAT_THREAD_CONFIG* ThreadConfig, // Only for internal workers
+    _In_opt_ const QUIC_GLOBAL_EXECUTION_CONFIG* Config // Only for internal workers
     )
 {
     CxPlatLockInitialize(&Worker->ECLock);
     CxPlatListInitializeHead(&Worker->DynamicPoolList);
     Worker->InitializedECLock = TRUE;
     Worker->IdealProcessor = IdealProcessor;
+    Worker->BusyPollUs = CxPlatWorkerBusyPollUs(Config);
     Worker->State.WaitTime = UINT32_MAX;
     Worker->State.ThreadID = UINT32_MAX;
 
     if (EventQ != NULL) {
         Worker->EventQ = *EventQ;
     } else {
-        if (!CxPlatEventQInitialize(&Worker->EventQ)) {
+        if (!CxPlatWorkerEventQInitialize(&Worker->EventQ, Config)) {
             QuicTraceEvent(
                 LibraryError,
                 "[ lib] ERROR, %s.",
@@ -302,6 +375,7 @@ CxPlatWorkerPoolCreate(
     }
     CxPlatZeroMemory(WorkerPool, WorkerPoolSize);
     WorkerPool->WorkerCount = ProcessorCount;
+    WorkerPool->BusyPollUs = CxPlatWorkerBusyPollUs(Config);
 
     //
     // Build up the configuration for creating the worker threads.
@@ -338,7 +412,7 @@ CxPlatWorkerPoolCreate(
 
         CXPLAT_WORKER* Worker = &WorkerPool->Workers[i];
         if (!CxPlatWorkerPoolInitWorker(
-                Worker, IdealProcessor, NULL, &ThreadConfig)) {
+                Worker, IdealProcessor, NULL, &ThreadConfig, Config)) {
             goto Error;
         }
     }
@@ -407,7 +481,7 @@ CxPlatWorkerPoolCreateExternal(
 
         CXPLAT_WORKER* Worker = &WorkerPool->Workers[i];
         if (!CxPlatWorkerPoolInitWorker(
-                Worker, IdealProcessor, Configs[i].EventQ, NULL)) {
+                Worker, IdealProcessor, Configs[i].EventQ, NULL, NULL)) {
             goto Error;
         }
         Executions[i] = (QUIC_EXECUTION*)Worker;
@@ -517,6 +591,15 @@ CxPlatWorkerPoolGetIdealProcessor(
     return WorkerPool->Workers[Index].IdealProcessor;
 }
 
+uint32_t
+CxPlatWorkerPoolGetBusyPollUs(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    )
+{
+    CXPLAT_DBG_ASSERT(WorkerPool);
+    return WorkerPool->BusyPollUs;
+}
+
 CXPLAT_EVENTQ*
 CxPlatWorkerPoolGetEventQ(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -528,6 +611,46 @@ CxPlatWorkerPoolGetEventQ(
     return &WorkerPool->Workers[Index].EventQ;
 }
 
+void
+CxPlatWorkerPoolGetStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index,
+    _Out_ CXPLAT_WORKER_POOL_STATISTICS* Statistics
+    )
+{
+    CXPLAT_DBG_ASSERT(WorkerPool);
+    CXPLAT_FRE_ASSERT(Index < WorkerPool->WorkerCount);
+#ifdef CXPLAT_USE_IO_URING
+    const CXPLAT_EVENTQ* EventQ = &WorkerPool->Workers[Index].EventQ;
+    Statistics->EventQSubmitCount = EventQ->SubmitCount;
+    Statistics->EventQWakeupCount = EventQ->WakeupCount;
+    Statistics->EventQRecvNoBufferCount = EventQ->RecvNoBufferCount;
+    Statistics->EventQRecvRearmCount = EventQ->RecvRearmCount;
+#else
+    Statistics->EventQSubmitCount = 0;
+    Statistics->EventQWakeupCount = 0;
+    Statistics->EventQRecvNoBufferCount = 0;
+    Statistics->EventQRecvRearmCount = 0;
+#endif
+    Statistics->SendZeroCopyCount = WorkerPool->Workers[Index].SendZeroCopyCount;
+    Statistics->SendZeroCopyCopiedCount = WorkerPool->Workers[Index].SendZeroCopyCopiedCount;
+}
+
+void
+CxPlatWorkerPoolAddSendZeroCopyStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index,
+    _In_ uint32_t CompletedCount,
+    _In_ uint32_t CopiedCount
+    )
+{
+    CXPLAT_DBG_ASSERT(WorkerPool);
+    CXPLAT_FRE_ASSERT(Index < WorkerPool->WorkerCount);
+    CXPLAT_WORKER* Worker = &WorkerPool->Workers[Index];
+    Worker->SendZeroCopyCount += CompletedCount;
+    Worker->SendZeroCopyCopiedCount += CopiedCount;
+}
+
 void
 CxPlatWorkerPoolAddExecutionContext(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -796,6 +919,22 @@ CXPLAT_THREAD_CALLBACK(CxPlatWorkerThread, Context)
 
     Worker->State.ThreadID = CxPlatCurThreadID();
     Worker->Running = TRUE;
+#ifdef CXPLAT_USE_IO_URING
+    CxPlatEventQStartIssuer(&Worker->EventQ);
+#endif
+#ifdef CX_PLATFORM_LINUX
+    if (Worker->BusyPollUs != 0 &&
+        !CxPlatEventQSetBusyPoll(&Worker->EventQ, Worker->BusyPollUs)) {
+        //
+        // Older kernels can't busy poll from the event queue wait, but the
+        // sockets still busy poll on their own receives.
+        //
+        QuicTraceEvent(
+            LibraryError,
+            "[ lib] ERROR, %s.",
+            "CxPlatEventQSetBusyPoll");
+    }
+#endif
 
     while (!Worker->StoppedThread) {
 
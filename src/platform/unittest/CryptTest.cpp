@@ -619,6 +619,230 @@ TEST_P(CryptTest, Encryption)
     ASSERT_FALSE(Key.Decrypt(Iv, sizeof(AuthData), AuthData, sizeof(Buffer), Buffer));
 }
 
+TEST_P(CryptTest, EncryptionBatch)
+{
+    int AEAD = GetParam();
+
+    const uint8_t BatchSize = 8;
+    const uint16_t HeaderLength = 13;
+    const uint16_t PayloadLength = 1200;
+    const uint16_t PacketLength = HeaderLength + PayloadLength;
+
+    uint8_t RawKey[32];
+    uint8_t RawIv[CXPLAT_IV_LENGTH];
+    CxPlatRandom(sizeof(RawKey), RawKey);
+    CxPlatRandom(sizeof(RawIv), RawIv);
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    uint8_t Plain[BatchSize * PacketLength];
+    uint8_t Single[BatchSize * PacketLength];
+    uint8_t Batched[BatchSize * PacketLength];
+    CxPlatRandom(sizeof(Plain), Plain);
+
+    CXPLAT_CRYPT_BATCH_ENTRY Batch[BatchSize];
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        uint64_t PacketNumber = i;
+        QuicCryptoCombineIvAndPacketNumber(RawIv, (uint8_t*)&PacketNumber, Batch[i].Iv);
+        Batch[i].AuthData = Batched + i * PacketLength;
+        Batch[i].AuthDataLength = HeaderLength;
+        Batch[i].Buffer = Batched + i * PacketLength + HeaderLength;
+        Batch[i].BufferLength = PayloadLength;
+        Batch[i].Extents = NULL;
+        Batch[i].ExtentCount = 0;
+    }
+
+    //
+    // The batch must produce exactly the same output as encrypting each
+    // packet individually.
+    //
+
+    CxPlatCopyMemory(Single, Plain, sizeof(Plain));
+    CxPlatCopyMemory(Batched, Plain, sizeof(Plain));
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_TRUE(
+            Key.Encrypt(
+                Batch[i].Iv,
+                HeaderLength,
+                Single + i * PacketLength,
+                PayloadLength,
+                Single + i * PacketLength + HeaderLength));
+    }
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatEncryptBatch(Key.Ptr, BatchSize, Batch));
+    ASSERT_EQ(0, memcmp(Single, Batched, sizeof(Single)));
+
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_TRUE(
+            Key.Decrypt(
+                Batch[i].Iv,
+                HeaderLength,
+                Batched + i * PacketLength,
+                PayloadLength,
+                Batched + i * PacketLength + HeaderLength));
+    }
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_EQ(
+            0,
+            memcmp(
+                Plain + i * PacketLength,
+                Batched + i * PacketLength,
+                PacketLength - CXPLAT_ENCRYPTION_OVERHEAD));
+    }
+}
+
+TEST_P(CryptTest, EncryptionBatchExtents)
+{
+    int AEAD = GetParam();
+
+    const uint8_t BatchSize = 8;
+    const uint16_t HeaderLength = 13;
+    const uint16_t PayloadLength = 1200;
+    const uint16_t PacketLength = HeaderLength + PayloadLength;
+    const uint16_t FrameHeaderLength = 11;
+    const uint16_t DataLength = PayloadLength - FrameHeaderLength - CXPLAT_ENCRYPTION_OVERHEAD;
+
+    uint8_t RawKey[32];
+    uint8_t RawIv[CXPLAT_IV_LENGTH];
+    CxPlatRandom(sizeof(RawKey), RawKey);
+    CxPlatRandom(sizeof(RawIv), RawIv);
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    //
+    // Like stream frames, each payload is a frame header followed by app data,
+    // which is either copied in or encrypted from the app's buffer, split in
+    // two extents for the odd packets.
+    //
+    uint8_t AppData[BatchSize * DataLength];
+    uint8_t Headers[PacketLength];
+    uint8_t Copied[BatchSize * PacketLength];
+    uint8_t Fused[BatchSize * PacketLength];
+    CxPlatRandom(sizeof(AppData), AppData);
+    CxPlatRandom(sizeof(Headers), Headers);
+    CxPlatZeroMemory(Fused, sizeof(Fused));
+
+    CXPLAT_CRYPT_EXTENT Extents[BatchSize * 2];
+    uint8_t ExtentCount = 0;
+    CXPLAT_CRYPT_BATCH_ENTRY CopiedBatch[BatchSize];
+    CXPLAT_CRYPT_BATCH_ENTRY FusedBatch[BatchSize];
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        uint64_t PacketNumber = i;
+        QuicCryptoCombineIvAndPacketNumber(RawIv, (uint8_t*)&PacketNumber, CopiedBatch[i].Iv);
+        CopiedBatch[i].AuthData = Copied + i * PacketLength;
+        CopiedBatch[i].AuthDataLength = HeaderLength;
+        CopiedBatch[i].Buffer = Copied + i * PacketLength + HeaderLength;
+        CopiedBatch[i].BufferLength = PayloadLength;
+        CopiedBatch[i].Extents = NULL;
+        CopiedBatch[i].ExtentCount = 0;
+
+        FusedBatch[i] = CopiedBatch[i];
+        FusedBatch[i].AuthData = Fused + i * PacketLength;
+        FusedBatch[i].Buffer = Fused + i * PacketLength + HeaderLength;
+        FusedBatch[i].Extents = Extents + ExtentCount;
+        const uint8_t* Data = AppData + i * DataLength;
+        if (i % 2 == 0) {
+            Extents[ExtentCount++] = { Data, FrameHeaderLength, DataLength };
+            FusedBatch[i].ExtentCount = 1;
+        } else {
+            const uint16_t Split = 333;
+            Extents[ExtentCount++] = { Data, FrameHeaderLength, Split };
+            Extents[ExtentCount++] = { Data + Split, FrameHeaderLength + Split, DataLength - Split };
+            FusedBatch[i].ExtentCount = 2;
+        }
+
+        CxPlatCopyMemory(Copied + i * PacketLength, Headers, HeaderLength + FrameHeaderLength);
+        CxPlatCopyMemory(Fused + i * PacketLength, Headers, HeaderLength + FrameHeaderLength);
+    }
+
+    //
+    // Encrypting from the extents must produce exactly the same output as
+    // copying the app data in first.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        CxPlatCopyMemory(
+            CopiedBatch[i].Buffer + FrameHeaderLength,
+            AppData + i * DataLength,
+            DataLength);
+    }
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatEncryptBatch(Key.Ptr, BatchSize, CopiedBatch));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatEncryptBatch(Key.Ptr, BatchSize, FusedBatch));
+    ASSERT_EQ(0, memcmp(Copied, Fused, sizeof(Copied)));
+}
+
+TEST_P(CryptTest, DecryptionBatch)
+{
+    int AEAD = GetParam();
+
+    const uint8_t BatchSize = 8;
+    const uint16_t HeaderLength = 13;
+    const uint16_t PayloadLength = 1200;
+    const uint16_t PacketLength = HeaderLength + PayloadLength;
+
+    uint8_t RawKey[32];
+    uint8_t RawIv[CXPLAT_IV_LENGTH];
+    CxPlatRandom(sizeof(RawKey), RawKey);
+    CxPlatRandom(sizeof(RawIv), RawIv);
+
+    QuicKey Key((CXPLAT_AEAD_TYPE)AEAD, RawKey);
+    if (Key.Ptr == NULL) return;
+
+    uint8_t Plain[BatchSize * PacketLength];
+    uint8_t Cipher[BatchSize * PacketLength];
+    uint8_t Buffer[BatchSize * PacketLength];
+    CxPlatRandom(sizeof(Plain), Plain);
+    CxPlatCopyMemory(Cipher, Plain, sizeof(Plain));
+
+    CXPLAT_CRYPT_BATCH_ENTRY Batch[BatchSize];
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        uint64_t PacketNumber = i;
+        QuicCryptoCombineIvAndPacketNumber(RawIv, (uint8_t*)&PacketNumber, Batch[i].Iv);
+        Batch[i].AuthData = Buffer + i * PacketLength;
+        Batch[i].AuthDataLength = HeaderLength;
+        Batch[i].Buffer = Buffer + i * PacketLength + HeaderLength;
+        Batch[i].BufferLength = PayloadLength;
+        ASSERT_TRUE(
+            Key.Encrypt(
+                Batch[i].Iv,
+                HeaderLength,
+                Cipher + i * PacketLength,
+                PayloadLength,
+                Cipher + i * PacketLength + HeaderLength));
+    }
+
+    //
+    // Positive case
+    //
+
+    uint8_t DecryptedCount;
+    CxPlatCopyMemory(Buffer, Cipher, sizeof(Cipher));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatDecryptBatch(Key.Ptr, BatchSize, Batch, &DecryptedCount));
+    ASSERT_EQ(BatchSize, DecryptedCount);
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        ASSERT_EQ(
+            0,
+            memcmp(
+                Plain + i * PacketLength,
+                Buffer + i * PacketLength,
+                PacketLength - CXPLAT_ENCRYPTION_OVERHEAD));
+    }
+
+    //
+    // Negative case: decryption stops at the first bad packet and leaves the
+    // rest untouched.
+    //
+
+    CxPlatCopyMemory(Buffer, Cipher, sizeof(Cipher));
+    Buffer[3 * PacketLength + HeaderLength] ^= 1;
+    ASSERT_NE(QUIC_STATUS_SUCCESS, CxPlatDecryptBatch(Key.Ptr, BatchSize, Batch, &DecryptedCount));
+    ASSERT_EQ(3, DecryptedCount);
+    ASSERT_EQ(0, memcmp(Plain, Buffer, HeaderLength + PayloadLength - CXPLAT_ENCRYPTION_OVERHEAD));
+    ASSERT_EQ(0, memcmp(Cipher + 4 * PacketLength, Buffer + 4 * PacketLength, 4 * PacketLength));
+    ASSERT_EQ(QUIC_STATUS_SUCCESS, CxPlatDecryptBatch(Key.Ptr, BatchSize - 4, Batch + 4, &DecryptedCount));
+    ASSERT_EQ(BatchSize - 4, DecryptedCount);
+}
+
 TEST_P(CryptTest, HashWellKnown)
 {
     int HASH = GetParam();
@@ -231,3 +231,136 @@ TEST(PlatformTest, EventQueueWorker)
 
     CxPlatEventQCleanup(&queue);
 }
+
+TEST(PlatformTest, PoolReuse)
+{
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitialize(FALSE, 64, QUIC_POOL_TEST, &Pool);
+
+    //
+    // Free entries are reused, and counted as hits.
+    //
+    void* Entry = CxPlatPoolAlloc(&Pool);
+    ASSERT_NE(nullptr, Entry);
+    CxPlatPoolFree(Entry);
+    void* Reused = CxPlatPoolAlloc(&Pool);
+    ASSERT_EQ(Entry, Reused);
+    CxPlatPoolFree(Reused);
+
+    CXPLAT_POOL_STATISTICS Stats;
+    CxPlatPoolGetStatistics(&Pool, &Stats);
+    ASSERT_EQ(1u, Stats.AllocHitCount);
+    ASSERT_EQ(1u, Stats.AllocMissCount);
+
+    //
+    // Bursts larger than the pool keeps start missing, until the pool grows
+    // to keep the whole burst.
+    //
+    const uint32_t BurstSize = 512;
+    void* Entries[BurstSize];
+    uint64_t LastMissCount = 0;
+    for (uint32_t Round = 0; Round < 64; ++Round) {
+        for (uint32_t i = 0; i < BurstSize; ++i) {
+            Entries[i] = CxPlatPoolAlloc(&Pool);
+            ASSERT_NE(nullptr, Entries[i]);
+            memset(Entries[i], (int)i, 64);
+        }
+        for (uint32_t i = 0; i < BurstSize; ++i) {
+            ASSERT_EQ((uint8_t)i, ((uint8_t*)Entries[i])[63]);
+            CxPlatPoolFree(Entries[i]);
+        }
+        CxPlatPoolGetStatistics(&Pool, &Stats);
+        ASSERT_EQ(2u + (Round + 1) * BurstSize, Stats.AllocHitCount + Stats.AllocMissCount);
+        if (Round == 0) {
+            ASSERT_NE(0u, Stats.AllocMissCount);
+        }
+        LastMissCount = Stats.AllocMissCount;
+    }
+    for (uint32_t i = 0; i < BurstSize; ++i) {
+        Entries[i] = CxPlatPoolAlloc(&Pool);
+        ASSERT_NE(nullptr, Entries[i]);
+    }
+    for (uint32_t i = 0; i < BurstSize; ++i) {
+        CxPlatPoolFree(Entries[i]);
+    }
+    CxPlatPoolGetStatistics(&Pool, &Stats);
+#ifndef DISABLE_CXPLAT_POOL
+    ASSERT_EQ(LastMissCount, Stats.AllocMissCount);
+#endif
+
+    //
+    // Pruning releases the free entries.
+    //
+    while (CxPlatPoolPrune(&Pool)) { }
+
+    CxPlatPoolUninitialize(&Pool);
+}
+
+struct PoolCrossThreadContext {
+    CXPLAT_POOL* Pool;
+    void** Entries;
+    uint32_t Count;
+    uint32_t Failures;
+
+    static CXPLAT_THREAD_CALLBACK(AllocCallback, Context) {
+        auto Ctx = (PoolCrossThreadContext*)Context;
+        for (uint32_t i = 0; i < Ctx->Count; ++i) {
+            Ctx->Entries[i] = CxPlatPoolAlloc(Ctx->Pool);
+            if (Ctx->Entries[i] == NULL) {
+                Ctx->Failures++;
+            } else {
+                *(uint32_t*)Ctx->Entries[i] = i;
+            }
+        }
+        CXPLAT_THREAD_RETURN(0);
+    }
+};
+
+TEST(PlatformTest, PoolCrossThread)
+{
+    //
+    // Entries allocated on other threads are freed on this one, and flow back
+    // to the allocating threads through the pool's depot.
+    //
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitialize(FALSE, sizeof(uint32_t), QUIC_POOL_TEST, &Pool);
+
+    const uint32_t ThreadCount = 4;
+    const uint32_t Count = 1000;
+    PoolCrossThreadContext Contexts[ThreadCount];
+    for (uint32_t i = 0; i < ThreadCount; ++i) {
+        Contexts[i].Pool = &Pool;
+        Contexts[i].Entries = new void*[Count];
+        Contexts[i].Count = Count;
+        Contexts[i].Failures = 0;
+    }
+
+    for (uint32_t Round = 0; Round < 20; ++Round) {
+        CXPLAT_THREAD Threads[ThreadCount];
+        for (uint32_t i = 0; i < ThreadCount; ++i) {
+            CXPLAT_THREAD_CONFIG Config = {
+                0, 0, NULL, PoolCrossThreadContext::AllocCallback, &Contexts[i] };
+            ASSERT_TRUE(QUIC_SUCCEEDED(CxPlatThreadCreate(&Config, &Threads[i])));
+        }
+        for (uint32_t i = 0; i < ThreadCount; ++i) {
+            CxPlatThreadWait(&Threads[i]);
+            CxPlatThreadDelete(&Threads[i]);
+        }
+        for (uint32_t i = 0; i < ThreadCount; ++i) {
+            ASSERT_EQ(0u, Contexts[i].Failures);
+            for (uint32_t j = 0; j < Count; ++j) {
+                ASSERT_EQ(j, *(uint32_t*)Contexts[i].Entries[j]);
+                CxPlatPoolFree(Contexts[i].Entries[j]);
+            }
+        }
+    }
+
+    CXPLAT_POOL_STATISTICS Stats;
+    CxPlatPoolGetStatistics(&Pool, &Stats);
+    ASSERT_EQ(20u * ThreadCount * Count, Stats.AllocHitCount + Stats.AllocMissCount);
+
+    for (uint32_t i = 0; i < ThreadCount; ++i) {
+        delete[] Contexts[i].Entries;
+    }
+    CxPlatPoolUninitialize(&Pool);
+}
@@ -118,32 +118,50 @@ EXT_COMMAND(
         Conn.HasQueuedWork() ? "TRUE" : "FALSE",
         Conn.HasPriorityWork() ? "TRUE" : "FALSE");
 
-    auto Operations = Conn.GetOperQueue().GetOperations();
-    if (Operations.IsEmpty()) {
+    auto OperQ = Conn.GetOperQueue();
+    auto PriorityOperations = OperQ.GetPriorityOperations();
+    auto Operations = OperQ.GetOperations();
+    auto Inbox = OperQ.GetInbox();
+    if (PriorityOperations.IsEmpty() && Operations.IsEmpty() && Inbox == 0) {
         Dml("\t\tNo Operations Queued\n");
     } else {
-        bool IsHighPriority = true;
-        bool IsFirstOperation = true;
-        UINT64 PriorityTail;
-        ReadPointerAtAddr(Conn.GetOperQueue().GetPriorityTail(), &PriorityTail);
-        while (!CheckControlC()) {
-            auto OperLinkAddr = Operations.Next();
-            if (OperLinkAddr == 0) {
-                break;
+        if (!PriorityOperations.IsEmpty()) {
+            Dml("\n\tHIGH PRIORITY:\n\n");
+            while (!CheckControlC()) {
+                auto OperLinkAddr = PriorityOperations.Next();
+                if (OperLinkAddr == 0) {
+                    break;
+                }
+                Dml("\t\t%s\n", Operation::FromLink(OperLinkAddr).TypeStr());
             }
+        }
 
-            if (PriorityTail == OperLinkAddr) {
-                IsHighPriority = false;
-                Dml("\n\tNORMAL PRIORITY:\n\n");
+        if (!Operations.IsEmpty()) {
+            Dml("\n\tNORMAL PRIORITY:\n\n");
+            while (!CheckControlC()) {
+                auto OperLinkAddr = Operations.Next();
+                if (OperLinkAddr == 0) {
+                    break;
+                }
+                Dml("\t\t%s\n", Operation::FromLink(OperLinkAddr).TypeStr());
             }
+        }
 
-            if (IsFirstOperation && IsHighPriority) {
-                Dml("\n\tHIGH PRIORITY:\n\n");
+        //
+        // Operations pushed since the worker last took the inbox, newest
+        // first. They go to the lanes above when it next takes the inbox.
+        //
+        if (Inbox != 0) {
+            Dml("\n\tINBOX (NEWEST FIRST):\n\n");
+            while (Inbox != 0 && !CheckControlC()) {
+                auto Oper = Operation::FromLink(Inbox);
+                auto Lane = Oper.Lane();
+                Dml("\t\t%s%s\n",
+                    Oper.TypeStr(),
+                    Lane == QUIC_OPERATION_LANE_FRONT ? " (FRONT)" :
+                    Lane == QUIC_OPERATION_LANE_PRIORITY ? " (PRIORITY)" : "");
+                Inbox = Oper.NextInInbox();
             }
-
-            auto Operation = Operation::FromLink(OperLinkAddr);
-            Dml("\t\t%s\n", Operation.TypeStr());
-            IsFirstOperation = false;
         }
     }
 
@@ -250,18 +268,34 @@ EXT_COMMAND(
     Dml("\tOutstanding Packets  ");
 
     auto Loss = Conn.GetLossDetection();
-    auto SendPackets = Loss.GetSendPackets();
 
-    if (SendPackets == 0) {
-        Dml("NONE\n");
+    if (!Loss.SentPacketsIndexed()) {
+        auto SentPackets = Loss.GetSentPacketsList();
+        if (SentPackets == 0) {
+            Dml("NONE\n");
+        } else {
+            while (SentPackets && !CheckControlC()) {
+                auto Packet = SentPacketMetadata(SentPackets);
+                Dml("<link cmd=\"!quicpacket 0x%I64X\">%I64u</link>\n"
+                    "\t                     ",
+                    Packet.Addr,
+                    Packet.PacketNumber());
+                SentPackets = Packet.Next();
+            }
+            Dml("\n");
+        }
     } else {
-        while (SendPackets && !CheckControlC()) {
-            auto Packet = SentPacketMetadata(SendPackets);
+        auto SentPacketsLength = Loss.SentPacketsLength();
+        for (ULONG i = 0; i < SentPacketsLength && !CheckControlC(); i++) {
+            auto SentPacket = Loss.GetSentPacket(i);
+            if (SentPacket == 0) {
+                continue;
+            }
+            auto Packet = SentPacketMetadata(SentPacket);
             Dml("<link cmd=\"!quicpacket 0x%I64X\">%I64u</link>\n"
                 "\t                     ",
                 Packet.Addr,
                 Packet.PacketNumber());
-            SendPackets = Packet.Next();
         }
         Dml("\n");
     }
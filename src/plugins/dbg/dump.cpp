@@ -105,15 +105,31 @@ EXT_COMMAND(
                         Conn.Addr,
                         Conn.TypeStr());
 
-                    auto Operations = Conn.GetOperQueue().GetOperations();
-                    while (!CheckControlC()) {
-                        auto OperLinkAddr = Operations.Next();
-                        if (OperLinkAddr == 0) {
-                            break;
+                    auto OperQ = Conn.GetOperQueue();
+                    LinkedList Lanes[] = {
+                        OperQ.GetPriorityOperations(), OperQ.GetOperations()
+                    };
+                    for (auto& Operations : Lanes) {
+                        while (!CheckControlC()) {
+                            auto OperLinkAddr = Operations.Next();
+                            if (OperLinkAddr == 0) {
+                                break;
+                            }
+
+                            auto Operation = Operation::FromLink(OperLinkAddr);
+                            Dml("      %s\n", Operation.TypeStr());
                         }
+                    }
 
-                        auto Operation = Operation::FromLink(OperLinkAddr);
-                        Dml("      %s\n", Operation.TypeStr());
+                    //
+                    // Then the operations not yet taken from the inbox, newest
+                    // first.
+                    //
+                    auto Inbox = OperQ.GetInbox();
+                    while (Inbox != 0 && !CheckControlC()) {
+                        auto Operation = Operation::FromLink(Inbox);
+                        Dml("      %s (inbox)\n", Operation.TypeStr());
+                        Inbox = Operation.NextInInbox();
                     }
                 }
             }
@@ -80,6 +80,7 @@ typedef union QUIC_STREAM_FLAGS {
         BOOLEAN InStreamTable           : 1;    // The stream is currently in the connection's table.
         BOOLEAN InWaitingList           : 1;    // The stream is currently in the waiting list for stream id FC.
         BOOLEAN DelayIdFcUpdate         : 1;    // Delay stream ID FC updates to StreamClose.
+        BOOLEAN SendRequestIndexFailed  : 1;    // Indexing the send requests failed; walk them instead.
     };
 } QUIC_STREAM_FLAGS;
 
@@ -1001,8 +1002,27 @@ struct LossDetection : Struct {
         return ReadType<UINT32>("RttVariance"); // Microseconds
     }
 
-    ULONG64 GetSendPackets() {
-        return ReadPointer("SentPackets");
+    bool SentPacketsIndexed() {
+        return ReadType<UCHAR>("SentPackets.Indexed") != 0;
+    }
+
+    ULONG64 GetSentPacketsList() { // Only while not indexed.
+        return ReadPointer("SentPackets.List");
+    }
+
+    ULONG SentPacketsLength() { // Only while indexed.
+        return ReadType<ULONG>("SentPackets.Length");
+    }
+
+    ULONG64 GetSentPacket(ULONG i) { // NULL if the packet number isn't outstanding.
+        UINT64 FirstPacketNumber = ReadType<UINT64>("SentPackets.FirstPacketNumber");
+        ULONG Capacity = ReadType<ULONG>("SentPackets.Capacity");
+        ULONG64 Slot =
+            ReadPointer("SentPackets.Packets") +
+            ((FirstPacketNumber + i) & (Capacity - 1)) * g_ExtInstance.m_PtrSize;
+        ULONG64 Packet = 0;
+        ReadPointerAtAddr(Slot, &Packet);
+        return Packet;
     }
 
     ULONG64 GetLostPackets() {
@@ -1105,6 +1125,17 @@ typedef enum QUIC_OPERATION_TYPE {
 
 } QUIC_OPERATION_TYPE;
 
+typedef enum QUIC_OPERATION_LANE {
+    QUIC_OPERATION_LANE_FRONT,      // Head of the priority operations.
+    QUIC_OPERATION_LANE_PRIORITY,   // Tail of the priority operations.
+    QUIC_OPERATION_LANE_NORMAL      // Tail of the normal operations.
+} QUIC_OPERATION_LANE;
+
+//
+// The value of an operation queue's inbox when it's empty and not being drained.
+//
+#define QUIC_OPERATION_QUEUE_IDLE 1
+
 struct Operation : Struct {
 
     Operation(ULONG64 Addr) : Struct("msquic!QUIC_OPERATION", Addr) { }
@@ -1117,6 +1148,14 @@ struct Operation : Struct {
         return ReadType<QUIC_OPERATION_TYPE>("Type");
     }
 
+    QUIC_OPERATION_LANE Lane() {
+        return (QUIC_OPERATION_LANE)ReadType<UCHAR>("Lane");
+    }
+
+    ULONG64 NextInInbox() { // The operation pushed before this one.
+        return ReadPointer("Link.Flink");
+    }
+
     PCSTR TypeStr() {
         switch (Type()) {
         case QUIC_OPER_TYPE_API_CALL:
@@ -1155,12 +1194,17 @@ struct OperQueue : Struct {
 
     OperQueue(ULONG64 Addr) : Struct("msquic!QUIC_OPERATION_QUEUE", Addr) { }
 
-    LinkedList GetOperations() {
-        return LinkedList(AddrOf("List"));
+    ULONG64 GetInbox() { // The newest operation pushed, or 0.
+        ULONG64 Inbox = ReadPointer("Inbox");
+        return Inbox == QUIC_OPERATION_QUEUE_IDLE ? 0 : Inbox;
+    }
+
+    LinkedList GetPriorityOperations() {
+        return LinkedList(AddrOf("PriorityList"));
     }
 
-    ULONG64 GetPriorityTail() {
-        return ReadPointer("PriorityTail");
+    LinkedList GetOperations() {
+        return LinkedList(AddrOf("List"));
     }
 };
 
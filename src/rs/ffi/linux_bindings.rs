@@ -442,6 +442,12 @@ pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_H
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 16;
 pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_AFFINITIZE:
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 32;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_SQPOLL:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 64;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_RING_DEFER:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 128;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 256;
 pub type QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -1683,7 +1689,28 @@ pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_LOAD_REJECT: QUIC_PER
     31;
 pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH:
     QUIC_PERFORMANCE_COUNTERS = 32;
-pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_IO_RING_SUBMITS: QUIC_PERFORMANCE_COUNTERS =
+    33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_IO_RING_WAKEUPS: QUIC_PERFORMANCE_COUNTERS =
+    34;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS:
+    QUIC_PERFORMANCE_COUNTERS = 35;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_IO_RING_RECV_REARMS:
+    QUIC_PERFORMANCE_COUNTERS = 36;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_SEND_ZERO_COPY:
+    QUIC_PERFORMANCE_COUNTERS = 37;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED:
+    QUIC_PERFORMANCE_COUNTERS = 38;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_LOOKUP_LOCK_WAITS:
+    QUIC_PERFORMANCE_COUNTERS = 39;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_LOOKUP_LOCK_WAIT_US:
+    QUIC_PERFORMANCE_COUNTERS = 40;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_POOL_ALLOC_HITS:
+    QUIC_PERFORMANCE_COUNTERS = 41;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_POOL_ALLOC_MISSES:
+    QUIC_PERFORMANCE_COUNTERS = 42;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_STOLEN: QUIC_PERFORMANCE_COUNTERS = 43;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 44;
 pub type QUIC_PERFORMANCE_COUNTERS = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -207,7 +207,7 @@ struct DrillSender {
         CxPlatSocketGetLocalAddress(Binding, &Route.LocalAddress);
         Route.RemoteAddress = ServerAddress;
 
-        CXPLAT_SEND_CONFIG SendConfig = { &Route, DatagramLength, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0 };
+        CXPLAT_SEND_CONFIG SendConfig = { &Route, DatagramLength, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0, 0 };
 
         CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Binding, &SendConfig);
 
@@ -314,6 +314,39 @@ QuicTraceGlobalEvent(
             case QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH:
                 printf("    Current listeners queued for processing:            ");
                 break;
+            case QUIC_PERF_COUNTER_IO_RING_SUBMITS:
+                printf("    Total io_uring submit system calls:                 ");
+                break;
+            case QUIC_PERF_COUNTER_IO_RING_WAKEUPS:
+                printf("    Total io_uring submitter wakeups:                   ");
+                break;
+            case QUIC_PERF_COUNTER_IO_RING_RECV_NO_BUFFERS:
+                printf("    Total io_uring receives without buffers:            ");
+                break;
+            case QUIC_PERF_COUNTER_IO_RING_RECV_REARMS:
+                printf("    Total io_uring multishot receive re-arms:           ");
+                break;
+            case QUIC_PERF_COUNTER_SEND_ZERO_COPY:
+                printf("    Total zero-copy sends completed:                    ");
+                break;
+            case QUIC_PERF_COUNTER_SEND_ZERO_COPY_COPIED:
+                printf("    Total zero-copy sends copied by the kernel:         ");
+                break;
+            case QUIC_PERF_COUNTER_LOOKUP_LOCK_WAITS:
+                printf("    Total lookup lock acquisitions that waited:         ");
+                break;
+            case QUIC_PERF_COUNTER_LOOKUP_LOCK_WAIT_US:
+                printf("    Total lookup lock wait time (us):                   ");
+                break;
+            case QUIC_PERF_COUNTER_POOL_ALLOC_HITS:
+                printf("    Total pool allocations reusing a free entry:        ");
+                break;
+            case QUIC_PERF_COUNTER_POOL_ALLOC_MISSES:
+                printf("    Total pool allocations of a new entry:              ");
+                break;
+            case QUIC_PERF_COUNTER_CONN_STOLEN:
+                printf("    Total connections taken from loaded workers:        ");
+                break;
             default:
                 printf("    Unknown:                                            ");
                 break;
@@ -717,7 +717,7 @@ void BuildAndSendPackets(
     )
 {
     const uint16_t DatagramLength = MinInitialDatagramLength;
-    CXPLAT_SEND_CONFIG SendConfig = { Route, DatagramLength, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0 };
+    CXPLAT_SEND_CONFIG SendConfig = { Route, DatagramLength, CXPLAT_ECN_NON_ECT, 0, CXPLAT_DSCP_CS0, 0 };
     CXPLAT_SEND_DATA* SendData = CxPlatSendDataAlloc(Binding, &SendConfig);
     CXPLAT_FRE_ASSERT(SendData != nullptr);
 